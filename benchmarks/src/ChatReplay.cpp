@@ -0,0 +1,493 @@
+#include "common/Literals.hpp"
+#include "controllers/accounts/AccountController.hpp"
+#include "controllers/highlights/HighlightController.hpp"
+#include "messages/Emote.hpp"
+#include "mocks/BaseApplication.hpp"
+#include "mocks/DisabledStreamerMode.hpp"
+#include "mocks/Emotes.hpp"
+#include "mocks/LinkResolver.hpp"
+#include "mocks/Logging.hpp"
+#include "mocks/TwitchIrcServer.hpp"
+#include "mocks/UserData.hpp"
+#include "providers/bttv/BttvEmotes.hpp"
+#include "providers/chatterino/ChatterinoBadges.hpp"
+#include "providers/ffz/FfzBadges.hpp"
+#include "providers/ffz/FfzEmotes.hpp"
+#include "providers/seventv/SeventvBadges.hpp"
+#include "providers/seventv/SeventvEmotes.hpp"
+#include "providers/twitch/IrcMessageHandler.hpp"
+#include "providers/twitch/TwitchBadges.hpp"
+#include "providers/twitch/TwitchChannel.hpp"
+#include "singletons/WindowManager.hpp"
+#include "util/Metrics.hpp"
+#include "widgets/helper/ChannelView.hpp"
+
+#include <benchmark/benchmark.h>
+#include <IrcMessage>
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QHBoxLayout>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTimer>
+#include <QWidget>
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#ifdef Q_OS_WIN
+#    include <Windows.h>
+// Windows.h must be included first
+#    include <psapi.h>
+#elif defined(Q_OS_UNIX)
+#    include <sys/resource.h>
+#endif
+
+using namespace chatterino;
+using namespace literals;
+using namespace std::chrono_literals;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+class MockApplication : public mock::BaseApplication
+{
+public:
+    MockApplication()
+        : highlights(this->settings, &this->accounts)
+        , windowManager(this->args, this->paths_, this->settings, this->theme,
+                        this->fonts)
+    {
+    }
+
+    IEmotes *getEmotes() override
+    {
+        return &this->emotes;
+    }
+
+    IUserDataController *getUserData() override
+    {
+        return &this->userData;
+    }
+
+    AccountController *getAccounts() override
+    {
+        return &this->accounts;
+    }
+
+    ITwitchIrcServer *getTwitch() override
+    {
+        return &this->twitch;
+    }
+
+    ChatterinoBadges *getChatterinoBadges() override
+    {
+        return &this->chatterinoBadges;
+    }
+
+    FfzBadges *getFfzBadges() override
+    {
+        return &this->ffzBadges;
+    }
+
+    SeventvBadges *getSeventvBadges() override
+    {
+        return &this->seventvBadges;
+    }
+
+    HighlightController *getHighlights() override
+    {
+        return &this->highlights;
+    }
+
+    TwitchBadges *getTwitchBadges() override
+    {
+        return &this->twitchBadges;
+    }
+
+    BttvEmotes *getBttvEmotes() override
+    {
+        return &this->bttvEmotes;
+    }
+
+    FfzEmotes *getFfzEmotes() override
+    {
+        return &this->ffzEmotes;
+    }
+
+    SeventvEmotes *getSeventvEmotes() override
+    {
+        return &this->seventvEmotes;
+    }
+
+    IStreamerMode *getStreamerMode() override
+    {
+        return &this->streamerMode;
+    }
+
+    ILinkResolver *getLinkResolver() override
+    {
+        return &this->linkResolver;
+    }
+
+    ILogging *getChatLogger() override
+    {
+        return &this->logging;
+    }
+
+    WindowManager *getWindows() override
+    {
+        return &this->windowManager;
+    }
+
+    mock::EmptyLogging logging;
+    AccountController accounts;
+    mock::Emotes emotes;
+    mock::UserDataController userData;
+    mock::MockTwitchIrcServer twitch;
+    mock::EmptyLinkResolver linkResolver;
+    ChatterinoBadges chatterinoBadges;
+    FfzBadges ffzBadges;
+    SeventvBadges seventvBadges;
+    HighlightController highlights;
+    TwitchBadges twitchBadges;
+    BttvEmotes bttvEmotes;
+    FfzEmotes ffzEmotes;
+    SeventvEmotes seventvEmotes;
+    DisabledStreamerMode streamerMode;
+    WindowManager windowManager;
+};
+
+QJsonObject readJsonObject(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly))
+    {
+        return {};
+    }
+    return QJsonDocument::fromJson(file.readAll()).object();
+}
+
+/// The replayed IRC lines: the recent messages of nymn followed by the inputs
+/// of the IrcMessageHandler snapshots
+std::vector<QByteArray> readReplayLines()
+{
+    std::vector<QByteArray> lines;
+
+    auto recentMessages =
+        readJsonObject(u":/bench/recentmessages-nymn.json"_s)["messages"_L1]
+            .toArray();
+    for (const auto &line : recentMessages)
+    {
+        lines.emplace_back(line.toString().toUtf8());
+    }
+
+    QDir snapshotDir(QStringLiteral(__FILE__));
+    snapshotDir.cd("../../../tests/snapshots/IrcMessageHandler");
+    for (const auto &entry :
+         snapshotDir.entryInfoList({u"*.json"_s}, QDir::Files, QDir::Name))
+    {
+        auto snapshot = readJsonObject(entry.absoluteFilePath());
+        for (const auto &prev :
+             snapshot["params"_L1].toObject()["prevMessages"_L1].toArray())
+        {
+            lines.emplace_back(prev.toString().toUtf8());
+        }
+        lines.emplace_back(snapshot["input"_L1].toString().toUtf8());
+    }
+
+    std::erase_if(lines, [](const auto &line) {
+        return line.isEmpty();
+    });
+    return lines;
+}
+
+/// The peak resident set size of this process in bytes (0 if unknown)
+size_t peakRss()
+{
+#ifdef Q_OS_WIN
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters,
+                             sizeof(counters)) == 0)
+    {
+        return 0;
+    }
+    return counters.PeakWorkingSetSize;
+#elif defined(Q_OS_UNIX)
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+#    ifdef Q_OS_MACOS
+    return static_cast<size_t>(usage.ru_maxrss);
+#    else
+    // Linux and the BSDs report kilobytes
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#    endif
+#else
+    return 0;
+#endif
+}
+
+/// The mean of the durations recorded between @a before and @a after in
+/// microseconds
+double meanMicros(const metrics::Histogram::Snapshot &before,
+                  const metrics::Histogram::Snapshot &after)
+{
+    auto count = after.count - before.count;
+    if (count == 0)
+    {
+        return 0;
+    }
+    return std::chrono::duration<double, std::micro>(after.sum - before.sum)
+               .count() /
+           static_cast<double>(count);
+}
+
+/// A view that measures how long it takes for messages to be painted
+class ReplayView : public ChannelView
+{
+public:
+    ReplayView(QWidget *parent, std::vector<Clock::duration> &latencies)
+        : ChannelView(parent)
+        , latencies_(latencies)
+    {
+        QObject::connect(this, &ChannelView::messageAddedToChannel, this,
+                         [this] {
+                             this->pending_.push_back(this->arrival);
+                         });
+    }
+
+    /// When the message that is currently being added arrived
+    Clock::time_point arrival;
+
+    bool hasPending() const
+    {
+        return !this->pending_.empty();
+    }
+
+    void reset()
+    {
+        this->pending_.clear();
+    }
+
+protected:
+    void paintEvent(QPaintEvent *event) override
+    {
+        // Only messages added before this paint can be part of it
+        auto painted = this->pending_.size();
+        ChannelView::paintEvent(event);
+
+        auto now = Clock::now();
+        for (size_t i = 0; i < painted; i++)
+        {
+            this->latencies_.emplace_back(now - this->pending_.front());
+            this->pending_.pop_front();
+        }
+    }
+
+private:
+    std::vector<Clock::duration> &latencies_;
+    std::deque<Clock::time_point> pending_;
+};
+
+/// Replays IRC lines at a fixed rate into a channel shown in several views,
+/// like a busy chat in multiple splits.
+///
+/// All work happens in the GUI thread: handling the IRC line, building the
+/// message, adding it to the channel and its views, layout (once per frame)
+/// and painting.
+class ChatReplay
+{
+public:
+    ChatReplay(size_t rate, size_t viewCount)
+        : rate_(rate)
+        , lines_(readReplayLines())
+    {
+        auto *layout = new QHBoxLayout(&this->window_);
+        layout->setContentsMargins(0, 0, 0, 0);
+        for (size_t i = 0; i < viewCount; i++)
+        {
+            auto *view = new ReplayView(&this->window_, this->latencies_);
+            layout->addWidget(view);
+            this->views_.emplace_back(view);
+        }
+        this->window_.resize(static_cast<int>(400 * viewCount), 800);
+        this->window_.show();
+        QCoreApplication::processEvents();
+    }
+
+    ~ChatReplay()
+    {
+        this->window_.close();
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    }
+
+    ChatReplay(const ChatReplay &) = delete;
+    ChatReplay(ChatReplay &&) = delete;
+    ChatReplay &operator=(const ChatReplay &) = delete;
+    ChatReplay &operator=(ChatReplay &&) = delete;
+
+    void run(benchmark::State &state)
+    {
+        const metrics::Histogram layoutTime("channel view layout time");
+        const metrics::Histogram paintTime("channel view paint time");
+
+        size_t messageCount = 0;
+        auto layoutBefore = layoutTime.snapshot();
+        auto paintBefore = paintTime.snapshot();
+
+        for (auto _ : state)
+        {
+            messageCount += this->replay();
+        }
+
+        auto layoutAfter = layoutTime.snapshot();
+        auto paintAfter = paintTime.snapshot();
+
+        auto percentile = [&](double q) {
+            if (this->latencies_.empty())
+            {
+                return 0.0;
+            }
+            auto last = static_cast<double>(this->latencies_.size() - 1);
+            auto nth = this->latencies_.begin() +
+                       static_cast<ptrdiff_t>(q * last);
+            std::ranges::nth_element(this->latencies_, nth);
+            return std::chrono::duration<double, std::micro>(*nth).count();
+        };
+
+        state.counters["msgs/s"] =
+            benchmark::Counter(static_cast<double>(messageCount),
+                               benchmark::Counter::kIsRate);
+        state.counters["p50_us"] = percentile(0.5);
+        state.counters["p99_us"] = percentile(0.99);
+        state.counters["layout_us"] = meanMicros(layoutBefore, layoutAfter);
+        state.counters["paint_us"] = meanMicros(paintBefore, paintAfter);
+        state.counters["frames"] = static_cast<double>(
+            (paintAfter.count - paintBefore.count) / this->views_.size());
+        state.counters["peak_rss"] =
+            benchmark::Counter(static_cast<double>(peakRss()),
+                               benchmark::Counter::kDefaults,
+                               benchmark::Counter::OneK::kIs1024);
+    }
+
+private:
+    /// Plays all lines once into a new channel, returns the number of lines
+    size_t replay()
+    {
+        auto channel = std::make_shared<TwitchChannel>(u"nymn"_s);
+        auto seventvEmotes =
+            readJsonObject(u":/bench/seventvemotes-nymn.json"_s);
+        channel->setSeventvEmotes(
+            std::make_shared<const EmoteMap>(seventv::detail::parseEmotes(
+                seventvEmotes["emote_set"_L1].toObject()["emotes"_L1].toArray(),
+                false)));
+
+        for (auto *view : this->views_)
+        {
+            view->reset();
+            view->setChannel(channel);
+        }
+
+        QEventLoop loop;
+        QTimer timer;
+        timer.setTimerType(Qt::PreciseTimer);
+
+        size_t next = 0;
+        const auto start = Clock::now();
+        const auto interval =
+            this->rate_ == 0
+                ? Clock::duration{}
+                : Clock::duration{1s} / static_cast<int64_t>(this->rate_);
+
+        QObject::connect(&timer, &QTimer::timeout, [&] {
+            auto now = Clock::now();
+            while (next < this->lines_.size())
+            {
+                auto arrival =
+                    this->rate_ == 0
+                        ? now
+                        : start + interval * static_cast<int64_t>(next);
+                if (arrival > now)
+                {
+                    return;
+                }
+                this->inject(*channel, this->lines_[next], arrival);
+                next++;
+
+                if (this->rate_ == 0)
+                {
+                    // Let the event loop run between messages
+                    return;
+                }
+            }
+
+            // Wait until the views painted all messages
+            auto done =
+                std::ranges::none_of(this->views_, &ReplayView::hasPending);
+            if (done || now - start > 30s)
+            {
+                loop.quit();
+            }
+        });
+        timer.start(this->rate_ == 0 ? 0ms : 1ms);
+        loop.exec();
+
+        return next;
+    }
+
+    void inject(TwitchChannel &channel, const QByteArray &line,
+                Clock::time_point arrival)
+    {
+        for (auto *view : this->views_)
+        {
+            view->arrival = arrival;
+        }
+
+        auto *message = Communi::IrcMessage::fromData(line, nullptr);
+        if (message == nullptr)
+        {
+            return;
+        }
+        IrcMessageHandler::parseMessageInto(message, channel, &channel);
+        delete message;
+    }
+
+    MockApplication app_;
+    size_t rate_;
+    std::vector<QByteArray> lines_;
+    std::vector<Clock::duration> latencies_;
+    QWidget window_;
+    std::vector<ReplayView *> views_;
+};
+
+/// Replays chat at `state.range(0)` messages per second (0 = as fast as
+/// possible) into `state.range(1)` views.
+///
+/// Reports the achieved message rate, the p50/p99 time from a message
+/// arriving until it's painted, the mean time of a view's layout and paint
+/// per frame and the peak RSS of the process.
+///
+/// e.g. `chatterino-benchmark --benchmark_filter=ChatReplay/rate:0/views:4`
+void BM_ChatReplay(benchmark::State &state)
+{
+    ChatReplay replay(static_cast<size_t>(state.range(0)),
+                      static_cast<size_t>(state.range(1)));
+    replay.run(state);
+}
+
+}  // namespace
+
+BENCHMARK(BM_ChatReplay)
+    ->ArgNames({"rate", "views"})
+    ->ArgsProduct({{250, 1000, 0}, {1, 4}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
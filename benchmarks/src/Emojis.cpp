@@ -6,6 +6,18 @@
 
 using namespace chatterino;
 
+static void BM_EmojiLoad(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        Emojis emojis;
+        emojis.load();
+        benchmark::DoNotOptimize(emojis.getEmojis().size());
+    }
+}
+
+BENCHMARK(BM_EmojiLoad);
+
 static void BM_ShortcodeParsing(benchmark::State &state)
 {
     Emojis emojis;
@@ -180,3 +192,11 @@ BENCHMARK_CAPTURE(
     "😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 "
     "😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 😂 ",
     61);
+BENCHMARK_CAPTURE(BM_EmojiParsing2, no_emoji,
+                  "this is a regular chat message without any emojis, just "
+                  "some words and punctuation like most messages in chat :)",
+                  0);
+BENCHMARK_CAPTURE(BM_EmojiParsing2, ascii_with_emoji,
+                  "this is a regular chat message with a single emoji at the "
+                  "end like a lot of messages in chat 🐧",
+                  1);
@@ -0,0 +1,66 @@
+#include "messages/Emote.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+
+using namespace chatterino;
+
+namespace {
+
+std::shared_ptr<const EmoteMap> makeMap(int64_t size)
+{
+    auto map = std::make_shared<EmoteMap>();
+    for (int64_t i = 0; i < size; i++)
+    {
+        EmoteName name{QString::number(i)};
+        (*map)[name] = std::make_shared<const Emote>(Emote{.name = name});
+    }
+    return map;
+}
+
+}  // namespace
+
+/// A single live update to a published map (see SeventvEmotes::addEmote)
+void BM_EmoteMap_UpdateOne(benchmark::State &state)
+{
+    auto published = makeMap(state.range(0));
+    auto emote = std::make_shared<const Emote>(Emote{.name = {"new"}});
+
+    for (auto _ : state)
+    {
+        EmoteMap updated = *published;
+        updated[emote->name] = emote;
+        benchmark::DoNotOptimize(updated);
+    }
+}
+
+void BM_EmoteMap_Find(benchmark::State &state)
+{
+    auto map = makeMap(state.range(0));
+    EmoteName name{QString::number(state.range(0) / 2)};
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(map->find(name));
+    }
+}
+
+void BM_EmoteMap_Iterate(benchmark::State &state)
+{
+    auto map = makeMap(state.range(0));
+
+    for (auto _ : state)
+    {
+        size_t n = 0;
+        for (const auto &[name, emote] : *map)
+        {
+            n += static_cast<size_t>(name.string.size());
+        }
+        benchmark::DoNotOptimize(n);
+    }
+}
+
+BENCHMARK(BM_EmoteMap_UpdateOne)->Arg(100)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_EmoteMap_Find)->Arg(100)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_EmoteMap_Iterate)->Arg(1000);
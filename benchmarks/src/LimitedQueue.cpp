@@ -62,10 +62,11 @@ void BM_LimitedQueue_Replace(benchmark::State &state)
 
 void BM_LimitedQueue_Snapshot(benchmark::State &state)
 {
-    LimitedQueue<int> queue(1000);
-    for (int i = 0; i < 1000; ++i)
+    auto size = static_cast<size_t>(state.range(0));
+    LimitedQueue<int> queue(size);
+    for (size_t i = 0; i < size; ++i)
     {
-        queue.pushBack(i);
+        queue.pushBack(static_cast<int>(i));
     }
 
     for (auto _ : state)
@@ -77,10 +78,11 @@ void BM_LimitedQueue_Snapshot(benchmark::State &state)
 
 void BM_LimitedQueue_Snapshot_ExpensiveCopy(benchmark::State &state)
 {
-    LimitedQueue<std::shared_ptr<int>> queue(1000);
-    for (int i = 0; i < 1000; ++i)
+    auto size = static_cast<size_t>(state.range(0));
+    LimitedQueue<std::shared_ptr<int>> queue(size);
+    for (size_t i = 0; i < size; ++i)
     {
-        queue.pushBack(std::make_shared<int>(i));
+        queue.pushBack(std::make_shared<int>(static_cast<int>(i)));
     }
 
     for (auto _ : state)
@@ -90,6 +92,26 @@ void BM_LimitedQueue_Snapshot_ExpensiveCopy(benchmark::State &state)
     }
 }
 
+/// A new message arrives and a view takes a snapshot to paint it
+void BM_LimitedQueue_PushBack_Snapshot(benchmark::State &state)
+{
+    auto size = static_cast<size_t>(state.range(0));
+    LimitedQueue<std::shared_ptr<int>> queue(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        queue.pushBack(std::make_shared<int>(static_cast<int>(i)));
+    }
+
+    auto item = std::make_shared<int>(0);
+    auto snapshot = queue.getSnapshot();
+    for (auto _ : state)
+    {
+        queue.pushBack(item);
+        snapshot = queue.getSnapshot();
+        benchmark::DoNotOptimize(snapshot);
+    }
+}
+
 void BM_LimitedQueue_Find(benchmark::State &state)
 {
     LimitedQueue<int> queue(1000);
@@ -111,6 +133,11 @@ BENCHMARK(BM_LimitedQueue_PushBack);
 BENCHMARK(BM_LimitedQueue_PushFront_One);
 BENCHMARK(BM_LimitedQueue_PushFront_Many);
 BENCHMARK(BM_LimitedQueue_Replace);
-BENCHMARK(BM_LimitedQueue_Snapshot);
-BENCHMARK(BM_LimitedQueue_Snapshot_ExpensiveCopy);
+BENCHMARK(BM_LimitedQueue_Snapshot)->RangeMultiplier(10)->Range(100, 100000);
+BENCHMARK(BM_LimitedQueue_Snapshot_ExpensiveCopy)
+    ->RangeMultiplier(10)
+    ->Range(100, 100000);
+BENCHMARK(BM_LimitedQueue_PushBack_Snapshot)
+    ->RangeMultiplier(10)
+    ->Range(100, 100000);
 BENCHMARK(BM_LimitedQueue_Find);
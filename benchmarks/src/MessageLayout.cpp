@@ -0,0 +1,133 @@
+#include "messages/layouts/MessageLayoutContainer.hpp"
+#include "messages/layouts/MessageLayoutContext.hpp"
+#include "messages/MessageElement.hpp"
+#include "mocks/BaseApplication.hpp"
+#include "singletons/Fonts.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+constexpr size_t MESSAGE_COUNT = 5000;
+
+const QStringList WORDS{
+    "LUL",      "KEKW",  "PogChamp", "the",      "streamer", "is",
+    "so",       "good",  "at",       "this",     "game",     "@forsen",
+    "xD",       "monkaS", "what",    "happened", "there",    "12:34",
+    "OMEGALUL", "chat",  "clip",     "it",       "Kappa",    "wideVIBE",
+};
+
+/// The words of the `i`-th message
+QStringList messageWords(size_t i)
+{
+    QStringList words;
+    for (size_t j = 0; j < 8 + i % 12; j++)
+    {
+        words.append(
+            WORDS[static_cast<qsizetype>((i * 7 + j * 13) % WORDS.size())]);
+    }
+    return words;
+}
+
+/// Builds text elements for MESSAGE_COUNT chat messages made of common words
+std::vector<std::unique_ptr<TextElement>> makeMessages()
+{
+    std::vector<std::unique_ptr<TextElement>> messages;
+    messages.reserve(MESSAGE_COUNT);
+    for (size_t i = 0; i < MESSAGE_COUNT; i++)
+    {
+        messages.emplace_back(std::make_unique<TextElement>(
+            messageWords(i).join(' '), MessageElementFlag::Text));
+    }
+    return messages;
+}
+
+void layoutAll(std::vector<std::unique_ptr<TextElement>> &messages, int width,
+               float scale)
+{
+    MessageLayoutContext ctx{
+        .messageColors = {},
+        .flags = MessageElementFlag::Text,
+        .width = width,
+        .scale = scale,
+        .imageScale = scale,
+    };
+
+    for (auto &message : messages)
+    {
+        MessageLayoutContainer container;
+        container.beginLayout(ctx.width, ctx.scale, ctx.imageScale, {});
+        message->addToContainer(container, ctx);
+        container.endLayout();
+        benchmark::DoNotOptimize(container.getHeight());
+    }
+}
+
+}  // namespace
+
+/// What every layout used to cost on top of line breaking: measuring every
+/// word with the font metrics
+void BM_MessageLayout_MeasureAllWords(benchmark::State &state)
+{
+    mock::BaseApplication mockApplication;
+    auto metrics =
+        mockApplication.fonts.getFontMetrics(FontStyle::ChatMedium, 1);
+    QStringList words;
+    for (size_t i = 0; i < MESSAGE_COUNT; i++)
+    {
+        words.append(messageWords(i));
+    }
+
+    for (auto _ : state)
+    {
+        qreal total = 0;
+        for (const auto &word : words)
+        {
+            total += metrics.horizontalAdvance(word);
+        }
+        benchmark::DoNotOptimize(total);
+    }
+}
+
+/// Resizing a view: only the width changes, the measured widths are reused
+void BM_MessageLayout_Resize(benchmark::State &state)
+{
+    mock::BaseApplication mockApplication;
+    auto messages = makeMessages();
+    layoutAll(messages, 400, 1);
+
+    int width = 400;
+    for (auto _ : state)
+    {
+        width = width == 400 ? 250 : 400;
+        layoutAll(messages, width, 1);
+    }
+}
+
+/// Zooming: every element measures again, but the words come from the cache in
+/// Fonts
+void BM_MessageLayout_Zoom(benchmark::State &state)
+{
+    mock::BaseApplication mockApplication;
+    auto messages = makeMessages();
+    layoutAll(messages, 400, 1);
+    layoutAll(messages, 400, 1.5);
+
+    float scale = 1;
+    for (auto _ : state)
+    {
+        scale = scale == 1 ? 1.5F : 1;
+        layoutAll(messages, 400, scale);
+    }
+}
+
+BENCHMARK(BM_MessageLayout_MeasureAllWords);
+BENCHMARK(BM_MessageLayout_Resize);
+BENCHMARK(BM_MessageLayout_Zoom);
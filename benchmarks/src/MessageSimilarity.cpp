@@ -0,0 +1,103 @@
+#include "messages/MessageSimilarity.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QString>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+QString makeText(int64_t length, uint32_t seed)
+{
+    static const QString WORDS[] = {
+        "forsenE", "LULW", "the", "quick", "brown", "fox", "KEKW", "nice",
+        "play",    "is",   "he",  "game",  "over",  "dog", "chat", "clip",
+    };
+
+    QString text;
+    text.reserve(length + 8);
+    for (uint32_t i = seed; text.size() < length; i = i * 7 + 3)
+    {
+        text += WORDS[i % std::size(WORDS)];
+        text += ' ';
+    }
+    text.truncate(length);
+    return text;
+}
+
+/// The way similarity was computed before: a full len1 x len2 table
+float fullTableSimilarity(QStringView str1, QStringView str2)
+{
+    std::vector<std::vector<int>> tree(str1.size(),
+                                       std::vector<int>(str2.size(), 0));
+    int z = 0;
+    for (qsizetype i = 0; i < str1.size(); ++i)
+    {
+        for (qsizetype j = 0; j < str2.size(); ++j)
+        {
+            if (str1[i] == str2[j])
+            {
+                tree[i][j] = (i == 0 || j == 0) ? 1 : tree[i - 1][j - 1] + 1;
+                z = std::max(tree[i][j], z);
+            }
+        }
+    }
+    auto div = std::max({qsizetype{1}, str1.size(), str2.size()});
+    return float(z) / float(div);
+}
+
+}  // namespace
+
+void BM_MessageSimilarity_FullTable(benchmark::State &state)
+{
+    auto a = makeText(state.range(0), 1);
+    auto b = makeText(state.range(0), 2);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(fullTableSimilarity(a, b));
+    }
+}
+
+void BM_MessageSimilarity_Relative(benchmark::State &state)
+{
+    auto a = makeText(state.range(0), 1);
+    auto b = makeText(state.range(0), 2);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(relativeSimilarity(a, b));
+    }
+}
+
+/// Spam: the texts are the same, so the check stops early
+void BM_MessageSimilarity_ExceedsSimilar(benchmark::State &state)
+{
+    auto a = makeText(state.range(0), 1);
+    auto b = a;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(exceedsSimilarity(a, b, 0.9F));
+    }
+}
+
+void BM_MessageSimilarity_ExceedsDifferent(benchmark::State &state)
+{
+    auto a = makeText(state.range(0), 1);
+    auto b = makeText(state.range(0), 2);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(exceedsSimilarity(a, b, 0.9F));
+    }
+}
+
+BENCHMARK(BM_MessageSimilarity_FullTable)->RangeMultiplier(4)->Range(32, 512);
+BENCHMARK(BM_MessageSimilarity_Relative)->RangeMultiplier(4)->Range(32, 512);
+BENCHMARK(BM_MessageSimilarity_ExceedsSimilar)
+    ->RangeMultiplier(4)
+    ->Range(32, 512);
+BENCHMARK(BM_MessageSimilarity_ExceedsDifferent)
+    ->RangeMultiplier(4)
+    ->Range(32, 512);
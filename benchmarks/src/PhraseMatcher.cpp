@@ -0,0 +1,105 @@
+#include "util/PhraseMatcher.hpp"
+
+#include "controllers/highlights/HighlightPhrase.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QString>
+#include <QStringList>
+
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+const QStringList MESSAGES{
+    "forsenE forsenE forsenE",
+    "@pajlada did you see the new nightly build? it fixes the emote issue",
+    "LULW he really just walked into that",
+    "is this the same game as yesterday or did he switch",
+    "https://github.com/Chatterino/chatterino2 check the releases page",
+    "KEKW KEKW KEKW KEKW KEKW KEKW",
+    "nice play phrase42 nice play",
+    "the quick brown fox jumps over the lazy dog 1234",
+};
+
+/// Every tenth phrase is a regex, the rest are plain phrases
+std::vector<PhraseMatcher::Phrase> makePhrases(int64_t count)
+{
+    std::vector<PhraseMatcher::Phrase> phrases;
+    phrases.reserve(static_cast<size_t>(count));
+    for (int64_t i = 0; i < count; i++)
+    {
+        if (i % 10 == 9)
+        {
+            phrases.push_back({
+                .pattern = QString(R"(\bregex%1\d+)").arg(i),
+                .isRegex = true,
+            });
+        }
+        else
+        {
+            phrases.push_back({
+                .pattern = QString("phrase%1").arg(i),
+                .wholeWord = true,
+            });
+        }
+    }
+    return phrases;
+}
+
+}  // namespace
+
+/// The way highlights were checked before: one regex per phrase
+void BM_PhraseMatcher_PerPhraseRegex(benchmark::State &state)
+{
+    std::vector<HighlightPhrase> highlights;
+    for (const auto &phrase : makePhrases(state.range(0)))
+    {
+        highlights.emplace_back(phrase.pattern, false, false, false,
+                                phrase.isRegex, phrase.isCaseSensitive, "",
+                                QColor());
+    }
+
+    for (auto _ : state)
+    {
+        for (const auto &message : MESSAGES)
+        {
+            for (const auto &highlight : highlights)
+            {
+                benchmark::DoNotOptimize(highlight.isMatch(message));
+            }
+        }
+    }
+}
+
+void BM_PhraseMatcher_Match(benchmark::State &state)
+{
+    PhraseMatcher matcher(makePhrases(state.range(0)));
+
+    for (auto _ : state)
+    {
+        for (const auto &message : MESSAGES)
+        {
+            auto matches = matcher.match(message);
+            benchmark::DoNotOptimize(matches);
+        }
+    }
+}
+
+void BM_PhraseMatcher_MatchesAny(benchmark::State &state)
+{
+    PhraseMatcher matcher(makePhrases(state.range(0)));
+
+    for (auto _ : state)
+    {
+        for (const auto &message : MESSAGES)
+        {
+            benchmark::DoNotOptimize(matcher.matchesAny(message));
+        }
+    }
+}
+
+BENCHMARK(BM_PhraseMatcher_PerPhraseRegex)->RangeMultiplier(4)->Range(4, 1024);
+BENCHMARK(BM_PhraseMatcher_Match)->RangeMultiplier(4)->Range(4, 1024);
+BENCHMARK(BM_PhraseMatcher_MatchesAny)->RangeMultiplier(4)->Range(4, 1024);
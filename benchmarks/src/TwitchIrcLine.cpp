@@ -0,0 +1,82 @@
+#include "providers/twitch/TwitchIrcLine.hpp"
+
+#include <benchmark/benchmark.h>
+#include <IrcMessage>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <memory>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+/// The raw lines of the recent messages of a channel
+std::vector<QByteArray> readRecentMessages(const QString &name)
+{
+    QFile file(QStringLiteral(":/bench/recentmessages-%1.json").arg(name));
+    if (!file.open(QFile::ReadOnly))
+    {
+        _exit(1);
+    }
+
+    std::vector<QByteArray> lines;
+    const auto messages = QJsonDocument::fromJson(file.readAll())
+                              .object()
+                              .value("messages")
+                              .toArray();
+    for (const auto &message : messages)
+    {
+        lines.emplace_back(message.toString().toUtf8());
+    }
+    return lines;
+}
+
+}  // namespace
+
+/// Parsing every line with Communi and reading the tags most messages use
+void BM_TwitchIrcLine_Communi(benchmark::State &state)
+{
+    auto lines = readRecentMessages("nymn");
+
+    for (auto _ : state)
+    {
+        for (const auto &line : lines)
+        {
+            std::unique_ptr<Communi::IrcMessage> message(
+                Communi::IrcMessage::fromData(line, nullptr));
+            auto tags = message->tags();
+            benchmark::DoNotOptimize(tags.value("user-id").toString());
+            benchmark::DoNotOptimize(tags.value("display-name").toString());
+            benchmark::DoNotOptimize(tags.value("badges").toString());
+            benchmark::DoNotOptimize(tags.contains("reply-parent-msg-id"));
+            benchmark::DoNotOptimize(message->nick());
+        }
+    }
+}
+
+/// The same with TwitchIrcLine
+void BM_TwitchIrcLine_Parse(benchmark::State &state)
+{
+    auto lines = readRecentMessages("nymn");
+
+    for (auto _ : state)
+    {
+        for (const auto &data : lines)
+        {
+            auto line = TwitchIrcLine::parse(data);
+            benchmark::DoNotOptimize(line->tag(TwitchTag::UserId));
+            benchmark::DoNotOptimize(line->tag(TwitchTag::DisplayName));
+            benchmark::DoNotOptimize(line->tag(TwitchTag::Badges));
+            benchmark::DoNotOptimize(
+                line->hasTag(TwitchTag::ReplyParentMsgId));
+            benchmark::DoNotOptimize(line->nick());
+        }
+    }
+}
+
+BENCHMARK(BM_TwitchIrcLine_Communi);
+BENCHMARK(BM_TwitchIrcLine_Parse);
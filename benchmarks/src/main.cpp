@@ -11,6 +11,12 @@ using namespace chatterino;
 
 int main(int argc, char **argv)
 {
+    // Benchmarks that show widgets (e.g. ChatReplay) don't need a display
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+    {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
     QApplication app(argc, argv);
 
     initResources();
@@ -3,6 +3,7 @@ set(RES_DIR "${CMAKE_SOURCE_DIR}/resources")
 set(
         RES_IGNORED_FILES
         .gitignore
+        emoji.json
         qt.conf
         resources.qrc
         resources_autogenerated.qrc
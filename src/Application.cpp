@@ -2,6 +2,7 @@
 
 #include "common/Args.hpp"
 #include "common/Channel.hpp"
+#include "common/Env.hpp"
 #include "common/Version.hpp"
 #include "controllers/accounts/AccountController.hpp"
 #include "controllers/commands/Command.hpp"
@@ -29,6 +30,7 @@
 #include "controllers/twitch/LiveController.hpp"
 #include "controllers/userdata/UserDataController.hpp"
 #include "debug/AssertInGuiThread.hpp"
+#include "debug/Trace.hpp"
 #include "messages/Message.hpp"
 #include "messages/MessageBuilder.hpp"
 #include "providers/bttv/BttvLiveUpdates.hpp"
@@ -45,7 +47,6 @@
 #include "singletons/CrashHandler.hpp"
 #include "singletons/Emotes.hpp"
 #include "singletons/Fonts.hpp"
-#include "singletons/helper/LoggingChannel.hpp"
 #include "singletons/Logging.hpp"
 #include "singletons/Paths.hpp"
 #include "singletons/Settings.hpp"
@@ -54,7 +55,9 @@
 #include "singletons/Toasts.hpp"
 #include "singletons/Updates.hpp"
 #include "singletons/WindowManager.hpp"
+#include "util/CombinePath.hpp"
 #include "util/Helpers.hpp"
+#include "util/Metrics.hpp"
 #include "util/PostToThread.hpp"
 #include "widgets/Notebook.hpp"
 #include "widgets/splits/Split.hpp"
@@ -162,7 +165,7 @@ Application::Application(Settings &_settings, const Paths &paths,
     , args_(_args)
     , themes(new Theme(paths))
     , fonts(new Fonts(_settings))
-    , logging(new Logging(_settings))
+    , logging(new Logging(_settings, paths))
     , emotes(new Emotes)
     , accounts(new AccountController)
     , eventSub(makeEventSubController(_settings))
@@ -294,6 +297,21 @@ void Application::initialize(Settings &settings, const Paths &paths)
 
     this->streamerMode->start();
 
+    if (const auto &metricsFile = Env::get().metricsFile)
+    {
+        metrics::startExport(
+            *metricsFile,
+            std::chrono::seconds(
+                std::max<uint16_t>(Env::get().metricsIntervalSeconds, 1)));
+    }
+
+    if constexpr (trace::ENABLED)
+    {
+        trace::initialize(
+            combinePath(paths.rootAppDataDirectory, "Traces"),
+            std::chrono::milliseconds(Env::get().traceLongFrameMs));
+    }
+
     this->initialized = true;
 }
 
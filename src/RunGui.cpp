@@ -274,6 +274,7 @@ void runGui(QApplication &a, const Paths &paths, Settings &settings,
     });
 
     chatterino::NetworkManager::init();
+    chatterino::NetworkManager::initCache(paths, settings);
     updates.checkForUpdates();
 
     QObject::connect(qApp, &QApplication::aboutToQuit, [] {
@@ -7,9 +7,16 @@
 #include "singletons/Logging.hpp"
 #include "singletons/Settings.hpp"
 #include "util/ChannelHelpers.hpp"
+#include "util/Metrics.hpp"
 
 namespace chatterino {
 
+namespace {
+
+const metrics::Histogram MESSAGE_ADD_TIME("message add time");
+
+}  // namespace
+
 //
 // Channel
 //
@@ -79,6 +86,8 @@ LimitedQueueSnapshot<MessagePtr> Channel::getMessageSnapshot()
 void Channel::addMessage(MessagePtr message, MessageContext context,
                          std::optional<MessageFlags> overridingFlags)
 {
+    auto timer = MESSAGE_ADD_TIME.time();
+
     message->freeze();
 
     MessagePtr deleted;
@@ -116,15 +125,20 @@ void Channel::addSystemMessage(const QString &contents)
 
 void Channel::addOrReplaceTimeout(MessagePtr message, const QDateTime &now)
 {
+    // Collected before the timeout is added, so it's not disabled itself
+    auto timeoutUser = message->timeoutUser;
+    auto userMessages = this->findMessagesByUser(timeoutUser);
+
     addOrReplaceChannelTimeout(
         this->getMessageSnapshot(), std::move(message), now,
-        [this](auto /*idx*/, auto msg, auto replacement) {
-            this->replaceMessage(msg, replacement);
+        [this](auto idx, auto msg, auto replacement) {
+            this->replaceMessage(static_cast<size_t>(idx), msg, replacement);
         },
         [this](auto msg) {
             this->addMessage(msg, MessageContext::Original);
-        },
-        true);
+        });
+
+    disableUserMessages(userMessages, timeoutUser);
 }
 
 void Channel::addOrReplaceClearChat(MessagePtr message, const QDateTime &now)
@@ -295,7 +309,8 @@ void Channel::replaceMessage(size_t hint, const MessagePtr &message,
     auto index = this->messages_.replaceItem(hint, message, replacement);
     if (index >= 0)
     {
-        this->messageReplaced.invoke(hint, message, replacement);
+        this->messageReplaced.invoke(static_cast<size_t>(index), message,
+                                     replacement);
     }
 }
 
@@ -316,17 +331,38 @@ void Channel::clearMessages()
 
 MessagePtr Channel::findMessageByID(QStringView messageID)
 {
-    MessagePtr res;
+    return this->messages_.findByKey(messageID).value_or(nullptr);
+}
+
+const QString &Channel::MessageIdOf::operator()(const MessagePtr &message) const
+{
+    return message->id;
+}
 
-    if (auto msg = this->messages_.rfind([messageID](const MessagePtr &msg) {
-            return msg->id == messageID;
-        });
-        msg)
+std::vector<MessagePtr> Channel::findMessagesByUser(const QString &login) const
+{
+    return this->messages_.findAllInGroup(login.toLower());
+}
+
+std::array<QString, 2> Channel::MessageUsersOf::operator()(
+    const MessagePtr &message) const
+{
+    auto author = message->loginName.toLower();
+    if (author.isEmpty() && message->flags.has(MessageFlag::Subscription))
+    {
+        // Subscription messages start with the user's name
+        QStringView text = message->messageText;
+        author = text.left(text.indexOf(u' ')).toString().toLower();
+    }
+
+    // The user a moderation message is about
+    auto target = message->timeoutUser.toLower();
+    if (target == author)
     {
-        res = *msg;
+        target.clear();
     }
 
-    return res;
+    return {author, target};
 }
 
 void Channel::applySimilarityFilters(const MessagePtr &message) const
@@ -5,6 +5,7 @@
 #include "messages/LimitedQueue.hpp"
 #include "messages/MessageFlag.hpp"
 #include "messages/MessageSink.hpp"
+#include "util/QStringHash.hpp"
 
 #include <magic_enum/magic_enum.hpp>
 #include <pajlada/signals/signal.hpp>
@@ -12,8 +13,10 @@
 #include <QString>
 #include <QTimer>
 
+#include <array>
 #include <memory>
 #include <optional>
+#include <vector>
 
 namespace chatterino {
 
@@ -110,6 +113,10 @@ public:
 
     MessagePtr findMessageByID(QStringView messageID) final;
 
+    /// Returns the messages sent by the user with the given login or about
+    /// them (e.g. timeouts), oldest first.
+    std::vector<MessagePtr> findMessagesByUser(const QString &login) const;
+
     bool hasMessages() const;
 
     void applySimilarityFilters(const MessagePtr &message) const final;
@@ -143,7 +150,18 @@ protected:
 
 private:
     const QString name_;
-    LimitedQueue<MessagePtr> messages_;
+    struct MessageIdOf {
+        using Hash = TransparentQStringHash;
+
+        const QString &operator()(const MessagePtr &message) const;
+    };
+
+    /// The sender and the target of moderation messages
+    struct MessageUsersOf {
+        std::array<QString, 2> operator()(const MessagePtr &message) const;
+    };
+
+    LimitedQueue<MessagePtr, MessageIdOf, MessageUsersOf> messages_;
     Type type_;
     bool anythingLogged_ = false;
     QTimer clearCompletionModelTimer_;
@@ -81,6 +81,10 @@ Env::Env()
     , twitchServerPort(readPortEnv("CHATTERINO2_TWITCH_SERVER_PORT", 443))
     , twitchServerSecure(readBoolEnv("CHATTERINO2_TWITCH_SERVER_SECURE", true))
     , proxyUrl(readOptionalStringEnv("CHATTERINO2_PROXY_URL"))
+    , metricsFile(readOptionalStringEnv("CHATTERINO2_METRICS_FILE"))
+    , metricsIntervalSeconds(
+          readPortEnv("CHATTERINO2_METRICS_INTERVAL_SECONDS", 15))
+    , traceLongFrameMs(readPortEnv("CHATTERINO2_TRACE_LONG_FRAME_MS", 250))
 {
 }
 
@@ -19,6 +19,12 @@ public:
     const uint16_t twitchServerPort;
     const bool twitchServerSecure;
     const std::optional<QString> proxyUrl;
+    /// Periodically write all metrics to this file (see metrics::startExport)
+    const std::optional<QString> metricsFile;
+    const uint16_t metricsIntervalSeconds;
+    /// Dump a trace after the GUI thread was blocked for this long (0 to
+    /// disable). Only used if tracing is compiled in.
+    const uint16_t traceLongFrameMs;
 };
 
 }  // namespace chatterino
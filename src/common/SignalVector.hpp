@@ -1,11 +1,13 @@
 #pragma once
 
+#include "common/Atomic.hpp"
 #include "debug/AssertInGuiThread.hpp"
 
 #include <pajlada/signals/signal.hpp>
 #include <QStandardItemModel>
 #include <QTimer>
 
+#include <memory>
 #include <vector>
 
 namespace chatterino {
@@ -26,7 +28,7 @@ public:
     pajlada::Signals::NoArgSignal delayedItemsChanged;
 
     SignalVector()
-        : readOnly_(new std::vector<T>())
+        : readOnly_(std::make_shared<const std::vector<T>>())
     {
         QObject::connect(&this->itemsChangedTimer_, &QTimer::timeout, [this] {
             this->delayedItemsChanged.invoke();
@@ -55,7 +57,7 @@ public:
     /// A read-only version of the vector which can be used concurrently.
     std::shared_ptr<const std::vector<T>> readOnly()
     {
-        return this->readOnly_;
+        return this->readOnly_.get();
     }
 
     /// This may only be called from the GUI thread.
@@ -197,11 +199,12 @@ private:
         }
 
         // update concurrent version
-        this->readOnly_ = std::make_shared<const std::vector<T>>(this->items_);
+        this->readOnly_.set(
+            std::make_shared<const std::vector<T>>(this->items_));
     }
 
     std::vector<T> items_;
-    std::shared_ptr<const std::vector<T>> readOnly_;
+    Atomic<std::shared_ptr<const std::vector<T>>> readOnly_;
     QTimer itemsChangedTimer_;
     std::function<bool(const T &, const T &)> itemCompare_;
 };
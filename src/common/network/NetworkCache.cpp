@@ -0,0 +1,490 @@
+#include "common/network/NetworkCache.hpp"
+
+#include "common/network/NetworkManager.hpp"
+#include "common/QLogging.hpp"
+#include "debug/AssertInGuiThread.hpp"
+#include "util/Metrics.hpp"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QNetworkReply>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+using namespace chatterino::network::detail;
+
+const chatterino::metrics::Counter HTTP_CACHE_HITS("http cache hits");
+const chatterino::metrics::Counter HTTP_CACHE_STALE_HITS(
+    "http cache stale hits");
+const chatterino::metrics::Counter HTTP_CACHE_MISSES("http cache misses");
+
+constexpr quint32 INDEX_MAGIC = 0x43484e43;  // CHNC
+constexpr quint32 INDEX_VERSION = 1;
+
+/// The index is written at most this often while running
+constexpr int64_t SAVE_INTERVAL_MS = 60 * 1000;
+
+/// Length of a hex encoded SHA-256 hash
+constexpr qsizetype HASH_LENGTH = 64;
+
+std::unique_ptr<NetworkCache> &currentCache()
+{
+    static std::unique_ptr<NetworkCache> cache;
+    return cache;
+}
+
+std::optional<int64_t> parseHttpDate(const QByteArray &value)
+{
+    auto date = QDateTime::fromString(QString::fromLatin1(value).trimmed(),
+                                      Qt::RFC2822Date);
+    if (!date.isValid())
+    {
+        return std::nullopt;
+    }
+    return date.toMSecsSinceEpoch();
+}
+
+bool isHash(const QString &name)
+{
+    return name.size() == HASH_LENGTH &&
+           std::ranges::all_of(name, [](QChar c) {
+               return c.isDigit() || (c >= u'a' && c <= u'f');
+           });
+}
+
+}  // namespace
+
+namespace chatterino::network::detail {
+
+NetworkCache::NetworkCache(QString directory, int64_t budget)
+    : directory_(std::move(directory))
+    , budget_(budget)
+{
+    this->load();
+    this->reconcile();
+    this->evict();
+}
+
+NetworkCache::~NetworkCache()
+{
+    this->save();
+}
+
+void NetworkCache::configure(QString directory, int64_t budget)
+{
+    assertInGuiThread();
+    assert(NetworkManager::accessManager != nullptr);
+
+    QMetaObject::invokeMethod(
+        NetworkManager::accessManager,
+        [directory = std::move(directory), budget] {
+            auto &cache = currentCache();
+            if (cache && cache->directory_ == directory)
+            {
+                cache->setBudget(budget);
+                return;
+            }
+
+            // The cache directory was changed in the settings
+            cache.reset();
+            cache = std::make_unique<NetworkCache>(directory, budget);
+        });
+}
+
+NetworkCache *NetworkCache::instance()
+{
+    return currentCache().get();
+}
+
+void NetworkCache::saveInstance()
+{
+    if (currentCache())
+    {
+        currentCache()->save();
+    }
+}
+
+std::optional<NetworkCache::Hit> NetworkCache::read(const QString &hash,
+                                                    int64_t now)
+{
+    auto it = this->entries_.find(hash);
+    if (it == this->entries_.end())
+    {
+        HTTP_CACHE_MISSES.increase();
+        return std::nullopt;
+    }
+
+    QFile file(this->filePath(hash));
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        // The body was deleted from outside (e.g. "Clear Cache")
+        this->remove(hash);
+        HTTP_CACHE_MISSES.increase();
+        return std::nullopt;
+    }
+
+    auto &entry = it->second;
+    Hit hit{
+        .body = file.readAll(),
+        .metadata = entry.metadata,
+        .fresh = now < entry.metadata.expires,
+    };
+
+    if (hit.body.size() != entry.size)
+    {
+        this->totalSize_ += hit.body.size() - entry.size;
+        entry.size = hit.body.size();
+    }
+    entry.lastAccess = now;
+    this->dirty_ = true;
+    this->maybeSave(now);
+
+    (hit.fresh ? HTTP_CACHE_HITS : HTTP_CACHE_STALE_HITS).increase();
+    return hit;
+}
+
+void NetworkCache::write(const QString &hash, const QByteArray &body,
+                         const Metadata &metadata, int64_t now)
+{
+    QFile file(this->filePath(hash));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+        file.write(body) != body.size())
+    {
+        qCWarning(chatterinoCache)
+            << "Failed to write" << file.fileName() << file.errorString();
+        file.remove();
+        this->remove(hash);
+        return;
+    }
+
+    auto &entry = this->entries_[hash];
+    this->totalSize_ += body.size() - entry.size;
+    entry = {
+        .size = body.size(),
+        .lastAccess = now,
+        .metadata = metadata,
+    };
+    this->dirty_ = true;
+
+    this->evict();
+    this->maybeSave(now);
+}
+
+void NetworkCache::refresh(const QString &hash, const Metadata &metadata,
+                           int64_t now)
+{
+    auto it = this->entries_.find(hash);
+    if (it == this->entries_.end())
+    {
+        return;
+    }
+
+    auto &entry = it->second;
+    // A 304 response doesn't have to repeat the validators
+    if (!metadata.etag.isEmpty())
+    {
+        entry.metadata.etag = metadata.etag;
+    }
+    if (!metadata.lastModified.isEmpty())
+    {
+        entry.metadata.lastModified = metadata.lastModified;
+    }
+    entry.metadata.expires = metadata.expires;
+    entry.lastAccess = now;
+    this->dirty_ = true;
+
+    this->maybeSave(now);
+}
+
+void NetworkCache::setBudget(int64_t budget)
+{
+    if (this->budget_ == budget)
+    {
+        return;
+    }
+
+    this->budget_ = budget;
+    this->evict();
+}
+
+int64_t NetworkCache::totalSize() const
+{
+    return this->totalSize_;
+}
+
+size_t NetworkCache::size() const
+{
+    return this->entries_.size();
+}
+
+void NetworkCache::save()
+{
+    if (!this->dirty_)
+    {
+        return;
+    }
+
+    QDir().mkpath(this->directory_);
+    QSaveFile file(this->directory_ + '/' + INDEX_FILE_NAME);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qCWarning(chatterinoCache)
+            << "Failed to write" << file.fileName() << file.errorString();
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream << INDEX_MAGIC << INDEX_VERSION
+           << static_cast<quint64>(this->entries_.size());
+    for (const auto &[hash, entry] : this->entries_)
+    {
+        stream << QByteArray::fromHex(hash.toLatin1())
+               << static_cast<qint64>(entry.size)
+               << static_cast<qint64>(entry.lastAccess)
+               << static_cast<qint64>(entry.metadata.expires)
+               << entry.metadata.etag << entry.metadata.lastModified;
+    }
+
+    if (!file.commit())
+    {
+        qCWarning(chatterinoCache)
+            << "Failed to write" << file.fileName() << file.errorString();
+        return;
+    }
+
+    this->dirty_ = false;
+}
+
+NetworkCache::Metadata NetworkCache::metadataOf(const QNetworkReply &reply,
+                                                int64_t now)
+{
+    auto lastModified = reply.rawHeader("Last-Modified");
+    return {
+        .etag = reply.rawHeader("ETag"),
+        .lastModified = lastModified,
+        .expires = expiryOf(reply.rawHeader("Cache-Control"),
+                            reply.rawHeader("Expires"), lastModified, now),
+    };
+}
+
+int64_t NetworkCache::expiryOf(const QByteArray &cacheControl,
+                               const QByteArray &expires,
+                               const QByteArray &lastModified, int64_t now)
+{
+    std::optional<int64_t> maxAge;
+    for (const auto &part : cacheControl.split(','))
+    {
+        auto directive = part.trimmed().toLower();
+        // The request asked for a cached response, so the body is still
+        // stored, but it's revalidated every time it's used.
+        if (directive == "no-cache" || directive == "no-store")
+        {
+            return now;
+        }
+        if (directive.startsWith("max-age="))
+        {
+            bool ok = false;
+            auto seconds = directive.mid(8).toLongLong(&ok);
+            if (ok && seconds >= 0)
+            {
+                maxAge = seconds;
+            }
+        }
+    }
+
+    if (maxAge)
+    {
+        return now + *maxAge * 1000;
+    }
+
+    if (!expires.isEmpty())
+    {
+        // Invalid dates (e.g. "0") mean the response is already expired
+        return parseHttpDate(expires).value_or(now);
+    }
+
+    if (!lastModified.isEmpty())
+    {
+        auto date = parseHttpDate(lastModified);
+        if (date && *date < now)
+        {
+            return now +
+                   std::min((now - *date) / 10, MAX_HEURISTIC_FRESHNESS_MS);
+        }
+    }
+
+    return now + DEFAULT_FRESHNESS_MS;
+}
+
+void NetworkCache::load()
+{
+    QFile file(this->directory_ + '/' + INDEX_FILE_NAME);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return;
+    }
+
+    QDataStream stream(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint64 count = 0;
+    stream >> magic >> version >> count;
+    if (magic != INDEX_MAGIC || version != INDEX_VERSION)
+    {
+        qCWarning(chatterinoCache) << "Ignoring unknown cache index";
+        return;
+    }
+
+    this->entries_.reserve(count);
+    for (quint64 i = 0; i < count && stream.status() == QDataStream::Ok; i++)
+    {
+        QByteArray hash;
+        qint64 size = 0;
+        qint64 lastAccess = 0;
+        qint64 expires = 0;
+        Metadata metadata;
+        stream >> hash >> size >> lastAccess >> expires >> metadata.etag >>
+            metadata.lastModified;
+        metadata.expires = expires;
+
+        if (stream.status() != QDataStream::Ok)
+        {
+            break;
+        }
+
+        this->entries_[QString::fromLatin1(hash.toHex())] = {
+            .size = size,
+            .lastAccess = lastAccess,
+            .metadata = std::move(metadata),
+        };
+        this->totalSize_ += size;
+    }
+
+    if (stream.status() != QDataStream::Ok)
+    {
+        qCWarning(chatterinoCache) << "Cache index is truncated";
+        this->dirty_ = true;
+    }
+}
+
+void NetworkCache::reconcile()
+{
+    QDir dir(this->directory_);
+    std::unordered_set<QString> bodies;
+    size_t added = 0;
+    for (const auto &info : dir.entryInfoList(QDir::Files))
+    {
+        auto name = info.fileName();
+        if (!isHash(name))
+        {
+            continue;
+        }
+
+        bodies.insert(name);
+        if (this->entries_.contains(name))
+        {
+            continue;
+        }
+
+        auto modified = info.lastModified().toMSecsSinceEpoch();
+        this->entries_[name] = {
+            .size = info.size(),
+            .lastAccess = modified,
+            .metadata = {.expires = modified + DEFAULT_FRESHNESS_MS},
+        };
+        this->totalSize_ += info.size();
+        added++;
+    }
+
+    size_t dropped = 0;
+    for (auto it = this->entries_.begin(); it != this->entries_.end();)
+    {
+        if (bodies.contains(it->first))
+        {
+            ++it;
+            continue;
+        }
+
+        this->totalSize_ -= it->second.size;
+        it = this->entries_.erase(it);
+        dropped++;
+    }
+
+    if (added > 0 || dropped > 0)
+    {
+        qCDebug(chatterinoCache) << "Added" << added << "and dropped"
+                                 << dropped << "index entries in" << dir.path();
+        this->dirty_ = true;
+    }
+}
+
+void NetworkCache::evict()
+{
+    if (this->totalSize_ <= this->budget_)
+    {
+        return;
+    }
+
+    std::vector<std::pair<int64_t, QString>> byAccess;
+    byAccess.reserve(this->entries_.size());
+    for (const auto &[hash, entry] : this->entries_)
+    {
+        byAccess.emplace_back(entry.lastAccess, hash);
+    }
+    std::ranges::sort(byAccess);
+
+    // Leave some room, so we don't evict on every write
+    auto target = this->budget_ / 10 * 9;
+    size_t evicted = 0;
+    for (const auto &[lastAccess, hash] : byAccess)
+    {
+        if (this->totalSize_ <= target)
+        {
+            break;
+        }
+
+        QFile::remove(this->filePath(hash));
+        this->remove(hash);
+        evicted++;
+    }
+
+    qCDebug(chatterinoCache) << "Evicted" << evicted << "files from"
+                             << this->directory_;
+}
+
+void NetworkCache::remove(const QString &hash)
+{
+    auto it = this->entries_.find(hash);
+    if (it == this->entries_.end())
+    {
+        return;
+    }
+
+    this->totalSize_ -= it->second.size;
+    this->entries_.erase(it);
+    this->dirty_ = true;
+}
+
+void NetworkCache::maybeSave(int64_t now)
+{
+    if (this->dirty_ && now - this->lastSave_ >= SAVE_INTERVAL_MS)
+    {
+        this->lastSave_ = now;
+        this->save();
+    }
+}
+
+QString NetworkCache::filePath(const QString &hash) const
+{
+    return this->directory_ + '/' + hash;
+}
+
+}  // namespace chatterino::network::detail
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+
+class QNetworkReply;
+
+namespace chatterino::network::detail {
+
+/// @brief The disk cache used for requests made with NetworkRequest::cache()
+///
+/// Each response body is stored in its own file in the cache directory, named
+/// after NetworkData::getHash(). A compact index next to them records the size,
+/// the validators (ETag and Last-Modified), the expiry and the last access of
+/// every body. Once the bodies exceed the byte budget, the least recently used
+/// ones are deleted.
+///
+/// The index is only written periodically. When the cache is loaded, bodies
+/// missing from the index (e.g. written before a crash or by older versions
+/// without an index) are added like responses without validators, and entries
+/// whose body was deleted are dropped.
+///
+/// Apart from configure(), this must only be used from the network worker
+/// thread.
+class NetworkCache
+{
+public:
+    /// The name of the index file in the cache directory
+    static constexpr const char *INDEX_FILE_NAME = "network-cache.index";
+
+    /// How long responses without any freshness information are fresh
+    static constexpr int64_t DEFAULT_FRESHNESS_MS = 24LL * 60 * 60 * 1000;
+    /// The longest freshness derived from Last-Modified
+    static constexpr int64_t MAX_HEURISTIC_FRESHNESS_MS =
+        7 * DEFAULT_FRESHNESS_MS;
+
+    struct Metadata {
+        QByteArray etag;
+        QByteArray lastModified;
+        /// Milliseconds since epoch after which the body must be revalidated
+        int64_t expires = 0;
+    };
+
+    struct Hit {
+        QByteArray body;
+        Metadata metadata;
+        bool fresh = false;
+    };
+
+    NetworkCache(QString directory, int64_t budget);
+    ~NetworkCache();
+
+    NetworkCache(const NetworkCache &) = delete;
+    NetworkCache(NetworkCache &&) = delete;
+    NetworkCache &operator=(const NetworkCache &) = delete;
+    NetworkCache &operator=(NetworkCache &&) = delete;
+
+    /// @brief Sets the directory and the budget of the cache used for requests
+    ///
+    /// This must be called from the GUI thread. The cache is opened or updated
+    /// on the network worker.
+    static void configure(QString directory, int64_t budget);
+
+    /// Returns the cache for requests or nullptr if configure() wasn't called
+    static NetworkCache *instance();
+
+    /// Writes the index of the current cache (if any) to disk
+    static void saveInstance();
+
+    /// Reads the body stored for @a hash and marks it as used
+    std::optional<Hit> read(const QString &hash, int64_t now);
+
+    /// Stores @a body for @a hash and evicts bodies if the budget is exceeded
+    void write(const QString &hash, const QByteArray &body,
+               const Metadata &metadata, int64_t now);
+
+    /// Updates the metadata of a body after it was revalidated
+    void refresh(const QString &hash, const Metadata &metadata, int64_t now);
+
+    void setBudget(int64_t budget);
+
+    /// The combined size of all bodies in bytes
+    int64_t totalSize() const;
+
+    size_t size() const;
+
+    /// Writes the index to disk if it changed
+    void save();
+
+    /// @brief Returns the metadata of a response
+    ///
+    /// The expiry is taken from Cache-Control's max-age, Expires or, as a
+    /// heuristic, a tenth of the time since Last-Modified.
+    /// no-cache and no-store make the response expire immediately.
+    static Metadata metadataOf(const QNetworkReply &reply, int64_t now);
+
+    static int64_t expiryOf(const QByteArray &cacheControl,
+                            const QByteArray &expires,
+                            const QByteArray &lastModified, int64_t now);
+
+private:
+    struct Entry {
+        int64_t size = 0;
+        int64_t lastAccess = 0;
+        Metadata metadata;
+    };
+
+    void load();
+    void reconcile();
+    void evict();
+    void remove(const QString &hash);
+    void maybeSave(int64_t now);
+
+    QString filePath(const QString &hash) const;
+
+    const QString directory_;
+    int64_t budget_;
+    int64_t totalSize_ = 0;
+    bool dirty_ = false;
+    int64_t lastSave_ = 0;
+
+    std::unordered_map<QString, Entry> entries_;
+};
+
+}  // namespace chatterino::network::detail
@@ -1,7 +1,22 @@
 #include "common/network/NetworkManager.hpp"
 
+#include "common/network/NetworkCache.hpp"
+#include "singletons/Paths.hpp"
+#include "singletons/Settings.hpp"
+
 #include <QNetworkAccessManager>
 
+#include <memory>
+#include <vector>
+
+namespace {
+
+/// Updates the cache when its settings change, see NetworkManager::initCache
+std::vector<std::unique_ptr<pajlada::Signals::ScopedConnection>>
+    cacheConnections;
+
+}  // namespace
+
 namespace chatterino {
 
 QThread *NetworkManager::workerThread = nullptr;
@@ -25,6 +40,16 @@ void NetworkManager::deinit()
     assert(NetworkManager::workerThread);
     assert(NetworkManager::accessManager);
 
+    cacheConnections.clear();
+
+    // the cache index is only written periodically
+    QMetaObject::invokeMethod(
+        NetworkManager::accessManager,
+        [] {
+            network::detail::NetworkCache::saveInstance();
+        },
+        Qt::BlockingQueuedConnection);
+
     // delete the access manager first:
     // - put the event on the worker thread
     // - wait for it to process
@@ -41,4 +66,17 @@ void NetworkManager::deinit()
     NetworkManager::workerThread = nullptr;
 }
 
+void NetworkManager::initCache(const Paths &paths, Settings &settings)
+{
+    auto configure = [&paths, &settings] {
+        network::detail::NetworkCache::configure(
+            paths.cacheDirectory(),
+            static_cast<int64_t>(settings.cacheSizeLimit.getValue()) * 1024 *
+                1024);
+    };
+    settings.cachePath.connect(configure, cacheConnections, false);
+    settings.cacheSizeLimit.connect(configure, cacheConnections, false);
+    configure();
+}
+
 }  // namespace chatterino
@@ -5,6 +5,9 @@
 
 namespace chatterino {
 
+class Paths;
+class Settings;
+
 class NetworkManager : public QObject
 {
     Q_OBJECT
@@ -15,6 +18,11 @@ public:
 
     static void init();
     static void deinit();
+
+    /// Passes the cache directory and size limit to the network worker and
+    /// keeps them up to date. This must be called from the GUI thread after
+    /// init().
+    static void initCache(const Paths &paths, Settings &settings);
 };
 
 }  // namespace chatterino
@@ -5,16 +5,15 @@
 #include "common/network/NetworkResult.hpp"
 #include "common/network/NetworkTask.hpp"
 #include "common/QLogging.hpp"
-#include "singletons/Paths.hpp"
+#include "debug/Trace.hpp"
 #include "util/AbandonObject.hpp"
-#include "util/DebugCount.hpp"
+#include "util/Metrics.hpp"
 #include "util/PostToThread.hpp"
 #include "util/QMagicEnum.hpp"
 
 #include <magic_enum/magic_enum.hpp>
 #include <QCryptographicHash>
 #include <QElapsedTimer>
-#include <QFile>
 #include <QNetworkReply>
 #include <QtConcurrent>
 
@@ -30,6 +29,9 @@ namespace {
 
 using namespace chatterino;
 
+const metrics::Counter HTTP_REQUEST_STARTED("http request started");
+const metrics::Counter NETWORK_DATA("NetworkData");
+
 void runCallback(bool concurrent, auto &&fn)
 {
     if (concurrent)
@@ -42,9 +44,9 @@ void runCallback(bool concurrent, auto &&fn)
     }
 }
 
-void loadUncached(std::shared_ptr<NetworkData> &&data)
+void startTask(std::shared_ptr<NetworkData> &&data)
 {
-    DebugCount::increase("http request started");
+    HTTP_REQUEST_STARTED.increase();
 
     NetworkRequester requester;
     auto *worker = new NetworkTask(std::move(data));
@@ -57,40 +59,18 @@ void loadUncached(std::shared_ptr<NetworkData> &&data)
     requester.requestUrl();
 }
 
-void loadCached(std::shared_ptr<NetworkData> &&data)
-{
-    QFile cachedFile(getApp()->getPaths().cacheDirectory() + "/" +
-                     data->getHash());
-
-    if (!cachedFile.exists() || !cachedFile.open(QIODevice::ReadOnly))
-    {
-        loadUncached(std::move(data));
-        return;
-    }
-
-    // XXX: check if bytes is empty?
-    QByteArray bytes = cachedFile.readAll();
-
-    qCDebug(chatterinoHTTP).noquote() << data->typeString() << "[CACHED] 200"
-                                      << data->request.url().toString();
-
-    data->emitSuccess(
-        {NetworkResult::NetworkError::NoError, QVariant(200), bytes});
-    data->emitFinally();
-}
-
 }  // namespace
 
 namespace chatterino {
 
 NetworkData::NetworkData()
 {
-    DebugCount::increase("NetworkData");
+    NETWORK_DATA.increase();
 }
 
 NetworkData::~NetworkData()
 {
-    DebugCount::decrease("NetworkData");
+    NETWORK_DATA.decrease();
 }
 
 QString NetworkData::getHash()
@@ -139,6 +119,7 @@ void NetworkData::emitSuccess(NetworkResult &&result)
                         return;
                     }
 
+                    TRACE_ZONE("network success callback");
                     QElapsedTimer timer;
                     timer.start();
                     cb(result);
@@ -176,6 +157,7 @@ void NetworkData::emitError(NetworkResult &&result)
                         return;
                     }
 
+                    TRACE_ZONE("network error callback");
                     cb(result);
                 });
 }
@@ -203,6 +185,7 @@ void NetworkData::emitFinally()
                         return;
                     }
 
+                    TRACE_ZONE("network finally callback");
                     cb();
                 });
 }
@@ -214,16 +197,8 @@ QString NetworkData::typeString() const
 
 void load(std::shared_ptr<NetworkData> &&data)
 {
-    if (data->cache)
-    {
-        std::ignore = QtConcurrent::run([data = std::move(data)]() mutable {
-            loadCached(std::move(data));
-        });
-    }
-    else
-    {
-        loadUncached(std::move(data));
-    }
+    // Cached responses are read on the worker thread (see NetworkTask::run)
+    startTask(std::move(data));
 }
 
 }  // namespace chatterino
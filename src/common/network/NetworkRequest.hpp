@@ -48,6 +48,8 @@ public:
     NetworkRequest finally(NetworkFinallyCallback cb) &&;
 
     NetworkRequest payload(const QByteArray &payload) &&;
+    /// Answers the request from the disk cache if possible. Stale responses
+    /// are answered from the cache too, but they're revalidated afterwards.
     NetworkRequest cache() &&;
     /// NetworkRequest makes sure that the `caller` object still exists when the
     /// callbacks are executed. Cannot be used with concurrent() since we can't
@@ -1,20 +1,25 @@
 #include "common/network/NetworkTask.hpp"
 
-#include "Application.hpp"
+#include "common/network/NetworkCache.hpp"
 #include "common/network/NetworkManager.hpp"
 #include "common/network/NetworkPrivate.hpp"
 #include "common/network/NetworkResult.hpp"
 #include "common/QLogging.hpp"
-#include "singletons/Paths.hpp"
+#include "debug/Trace.hpp"
 #include "util/AbandonObject.hpp"
-#include "util/DebugCount.hpp"
+#include "util/Metrics.hpp"
 
-#include <QFile>
+#include <QDateTime>
 #include <QNetworkReply>
-#include <QtConcurrent>
 
 namespace chatterino::network::detail {
 
+namespace {
+
+const metrics::Counter HTTP_REQUEST_SUCCESS("http request success");
+
+}  // namespace
+
 NetworkTask::NetworkTask(std::shared_ptr<NetworkData> &&data)
     : data_(std::move(data))
 {
@@ -30,6 +35,12 @@ NetworkTask::~NetworkTask()
 
 void NetworkTask::run()
 {
+    if (this->data_->cache && this->loadFromCache())
+    {
+        this->deleteLater();
+        return;
+    }
+
     this->reply_ = this->createReply();
     if (!this->reply_)
     {
@@ -118,6 +129,50 @@ QNetworkReply *NetworkTask::createReply()
     return nullptr;
 }
 
+bool NetworkTask::loadFromCache()
+{
+    // The hash must be computed before adding any validators
+    auto *cache = NetworkCache::instance();
+    if (cache == nullptr)
+    {
+        return false;
+    }
+
+    auto hash = this->data_->getHash();
+    auto cached = cache->read(hash, QDateTime::currentMSecsSinceEpoch());
+    if (!cached)
+    {
+        return false;
+    }
+
+    qCDebug(chatterinoHTTP).noquote()
+        << this->data_->typeString()
+        << (cached->fresh ? "[CACHED] 200" : "[STALE] 200")
+        << this->data_->request.url().toString();
+
+    this->data_->emitSuccess({NetworkResult::NetworkError::NoError,
+                              QVariant(200), std::move(cached->body)});
+    this->data_->emitFinally();
+
+    if (cached->fresh)
+    {
+        return true;
+    }
+
+    this->revalidating_ = true;
+    auto &request = this->data_->request;
+    if (!cached->metadata.etag.isEmpty())
+    {
+        request.setRawHeader("If-None-Match", cached->metadata.etag);
+    }
+    if (!cached->metadata.lastModified.isEmpty())
+    {
+        request.setRawHeader("If-Modified-Since",
+                             cached->metadata.lastModified);
+    }
+    return false;
+}
+
 void NetworkTask::logReply()
 {
     auto status =
@@ -140,15 +195,15 @@ void NetworkTask::logReply()
 
 void NetworkTask::writeToCache(const QByteArray &bytes) const
 {
-    std::ignore = QtConcurrent::run([data = this->data_, bytes] {
-        QFile cachedFile(getApp()->getPaths().cacheDirectory() + "/" +
-                         data->getHash());
+    auto *cache = NetworkCache::instance();
+    if (cache == nullptr)
+    {
+        return;
+    }
 
-        if (cachedFile.open(QIODevice::WriteOnly))
-        {
-            cachedFile.write(bytes);
-        }
-    });
+    auto now = QDateTime::currentMSecsSinceEpoch();
+    cache->write(this->data_->getHash(), bytes,
+                 NetworkCache::metadataOf(*this->reply_, now), now);
 }
 
 void NetworkTask::timeout()
@@ -164,12 +219,19 @@ void NetworkTask::timeout()
         << this->data_->typeString() << "[timed out]"
         << this->data_->request.url().toString();
 
+    if (this->revalidating_)
+    {
+        return;
+    }
+
     this->data_->emitError({NetworkResult::NetworkError::TimeoutError, {}, {}});
     this->data_->emitFinally();
 }
 
 void NetworkTask::finished()
 {
+    TRACE_ZONE("network reply");
+
     AbandonObject guard(this);
 
     if (this->timer_)
@@ -192,12 +254,30 @@ void NetworkTask::finished()
     if (reply->error() != QNetworkReply::NoError)
     {
         this->logReply();
+        if (this->revalidating_)
+        {
+            // Keep serving the stale response
+            return;
+        }
+
         this->data_->emitError({reply->error(), status, reply->readAll()});
         this->data_->emitFinally();
 
         return;
     }
 
+    if (this->revalidating_ && status.toInt() == 304)
+    {
+        this->logReply();
+        if (auto *cache = NetworkCache::instance())
+        {
+            auto now = QDateTime::currentMSecsSinceEpoch();
+            cache->refresh(this->data_->getHash(),
+                           NetworkCache::metadataOf(*reply, now), now);
+        }
+        return;
+    }
+
     QByteArray bytes = reply->readAll();
 
     if (this->data_->cache)
@@ -205,8 +285,14 @@ void NetworkTask::finished()
         this->writeToCache(bytes);
     }
 
-    DebugCount::increase("http request success");
+    HTTP_REQUEST_SUCCESS.increase();
     this->logReply();
+    if (this->revalidating_)
+    {
+        // The new response is used the next time it's requested
+        return;
+    }
+
     this->data_->emitSuccess({reply->error(), status, bytes});
     this->data_->emitFinally();
 }
@@ -35,6 +35,13 @@ public Q_SLOTS:
 private:
     QNetworkReply *createReply();
 
+    /// @brief Answers the request from the cache if possible
+    ///
+    /// Returns true if the cached response was fresh and no request has to
+    /// be made. Stale responses are emitted as well, but they're revalidated
+    /// afterwards.
+    bool loadFromCache();
+
     void logReply();
     void writeToCache(const QByteArray &bytes) const;
 
@@ -42,6 +49,10 @@ private:
     QNetworkReply *reply_{};  // parent: default (accessManager)
     QTimer *timer_{};         // parent: this
 
+    /// The callbacks were already called with a stale cached response, the
+    /// reply only updates the cache.
+    bool revalidating_ = false;
+
     // NOLINTNEXTLINE(readability-redundant-access-specifiers)
 private Q_SLOTS:
     void timeout();
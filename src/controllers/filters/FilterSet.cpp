@@ -1,6 +1,8 @@
 #include "controllers/filters/FilterSet.hpp"
 
 #include "controllers/filters/FilterRecord.hpp"
+#include "controllers/filters/lang/MessageContext.hpp"
+#include "messages/Message.hpp"
 #include "singletons/Settings.hpp"
 
 namespace chatterino {
@@ -42,8 +44,9 @@ bool FilterSet::filter(const MessagePtr &m, ChannelPtr channel) const
         return true;
     }
 
-    filters::ContextMap context = filters::buildContextMap(m, channel.get());
-    for (const auto &f : this->filters_.values())
+    // Values are computed on demand and shared between all filters of the set
+    filters::MessageContext context(*m, channel.get());
+    for (const auto &f : this->filters_)
     {
         if (!f->valid() || !f->filter(context))
         {
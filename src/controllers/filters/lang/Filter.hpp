@@ -1,6 +1,7 @@
 #pragma once
 
 #include "controllers/filters/lang/expressions/Expression.hpp"
+#include "controllers/filters/lang/MessageContext.hpp"
 #include "controllers/filters/lang/Types.hpp"
 
 #include <QString>
@@ -24,6 +25,9 @@ namespace chatterino::filters {
 // i.e. if all the variables and operators being used have compatible types.
 extern const QMap<QString, Type> MESSAGE_TYPING_CONTEXT;
 
+/// Builds a map of every identifier's value for the given message.
+/// Filtering messages should go through a MessageContext instead, which only
+/// computes the values a filter references.
 ContextMap buildContextMap(const MessagePtr &m, chatterino::Channel *channel);
 
 class Filter;
@@ -40,6 +44,7 @@ public:
 
     Type returnType() const;
     QVariant execute(const ContextMap &context) const;
+    QVariant execute(const MessageContext &context) const;
 
     QString filterString() const;
     QString debugString(const TypingContext &context) const;
@@ -48,6 +53,7 @@ private:
     Filter(ExpressionPtr expression, Type returnType);
 
     ExpressionPtr expression_;
+    CompiledExpression compiled_;
     Type returnType_;
 };
 
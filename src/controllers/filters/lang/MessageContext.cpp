@@ -0,0 +1,241 @@
+#include "controllers/filters/lang/MessageContext.hpp"
+
+#include "Application.hpp"
+#include "common/Channel.hpp"
+#include "messages/Message.hpp"
+#include "providers/twitch/TwitchChannel.hpp"
+#include "providers/twitch/TwitchIrcServer.hpp"
+
+#include <QHash>
+#include <QStringList>
+
+#include <algorithm>
+#include <cassert>
+
+namespace {
+
+using namespace chatterino::filters;
+
+// Indexed by ContextSlot
+constexpr std::array<const char *, CONTEXT_SLOT_COUNT> SLOT_IDENTIFIERS{
+    "author.badges",
+    "author.color",
+    "author.name",
+    "author.user_id",
+    "author.no_color",
+    "author.subbed",
+    "author.sub_length",
+
+    "channel.name",
+    "channel.watching",
+    "channel.live",
+
+    "flags.action",
+    "flags.highlighted",
+    "flags.points_redeemed",
+    "flags.sub_message",
+    "flags.system_message",
+    "flags.reward_message",
+    "flags.first_message",
+    "flags.elevated_message",
+    "flags.hype_chat",
+    "flags.cheer_message",
+    "flags.whisper",
+    "flags.reply",
+    "flags.automod",
+    "flags.restricted",
+    "flags.monitored",
+    "flags.shared",
+    "flags.similar",
+
+    "message.content",
+    "message.length",
+
+    "reward.title",
+    "reward.cost",
+    "reward.id",
+};
+
+std::size_t slotIndex(ContextSlot slot)
+{
+    return static_cast<std::size_t>(slot);
+}
+
+}  // namespace
+
+namespace chatterino::filters {
+
+std::optional<ContextSlot> slotFromIdentifier(const QString &identifier)
+{
+    static const QHash<QString, ContextSlot> slots = [] {
+        QHash<QString, ContextSlot> map;
+        for (std::size_t i = 0; i < SLOT_IDENTIFIERS.size(); ++i)
+        {
+            map.insert(QString::fromLatin1(SLOT_IDENTIFIERS[i]),
+                       static_cast<ContextSlot>(i));
+        }
+        return map;
+    }();
+
+    auto it = slots.find(identifier);
+    if (it == slots.end())
+    {
+        return std::nullopt;
+    }
+    return it.value();
+}
+
+QString slotIdentifier(ContextSlot slot)
+{
+    assert(slot != ContextSlot::Count);
+    return QString::fromLatin1(SLOT_IDENTIFIERS[slotIndex(slot)]);
+}
+
+MessageContext::MessageContext(const Message &message, Channel *channel)
+    : message_(message)
+    , channel_(channel)
+{
+}
+
+const QVariant &MessageContext::value(ContextSlot slot) const
+{
+    assert(slot != ContextSlot::Count);
+
+    auto idx = slotIndex(slot);
+    if (!this->computed_.test(idx))
+    {
+        this->values_[idx] = this->compute(slot);
+        this->computed_.set(idx);
+    }
+    return this->values_[idx];
+}
+
+void MessageContext::computeSubscription() const
+{
+    bool subscribed = false;
+    int subLength = 0;
+    for (const auto *subBadge : {"subscriber", "founder"})
+    {
+        auto hasBadge = std::any_of(this->message_.badges.begin(),
+                                    this->message_.badges.end(),
+                                    [&](const auto &badge) {
+                                        return badge.key_ ==
+                                               QLatin1String(subBadge);
+                                    });
+        if (!hasBadge)
+        {
+            continue;
+        }
+        subscribed = true;
+        auto it = this->message_.badgeInfos.find(subBadge);
+        if (it != this->message_.badgeInfos.end())
+        {
+            subLength = it->second.toInt();
+        }
+    }
+
+    this->values_[slotIndex(ContextSlot::AuthorSubbed)] = subscribed;
+    this->values_[slotIndex(ContextSlot::AuthorSubLength)] = subLength;
+    this->computed_.set(slotIndex(ContextSlot::AuthorSubbed));
+    this->computed_.set(slotIndex(ContextSlot::AuthorSubLength));
+}
+
+QVariant MessageContext::compute(ContextSlot slot) const
+{
+    using MessageFlag = chatterino::MessageFlag;
+
+    const auto &m = this->message_;
+
+    switch (slot)
+    {
+        case ContextSlot::AuthorBadges: {
+            QStringList badges;
+            badges.reserve(static_cast<qsizetype>(m.badges.size()));
+            for (const auto &e : m.badges)
+            {
+                badges << e.key_;
+            }
+            return badges;
+        }
+        case ContextSlot::AuthorColor:
+            return m.usernameColor;
+        case ContextSlot::AuthorName:
+            return m.displayName;
+        case ContextSlot::AuthorUserID:
+            return m.userID;
+        case ContextSlot::AuthorNoColor:
+            return !m.usernameColor.isValid();
+        case ContextSlot::AuthorSubbed:
+        case ContextSlot::AuthorSubLength:
+            this->computeSubscription();
+            return this->values_[slotIndex(slot)];
+
+        case ContextSlot::ChannelName:
+            return m.channelName;
+        case ContextSlot::ChannelWatching: {
+            auto watchingChannel =
+                getApp()->getTwitch()->getWatchingChannel().get();
+            return !watchingChannel->getName().isEmpty() &&
+                   watchingChannel->getName().compare(
+                       m.channelName, Qt::CaseInsensitive) == 0;
+        }
+        case ContextSlot::ChannelLive: {
+            auto *tc = dynamic_cast<TwitchChannel *>(this->channel_);
+            return this->channel_ != nullptr && !this->channel_->isEmpty() &&
+                   tc != nullptr && tc->isLive();
+        }
+
+        case ContextSlot::FlagsAction:
+            return m.flags.has(MessageFlag::Action);
+        case ContextSlot::FlagsHighlighted:
+            return m.flags.has(MessageFlag::Highlighted);
+        case ContextSlot::FlagsPointsRedeemed:
+            return m.flags.has(MessageFlag::RedeemedHighlight);
+        case ContextSlot::FlagsSubMessage:
+            return m.flags.has(MessageFlag::Subscription);
+        case ContextSlot::FlagsSystemMessage:
+            return m.flags.has(MessageFlag::System);
+        case ContextSlot::FlagsRewardMessage:
+            return m.flags.has(MessageFlag::RedeemedChannelPointReward);
+        case ContextSlot::FlagsFirstMessage:
+            return m.flags.has(MessageFlag::FirstMessage);
+        case ContextSlot::FlagsElevatedMessage:
+        case ContextSlot::FlagsHypeChat:
+            return m.flags.has(MessageFlag::ElevatedMessage);
+        case ContextSlot::FlagsCheerMessage:
+            return m.flags.has(MessageFlag::CheerMessage);
+        case ContextSlot::FlagsWhisper:
+            return m.flags.has(MessageFlag::Whisper);
+        case ContextSlot::FlagsReply:
+            return m.flags.has(MessageFlag::ReplyMessage);
+        case ContextSlot::FlagsAutomod:
+            return m.flags.has(MessageFlag::AutoMod);
+        case ContextSlot::FlagsRestricted:
+            return m.flags.has(MessageFlag::RestrictedMessage);
+        case ContextSlot::FlagsMonitored:
+            return m.flags.has(MessageFlag::MonitoredMessage);
+        case ContextSlot::FlagsShared:
+            return m.flags.has(MessageFlag::SharedMessage);
+        case ContextSlot::FlagsSimilar:
+            return m.flags.has(MessageFlag::Similar);
+
+        case ContextSlot::MessageContent:
+            return m.messageText;
+        case ContextSlot::MessageLength:
+            return m.messageText.length();
+
+        case ContextSlot::RewardTitle:
+            return m.reward ? m.reward->title : QString("");
+        case ContextSlot::RewardCost:
+            return m.reward ? m.reward->cost : -1;
+        case ContextSlot::RewardID:
+            return m.reward ? m.reward->id : QString("");
+
+        case ContextSlot::Count:
+            break;
+    }
+
+    return {};
+}
+
+}  // namespace chatterino::filters
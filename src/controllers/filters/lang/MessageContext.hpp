@@ -0,0 +1,100 @@
+#pragma once
+
+#include <QString>
+#include <QVariant>
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace chatterino {
+
+class Channel;
+struct Message;
+
+}  // namespace chatterino
+
+namespace chatterino::filters {
+
+/// Every identifier a filter can reference, resolved once at parse time.
+/// Keep this in sync with MESSAGE_TYPING_CONTEXT and VALID_IDENTIFIERS_MAP.
+enum class ContextSlot : std::uint8_t {
+    AuthorBadges,
+    AuthorColor,
+    AuthorName,
+    AuthorUserID,
+    AuthorNoColor,
+    AuthorSubbed,
+    AuthorSubLength,
+
+    ChannelName,
+    ChannelWatching,
+    ChannelLive,
+
+    FlagsAction,
+    FlagsHighlighted,
+    FlagsPointsRedeemed,
+    FlagsSubMessage,
+    FlagsSystemMessage,
+    FlagsRewardMessage,
+    FlagsFirstMessage,
+    FlagsElevatedMessage,
+    FlagsHypeChat,
+    FlagsCheerMessage,
+    FlagsWhisper,
+    FlagsReply,
+    FlagsAutomod,
+    FlagsRestricted,
+    FlagsMonitored,
+    FlagsShared,
+    FlagsSimilar,
+
+    MessageContent,
+    MessageLength,
+
+    RewardTitle,
+    RewardCost,
+    RewardID,
+
+    Count,
+};
+
+constexpr std::size_t CONTEXT_SLOT_COUNT =
+    static_cast<std::size_t>(ContextSlot::Count);
+
+/// Returns the slot for an identifier like "author.name", or std::nullopt if
+/// the identifier is unknown.
+std::optional<ContextSlot> slotFromIdentifier(const QString &identifier);
+
+/// Returns the identifier of a slot, e.g. "author.name" for ContextSlot::AuthorName
+QString slotIdentifier(ContextSlot slot);
+
+/// MessageContext is the evaluation context of compiled filters.
+///
+/// Values are only computed when a filter asks for them and are cached for the
+/// lifetime of the context, so a single context can be shared by every filter
+/// of a FilterSet. Nothing is allocated up front.
+class MessageContext
+{
+public:
+    MessageContext(const Message &message, Channel *channel);
+
+    MessageContext(const MessageContext &) = delete;
+    MessageContext &operator=(const MessageContext &) = delete;
+
+    const QVariant &value(ContextSlot slot) const;
+
+private:
+    QVariant compute(ContextSlot slot) const;
+    void computeSubscription() const;
+
+    const Message &message_;
+    Channel *channel_;
+
+    mutable std::array<QVariant, CONTEXT_SLOT_COUNT> values_;
+    mutable std::bitset<CONTEXT_SLOT_COUNT> computed_;
+};
+
+}  // namespace chatterino::filters
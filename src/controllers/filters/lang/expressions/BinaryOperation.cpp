@@ -4,6 +4,8 @@
 
 namespace {
 
+using namespace chatterino::filters;
+
 /// Loosely compares `lhs` with `rhs`.
 /// This attempts to convert both variants to a common type if they're not equal.
 bool looselyCompareVariants(QVariant &lhs, QVariant &rhs)
@@ -37,23 +39,10 @@ bool looselyCompareVariants(QVariant &lhs, QVariant &rhs)
     return lhs == rhs;
 }
 
-}  // namespace
-
-namespace chatterino::filters {
-
-BinaryOperation::BinaryOperation(TokenType op, ExpressionPtr left,
-                                 ExpressionPtr right)
-    : op_(op)
-    , left_(std::move(left))
-    , right_(std::move(right))
-{
-}
-
-QVariant BinaryOperation::execute(const ContextMap &context) const
+/// Applies the binary operator `op` to the already evaluated operands.
+QVariant evaluate(TokenType op, QVariant left, QVariant right)
 {
-    auto left = this->left_->execute(context);
-    auto right = this->right_->execute(context);
-    switch (this->op_)
+    switch (op)
     {
         case PLUS:
             if (variantIs(left, QMetaType::QString) &&
@@ -269,6 +258,97 @@ QVariant BinaryOperation::execute(const ContextMap &context) const
     }
 }
 
+}  // namespace
+
+namespace chatterino::filters {
+
+BinaryOperation::BinaryOperation(TokenType op, ExpressionPtr left,
+                                 ExpressionPtr right)
+    : op_(op)
+    , left_(std::move(left))
+    , right_(std::move(right))
+{
+}
+
+QVariant BinaryOperation::execute(const ContextMap &context) const
+{
+    return evaluate(this->op_, this->left_->execute(context),
+                    this->right_->execute(context));
+}
+
+bool BinaryOperation::isConstant() const
+{
+    return this->left_->isConstant() && this->right_->isConstant();
+}
+
+CompiledExpression BinaryOperation::compile(const TypingContext &context) const
+{
+    if (this->isConstant())
+    {
+        return Expression::compile(context);
+    }
+
+    auto isBool = [&](const ExpressionPtr &exp) {
+        auto typ = exp->synthesizeType(context);
+        return !isIllTyped(typ) && std::get<TypeClass>(typ) == Type::Bool;
+    };
+
+    auto left = this->left_->compile(context);
+
+    switch (this->op_)
+    {
+        case AND:
+        case OR:
+            // Both sides are Bools in a well-typed filter, so we can skip
+            // computing the right side's context values when it can't change
+            // the result
+            if (isBool(this->left_) && isBool(this->right_))
+            {
+                auto right = this->right_->compile(context);
+                if (this->op_ == AND)
+                {
+                    return [left = std::move(left),
+                            right = std::move(right)](const MessageContext &ctx) {
+                        return QVariant(left(ctx).toBool() &&
+                                        right(ctx).toBool());
+                    };
+                }
+                return [left = std::move(left),
+                        right = std::move(right)](const MessageContext &ctx) {
+                    return QVariant(left(ctx).toBool() || right(ctx).toBool());
+                };
+            }
+            break;
+        case MATCH:
+            if (this->right_->isConstant())
+            {
+                auto right = this->right_->execute({});
+                if (variantIs(right, QMetaType::QRegularExpression))
+                {
+                    return [left = std::move(left),
+                            regex = right.toRegularExpression()](
+                               const MessageContext &ctx) {
+                        auto value = left(ctx);
+                        if (!value.canConvert<QString>())
+                        {
+                            return QVariant(false);
+                        }
+                        return QVariant(
+                            regex.match(value.toString()).hasMatch());
+                    };
+                }
+            }
+            break;
+        default:
+            break;
+    }
+
+    return [op = this->op_, left = std::move(left),
+            right = this->right_->compile(context)](const MessageContext &ctx) {
+        return evaluate(op, left(ctx), right(ctx));
+    };
+}
+
 PossibleType BinaryOperation::synthesizeType(const TypingContext &context) const
 {
     auto leftSyn = this->left_->synthesizeType(context);
@@ -1,5 +1,16 @@
 #include "controllers/filters/lang/expressions/Expression.hpp"
 
+#include <cassert>
+
 namespace chatterino::filters {
 
+CompiledExpression Expression::compile(const TypingContext & /*context*/) const
+{
+    assert(this->isConstant());
+
+    return [value = this->execute({})](const MessageContext & /*context*/) {
+        return value;
+    };
+}
+
 }  // namespace chatterino::filters
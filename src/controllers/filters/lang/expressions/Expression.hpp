@@ -6,11 +6,19 @@
 #include <QString>
 #include <QVariant>
 
+#include <functional>
 #include <memory>
 #include <vector>
 
 namespace chatterino::filters {
 
+class MessageContext;
+
+/// A compiled expression. Identifiers are resolved to ContextSlots and
+/// constant subexpressions are folded, so evaluating it doesn't look anything
+/// up by name.
+using CompiledExpression = std::function<QVariant(const MessageContext &)>;
+
 class Expression
 {
 public:
@@ -20,6 +28,14 @@ public:
     virtual PossibleType synthesizeType(const TypingContext &context) const = 0;
     virtual QString debug(const TypingContext &context) const = 0;
     virtual QString filterString() const = 0;
+
+    /// Returns true if this expression doesn't depend on the message context
+    virtual bool isConstant() const = 0;
+
+    /// Compiles this expression. The default implementation evaluates the
+    /// expression once and returns a closure yielding the folded value, so it
+    /// must only be used by constant expressions.
+    virtual CompiledExpression compile(const TypingContext &context) const;
 };
 
 using ExpressionPtr = std::unique_ptr<Expression>;
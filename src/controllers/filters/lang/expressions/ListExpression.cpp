@@ -1,25 +1,18 @@
 #include "controllers/filters/lang/expressions/ListExpression.hpp"
 
-namespace chatterino::filters {
+#include <algorithm>
 
-ListExpression::ListExpression(ExpressionList &&list)
-    : list_(std::move(list)) {};
+namespace {
 
-QVariant ListExpression::execute(const ContextMap &context) const
-{
-    QList<QVariant> results;
-    bool allStrings = true;
-    for (const auto &exp : this->list_)
-    {
-        auto res = exp->execute(context);
-        if (allStrings && variantIsNot(res, QMetaType::QString))
-        {
-            allStrings = false;
-        }
-        results.append(res);
-    }
+using namespace chatterino::filters;
 
+QVariant makeList(QList<QVariant> &&results)
+{
     // if everything is a string return a QStringList for case-insensitive comparison
+    bool allStrings = std::all_of(results.begin(), results.end(),
+                                  [](const auto &res) {
+                                      return variantIs(res, QMetaType::QString);
+                                  });
     if (allStrings)
     {
         QStringList strings;
@@ -34,6 +27,59 @@ QVariant ListExpression::execute(const ContextMap &context) const
     return results;
 }
 
+}  // namespace
+
+namespace chatterino::filters {
+
+ListExpression::ListExpression(ExpressionList &&list)
+    : list_(std::move(list)) {};
+
+QVariant ListExpression::execute(const ContextMap &context) const
+{
+    QList<QVariant> results;
+    results.reserve(static_cast<qsizetype>(this->list_.size()));
+    for (const auto &exp : this->list_)
+    {
+        results.append(exp->execute(context));
+    }
+
+    return makeList(std::move(results));
+}
+
+bool ListExpression::isConstant() const
+{
+    return std::all_of(this->list_.begin(), this->list_.end(),
+                       [](const auto &exp) {
+                           return exp->isConstant();
+                       });
+}
+
+CompiledExpression ListExpression::compile(const TypingContext &context) const
+{
+    if (this->isConstant())
+    {
+        return Expression::compile(context);
+    }
+
+    std::vector<CompiledExpression> list;
+    list.reserve(this->list_.size());
+    for (const auto &exp : this->list_)
+    {
+        list.emplace_back(exp->compile(context));
+    }
+
+    return [list = std::move(list)](const MessageContext &ctx) {
+        QList<QVariant> results;
+        results.reserve(static_cast<qsizetype>(list.size()));
+        for (const auto &exp : list)
+        {
+            results.append(exp(ctx));
+        }
+
+        return makeList(std::move(results));
+    };
+}
+
 PossibleType ListExpression::synthesizeType(const TypingContext &context) const
 {
     std::vector<TypeClass> types;
@@ -14,6 +14,8 @@ public:
     PossibleType synthesizeType(const TypingContext &context) const override;
     QString debug(const TypingContext &context) const override;
     QString filterString() const override;
+    bool isConstant() const override;
+    CompiledExpression compile(const TypingContext &context) const override;
 
 private:
     ExpressionList list_;
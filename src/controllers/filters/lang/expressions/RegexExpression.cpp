@@ -7,13 +7,22 @@ RegexExpression::RegexExpression(const QString &regex, bool caseInsensitive)
     , caseInsensitive_(caseInsensitive)
     , regex_(QRegularExpression(
           regex, caseInsensitive ? QRegularExpression::CaseInsensitiveOption
-                                 : QRegularExpression::NoPatternOption)) {};
+                                 : QRegularExpression::NoPatternOption))
+{
+    // Filters run against every message, so compile the pattern right away
+    this->regex_.optimize();
+}
 
 QVariant RegexExpression::execute(const ContextMap & /*context*/) const
 {
     return this->regex_;
 }
 
+bool RegexExpression::isConstant() const
+{
+    return true;
+}
+
 PossibleType RegexExpression::synthesizeType(
     const TypingContext & /*context*/) const
 {
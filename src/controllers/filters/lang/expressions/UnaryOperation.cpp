@@ -20,6 +20,33 @@ QVariant UnaryOperation::execute(const ContextMap &context) const
     }
 }
 
+bool UnaryOperation::isConstant() const
+{
+    return this->right_->isConstant();
+}
+
+CompiledExpression UnaryOperation::compile(const TypingContext &context) const
+{
+    if (this->isConstant())
+    {
+        return Expression::compile(context);
+    }
+
+    auto right = this->right_->compile(context);
+    switch (this->op_)
+    {
+        case NOT:
+            return [right = std::move(right)](const MessageContext &ctx) {
+                auto value = right(ctx);
+                return QVariant(value.canConvert<bool>() && !value.toBool());
+            };
+        default:
+            return [](const MessageContext & /*context*/) {
+                return QVariant(false);
+            };
+    }
+}
+
 PossibleType UnaryOperation::synthesizeType(const TypingContext &context) const
 {
     auto rightSyn = this->right_->synthesizeType(context);
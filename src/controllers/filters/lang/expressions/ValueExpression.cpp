@@ -8,6 +8,10 @@ ValueExpression::ValueExpression(QVariant value, TokenType type)
     : value_(std::move(value))
     , type_(type)
 {
+    if (this->type_ == TokenType::IDENTIFIER)
+    {
+        this->slot_ = slotFromIdentifier(this->value_.toString());
+    }
 }
 
 QVariant ValueExpression::execute(const ContextMap &context) const
@@ -19,6 +23,32 @@ QVariant ValueExpression::execute(const ContextMap &context) const
     return this->value_;
 }
 
+bool ValueExpression::isConstant() const
+{
+    return this->type_ != TokenType::IDENTIFIER;
+}
+
+CompiledExpression ValueExpression::compile(const TypingContext &context) const
+{
+    if (this->isConstant())
+    {
+        return Expression::compile(context);
+    }
+
+    if (!this->slot_)
+    {
+        // Unbound identifiers evaluate to an invalid QVariant, just like a
+        // missing entry in a ContextMap
+        return [](const MessageContext & /*context*/) {
+            return QVariant();
+        };
+    }
+
+    return [slot = *this->slot_](const MessageContext &context) {
+        return context.value(slot);
+    };
+}
+
 PossibleType ValueExpression::synthesizeType(const TypingContext &context) const
 {
     switch (this->type_)
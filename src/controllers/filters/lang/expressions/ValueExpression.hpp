@@ -1,8 +1,11 @@
 #pragma once
 
 #include "controllers/filters/lang/expressions/Expression.hpp"
+#include "controllers/filters/lang/MessageContext.hpp"
 #include "controllers/filters/lang/Types.hpp"
 
+#include <optional>
+
 namespace chatterino::filters {
 
 class ValueExpression : public Expression
@@ -15,10 +18,15 @@ public:
     PossibleType synthesizeType(const TypingContext &context) const override;
     QString debug(const TypingContext &context) const override;
     QString filterString() const override;
+    bool isConstant() const override;
+    CompiledExpression compile(const TypingContext &context) const override;
 
 private:
     QVariant value_;
     TokenType type_;
+
+    /// The slot of an IDENTIFIER, resolved when the expression is parsed
+    std::optional<ContextSlot> slot_;
 };
 
 }  // namespace chatterino::filters
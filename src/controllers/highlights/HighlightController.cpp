@@ -5,6 +5,7 @@
 #include "controllers/accounts/AccountController.hpp"
 #include "controllers/highlights/HighlightBadge.hpp"
 #include "controllers/highlights/HighlightPhrase.hpp"
+#include "debug/Trace.hpp"
 #include "messages/Message.hpp"
 #include "messages/MessageBuilder.hpp"
 #include "providers/colors/ColorProvider.hpp"
@@ -17,17 +18,29 @@ namespace {
 
 using namespace chatterino;
 
-auto highlightPhraseCheck(const HighlightPhrase &highlight) -> HighlightCheck
+/// Creates a check for a message phrase highlight. The phrase itself is
+/// matched by HighlightChecks::phrases, so the check only runs if it matched.
+auto highlightPhraseCheck(const HighlightPhrase &highlight,
+                          std::vector<PhraseMatcher::Phrase> &phrases)
+    -> HighlightCheck
 {
+    phrases.push_back({
+        .pattern = highlight.getPattern(),
+        .isRegex = highlight.isRegex(),
+        .isCaseSensitive = highlight.isCaseSensitive(),
+        .wholeWord = !highlight.isRegex(),
+    });
+
     return HighlightCheck{
-        [highlight](const auto &args, const auto &badges,
-                    const auto &senderName, const auto &originalMessage,
-                    const auto &flags,
-                    const auto self) -> std::optional<HighlightResult> {
-            (void)args;        // unused
-            (void)badges;      // unused
-            (void)senderName;  // unused
-            (void)flags;       // unused
+        .cb = [highlight](const auto &args, const auto &badges,
+                          const auto &senderName,
+                          const auto &originalMessage, const auto &flags,
+                          const auto self) -> std::optional<HighlightResult> {
+            (void)args;             // unused
+            (void)badges;           // unused
+            (void)senderName;       // unused
+            (void)originalMessage;  // unused
+            (void)flags;            // unused
 
             if (self)
             {
@@ -35,11 +48,6 @@ auto highlightPhraseCheck(const HighlightPhrase &highlight) -> HighlightCheck
                 return std::nullopt;
             }
 
-            if (!highlight.isMatch(originalMessage))
-            {
-                return std::nullopt;
-            }
-
             std::optional<QUrl> highlightSoundUrl;
             if (highlight.hasCustomSound())
             {
@@ -51,7 +59,9 @@ auto highlightPhraseCheck(const HighlightPhrase &highlight) -> HighlightCheck
                 highlightSoundUrl,          highlight.getColor(),
                 highlight.showInMentions(),
             };
-        }};
+        },
+        .phraseIndex = phrases.size() - 1,
+    };
 }
 
 void rebuildSubscriptionHighlights(Settings &settings,
@@ -180,9 +190,11 @@ void rebuildReplyThreadHighlight(Settings &settings,
     }
 }
 
-void rebuildMessageHighlights(Settings &settings,
-                              std::vector<HighlightCheck> &checks)
+void rebuildMessageHighlights(Settings &settings, HighlightChecks &highlights)
 {
+    auto &checks = highlights.checks;
+    std::vector<PhraseMatcher::Phrase> phrases;
+
     auto currentUser = getApp()->getAccounts()->twitch.getCurrent();
     QString currentUsername = currentUser->getUserName();
 
@@ -196,15 +208,17 @@ void rebuildMessageHighlights(Settings &settings,
             settings.selfHighlightSoundUrl.getValue(),
             ColorProvider::instance().color(ColorType::SelfHighlight));
 
-        checks.emplace_back(highlightPhraseCheck(highlight));
+        checks.emplace_back(highlightPhraseCheck(highlight, phrases));
     }
 
     auto messageHighlights = settings.highlightedMessages.readOnly();
     for (const auto &highlight : *messageHighlights)
     {
-        checks.emplace_back(highlightPhraseCheck(highlight));
+        checks.emplace_back(highlightPhraseCheck(highlight, phrases));
     }
 
+    highlights.phrases = PhraseMatcher(phrases);
+
     if (settings.enableAutomodHighlight)
     {
         const auto highlightSound =
@@ -522,23 +536,26 @@ HighlightController::HighlightController(Settings &settings,
 void HighlightController::rebuildChecks(Settings &settings)
 {
     // Access checks for modification
-    auto checks = this->checks_.access();
-    checks->clear();
+    auto highlights = this->checks_.access();
+    auto &checks = highlights->checks;
+    checks.clear();
+    highlights->currentUsername =
+        getApp()->getAccounts()->twitch.getCurrent()->getUserName();
 
     // CURRENT ORDER:
     // Subscription -> Whisper -> Message -> User -> Reply Threads -> Badge
 
-    rebuildSubscriptionHighlights(settings, *checks);
+    rebuildSubscriptionHighlights(settings, checks);
 
-    rebuildWhisperHighlights(settings, *checks);
+    rebuildWhisperHighlights(settings, checks);
 
-    rebuildMessageHighlights(settings, *checks);
+    rebuildMessageHighlights(settings, *highlights);
 
-    rebuildUserHighlights(settings, *checks);
+    rebuildUserHighlights(settings, checks);
 
-    rebuildReplyThreadHighlight(settings, *checks);
+    rebuildReplyThreadHighlight(settings, checks);
 
-    rebuildBadgeHighlights(settings, *checks);
+    rebuildBadgeHighlights(settings, checks);
 }
 
 std::pair<bool, HighlightResult> HighlightController::check(
@@ -546,17 +563,33 @@ std::pair<bool, HighlightResult> HighlightController::check(
     const QString &senderName, const QString &originalMessage,
     const MessageFlags &messageFlags) const
 {
+    TRACE_ZONE("highlight check");
+
     bool highlighted = false;
     auto result = HighlightResult::emptyResult();
 
     // Access for checking
-    const auto checks = this->checks_.accessConst();
+    const auto highlights = this->checks_.accessConst();
 
-    auto currentUser = getApp()->getAccounts()->twitch.getCurrent();
-    auto self = (senderName == currentUser->getUserName());
+    auto self = (senderName == highlights->currentUsername);
+
+    // Computed on the first phrase check, for all phrases at once
+    std::optional<std::vector<bool>> matchedPhrases;
 
-    for (const auto &check : *checks)
+    for (const auto &check : highlights->checks)
     {
+        if (check.phraseIndex)
+        {
+            if (!matchedPhrases)
+            {
+                matchedPhrases = highlights->phrases.match(originalMessage);
+            }
+            if (!(*matchedPhrases)[*check.phraseIndex])
+            {
+                continue;
+            }
+        }
+
         if (auto checkResult = check.cb(args, badges, senderName,
                                         originalMessage, messageFlags, self);
             checkResult)
@@ -3,6 +3,7 @@
 #include "common/UniqueAccess.hpp"
 #include "messages/MessageFlag.hpp"
 #include "singletons/Settings.hpp"
+#include "util/PhraseMatcher.hpp"
 
 #include <boost/signals2/connection.hpp>
 #include <pajlada/settings.hpp>
@@ -81,6 +82,22 @@ struct HighlightCheck {
         const QString &senderName, const QString &originalMessage,
         const MessageFlags &messageFlags, bool self)>;
     Checker cb;
+
+    /// If set, this check belongs to the message phrase at this index of
+    /// HighlightChecks::phrases, and cb is only called if the phrase matched
+    std::optional<size_t> phraseIndex{};
+};
+
+struct HighlightChecks {
+    std::vector<HighlightCheck> checks;
+
+    /// Matches all message phrase highlights in a single pass over the message
+    PhraseMatcher phrases;
+
+    /// Name of the account that was current when the checks were built.
+    /// check() may run off the GUI thread, where the account controller must
+    /// not be accessed.
+    QString currentUsername;
 };
 
 class HighlightController final
@@ -104,7 +121,7 @@ private:
      **/
     void rebuildChecks(Settings &settings);
 
-    UniqueAccess<std::vector<HighlightCheck>> checks_;
+    UniqueAccess<HighlightChecks> checks_;
 
     pajlada::SettingListener rebuildListener_;
     pajlada::Signals::SignalHolder signalHolder_;
@@ -8,11 +8,51 @@
 #include "providers/twitch/TwitchAccount.hpp"
 #include "providers/twitch/TwitchIrc.hpp"
 #include "singletons/Settings.hpp"
+#include "util/PhraseMatcher.hpp"
+
+#include <mutex>
 
 namespace {
 
+using namespace chatterino;
 using namespace chatterino::literals;
 
+/// Returns a matcher for all blocking phrases in `phrases`.
+///
+/// The matcher is cached for the current snapshot of the ignored messages, so
+/// it's only rebuilt after the phrases change.
+std::shared_ptr<const PhraseMatcher> blockPhraseMatcher(
+    const std::shared_ptr<const std::vector<IgnorePhrase>> &phrases)
+{
+    static std::mutex mutex;
+    static std::weak_ptr<const std::vector<IgnorePhrase>> cachedPhrases;
+    static std::shared_ptr<const PhraseMatcher> cachedMatcher;
+
+    std::lock_guard lock(mutex);
+    if (cachedMatcher && cachedPhrases.lock() == phrases)
+    {
+        return cachedMatcher;
+    }
+
+    std::vector<PhraseMatcher::Phrase> blockPhrases;
+    for (const auto &phrase : *phrases)
+    {
+        if (!phrase.isBlock())
+        {
+            continue;
+        }
+        blockPhrases.push_back({
+            .pattern = phrase.getPattern(),
+            .isRegex = phrase.isRegex(),
+            .isCaseSensitive = phrase.isCaseSensitive(),
+        });
+    }
+
+    cachedPhrases = phrases;
+    cachedMatcher = std::make_shared<const PhraseMatcher>(blockPhrases);
+    return cachedMatcher;
+}
+
 /**
   * Computes (only) the replacement of @a match in @a source.
   * The parts before and after the match in @a source are ignored.
@@ -135,17 +175,12 @@ bool isIgnoredMessage(IgnoredMessageParameters &&params)
 {
     if (!params.message.isEmpty())
     {
-        // TODO(pajlada): Do we need to check if the phrase is valid first?
         auto phrases = getSettings()->ignoredMessages.readOnly();
-        for (const auto &phrase : *phrases)
+        if (blockPhraseMatcher(phrases)->matchesAny(params.message))
         {
-            if (phrase.isBlock() && phrase.isMatch(params.message))
-            {
-                qCDebug(chatterinoMessage)
-                    << "Blocking message because it contains ignored phrase"
-                    << phrase.getPattern();
-                return true;
-            }
+            qCDebug(chatterinoMessage)
+                << "Blocking message because it contains an ignored phrase";
+            return true;
         }
     }
 
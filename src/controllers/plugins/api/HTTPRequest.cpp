@@ -9,7 +9,7 @@
 #    include "controllers/plugins/LuaUtilities.hpp"
 #    include "controllers/plugins/PluginController.hpp"
 #    include "controllers/plugins/SolTypes.hpp"
-#    include "util/DebugCount.hpp"
+#    include "util/Metrics.hpp"
 
 #    include <lauxlib.h>
 #    include <lua.h>
@@ -30,6 +30,12 @@
 
 namespace chatterino::lua::api {
 
+namespace {
+
+const metrics::Counter HTTP_REQUESTS("lua::api::HTTPRequest");
+
+}  // namespace
+
 void HTTPRequest::createUserType(sol::table &c2)
 {
     c2.new_usertype<HTTPRequest>(                              //
@@ -177,12 +183,12 @@ HTTPRequest::HTTPRequest(HTTPRequest::ConstructorAccessTag /*ignored*/,
                          NetworkRequest req)
     : req_(std::move(req))
 {
-    DebugCount::increase("lua::api::HTTPRequest");
+    HTTP_REQUESTS.increase();
 }
 
 HTTPRequest::~HTTPRequest()
 {
-    DebugCount::decrease("lua::api::HTTPRequest");
+    HTTP_REQUESTS.decrease();
     // We might leak a Lua function or two here if the request isn't executed
     // but that's better than accessing a possibly invalid lua_State pointer.
 }
@@ -3,7 +3,7 @@
 
 #    include "common/network/NetworkResult.hpp"
 #    include "controllers/plugins/SolTypes.hpp"
-#    include "util/DebugCount.hpp"
+#    include "util/Metrics.hpp"
 
 #    include <lauxlib.h>
 #    include <sol/raii.hpp>
@@ -13,6 +13,12 @@
 
 namespace chatterino::lua::api {
 
+namespace {
+
+const metrics::Counter HTTP_RESPONSES("lua::api::HTTPResponse");
+
+}  // namespace
+
 void HTTPResponse::createUserType(sol::table &c2)
 {
     c2.new_usertype<HTTPResponse>(  //
@@ -29,11 +35,11 @@ void HTTPResponse::createUserType(sol::table &c2)
 HTTPResponse::HTTPResponse(NetworkResult res)
     : result_(std::move(res))
 {
-    DebugCount::increase("lua::api::HTTPResponse");
+    HTTP_RESPONSES.increase();
 }
 HTTPResponse::~HTTPResponse()
 {
-    DebugCount::decrease("lua::api::HTTPResponse");
+    HTTP_RESPONSES.decrease();
 }
 
 QByteArray HTTPResponse::data()
@@ -0,0 +1,405 @@
+#include "debug/Trace.hpp"
+
+#ifdef CHATTERINO_WITH_TRACING
+
+#    include "common/QLogging.hpp"
+#    include "debug/AssertInGuiThread.hpp"
+
+#    include <QAbstractEventDispatcher>
+#    include <QCoreApplication>
+#    include <QDateTime>
+#    include <QDir>
+#    include <QJsonArray>
+#    include <QJsonDocument>
+#    include <QJsonObject>
+#    include <QSaveFile>
+#    include <QThread>
+#    include <QtConcurrent>
+
+#    include <array>
+#    include <atomic>
+#    include <memory>
+#    include <mutex>
+#    include <optional>
+#    include <tuple>
+#    include <vector>
+
+namespace {
+
+using namespace chatterino::trace;
+using namespace std::chrono_literals;
+
+/// The number of events kept per thread
+constexpr size_t BUFFER_SIZE = 8192;
+
+/// At most one trace is dumped automatically in this interval
+constexpr auto LONG_FRAME_DUMP_INTERVAL = 30s;
+
+const Clock::time_point TRACE_START = Clock::now();
+
+/// Written by the owning thread and read while dumping. The fields are atomic
+/// so a dump can read them while they're written, torn events are dropped.
+struct Slot {
+    std::atomic<const char *> name{nullptr};
+    std::atomic<int64_t> startNs{0};
+    std::atomic<int64_t> durationNs{0};
+};
+
+struct ThreadBuffer {
+    std::array<Slot, BUFFER_SIZE> slots;
+    /// The number of events whose slot was (or is being) written
+    std::atomic<uint64_t> started{0};
+    /// The number of events that were completely written
+    std::atomic<uint64_t> written{0};
+
+    /// The following are guarded by the mutex of the Registry
+    bool inUse = false;
+    uint64_t threadID = 0;
+    QString threadName;
+};
+
+struct Event {
+    const char *name;
+    int64_t startNs;
+    int64_t durationNs;
+};
+
+struct ThreadEvents {
+    uint64_t threadID;
+    QString threadName;
+    std::vector<Event> events;
+};
+
+/// Buffers are never freed. When a thread exits, its buffer is reused by the
+/// next new thread, so threads of pools don't add new buffers forever.
+class Registry
+{
+public:
+    static Registry &instance()
+    {
+        // Leaked, so threads exiting during shutdown can still release their
+        // buffers
+        static auto *registry = new Registry;
+        return *registry;
+    }
+
+    ThreadBuffer *acquire()
+    {
+        auto *thread = QThread::currentThread();
+        auto *app = QCoreApplication::instance();
+        QString name = thread ? thread->objectName() : QString();
+        if (thread && app && thread == app->thread())
+        {
+            name = QStringLiteral("GUI");
+        }
+
+        std::lock_guard guard(this->mutex_);
+
+        ThreadBuffer *buffer = nullptr;
+        for (const auto &candidate : this->buffers_)
+        {
+            if (!candidate->inUse)
+            {
+                buffer = candidate.get();
+                break;
+            }
+        }
+        if (!buffer)
+        {
+            buffer =
+                this->buffers_.emplace_back(std::make_unique<ThreadBuffer>())
+                    .get();
+        }
+
+        buffer->inUse = true;
+        buffer->threadID = ++this->lastThreadID_;
+        buffer->threadName =
+            name.isEmpty()
+                ? QStringLiteral("Thread %1").arg(buffer->threadID)
+                : name;
+        buffer->started.store(0, std::memory_order_relaxed);
+        buffer->written.store(0, std::memory_order_relaxed);
+        return buffer;
+    }
+
+    void release(ThreadBuffer *buffer)
+    {
+        std::lock_guard guard(this->mutex_);
+        buffer->inUse = false;
+    }
+
+    std::vector<ThreadEvents> collect() const
+    {
+        std::lock_guard guard(this->mutex_);
+
+        std::vector<ThreadEvents> threads;
+        threads.reserve(this->buffers_.size());
+        for (const auto &buffer : this->buffers_)
+        {
+            auto &thread = threads.emplace_back(ThreadEvents{
+                .threadID = buffer->threadID,
+                .threadName = buffer->threadName,
+                .events = {},
+            });
+
+            auto end = buffer->written.load(std::memory_order_acquire);
+            auto begin = end > BUFFER_SIZE ? end - BUFFER_SIZE : 0;
+            thread.events.reserve(end - begin);
+            for (auto i = begin; i < end; i++)
+            {
+                const auto &slot = buffer->slots[i % BUFFER_SIZE];
+                thread.events.push_back({
+                    .name = slot.name.load(std::memory_order_relaxed),
+                    .startNs = slot.startNs.load(std::memory_order_relaxed),
+                    .durationNs =
+                        slot.durationNs.load(std::memory_order_relaxed),
+                });
+            }
+
+            // Events whose slots were overwritten while they were copied are
+            // torn
+            std::atomic_thread_fence(std::memory_order_acquire);
+            auto started = buffer->started.load(std::memory_order_relaxed);
+            if (started > begin + BUFFER_SIZE)
+            {
+                auto torn = std::min<uint64_t>(started - begin - BUFFER_SIZE,
+                                               thread.events.size());
+                thread.events.erase(
+                    thread.events.begin(),
+                    thread.events.begin() + static_cast<ptrdiff_t>(torn));
+            }
+        }
+        return threads;
+    }
+
+private:
+    Registry() = default;
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+    uint64_t lastThreadID_ = 0;
+};
+
+class BufferHandle
+{
+public:
+    BufferHandle()
+        : buffer(Registry::instance().acquire())
+    {
+    }
+
+    ~BufferHandle()
+    {
+        Registry::instance().release(this->buffer);
+    }
+
+    BufferHandle(const BufferHandle &) = delete;
+    BufferHandle(BufferHandle &&) = delete;
+    BufferHandle &operator=(const BufferHandle &) = delete;
+    BufferHandle &operator=(BufferHandle &&) = delete;
+
+    ThreadBuffer *const buffer;
+};
+
+int64_t sinceStart(Clock::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time -
+                                                                TRACE_START)
+        .count();
+}
+
+double toMicros(int64_t ns)
+{
+    return static_cast<double>(ns) / 1000.0;
+}
+
+QByteArray toTraceJson(const std::vector<ThreadEvents> &threads)
+{
+    const auto pid = QCoreApplication::applicationPid();
+
+    QJsonArray events;
+    for (const auto &thread : threads)
+    {
+        if (thread.events.empty())
+        {
+            continue;
+        }
+
+        events.append(QJsonObject{
+            {"name", "thread_name"},
+            {"ph", "M"},
+            {"pid", pid},
+            {"tid", static_cast<qint64>(thread.threadID)},
+            {"args", QJsonObject{{"name", thread.threadName}}},
+        });
+
+        for (const auto &event : thread.events)
+        {
+            events.append(QJsonObject{
+                {"name", QString::fromUtf8(event.name)},
+                {"cat", "chatterino"},
+                {"ph", "X"},
+                {"ts", toMicros(event.startNs)},
+                {"dur", toMicros(event.durationNs)},
+                {"pid", pid},
+                {"tid", static_cast<qint64>(thread.threadID)},
+            });
+        }
+    }
+
+    return QJsonDocument(QJsonObject{
+                             {"traceEvents", events},
+                             {"displayTimeUnit", "ms"},
+                         })
+        .toJson(QJsonDocument::Compact);
+}
+
+void writeTrace(const QString &path, const std::vector<ThreadEvents> &threads)
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qCWarning(chatterinoApp)
+            << "Failed to open trace file" << path << file.errorString();
+        return;
+    }
+
+    file.write(toTraceJson(threads));
+    if (!file.commit())
+    {
+        qCWarning(chatterinoApp)
+            << "Failed to write trace file" << path << file.errorString();
+        return;
+    }
+
+    qCInfo(chatterinoApp) << "Wrote trace to" << path;
+}
+
+/// Only accessed from the GUI thread
+QString traceDirectory;
+std::optional<Clock::time_point> iterationStart;
+std::optional<Clock::time_point> lastLongFrameDump;
+
+}  // namespace
+
+namespace chatterino::trace {
+
+void record(const char *name, Clock::time_point start,
+            Clock::time_point end) noexcept
+{
+    thread_local const BufferHandle handle;
+    auto &buffer = *handle.buffer;
+
+    auto index = buffer.written.load(std::memory_order_relaxed);
+    buffer.started.store(index + 1, std::memory_order_relaxed);
+    // A dump that sees any of the following stores also sees `started`
+    std::atomic_thread_fence(std::memory_order_release);
+
+    auto &slot = buffer.slots[index % BUFFER_SIZE];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.startNs.store(sinceStart(start), std::memory_order_relaxed);
+    slot.durationNs.store(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+            .count(),
+        std::memory_order_relaxed);
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+void initialize(const QString &directory, std::chrono::milliseconds longFrame)
+{
+    assertInGuiThread();
+
+    traceDirectory = directory;
+    QDir().mkpath(directory);
+
+    if (longFrame <= 0ms)
+    {
+        return;
+    }
+
+    qCDebug(chatterinoApp) << "Dumping a trace to" << directory
+                           << "after frames longer than" << longFrame.count()
+                           << "ms";
+
+    auto *dispatcher = QAbstractEventDispatcher::instance();
+    QObject::connect(dispatcher, &QAbstractEventDispatcher::awake, [] {
+        iterationStart = Clock::now();
+    });
+    QObject::connect(
+        dispatcher, &QAbstractEventDispatcher::aboutToBlock, [longFrame] {
+            if (!iterationStart)
+            {
+                return;
+            }
+
+            auto start = *iterationStart;
+            auto end = Clock::now();
+            iterationStart.reset();
+            if (end - start < longFrame)
+            {
+                return;
+            }
+
+            record("long frame", start, end);
+
+            if (lastLongFrameDump &&
+                end - *lastLongFrameDump < LONG_FRAME_DUMP_INTERVAL)
+            {
+                return;
+            }
+            lastLongFrameDump = end;
+
+            qCWarning(chatterinoApp)
+                << "GUI thread was blocked for"
+                << std::chrono::duration_cast<std::chrono::milliseconds>(
+                       end - start)
+                       .count()
+                << "ms";
+            dump();
+        });
+}
+
+QString dump()
+{
+    assertInGuiThread();
+
+    auto directory =
+        traceDirectory.isEmpty() ? QDir::tempPath() : traceDirectory;
+    auto path = QDir(directory)
+                    .filePath(QStringLiteral("trace-%1.json")
+                                  .arg(QDateTime::currentDateTime().toString(
+                                      "yyyy-MM-dd-HHmmss-zzz")));
+
+    // Copying the events is quick, serializing them is done in the background
+    std::ignore = QtConcurrent::run(
+        [path, threads = Registry::instance().collect()] {
+            writeTrace(path, threads);
+        });
+
+    return path;
+}
+
+}  // namespace chatterino::trace
+
+#else
+
+namespace chatterino::trace {
+
+void record(const char * /*name*/, Clock::time_point /*start*/,
+            Clock::time_point /*end*/) noexcept
+{
+}
+
+void initialize(const QString & /*directory*/,
+                std::chrono::milliseconds /*longFrame*/)
+{
+}
+
+QString dump()
+{
+    return {};
+}
+
+}  // namespace chatterino::trace
+
+#endif
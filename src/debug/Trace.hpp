@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QString>
+
+#include <chrono>
+
+/// Chrome trace events of the work done in the GUI thread (and others).
+///
+/// Zones are placed with `TRACE_ZONE("name")` and record how long their scope
+/// took. Every thread records into its own ring buffer, so only the most
+/// recent events are kept. The events can be dumped as Chrome trace-event JSON
+/// (from the debug popup or automatically after a long frame) and opened in
+/// https://ui.perfetto.dev or chrome://tracing.
+///
+/// Tracing is only compiled in with the CMake option CHATTERINO_TRACING.
+/// Otherwise, `TRACE_ZONE` expands to nothing.
+namespace chatterino::trace {
+
+#ifdef CHATTERINO_WITH_TRACING
+inline constexpr bool ENABLED = true;
+#else
+inline constexpr bool ENABLED = false;
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+/// Records an event from @a start to @a end in the buffer of this thread.
+/// @a name must outlive the program (i.e. be a string literal).
+void record(const char *name, Clock::time_point start,
+            Clock::time_point end) noexcept;
+
+/// Records the time until it's destroyed. Use `TRACE_ZONE` instead.
+class Zone
+{
+public:
+    explicit Zone(const char *name) noexcept
+        : name_(name)
+        , start_(Clock::now())
+    {
+    }
+
+    ~Zone()
+    {
+        record(this->name_, this->start_, Clock::now());
+    }
+
+    Zone(const Zone &) = delete;
+    Zone(Zone &&) = delete;
+    Zone &operator=(const Zone &) = delete;
+    Zone &operator=(Zone &&) = delete;
+
+private:
+    const char *name_;
+    Clock::time_point start_;
+};
+
+/// Sets the directory traces are written to and starts dumping a trace
+/// whenever an event-loop iteration of the GUI thread takes longer than
+/// @a longFrame (disabled if it's zero).
+///
+/// Does nothing if tracing isn't compiled in. Must be called from the GUI
+/// thread.
+void initialize(const QString &directory, std::chrono::milliseconds longFrame);
+
+/// Writes all recorded events to a new file in the trace directory. The file
+/// is written in the background.
+///
+/// Returns the path of the file or an empty string if tracing isn't enabled.
+QString dump();
+
+}  // namespace chatterino::trace
+
+#ifdef CHATTERINO_WITH_TRACING
+#    define TRACE_ZONE_CONCAT_INNER(a, b) a##b
+#    define TRACE_ZONE_CONCAT(a, b) TRACE_ZONE_CONCAT_INNER(a, b)
+/// Records the duration of the current scope as an event called `name`
+#    define TRACE_ZONE(name)                                        \
+        const ::chatterino::trace::Zone TRACE_ZONE_CONCAT(traceZone, \
+                                                          __LINE__)(name)
+#else
+#    define TRACE_ZONE(name) static_cast<void>(0)
+#endif
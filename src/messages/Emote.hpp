@@ -2,6 +2,7 @@
 
 #include "common/Aliases.hpp"
 #include "messages/ImageSet.hpp"
+#include "util/PersistentHashMap.hpp"
 
 #include <functional>
 #include <memory>
@@ -41,9 +42,13 @@ bool operator!=(const Emote &a, const Emote &b);
 
 using EmotePtr = std::shared_ptr<const Emote>;
 
-class EmoteMap : public std::unordered_map<EmoteName, EmotePtr>
+/// Emotes by name. Copies share their storage, so updating a single emote of
+/// a published map only copies O(log n) nodes (see PersistentHashMap).
+class EmoteMap : public PersistentHashMap<EmoteName, EmotePtr>
 {
 public:
+    using PersistentHashMap::PersistentHashMap;
+
     /**
      * Finds an emote by it's id with a hint to it's name.
      *
@@ -0,0 +1,104 @@
+#include "messages/EmoteIndex.hpp"
+
+#include "messages/Emote.hpp"
+
+#include <atomic>
+
+namespace {
+
+// Starts at 1, so default constructed indexes are always outdated
+std::atomic<uint64_t> currentGlobalsGeneration{1};
+
+}  // namespace
+
+namespace chatterino {
+
+EmoteIndex::EmoteIndex(const std::vector<Source> &sources,
+                       uint64_t globalsGeneration)
+    : globalsGeneration_(globalsGeneration)
+{
+    for (const auto &source : sources)
+    {
+        if (!source.emotes)
+        {
+            continue;
+        }
+        for (const auto &[name, emote] : *source.emotes)
+        {
+            // A source with a higher precedence might already have this name
+            this->entries_.try_emplace(name.string,
+                                       Entry{
+                                           .name = name.string,
+                                           .emote = emote,
+                                           .flag = source.flag,
+                                       });
+        }
+    }
+}
+
+EmoteIndex EmoteIndex::withChanges(const std::vector<Source> &sources,
+                                   const std::vector<QString> &names) const
+{
+    // Copying only copies the root, the changed paths are copied on write
+    auto index = *this;
+    for (const auto &name : names)
+    {
+        index.entries_.erase(name);
+        index.resolve(sources, name);
+    }
+    return index;
+}
+
+const EmoteIndex::Entry *EmoteIndex::find(QStringView name) const
+{
+    auto it = this->entries_.find(name);
+    if (it == this->entries_.end())
+    {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+size_t EmoteIndex::size() const
+{
+    return this->entries_.size();
+}
+
+uint64_t EmoteIndex::builtWithGlobalsGeneration() const
+{
+    return this->globalsGeneration_;
+}
+
+uint64_t EmoteIndex::globalsGeneration()
+{
+    return currentGlobalsGeneration.load(std::memory_order_acquire);
+}
+
+void EmoteIndex::invalidateGlobals()
+{
+    currentGlobalsGeneration.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void EmoteIndex::resolve(const std::vector<Source> &sources,
+                         const QString &name)
+{
+    for (const auto &source : sources)
+    {
+        if (!source.emotes)
+        {
+            continue;
+        }
+        auto it = source.emotes->find(EmoteName{name});
+        if (it != source.emotes->end())
+        {
+            this->entries_.try_emplace(name, Entry{
+                                                 .name = name,
+                                                 .emote = it->second,
+                                                 .flag = source.flag,
+                                             });
+            return;
+        }
+    }
+}
+
+}  // namespace chatterino
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "util/PersistentHashMap.hpp"
+#include "util/QStringHash.hpp"
+
+#include <QString>
+#include <QStringView>
+
+#include <cinttypes>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace chatterino {
+
+struct Emote;
+using EmotePtr = std::shared_ptr<const Emote>;
+class EmoteMap;
+enum class MessageElementFlag : int64_t;
+
+/// EmoteIndex merges several emote maps into one lookup table.
+///
+/// Names are resolved once when the index is built: if multiple sources
+/// contain the same name, the first source wins. Looking up a word hashes it
+/// once and doesn't allocate or touch any shared_ptr's reference count.
+///
+/// An index is immutable after it's built. Owners swap in a new index when
+/// any of its sources change. If only a few names changed, withChanges()
+/// derives the new index from the old one and shares everything else with it.
+class EmoteIndex
+{
+public:
+    struct Source {
+        const EmoteMap *emotes;
+        MessageElementFlag flag;
+    };
+
+    struct Entry {
+        QString name;
+        EmotePtr emote;
+        MessageElementFlag flag;
+    };
+
+    EmoteIndex() = default;
+
+    /// @param sources Emote maps in order of precedence. Null maps are skipped.
+    /// @param globalsGeneration The value of globalsGeneration() the global
+    ///                          sources were read at.
+    EmoteIndex(const std::vector<Source> &sources, uint64_t globalsGeneration);
+
+    /// Returns a copy of this index in which `names` are resolved again in
+    /// `sources`. This costs O(names) instead of O(all emotes), but `sources`
+    /// must be the ones this index was built from, with only `names` changed.
+    EmoteIndex withChanges(const std::vector<Source> &sources,
+                           const std::vector<QString> &names) const;
+
+    /// Returns the entry for `name` or nullptr if there's no such emote
+    const Entry *find(QStringView name) const;
+
+    size_t size() const;
+
+    /// Returns the generation of the global emote sets this index was built
+    /// with. An index with an outdated generation should be rebuilt.
+    uint64_t builtWithGlobalsGeneration() const;
+
+    /// Returns the current generation of the global emote sets
+    static uint64_t globalsGeneration();
+
+    /// Bumps the generation of the global emote sets. Call this whenever the
+    /// global FFZ, BTTV or 7TV emotes change.
+    static void invalidateGlobals();
+
+private:
+    /// Adds the entry for `name` from the first source that has it
+    void resolve(const std::vector<Source> &sources, const QString &name);
+
+    PersistentHashMap<QString, Entry, TransparentQStringHash, std::equal_to<>>
+        entries_;
+    uint64_t globalsGeneration_ = 0;
+};
+
+}  // namespace chatterino
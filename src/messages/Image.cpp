@@ -7,10 +7,11 @@
 #include "common/QLogging.hpp"
 #include "debug/AssertInGuiThread.hpp"
 #include "debug/Benchmark.hpp"
+#include "debug/Trace.hpp"
 #include "singletons/Emotes.hpp"
 #include "singletons/helper/GifTimer.hpp"
 #include "singletons/WindowManager.hpp"
-#include "util/DebugCount.hpp"
+#include "util/Metrics.hpp"
 #include "util/PostToThread.hpp"
 
 #include <boost/functional/hash.hpp>
@@ -19,24 +20,208 @@
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QNetworkRequest>
+#include <QThreadPool>
 #include <QTimer>
 
 #include <atomic>
+#include <list>
+#include <unordered_map>
 
 // Duration between each check of every Image instance
 const auto IMAGE_POOL_CLEANUP_INTERVAL = std::chrono::minutes(1);
 // Duration since last usage of Image pixmap before expiration of frames
 const auto IMAGE_POOL_IMAGE_LIFETIME = std::chrono::minutes(10);
+// Number of frames kept decoded ahead of the shown frame of streamed animations
+constexpr qsizetype FRAME_RING_SIZE = 8;
+// Combined size of the decoded frames of all animations. Once this is
+// exceeded, the least recently shown animations drop their decoded frames.
+constexpr int64_t DECODED_FRAMES_BUDGET = 256LL * 1024 * 1024;
 
 namespace chatterino::detail {
 
+namespace {
+
+const metrics::Counter IMAGES("images");
+const metrics::Counter LOADED_IMAGES("loaded images");
+const metrics::Counter ANIMATED_IMAGES("animated images");
+const metrics::Counter IMAGE_BYTES("image bytes", metrics::Unit::Bytes);
+const metrics::Counter IMAGE_BYTES_LOADED("image bytes (ever loaded)",
+                                          metrics::Unit::Bytes);
+const metrics::Counter IMAGE_BYTES_UNLOADED("image bytes (ever unloaded)",
+                                            metrics::Unit::Bytes);
+const metrics::Counter DECODED_FRAMES("decoded image frames");
+
+int64_t pixmapBytes(const QPixmap &pixmap)
+{
+    return int64_t(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+}
+
+int nextFrameDuration(QImageReader &reader)
+{
+    // It seems that browsers have special logic for fast animations.
+    // This implements Chrome and Firefox's behavior which uses
+    // a duration of 100 ms for any frames that specify a duration of <= 10 ms.
+    // See http://webkit.org/b/36082 for more information.
+    // https://github.com/SevenTV/chatterino7/issues/46#issuecomment-1010595231
+    int duration = reader.nextImageDelay();
+    if (duration <= 10)
+    {
+        duration = 100;
+    }
+    return std::max(20, duration);
+}
+
+/// Keeps track of the decoded frames of all animations, so the least recently
+/// shown ones can drop their frames when there are too many.
+///
+/// GUI thread only.
+class FrameBudget
+{
+public:
+    static FrameBudget &instance()
+    {
+        static auto *instance = new FrameBudget;
+        return *instance;
+    }
+
+    void touch(Frames *frames)
+    {
+        auto it = this->positions_.find(frames);
+        if (it != this->positions_.end())
+        {
+            this->lru_.splice(this->lru_.begin(), this->lru_, it->second);
+            return;
+        }
+        this->lru_.push_front(frames);
+        this->positions_.emplace(frames, this->lru_.begin());
+    }
+
+    void remove(Frames *frames)
+    {
+        auto it = this->positions_.find(frames);
+        if (it != this->positions_.end())
+        {
+            this->lru_.erase(it->second);
+            this->positions_.erase(it);
+        }
+    }
+
+    void change(int64_t bytes)
+    {
+        this->totalBytes_ += bytes;
+    }
+
+    /// Drops decoded frames of the least recently shown animations until the
+    /// budget is met. `keep` is never evicted.
+    void enforce(const Frames *keep)
+    {
+        auto it = this->lru_.end();
+        while (this->totalBytes_ > DECODED_FRAMES_BUDGET &&
+               it != this->lru_.begin())
+        {
+            --it;
+            if (*it != keep)
+            {
+                (*it)->evictDecoded();
+            }
+        }
+    }
+
+private:
+    std::list<Frames *> lru_;
+    std::unordered_map<Frames *, std::list<Frames *>::iterator> positions_;
+    int64_t totalBytes_{0};
+};
+
+}  // namespace
+
+FrameDecoder::FrameDecoder(QByteArray data, qsizetype frameCount)
+    : data_(std::move(data))
+    , frameCount_(frameCount)
+{
+}
+
+FrameDecoder::~FrameDecoder() = default;
+
+std::vector<std::pair<qsizetype, QImage>> FrameDecoder::decode(qsizetype first,
+                                                               qsizetype count)
+{
+    TRACE_ZONE("image decode ahead");
+
+    std::vector<std::pair<qsizetype, QImage>> images;
+    if (this->frameCount_ <= 0)
+    {
+        return images;
+    }
+
+    first %= this->frameCount_;
+    if (!this->reader_ || this->nextIndex_ > first)
+    {
+        this->restart();
+    }
+    while (this->nextIndex_ < first)
+    {
+        if (this->readNext().isNull())
+        {
+            return images;
+        }
+    }
+
+    images.reserve(static_cast<size_t>(count));
+    for (qsizetype i = 0; i < count; i++)
+    {
+        if (this->nextIndex_ >= this->frameCount_)
+        {
+            this->restart();
+        }
+
+        auto index = this->nextIndex_;
+        auto image = this->readNext();
+        if (image.isNull())
+        {
+            break;
+        }
+        images.emplace_back(index, std::move(image));
+    }
+
+    return images;
+}
+
+void FrameDecoder::restart()
+{
+    this->reader_.reset();
+    this->buffer_ = std::make_unique<QBuffer>();
+    this->buffer_->setData(this->data_);
+    this->reader_ = std::make_unique<QImageReader>(this->buffer_.get());
+    this->readAttempts_ = 0;
+    this->nextIndex_ = 0;
+}
+
+QImage FrameDecoder::readNext()
+{
+    // Frames that can't be decoded are skipped, same as in readFrames
+    while (this->readAttempts_ < this->reader_->imageCount())
+    {
+        this->readAttempts_++;
+        auto image = this->reader_->read();
+        if (!image.isNull())
+        {
+            DECODED_FRAMES.increase();
+            this->nextIndex_++;
+            return image;
+        }
+    }
+    return {};
+}
+
 Frames::Frames()
 {
-    DebugCount::increase("images");
+    IMAGES.increase();
 }
 
-Frames::Frames(QList<Frame> &&frames)
+Frames::Frames(QList<Frame> &&frames, std::shared_ptr<FrameDecoder> decoder)
     : items_(std::move(frames))
+    , decoder_(std::move(decoder))
 {
     assertInGuiThread();
     auto *app = tryGetApp();
@@ -44,29 +229,32 @@ Frames::Frames(QList<Frame> &&frames)
     {
         qCDebug(chatterinoImage)
             << "Frames constructor called while app is shutting down";
+        this->decoder_.reset();
         return;
     }
 
-    DebugCount::increase("images");
+    IMAGES.increase();
     if (!this->empty())
     {
-        DebugCount::increase("loaded images");
+        LOADED_IMAGES.increase();
     }
 
-    if (this->animated())
+    if (!this->animated())
     {
-        DebugCount::increase("animated images");
-
-        this->gifTimerConnection_ =
-            app->getEmotes()->getGIFTimer().signal.connect([this] {
-                this->advance();
-            });
+        // Nothing to decode later on
+        this->decoder_.reset();
+    }
+    else
+    {
+        ANIMATED_IMAGES.increase();
 
         auto totalLength =
             std::accumulate(this->items_.begin(), this->items_.end(), 0UL,
                             [](auto init, auto &&frame) {
                                 return init + frame.duration;
                             });
+        this->totalDuration_ = int(totalLength);
+        this->lastPosition_ = app->getEmotes()->getGIFTimer().position();
 
         if (totalLength == 0)
         {
@@ -74,54 +262,53 @@ Frames::Frames(QList<Frame> &&frames)
         }
         else
         {
-            this->durationOffset_ = std::min<int>(
-                int(app->getEmotes()->getGIFTimer().position() % totalLength),
-                60000);
+            this->durationOffset_ =
+                std::min<int>(int(this->lastPosition_ % totalLength), 60000);
         }
+
+        this->streaming_ =
+            this->decoder_ != nullptr &&
+            std::any_of(this->items_.begin(), this->items_.end(),
+                        [](const auto &frame) {
+                            return frame.image.isNull();
+                        });
         this->processOffset();
     }
 
-    DebugCount::increase("image bytes", this->memoryUsage());
-    DebugCount::increase("image bytes (ever loaded)", this->memoryUsage());
+    for (const auto &frame : this->items_)
+    {
+        this->decodedBytes_ += pixmapBytes(frame.image);
+    }
+    if (this->decoder_)
+    {
+        FrameBudget::instance().change(this->decodedBytes_);
+    }
+
+    IMAGE_BYTES.increase(this->decodedBytes_);
+    IMAGE_BYTES_LOADED.increase(this->decodedBytes_);
 }
 
 Frames::~Frames()
 {
     assertInGuiThread();
-    DebugCount::decrease("images");
+    IMAGES.decrease();
     if (!this->empty())
     {
-        DebugCount::decrease("loaded images");
+        LOADED_IMAGES.decrease();
     }
 
     if (this->animated())
     {
-        DebugCount::decrease("animated images");
+        ANIMATED_IMAGES.decrease();
     }
-    DebugCount::decrease("image bytes", this->memoryUsage());
-    DebugCount::increase("image bytes (ever unloaded)", this->memoryUsage());
-
-    this->gifTimerConnection_.disconnect();
-}
+    IMAGE_BYTES.decrease(this->decodedBytes_);
+    IMAGE_BYTES_UNLOADED.increase(this->decodedBytes_);
 
-int64_t Frames::memoryUsage() const
-{
-    int64_t usage = 0;
-    for (const auto &frame : this->items_)
+    if (this->decoder_)
     {
-        auto sz = frame.image.size();
-        auto area = sz.width() * sz.height();
-        auto memory = area * frame.image.depth() / 8;
-
-        usage += memory;
+        FrameBudget::instance().change(-this->decodedBytes_);
+        FrameBudget::instance().remove(this);
     }
-    return usage;
-}
-
-void Frames::advance()
-{
-    this->durationOffset_ += GIF_FRAME_LENGTH;
-    this->processOffset();
 }
 
 void Frames::processOffset()
@@ -131,6 +318,14 @@ void Frames::processOffset()
         return;
     }
 
+    if (this->totalDuration_ > 0 &&
+        this->durationOffset_ > this->totalDuration_)
+    {
+        // Skip whole loops of the animation, which happens if it wasn't shown
+        // for a while
+        this->durationOffset_ %= this->totalDuration_;
+    }
+
     while (true)
     {
         this->index_ %= this->items_.size();
@@ -145,6 +340,168 @@ void Frames::processOffset()
             break;
         }
     }
+
+    if (this->items_[this->index_].image.isNull())
+    {
+        // Keep showing the previous frame until this one is decoded
+        return;
+    }
+
+    if (this->streaming_)
+    {
+        // Drop the frames we went past
+        for (auto i = this->shownIndex_; i != this->index_;
+             i = (i + 1) % this->items_.size())
+        {
+            if (i != 0)
+            {
+                this->dropDecoded(i);
+            }
+        }
+    }
+    this->shownIndex_ = this->index_;
+}
+
+void Frames::decodeAhead()
+{
+    if (this->decoding_ || !this->decoder_)
+    {
+        return;
+    }
+
+    auto frameCount = this->items_.size();
+    auto window = std::min<qsizetype>(FRAME_RING_SIZE, frameCount);
+    qsizetype first = -1;
+    qsizetype count = 0;
+    for (qsizetype i = 0; i < window; i++)
+    {
+        auto index = (this->index_ + i) % frameCount;
+        if (this->items_[index].image.isNull())
+        {
+            first = index;
+            count = window - i;
+            break;
+        }
+    }
+    if (first < 0)
+    {
+        return;
+    }
+
+    auto *threadPool = QThreadPool::globalInstance();
+    if (threadPool == nullptr)
+    {
+        // Must be exiting - do nothing
+        return;
+    }
+
+    this->decoding_ = true;
+    std::weak_ptr<FrameDecoder> weak = this->decoder_;
+    threadPool->start(
+        [this, decoder = this->decoder_, weak, first, count]() mutable {
+            auto images = decoder->decode(first, count);
+            // The frames own the only other reference to the decoder, so
+            // this tells us whether they're still alive
+            decoder.reset();
+
+            postToThread([this, weak, images = std::move(images)]() mutable {
+                if (weak.expired())
+                {
+                    return;
+                }
+
+                this->decoding_ = false;
+                for (auto &[index, image] : images)
+                {
+                    this->setDecoded(index, QPixmap::fromImage(std::move(image)));
+                }
+                this->processOffset();
+                FrameBudget::instance().enforce(this);
+            });
+        });
+}
+
+void Frames::setDecoded(QList<Frame>::size_type index, QPixmap pixmap)
+{
+    if (index >= this->items_.size() || pixmap.isNull() ||
+        !this->items_[index].image.isNull())
+    {
+        return;
+    }
+
+    auto bytes = pixmapBytes(pixmap);
+    this->items_[index].image = std::move(pixmap);
+    this->decodedBytes_ += bytes;
+    IMAGE_BYTES.increase(bytes);
+    IMAGE_BYTES_LOADED.increase(bytes);
+    if (this->decoder_)
+    {
+        FrameBudget::instance().change(bytes);
+    }
+}
+
+void Frames::dropDecoded(QList<Frame>::size_type index)
+{
+    auto &image = this->items_[index].image;
+    if (image.isNull())
+    {
+        return;
+    }
+
+    auto bytes = pixmapBytes(image);
+    image = QPixmap();
+    this->decodedBytes_ -= bytes;
+    IMAGE_BYTES.decrease(bytes);
+    IMAGE_BYTES_UNLOADED.increase(bytes);
+    if (this->decoder_)
+    {
+        FrameBudget::instance().change(-bytes);
+    }
+}
+
+void Frames::markUsed()
+{
+    if (!this->animated())
+    {
+        return;
+    }
+
+    auto *app = tryGetApp();
+    if (app == nullptr)
+    {
+        return;
+    }
+
+    auto &timer = app->getEmotes()->getGIFTimer();
+    timer.markAnimationShown();
+
+    auto position = timer.position();
+    this->durationOffset_ += int(position - this->lastPosition_);
+    this->lastPosition_ = position;
+    this->processOffset();
+
+    if (this->decoder_)
+    {
+        FrameBudget::instance().touch(this);
+        this->decodeAhead();
+    }
+}
+
+void Frames::evictDecoded()
+{
+    if (!this->decoder_)
+    {
+        // We couldn't decode them again
+        return;
+    }
+
+    for (QList<Frame>::size_type i = 1; i < this->items_.size(); i++)
+    {
+        if (i != this->shownIndex_)
+        {
+            this->dropDecoded(i);
+        }
+    }
 }
 
 void Frames::clear()
@@ -152,15 +509,26 @@ void Frames::clear()
     assertInGuiThread();
     if (!this->empty())
     {
-        DebugCount::decrease("loaded images");
+        LOADED_IMAGES.decrease();
+    }
+    IMAGE_BYTES.decrease(this->decodedBytes_);
+    IMAGE_BYTES_UNLOADED.increase(this->decodedBytes_);
+
+    if (this->decoder_)
+    {
+        FrameBudget::instance().change(-this->decodedBytes_);
+        FrameBudget::instance().remove(this);
     }
-    DebugCount::decrease("image bytes", this->memoryUsage());
-    DebugCount::increase("image bytes (ever unloaded)", this->memoryUsage());
 
     this->items_.clear();
     this->index_ = 0;
+    this->shownIndex_ = 0;
     this->durationOffset_ = 0;
-    this->gifTimerConnection_.disconnect();
+    this->decodedBytes_ = 0;
+    this->totalDuration_ = 0;
+    this->decoder_.reset();
+    this->streaming_ = false;
+    this->decoding_ = false;
 }
 
 bool Frames::empty() const
@@ -180,7 +548,7 @@ std::optional<QPixmap> Frames::current() const
         return std::nullopt;
     }
 
-    return this->items_[this->index_].image;
+    return this->items_[this->shownIndex_].image;
 }
 
 std::optional<QPixmap> Frames::first() const
@@ -193,30 +561,43 @@ std::optional<QPixmap> Frames::first() const
     return this->items_.front().image;
 }
 
-QList<Frame> readFrames(QImageReader &reader, const Url &url)
+QList<Frame> readFrames(QImageReader &reader, const Url &url,
+                        qsizetype decodeCount)
 {
+    TRACE_ZONE("image decode");
+
     QList<Frame> frames;
     frames.reserve(reader.imageCount());
 
     for (int index = 0; index < reader.imageCount(); ++index)
     {
-        auto pixmap = QPixmap::fromImageReader(&reader);
-        if (!pixmap.isNull())
+        if (frames.size() >= decodeCount)
         {
-            // It seems that browsers have special logic for fast animations.
-            // This implements Chrome and Firefox's behavior which uses
-            // a duration of 100 ms for any frames that specify a duration of <= 10 ms.
-            // See http://webkit.org/b/36082 for more information.
-            // https://github.com/SevenTV/chatterino7/issues/46#issuecomment-1010595231
-            int duration = reader.nextImageDelay();
-            if (duration <= 10)
+            // We still need to know how long the frame is, but the image is
+            // decoded again once it's needed. Formats that can't skip a frame
+            // (e.g. GIF) have to decode it anyway.
+            if (!reader.jumpToNextImage())
             {
-                duration = 100;
+                if (reader.read().isNull())
+                {
+                    continue;
+                }
+                DECODED_FRAMES.increase();
             }
-            duration = std::max(20, duration);
+            frames.append(Frame{
+                .image = {},
+                .duration = nextFrameDuration(reader),
+            });
+            continue;
+        }
+
+        auto pixmap = QPixmap::fromImageReader(&reader);
+        if (!pixmap.isNull())
+        {
+            DECODED_FRAMES.increase();
             frames.append(Frame{
                 .image = std::move(pixmap),
-                .duration = duration,
+                .duration = nextFrameDuration(reader),
             });
         }
     }
@@ -230,17 +611,22 @@ QList<Frame> readFrames(QImageReader &reader, const Url &url)
     return frames;
 }
 
-void assignFrames(std::weak_ptr<Image> weak, QList<Frame> parsed)
+void assignFrames(std::weak_ptr<Image> weak, QList<Frame> parsed,
+                  std::shared_ptr<FrameDecoder> decoder)
 {
     static bool isPushQueued;
 
-    auto cb = [parsed = std::move(parsed), weak = std::move(weak)]() mutable {
+    auto cb = [parsed = std::move(parsed), decoder = std::move(decoder),
+               weak = std::move(weak)]() mutable {
+        TRACE_ZONE("image assign frames");
+
         auto shared = weak.lock();
         if (!shared)
         {
             return;
         }
-        shared->frames_ = std::make_unique<detail::Frames>(std::move(parsed));
+        shared->frames_ = std::make_unique<detail::Frames>(std::move(parsed),
+                                                           std::move(decoder));
 
         // Avoid too many layouts in one event-loop iteration
         //
@@ -273,6 +659,14 @@ void assignFrames(std::weak_ptr<Image> weak, QList<Frame> parsed)
 
 namespace chatterino {
 
+namespace {
+
+const metrics::Gauge LAST_GC_EXPIRED("last image gc: expired");
+const metrics::Gauge LAST_GC_ELIGIBLE("last image gc: eligible");
+const metrics::Gauge LAST_GC_LEFT("last image gc: left after gc");
+
+}  // namespace
+
 // IMAGE2
 Image::~Image()
 {
@@ -427,6 +821,7 @@ std::optional<QPixmap> Image::pixmapOrLoad() const
     this->lastUsed_ = std::chrono::steady_clock::now();
 
     this->load();
+    this->frames_->markUsed();
 
     return this->frames_->current();
 }
@@ -547,8 +942,16 @@ void Image::actuallyLoad()
             }
 
             // use "double" to prevent int overflows
-            if (double(size.width()) * double(size.height()) *
-                    double(reader.imageCount()) * 4.0 >
+            auto frameBytes = double(size.width()) * double(size.height()) * 4.0;
+            auto fullBytes = frameBytes * double(reader.imageCount());
+
+            // Large animations are streamed: only a few frames ahead of the
+            // current one are kept decoded
+            auto decodeCount = fullBytes > double(Image::maxBytesFullyDecoded)
+                                   ? FRAME_RING_SIZE
+                                   : qsizetype(reader.imageCount());
+            if (frameBytes * double(std::min<qsizetype>(decodeCount,
+                                                        reader.imageCount())) >
                 double(Image::maxBytesRam))
             {
                 qCDebug(chatterinoImage) << "image too large in RAM";
@@ -557,9 +960,17 @@ void Image::actuallyLoad()
                 return;
             }
 
-            auto parsed = detail::readFrames(reader, shared->url());
+            auto parsed =
+                detail::readFrames(reader, shared->url(), decodeCount);
+
+            std::shared_ptr<detail::FrameDecoder> decoder;
+            if (parsed.size() > 1)
+            {
+                decoder = std::make_shared<detail::FrameDecoder>(
+                    result.getData(), parsed.size());
+            }
 
-            assignFrames(shared, parsed);
+            assignFrames(shared, parsed, std::move(decoder));
         })
         .onError([weak](auto /*result*/) {
             auto shared = weak.lock();
@@ -604,13 +1015,6 @@ ImageExpirationPool::ImageExpirationPool()
     this->freeTimer_->start(
         std::chrono::duration_cast<std::chrono::milliseconds>(
             IMAGE_POOL_CLEANUP_INTERVAL));
-
-    // configure all debug counts used by images
-    DebugCount::configure("image bytes", DebugCount::Flag::DataSize);
-    DebugCount::configure("image bytes (ever loaded)",
-                          DebugCount::Flag::DataSize);
-    DebugCount::configure("image bytes (ever unloaded)",
-                          DebugCount::Flag::DataSize);
 }
 
 ImageExpirationPool &ImageExpirationPool::instance()
@@ -691,9 +1095,9 @@ void ImageExpirationPool::freeOld()
     qCDebug(chatterinoImage) << "freed frame data for" << numExpired << "/"
                              << eligible << "eligible images";
 #    endif
-    DebugCount::set("last image gc: expired", numExpired);
-    DebugCount::set("last image gc: eligible", eligible);
-    DebugCount::set("last image gc: left after gc", this->allImages_.size());
+    LAST_GC_EXPIRED.set(static_cast<int64_t>(numExpired));
+    LAST_GC_ELIGIBLE.set(static_cast<int64_t>(eligible));
+    LAST_GC_LEFT.set(static_cast<int64_t>(this->allImages_.size()));
 }
 
 #endif
@@ -12,10 +12,16 @@
 
 #include <atomic>
 #include <chrono>
+#include <limits>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <utility>
+#include <vector>
+
+class QBuffer;
+class QImageReader;
 
 namespace chatterino {
 
@@ -26,15 +32,55 @@ class Image;
 namespace chatterino::detail {
 
 struct Frame {
+    /// Null if the frame isn't decoded at the moment
     QPixmap image;
     int duration;
 };
 
+/// Decodes the frames of an animated image from its encoded data.
+///
+/// Frames can only be decoded in order, so continuing where the last call to
+/// decode() stopped is cheap, while going back means decoding from the start.
+/// This class isn't thread safe, but it can be used from any thread.
+class FrameDecoder
+{
+public:
+    FrameDecoder(QByteArray data, qsizetype frameCount);
+    ~FrameDecoder();
+
+    FrameDecoder(const FrameDecoder &) = delete;
+    FrameDecoder &operator=(const FrameDecoder &) = delete;
+
+    FrameDecoder(FrameDecoder &&) = delete;
+    FrameDecoder &operator=(FrameDecoder &&) = delete;
+
+    /// Decodes `count` frames starting at `first`, wrapping around after the
+    /// last frame. Returns the index and image of every decoded frame.
+    std::vector<std::pair<qsizetype, QImage>> decode(qsizetype first,
+                                                     qsizetype count);
+
+private:
+    void restart();
+    QImage readNext();
+
+    const QByteArray data_;
+    const qsizetype frameCount_;
+
+    std::unique_ptr<QBuffer> buffer_;
+    std::unique_ptr<QImageReader> reader_;
+    int readAttempts_{0};
+    qsizetype nextIndex_{0};
+};
+
 class Frames
 {
 public:
     Frames();
-    Frames(QList<Frame> &&frames);
+    /// If a decoder is given, frames that aren't decoded yet are decoded on
+    /// demand, and decoded frames may be dropped again to stay within the
+    /// budget for decoded frames.
+    Frames(QList<Frame> &&frames,
+           std::shared_ptr<FrameDecoder> decoder = nullptr);
     ~Frames();
 
     Frames(const Frames &) = delete;
@@ -46,21 +92,48 @@ public:
     void clear();
     bool empty() const;
     bool animated() const;
-    void advance();
     std::optional<QPixmap> current() const;
     std::optional<QPixmap> first() const;
 
+    /// Marks the frames as shown and moves to the frame for the current
+    /// position of the GIF timer. Animations only advance and decode frames
+    /// ahead while they're painted.
+    void markUsed();
+
+    /// Drops all decoded frames except the first one and the one that's
+    /// currently shown.
+    void evictDecoded();
+
 private:
-    int64_t memoryUsage() const;
     void processOffset();
+    void decodeAhead();
+    void setDecoded(QList<Frame>::size_type index, QPixmap pixmap);
+    void dropDecoded(QList<Frame>::size_type index);
+
     QList<Frame> items_;
     QList<Frame>::size_type index_{0};
+    /// The frame that's shown. This lags behind index_ while the frame at
+    /// index_ is being decoded.
+    QList<Frame>::size_type shownIndex_{0};
     int durationOffset_{0};
-    pajlada::Signals::Connection gifTimerConnection_;
+    int totalDuration_{0};
+    /// The GIF timer position durationOffset_ was last updated at
+    unsigned long lastPosition_{0};
+    int64_t decodedBytes_{0};
+
+    std::shared_ptr<FrameDecoder> decoder_;
+    /// Only keep the frames just ahead of the shown one decoded
+    bool streaming_{false};
+    bool decoding_{false};
 };
 
-QList<Frame> readFrames(QImageReader &reader, const Url &url);
-void assignFrames(std::weak_ptr<Image> weak, QList<Frame> parsed);
+/// Reads all frames from `reader`, but only keeps the images of the first
+/// `decodeCount` frames.
+QList<Frame> readFrames(
+    QImageReader &reader, const Url &url,
+    qsizetype decodeCount = std::numeric_limits<qsizetype>::max());
+void assignFrames(std::weak_ptr<Image> weak, QList<Frame> parsed,
+                  std::shared_ptr<FrameDecoder> decoder);
 
 }  // namespace chatterino::detail
 
@@ -73,8 +146,12 @@ using ImagePtr = std::shared_ptr<Image>;
 class Image : public std::enable_shared_from_this<Image>
 {
 public:
-    // Maximum amount of RAM used by the image in bytes.
+    // Maximum amount of RAM used by the decoded frames of an image that are
+    // kept at the same time in bytes.
     static constexpr int maxBytesRam = 20 * 1024 * 1024;
+    // Animations that need more RAM than this when fully decoded only keep a
+    // few frames ahead of the current one decoded.
+    static constexpr int maxBytesFullyDecoded = 4 * 1024 * 1024;
 
     ~Image();
 
@@ -132,7 +209,8 @@ private:
 
     friend class ImageExpirationPool;
     friend void detail::assignFrames(std::weak_ptr<Image>,
-                                     QList<detail::Frame>);
+                                     QList<detail::Frame>,
+                                     std::shared_ptr<detail::FrameDecoder>);
 };
 
 // forward-declarable function that calls Image::getEmpty() under the hood.
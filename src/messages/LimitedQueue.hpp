@@ -2,24 +2,90 @@
 
 #include "messages/LimitedQueueSnapshot.hpp"
 
-#include <boost/circular_buffer.hpp>
-
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <optional>
+#include <ranges>
 #include <shared_mutex>
+#include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 namespace chatterino {
 
+namespace detail {
+
+template <typename KeyOf, typename Key>
+struct LimitedQueueKeyHash {
+    using type = std::hash<Key>;
+};
+
+template <typename KeyOf, typename Key>
+    requires requires { typename KeyOf::Hash; }
+struct LimitedQueueKeyHash<KeyOf, Key> {
+    using type = typename KeyOf::Hash;
+};
+
+template <typename T, typename KeyOf>
+struct LimitedQueueIndex {
+    using Key = std::remove_cvref_t<std::invoke_result_t<KeyOf, const T &>>;
+
+    std::unordered_map<Key, T, typename LimitedQueueKeyHash<KeyOf, Key>::type,
+                       std::equal_to<>>
+        items;
+};
+
+template <typename T>
+struct LimitedQueueIndex<T, void> {
+};
+
+template <typename T, typename GroupOf>
+struct LimitedQueueGroups {
+    using Key = std::remove_cvref_t<
+        std::ranges::range_value_t<std::invoke_result_t<GroupOf, const T &>>>;
+
+    /// Logical positions of the items in each group in ascending order
+    std::unordered_map<Key, std::vector<size_t>> positions;
+};
+
 template <typename T>
+struct LimitedQueueGroups<T, void> {
+};
+
+}  // namespace detail
+
+/// A thread safe queue with a fixed capacity.
+///
+/// Items live in a ring with room for twice the limit. Snapshots share the
+/// ring with the queue: evicted slots aren't overwritten while a snapshot can
+/// still see them, and the live items are only copied to a new ring when a
+/// write would change what a snapshot sees.
+///
+/// If `KeyOf` is given, the queue keeps an index from `KeyOf{}(item)` to the
+/// newest item with that key, which findByKey uses instead of a linear search.
+/// If `KeyOf::Hash` names a transparent hash, findByKey accepts anything that
+/// hash and `==` accept without converting it to the key type first.
+///
+/// If `GroupOf` is given, `GroupOf{}(item)` returns the keys of the groups an
+/// item belongs to (default constructed keys are skipped). findAllInGroup
+/// returns the items of a group without looking at the other items.
+template <typename T, typename KeyOf = void, typename GroupOf = void>
 class LimitedQueue
 {
+    static constexpr bool HAS_INDEX = !std::is_void_v<KeyOf>;
+    static constexpr bool HAS_GROUPS = !std::is_void_v<GroupOf>;
+
 public:
     LimitedQueue(size_t limit = 1000)
         : limit_(limit)
-        , buffer_(limit)
+        , capacity_(std::max<size_t>(2 * limit, 2))
+        , storage_(std::make_shared<std::vector<T>>(this->capacity_))
+        , head_(this->capacity_)
     {
     }
 
@@ -32,7 +98,7 @@ private:
      */
     [[nodiscard]] size_t space() const
     {
-        return this->limit() - this->buffer_.size();
+        return this->limit() - this->size_;
     }
 
 public:
@@ -51,7 +117,7 @@ public:
     {
         std::shared_lock lock(this->mutex_);
 
-        return this->buffer_.empty();
+        return this->size_ == 0;
     }
 
     /// Value Accessors
@@ -67,12 +133,12 @@ public:
     {
         std::shared_lock lock(this->mutex_);
 
-        if (index >= this->buffer_.size())
+        if (index >= this->size_)
         {
             return std::nullopt;
         }
 
-        return this->buffer_[index];
+        return this->at(index);
     }
 
     /**
@@ -84,12 +150,12 @@ public:
     {
         std::shared_lock lock(this->mutex_);
 
-        if (this->buffer_.empty())
+        if (this->size_ == 0)
         {
             return std::nullopt;
         }
 
-        return this->buffer_.front();
+        return this->at(0);
     }
 
     /**
@@ -101,12 +167,12 @@ public:
     {
         std::shared_lock lock(this->mutex_);
 
-        if (this->buffer_.empty())
+        if (this->size_ == 0)
         {
             return std::nullopt;
         }
 
-        return this->buffer_.back();
+        return this->at(this->size_ - 1);
     }
 
     /// Modifiers
@@ -116,7 +182,30 @@ public:
     {
         std::unique_lock lock(this->mutex_);
 
-        this->buffer_.clear();
+        this->version_++;
+        if (this->hasSnapshots())
+        {
+            // Snapshots keep the old items
+            this->storage_ = std::make_shared<std::vector<T>>(this->capacity_);
+            this->snapshots_.clear();
+        }
+        else
+        {
+            for (size_t i = 0; i < this->size_; i++)
+            {
+                this->at(i) = T{};
+            }
+        }
+        this->head_ = this->capacity_;
+        this->size_ = 0;
+        if constexpr (HAS_INDEX)
+        {
+            this->index_.items.clear();
+        }
+        if constexpr (HAS_GROUPS)
+        {
+            this->groups_.positions.clear();
+        }
     }
 
     /**
@@ -130,12 +219,13 @@ public:
     {
         std::unique_lock lock(this->mutex_);
 
-        bool full = this->buffer_.full();
+        bool full = this->size_ == this->limit_;
         if (full)
         {
-            deleted = this->buffer_.front();
+            deleted = this->at(0);
+            this->popFront();
         }
-        this->buffer_.push_back(item);
+        this->emplaceBack(item);
         return full;
     }
 
@@ -149,8 +239,12 @@ public:
     {
         std::unique_lock lock(this->mutex_);
 
-        bool full = this->buffer_.full();
-        this->buffer_.push_back(item);
+        bool full = this->size_ == this->limit_;
+        if (full)
+        {
+            this->popFront();
+        }
+        this->emplaceBack(item);
         return full;
     }
 
@@ -176,7 +270,13 @@ public:
         size_t b = items.size() - 1;
         for (; f < items.size(); ++f, --b)
         {
-            this->buffer_.push_front(items[b]);
+            this->prepareWrite(this->head_ - 1);
+            this->head_--;
+            this->size_++;
+            this->at(0) = items[b];
+            // Items at the front are older than the ones already indexed
+            this->indexItem(items[b], false);
+            this->groupItem(this->head_, items[b]);
             pushed.push_back(items[f]);
         }
 
@@ -197,11 +297,11 @@ public:
         std::unique_lock lock(this->mutex_);
 
         Equals eq;
-        for (size_t i = 0; i < this->buffer_.size(); ++i)
+        for (size_t i = 0; i < this->size_; ++i)
         {
-            if (eq(this->buffer_[i], needle))
+            if (eq(this->at(i), needle))
             {
-                this->buffer_[i] = replacement;
+                this->replaceAt(i, replacement);
                 return static_cast<int>(i);
             }
         }
@@ -220,19 +320,16 @@ public:
     {
         std::unique_lock lock(this->mutex_);
 
-        if (index >= this->buffer_.size())
+        if (index >= this->size_)
         {
             return false;
         }
 
         if (prev)
         {
-            *prev = std::exchange(this->buffer_[index], replacement);
-        }
-        else
-        {
-            this->buffer_[index] = replacement;
+            *prev = this->at(index);
         }
+        this->replaceAt(index, replacement);
         return true;
     }
 
@@ -248,17 +345,17 @@ public:
     {
         std::unique_lock lock(this->mutex_);
 
-        if (hint < this->buffer_.size() && this->buffer_[hint] == needle)
+        if (hint < this->size_ && this->at(hint) == needle)
         {
-            this->buffer_[hint] = replacement;
+            this->replaceAt(hint, replacement);
             return static_cast<int>(hint);
         }
 
-        for (size_t i = 0; i < this->buffer_.size(); ++i)
+        for (size_t i = 0; i < this->size_; ++i)
         {
-            if (this->buffer_[i] == needle)
+            if (this->at(i) == needle)
             {
-                this->buffer_[i] = replacement;
+                this->replaceAt(i, replacement);
                 return static_cast<int>(i);
             }
         }
@@ -279,11 +376,11 @@ public:
         std::unique_lock lock(this->mutex_);
 
         Equals eq;
-        for (auto it = this->buffer_.begin(); it != this->buffer_.end(); ++it)
+        for (size_t i = 0; i < this->size_; ++i)
         {
-            if (eq(*it, needle))
+            if (eq(this->at(i), needle))
             {
-                this->buffer_.insert(it, item);
+                this->insertAt(i, item);
                 return true;
             }
         }
@@ -305,12 +402,12 @@ public:
         std::unique_lock lock(this->mutex_);
 
         Equals eq;
-        for (auto it = this->buffer_.begin(); it != this->buffer_.end(); ++it)
+        for (size_t i = 0; i < this->size_; ++i)
         {
-            if (eq(*it, needle))
+            if (eq(this->at(i), needle))
             {
-                ++it;  // advance to insert after it
-                this->buffer_.insert(it, item);
+                // insert after it
+                this->insertAt(i + 1, item);
                 return true;
             }
         }
@@ -318,10 +415,43 @@ public:
         return false;
     }
 
+    /**
+     * @brief Returns a snapshot of the current items
+     *
+     * This doesn't copy any items, the snapshot shares the queue's storage.
+     */
     [[nodiscard]] LimitedQueueSnapshot<T> getSnapshot() const
     {
-        std::shared_lock lock(this->mutex_);
-        return LimitedQueueSnapshot<T>(this->buffer_);
+        // Snapshots are tracked, so this needs exclusive access
+        std::unique_lock lock(this->mutex_);
+
+        if (this->size_ == 0)
+        {
+            return {};
+        }
+
+        // Without changes since the last snapshot, its range can be shared
+        std::shared_ptr<const std::vector<T>> owner;
+        if (!this->snapshots_.empty() &&
+            this->snapshots_.back().version == this->version_)
+        {
+            owner = this->snapshots_.back().owner.lock();
+        }
+        if (!owner)
+        {
+            // The owner has its own reference count, which tells us when all
+            // copies of this snapshot are gone
+            owner = std::shared_ptr<const std::vector<T>>(
+                this->storage_.get(), [storage = this->storage_](auto *) {});
+            this->snapshots_.push_back({
+                .owner = owner,
+                .begin = this->head_,
+                .end = this->head_ + this->size_,
+                .version = this->version_,
+            });
+        }
+
+        return {std::move(owner), this->slot(this->head_), this->size_};
     }
 
     // Actions
@@ -342,8 +472,9 @@ public:
     {
         std::shared_lock lock(this->mutex_);
 
-        for (const auto &item : this->buffer_)
+        for (size_t i = 0; i < this->size_; ++i)
         {
+            const auto &item = this->at(i);
             if (pred(item))
             {
                 return item;
@@ -364,16 +495,16 @@ public:
     {
         std::unique_lock lock(this->mutex_);
 
-        if (hint < this->buffer_.size() && predicate(this->buffer_[hint]))
+        if (hint < this->size_ && predicate(this->at(hint)))
         {
-            return std::pair{hint, this->buffer_[hint]};
+            return std::pair{hint, this->at(hint)};
         };
 
-        for (size_t i = 0; i < this->buffer_.size(); i++)
+        for (size_t i = 0; i < this->size_; i++)
         {
-            if (predicate(this->buffer_[i]))
+            if (predicate(this->at(i)))
             {
-                return std::pair{i, this->buffer_[i]};
+                return std::pair{i, this->at(i)};
             }
         }
         return std::nullopt;
@@ -395,22 +526,337 @@ public:
     {
         std::shared_lock lock(this->mutex_);
 
-        for (auto it = this->buffer_.rbegin(); it != this->buffer_.rend(); ++it)
+        for (size_t i = this->size_; i > 0; --i)
         {
-            if (pred(*it))
+            const auto &item = this->at(i - 1);
+            if (pred(item))
             {
-                return *it;
+                return item;
             }
         }
 
         return std::nullopt;
     }
 
+    /**
+     * @brief Returns the newest item with the given key
+     *
+     * Only available if the queue was declared with a `KeyOf`.
+     *
+     * @param[in] key the key to look for
+     * @return the item or std::nullopt if no item has this key
+     */
+    template <typename Key>
+    [[nodiscard]] std::optional<T> findByKey(const Key &key) const
+        requires HAS_INDEX
+    {
+        std::shared_lock lock(this->mutex_);
+
+        auto it = this->index_.items.find(key);
+        if (it == this->index_.items.end())
+        {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    /**
+     * @brief Returns all items in the given group from front to back
+     *
+     * Only available if the queue was declared with a `GroupOf`.
+     *
+     * @param[in] key the key of the group
+     * @return the items in the group, empty if there are none
+     */
+    template <typename Key>
+    [[nodiscard]] std::vector<T> findAllInGroup(const Key &key) const
+        requires HAS_GROUPS
+    {
+        std::shared_lock lock(this->mutex_);
+
+        std::vector<T> items;
+        auto it = this->groups_.positions.find(key);
+        if (it == this->groups_.positions.end())
+        {
+            return items;
+        }
+
+        items.reserve(it->second.size());
+        for (auto pos : it->second)
+        {
+            items.push_back(this->at(pos - this->head_));
+        }
+        return items;
+    }
+
 private:
+    /// Returns the slot in the storage of the logical position `pos`
+    size_t slot(size_t pos) const
+    {
+        return pos % this->capacity_;
+    }
+
+    /// Returns the item at `index`. The lock must be held.
+    T &at(size_t index)
+    {
+        return (*this->storage_)[this->slot(this->head_ + index)];
+    }
+
+    const T &at(size_t index) const
+    {
+        return (*this->storage_)[this->slot(this->head_ + index)];
+    }
+
+    /// Forgets snapshots that are gone and returns true if any are left.
+    /// The lock must be held.
+    bool hasSnapshots() const
+    {
+        std::erase_if(this->snapshots_, [](const auto &snapshot) {
+            return snapshot.owner.expired();
+        });
+        // Reads of dropped snapshots happen before our writes to their slots
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return !this->snapshots_.empty();
+    }
+
+    /// Returns true if a snapshot can see the slot of the logical position
+    /// `pos`. The lock must be held.
+    bool isVisibleToSnapshots(size_t pos) const
+    {
+        if (!this->hasSnapshots())
+        {
+            return false;
+        }
+
+        for (const auto &snapshot : this->snapshots_)
+        {
+            // The first position in the snapshot that uses the same slot
+            auto first = snapshot.begin +
+                         (this->slot(pos) + this->capacity_ -
+                          this->slot(snapshot.begin)) %
+                             this->capacity_;
+            if (first < snapshot.end)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Moves the items to new storage, leaving the old one to the snapshots.
+    /// The lock must be held.
+    void detach()
+    {
+        auto storage = std::make_shared<std::vector<T>>(this->capacity_);
+        for (size_t i = 0; i < this->size_; i++)
+        {
+            auto pos = this->slot(this->head_ + i);
+            (*storage)[pos] = (*this->storage_)[pos];
+        }
+        this->storage_ = std::move(storage);
+        this->snapshots_.clear();
+    }
+
+    /// Makes sure the slot of the logical position `pos` can be written
+    /// without changing any snapshot. The lock must be held.
+    void prepareWrite(size_t pos)
+    {
+        this->version_++;
+        if (this->isVisibleToSnapshots(pos))
+        {
+            this->detach();
+        }
+    }
+
+    /// Removes the first item. The lock must be held.
+    void popFront()
+    {
+        this->version_++;
+        this->unindexItem(this->at(0));
+        this->ungroupItem(this->head_, this->at(0));
+        if (!this->isVisibleToSnapshots(this->head_))
+        {
+            // Release the item now instead of when the slot is reused
+            this->at(0) = T{};
+        }
+        this->head_++;
+        this->size_--;
+    }
+
+    /// Appends an item, there must be space for it. The lock must be held.
+    void emplaceBack(const T &item)
+    {
+        assert(this->size_ < this->limit_);
+
+        this->prepareWrite(this->head_ + this->size_);
+        this->size_++;
+        this->at(this->size_ - 1) = item;
+        this->indexItem(item, true);
+        this->groupItem(this->head_ + this->size_ - 1, item);
+    }
+
+    /// Replaces the item at `index`. The lock must be held.
+    void replaceAt(size_t index, const T &replacement)
+    {
+        this->prepareWrite(this->head_ + index);
+        this->unindexItem(this->at(index));
+        this->ungroupItem(this->head_ + index, this->at(index));
+        this->at(index) = replacement;
+        this->indexItem(replacement, true);
+        this->groupItem(this->head_ + index, replacement);
+    }
+
+    /// Inserts an item before the one at `index`. The lock must be held.
+    void insertAt(size_t index, const T &item)
+    {
+        if (this->size_ == this->limit_)
+        {
+            if (index == 0)
+            {
+                // The item would be removed right away
+                return;
+            }
+            // The first item is removed to make room
+            this->popFront();
+            index--;
+        }
+
+        // All items after `index` move, so snapshots can't keep sharing
+        this->version_++;
+        if (this->hasSnapshots())
+        {
+            this->detach();
+        }
+
+        this->size_++;
+        for (size_t i = this->size_ - 1; i > index; i--)
+        {
+            this->at(i) = std::move(this->at(i - 1));
+        }
+        this->at(index) = item;
+        this->indexItem(item, false);
+
+        if constexpr (HAS_GROUPS)
+        {
+            // The positions of all following items changed
+            this->groups_.positions.clear();
+            for (size_t i = 0; i < this->size_; i++)
+            {
+                this->groupItem(this->head_ + i, this->at(i));
+            }
+        }
+    }
+
+    /// Adds `item` to the index. If another item has the same key, it's only
+    /// replaced if `overwrite` is true. The lock must be held.
+    void indexItem(const T &item, bool overwrite)
+    {
+        if constexpr (HAS_INDEX)
+        {
+            if (overwrite)
+            {
+                this->index_.items.insert_or_assign(KeyOf{}(item), item);
+            }
+            else
+            {
+                this->index_.items.try_emplace(KeyOf{}(item), item);
+            }
+        }
+    }
+
+    /// Removes `item` from the index if it's the indexed item for its key.
+    /// The lock must be held.
+    void unindexItem(const T &item)
+    {
+        if constexpr (HAS_INDEX)
+        {
+            auto it = this->index_.items.find(KeyOf{}(item));
+            if (it != this->index_.items.end() && it->second == item)
+            {
+                this->index_.items.erase(it);
+            }
+        }
+    }
+
+    /// Adds the item at the logical position `pos` to its groups.
+    /// The lock must be held.
+    void groupItem(size_t pos, const T &item)
+    {
+        if constexpr (HAS_GROUPS)
+        {
+            for (const auto &key : GroupOf{}(item))
+            {
+                if (key == typename decltype(this->groups_)::Key{})
+                {
+                    continue;
+                }
+
+                auto &positions = this->groups_.positions[key];
+                if (positions.empty() || positions.back() < pos)
+                {
+                    // Items are usually appended
+                    positions.push_back(pos);
+                }
+                else
+                {
+                    positions.insert(std::ranges::lower_bound(positions, pos),
+                                     pos);
+                }
+            }
+        }
+    }
+
+    /// Removes the item at the logical position `pos` from its groups.
+    /// The lock must be held.
+    void ungroupItem(size_t pos, const T &item)
+    {
+        if constexpr (HAS_GROUPS)
+        {
+            for (const auto &key : GroupOf{}(item))
+            {
+                auto it = this->groups_.positions.find(key);
+                if (it == this->groups_.positions.end())
+                {
+                    continue;
+                }
+
+                auto &positions = it->second;
+                auto posIt = std::ranges::lower_bound(positions, pos);
+                if (posIt != positions.end() && *posIt == pos)
+                {
+                    positions.erase(posIt);
+                }
+                if (positions.empty())
+                {
+                    this->groups_.positions.erase(it);
+                }
+            }
+        }
+    }
+
     mutable std::shared_mutex mutex_;
 
+    struct SnapshotRange {
+        std::weak_ptr<const std::vector<T>> owner;
+        // Logical positions of the items in the snapshot
+        size_t begin;
+        size_t end;
+        size_t version;
+    };
+
     const size_t limit_;
-    boost::circular_buffer<T> buffer_;
+    const size_t capacity_;
+
+    std::shared_ptr<std::vector<T>> storage_;
+    // Logical position of the first item, its slot is `slot(head_)`
+    size_t head_;
+    size_t size_ = 0;
+    // Incremented on every change
+    size_t version_ = 0;
+
+    mutable std::vector<SnapshotRange> snapshots_;
+    detail::LimitedQueueIndex<T, KeyOf> index_;
+    detail::LimitedQueueGroups<T, GroupOf> groups_;
 };
 
 }  // namespace chatterino
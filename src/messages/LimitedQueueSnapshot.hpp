@@ -1,62 +1,191 @@
 #pragma once
 
-#include <boost/circular_buffer.hpp>
-
 #include <cassert>
+#include <compare>
+#include <cstddef>
+#include <iterator>
 #include <memory>
 #include <vector>
 
 namespace chatterino {
 
-template <typename T>
+template <typename T, typename KeyOf, typename GroupOf>
 class LimitedQueue;
 
+/// An immutable view of the items of a LimitedQueue at the time it was taken.
+///
+/// Snapshots share their storage with the queue, so taking or copying one
+/// doesn't copy any items.
 template <typename T>
 class LimitedQueueSnapshot
 {
 private:
-    friend class LimitedQueue<T>;
+    template <typename, typename, typename>
+    friend class LimitedQueue;
 
-    LimitedQueueSnapshot(const boost::circular_buffer<T> &buf)
-        : buffer_(buf.begin(), buf.end())
+    LimitedQueueSnapshot(std::shared_ptr<const std::vector<T>> storage,
+                         size_t start, size_t size)
+        : storage_(std::move(storage))
+        , start_(start)
+        , size_(size)
     {
+        assert(this->start_ < this->storage_->size());
+        assert(this->size_ <= this->storage_->size());
     }
 
 public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        Iterator() = default;
+
+        reference operator*() const
+        {
+            return (*this->snapshot_)[this->index_];
+        }
+
+        pointer operator->() const
+        {
+            return &**this;
+        }
+
+        reference operator[](difference_type n) const
+        {
+            return *(*this + n);
+        }
+
+        Iterator &operator++()
+        {
+            ++this->index_;
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            auto copy = *this;
+            ++this->index_;
+            return copy;
+        }
+
+        Iterator &operator--()
+        {
+            --this->index_;
+            return *this;
+        }
+
+        Iterator operator--(int)
+        {
+            auto copy = *this;
+            --this->index_;
+            return copy;
+        }
+
+        Iterator &operator+=(difference_type n)
+        {
+            this->index_ += n;
+            return *this;
+        }
+
+        Iterator &operator-=(difference_type n)
+        {
+            this->index_ -= n;
+            return *this;
+        }
+
+        friend Iterator operator+(Iterator it, difference_type n)
+        {
+            return it += n;
+        }
+
+        friend Iterator operator+(difference_type n, Iterator it)
+        {
+            return it += n;
+        }
+
+        friend Iterator operator-(Iterator it, difference_type n)
+        {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const Iterator &a, const Iterator &b)
+        {
+            return static_cast<difference_type>(a.index_) -
+                   static_cast<difference_type>(b.index_);
+        }
+
+        bool operator==(const Iterator &other) const
+        {
+            return this->index_ == other.index_;
+        }
+
+        auto operator<=>(const Iterator &other) const
+        {
+            return this->index_ <=> other.index_;
+        }
+
+    private:
+        friend class LimitedQueueSnapshot;
+
+        Iterator(const LimitedQueueSnapshot *snapshot, size_t index)
+            : snapshot_(snapshot)
+            , index_(index)
+        {
+        }
+
+        const LimitedQueueSnapshot *snapshot_ = nullptr;
+        size_t index_ = 0;
+    };
+
     LimitedQueueSnapshot() = default;
 
     size_t size() const
     {
-        return this->buffer_.size();
+        return this->size_;
     }
 
     const T &operator[](size_t index) const
     {
-        return this->buffer_[index];
+        assert(index < this->size_);
+
+        // The items wrap around at the end of the storage
+        auto pos = this->start_ + index;
+        if (pos >= this->storage_->size())
+        {
+            pos -= this->storage_->size();
+        }
+        return (*this->storage_)[pos];
     }
 
-    auto begin() const
+    Iterator begin() const
     {
-        return this->buffer_.begin();
+        return {this, 0};
     }
 
-    auto end() const
+    Iterator end() const
     {
-        return this->buffer_.end();
+        return {this, this->size_};
     }
 
     auto rbegin() const
     {
-        return this->buffer_.rbegin();
+        return std::reverse_iterator(this->end());
     }
 
     auto rend() const
     {
-        return this->buffer_.rend();
+        return std::reverse_iterator(this->begin());
     }
 
 private:
-    std::vector<T> buffer_;
+    std::shared_ptr<const std::vector<T>> storage_;
+    size_t start_ = 0;
+    size_t size_ = 0;
 };
 
 }  // namespace chatterino
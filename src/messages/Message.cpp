@@ -6,14 +6,51 @@
 #include "providers/colors/ColorProvider.hpp"
 #include "providers/twitch/TwitchBadge.hpp"
 #include "singletons/Settings.hpp"
-#include "util/DebugCount.hpp"
+#include "util/Metrics.hpp"
 #include "util/QMagicEnum.hpp"
+#include "util/StringPool.hpp"
 #include "widgets/helper/ScrollbarHighlight.hpp"
 
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QJsonValue>
 
+#include <atomic>
+
+namespace {
+
+using namespace chatterino;
+
+const metrics::Counter MESSAGE_BYTES("message bytes", metrics::Unit::Bytes);
+const metrics::Gauge BYTES_PER_MESSAGE("bytes per message",
+                                       metrics::Unit::Bytes);
+const metrics::Counter MESSAGES("messages");
+
+/// The heap memory of `string` unless it's shared with other strings
+size_t ownedSize(const QString &string)
+{
+    if (!string.isDetached())
+    {
+        return 0;
+    }
+    return static_cast<size_t>(string.capacity()) * sizeof(QChar);
+}
+
+/// Updates the "message bytes" and "bytes per message" debug counts
+void reportSize(int64_t bytes, int64_t messages)
+{
+    static std::atomic<int64_t> totalBytes = 0;
+    static std::atomic<int64_t> totalMessages = 0;
+
+    auto newBytes = totalBytes += bytes;
+    auto newMessages = totalMessages += messages;
+
+    MESSAGE_BYTES.increase(bytes);
+    BYTES_PER_MESSAGE.set(newMessages > 0 ? newBytes / newMessages : 0);
+}
+
+}  // namespace
+
 namespace chatterino {
 
 using namespace literals;
@@ -21,12 +58,80 @@ using namespace literals;
 Message::Message()
     : parseTime(QTime::currentTime())
 {
-    DebugCount::increase("messages");
+    MESSAGES.increase();
 }
 
 Message::~Message()
 {
-    DebugCount::decrease("messages");
+    MESSAGES.decrease();
+
+    if (this->reportedSize_ > 0)
+    {
+        reportSize(-static_cast<int64_t>(this->reportedSize_), -1);
+    }
+}
+
+void Message::compact()
+{
+    auto &pool = StringPool::instance();
+    pool.internInPlace(this->loginName);
+    pool.internInPlace(this->displayName);
+    pool.internInPlace(this->localizedName);
+    pool.internInPlace(this->userID);
+    pool.internInPlace(this->channelName);
+
+    for (auto &badge : this->badges)
+    {
+        pool.internInPlace(badge.key_);
+        pool.internInPlace(badge.value_);
+    }
+
+    if (!this->badgeInfos.empty())
+    {
+        std::unordered_map<QString, QString> badgeInfos;
+        badgeInfos.reserve(this->badgeInfos.size());
+        for (const auto &[key, value] : this->badgeInfos)
+        {
+            badgeInfos.emplace(pool.intern(key), pool.intern(value));
+        }
+        this->badgeInfos = std::move(badgeInfos);
+    }
+
+    if (this->reportedSize_ == 0)
+    {
+        this->reportedSize_ = this->estimateSize();
+        reportSize(static_cast<int64_t>(this->reportedSize_), 1);
+    }
+}
+
+size_t Message::estimateSize() const
+{
+    size_t size = sizeof(Message) + this->elementArena.reservedBytes() +
+                  this->elements.capacity() * sizeof(this->elements[0]);
+
+    for (const auto *string :
+         {&this->id, &this->searchText, &this->messageText, &this->loginName,
+          &this->displayName, &this->localizedName, &this->userID,
+          &this->timeoutUser, &this->channelName})
+    {
+        size += ownedSize(*string);
+    }
+
+    size += this->badges.capacity() * sizeof(Badge);
+    for (const auto &badge : this->badges)
+    {
+        size += ownedSize(badge.key_) + ownedSize(badge.value_);
+    }
+
+    // Each node of the map holds the pair and the next pointer
+    size += this->badgeInfos.bucket_count() * sizeof(void *);
+    for (const auto &[key, value] : this->badgeInfos)
+    {
+        size += sizeof(void *) + sizeof(std::pair<const QString, QString>) +
+                ownedSize(key) + ownedSize(value);
+    }
+
+    return size;
 }
 
 ScrollbarHighlight Message::getScrollBarHighlight() const
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "messages/MessageElementArena.hpp"
 #include "messages/MessageFlag.hpp"
 #include "providers/twitch/ChannelPointReward.hpp"
 #include "util/QStringHash.hpp"
@@ -7,8 +8,10 @@
 #include <QColor>
 #include <QTime>
 
+#include <array>
 #include <cinttypes>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -34,8 +37,9 @@ struct Message {
     Message &operator=(Message &&) = delete;
 
     // Making this a mutable means that we can update a messages flags,
-    // while still keeping Message constant. This means that a message's flag
-    // can be updated without the renderer being made aware, which might be bad.
+    // while still keeping Message constant. The renderer isn't made aware of
+    // changes, but a MessageLayout notices changed flags the next time it's
+    // laid out (see WindowManager::layoutChannelViews).
     // This is a temporary effort until we can figure out what the right
     // const-correct way to deal with this is.
     // This might bring race conditions with it
@@ -96,18 +100,42 @@ struct Message {
     /// true.
     mutable bool frozen = false;
 
+    /// Holds the elements added with MessageBuilder::emplace. It's declared
+    /// before `elements`, so it outlives them.
+    MessageElementArena elementArena;
     std::vector<std::unique_ptr<MessageElement>> elements;
 
     ScrollbarHighlight getScrollBarHighlight() const;
 
     std::shared_ptr<ChannelPointReward> reward = nullptr;
 
+    /// Bigram counts of messageText used to skip similarity checks that
+    /// can't succeed. Computed on first use, see makeSimilaritySketch.
+    mutable std::once_flag similaritySketchOnce;
+    mutable std::array<uint16_t, 32> similaritySketch{};
+
     QJsonObject toJson() const;
 
     void freeze() const
     {
         this->frozen = true;
     }
+
+    /// @brief Shares the channel, user and badge strings with other messages
+    ///
+    /// This also reports the size of the message to the "message bytes" and
+    /// "bytes per message" debug counts. It's called once the message is built
+    /// (see MessageBuilder::release).
+    void compact();
+
+    /// @brief Estimates the memory used by this message alone
+    ///
+    /// Strings shared with other messages (e.g. interned ones) and memory
+    /// owned by the elements aren't included.
+    size_t estimateSize() const;
+
+private:
+    size_t reportedSize_ = 0;
 };
 
 }  // namespace chatterino
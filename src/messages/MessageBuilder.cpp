@@ -5,11 +5,16 @@
 #include "common/Literals.hpp"
 #include "common/QLogging.hpp"
 #include "controllers/accounts/AccountController.hpp"
+#include "controllers/highlights/HighlightBlacklistUser.hpp"
 #include "controllers/highlights/HighlightController.hpp"
 #include "controllers/ignores/IgnoreController.hpp"
 #include "controllers/ignores/IgnorePhrase.hpp"
+#include "controllers/nicknames/Nickname.hpp"
 #include "controllers/userdata/UserDataController.hpp"
+#include "debug/AssertInGuiThread.hpp"
+#include "debug/Trace.hpp"
 #include "messages/Emote.hpp"
+#include "messages/EmoteIndex.hpp"
 #include "messages/Image.hpp"
 #include "messages/Message.hpp"
 #include "messages/MessageColor.hpp"
@@ -20,7 +25,6 @@
 #include "providers/colors/ColorProvider.hpp"
 #include "providers/ffz/FfzBadges.hpp"
 #include "providers/ffz/FfzEmotes.hpp"
-#include "providers/links/LinkResolver.hpp"
 #include "providers/seventv/SeventvBadges.hpp"
 #include "providers/seventv/SeventvEmotes.hpp"
 #include "providers/twitch/api/Helix.hpp"
@@ -30,6 +34,7 @@
 #include "providers/twitch/TwitchBadges.hpp"
 #include "providers/twitch/TwitchChannel.hpp"
 #include "providers/twitch/TwitchIrc.hpp"
+#include "providers/twitch/TwitchIrcLine.hpp"
 #include "providers/twitch/TwitchIrcServer.hpp"
 #include "providers/twitch/TwitchUsers.hpp"
 #include "providers/twitch/UserColor.hpp"
@@ -42,6 +47,7 @@
 #include "util/FormatTime.hpp"
 #include "util/Helpers.hpp"
 #include "util/IrcHelpers.hpp"
+#include "util/Metrics.hpp"
 #include "util/QStringHash.hpp"
 #include "util/Variant.hpp"
 #include "widgets/Window.hpp"
@@ -78,6 +84,8 @@ const QRegularExpression allUsernamesMentionRegex("^" + regexHelpString);
 
 const QRegularExpression SPACE_REGEX("\\s");
 
+const metrics::Histogram MESSAGE_BUILD_TIME("message build time");
+
 struct HypeChatPaidLevel {
     std::chrono::seconds duration;
     uint8_t numeric;
@@ -184,7 +192,8 @@ void actuallyTriggerHighlights(const QString &channelName, bool playSound,
     }
 }
 
-QString stylizeUsername(const QString &username, const Message &message)
+QString stylizeUsername(const QString &username, const Message &message,
+                        const MessageBuildContext &context)
 {
     const QString &localizedName = message.localizedName;
     bool hasLocalizedName = !localizedName.isEmpty();
@@ -192,7 +201,7 @@ QString stylizeUsername(const QString &username, const Message &message)
     // The full string that will be rendered in the chat widget
     QString usernameText;
 
-    switch (getSettings()->usernameDisplayMode.getValue())
+    switch (context.usernameDisplayMode)
     {
         case UsernameDisplayMode::Username: {
             usernameText = username;
@@ -225,16 +234,20 @@ QString stylizeUsername(const QString &username, const Message &message)
         break;
     }
 
-    if (auto nicknameText = getSettings()->matchNickname(usernameText))
+    for (const auto &nickname : *context.nicknames)
     {
-        usernameText = *nicknameText;
+        if (auto nicknameText = nickname.match(usernameText))
+        {
+            return *nicknameText;
+        }
     }
 
     return usernameText;
 }
 
 std::optional<EmotePtr> getTwitchBadge(const Badge &badge,
-                                       const TwitchChannel *twitchChannel)
+                                       const TwitchChannel *twitchChannel,
+                                       const TwitchBadges &globalBadges)
 {
     if (auto channelBadge =
             twitchChannel->twitchBadge(badge.key_, badge.value_))
@@ -242,8 +255,7 @@ std::optional<EmotePtr> getTwitchBadge(const Badge &badge,
         return channelBadge;
     }
 
-    if (auto globalBadge =
-            getApp()->getTwitchBadges()->badge(badge.key_, badge.value_))
+    if (auto globalBadge = globalBadges.badge(badge.key_, badge.value_))
     {
         return globalBadge;
     }
@@ -253,7 +265,8 @@ std::optional<EmotePtr> getTwitchBadge(const Badge &badge,
 
 void appendBadges(MessageBuilder *builder, const std::vector<Badge> &badges,
                   const std::unordered_map<QString, QString> &badgeInfos,
-                  const TwitchChannel *twitchChannel)
+                  const TwitchChannel *twitchChannel,
+                  const MessageBuildContext &context)
 {
     if (twitchChannel == nullptr)
     {
@@ -262,7 +275,8 @@ void appendBadges(MessageBuilder *builder, const std::vector<Badge> &badges,
 
     for (const auto &badge : badges)
     {
-        auto badgeEmote = getTwitchBadge(badge, twitchChannel);
+        auto badgeEmote =
+            getTwitchBadge(badge, twitchChannel, *context.twitchBadges);
         if (!badgeEmote)
         {
             continue;
@@ -275,7 +289,7 @@ void appendBadges(MessageBuilder *builder, const std::vector<Badge> &badges,
             tooltip = QString("Twitch cheer %0").arg(cheerAmount);
         }
         else if (badge.key_ == "moderator" &&
-                 getSettings()->useCustomFfzModeratorBadges)
+                 context.useCustomFfzModeratorBadges)
         {
             if (auto customModBadge = twitchChannel->ffzCustomModBadge())
             {
@@ -288,7 +302,7 @@ void appendBadges(MessageBuilder *builder, const std::vector<Badge> &badges,
                 continue;
             }
         }
-        else if (badge.key_ == "vip" && getSettings()->useCustomFfzVipBadges)
+        else if (badge.key_ == "vip" && context.useCustomFfzVipBadges)
         {
             if (auto customVipBadge = twitchChannel->ffzCustomVipBadge())
             {
@@ -417,7 +431,7 @@ EmotePtr makeSharedChatBadge(const QString &sourceName,
 }
 
 std::tuple<std::optional<EmotePtr>, MessageElementFlags> parseEmote(
-    TwitchChannel *twitchChannel, const EmoteName &name)
+    const EmoteIndex *channelEmotes, const EmoteName &name)
 {
     // Emote order:
     //  - FrankerFaceZ Channel
@@ -426,51 +440,36 @@ std::tuple<std::optional<EmotePtr>, MessageElementFlags> parseEmote(
     //  - FrankerFaceZ Global
     //  - BetterTTV Global
     //  - 7TV Global
+    //
+    // A channel's emote index already contains all of these in this order.
 
-    const auto *globalFfzEmotes = getApp()->getFfzEmotes();
-    const auto *globalBttvEmotes = getApp()->getBttvEmotes();
-    const auto *globalSeventvEmotes = getApp()->getSeventvEmotes();
-
-    std::optional<EmotePtr> emote{};
-
-    if (twitchChannel != nullptr)
+    if (channelEmotes != nullptr)
     {
-        // Check for channel emotes
-
-        emote = twitchChannel->ffzEmote(name);
-        if (emote)
+        const auto *entry = channelEmotes->find(name.string);
+        if (entry == nullptr)
         {
-            return {emote, MessageElementFlag::FfzEmote};
-        }
-
-        emote = twitchChannel->bttvEmote(name);
-        if (emote)
-        {
-            return {emote, MessageElementFlag::BttvEmote};
-        }
-
-        emote = twitchChannel->seventvEmote(name);
-        if (emote)
-        {
-            return {emote, MessageElementFlag::SevenTVEmote};
+            return {{}, {}};
         }
+        return {entry->emote, entry->flag};
     }
 
     // Check for global emotes
 
-    emote = globalFfzEmotes->emote(name);
+    std::optional<EmotePtr> emote{};
+
+    emote = getApp()->getFfzEmotes()->emote(name);
     if (emote)
     {
         return {emote, MessageElementFlag::FfzEmote};
     }
 
-    emote = globalBttvEmotes->emote(name);
+    emote = getApp()->getBttvEmotes()->emote(name);
     if (emote)
     {
         return {emote, MessageElementFlag::BttvEmote};
     }
 
-    emote = globalSeventvEmotes->globalEmote(name);
+    emote = getApp()->getSeventvEmotes()->globalEmote(name);
     if (emote)
     {
         return {emote, MessageElementFlag::SevenTVEmote};
@@ -483,6 +482,47 @@ std::tuple<std::optional<EmotePtr>, MessageElementFlags> parseEmote(
 
 namespace chatterino {
 
+MessageBuildContext MessageBuildContext::fromApp()
+{
+    assertInGuiThread();
+
+    auto *app = getApp();
+    MessageBuildContext context{
+        .currentUser = app->getAccounts()->twitch.getCurrent(),
+        .ignoredPhrases = getSettings()->ignoredMessages.readOnly(),
+        .nicknames = getSettings()->nicknames.readOnly(),
+        .blacklistedUsers = getSettings()->blacklistedUsers.readOnly(),
+        .usernameDisplayMode = getSettings()->usernameDisplayMode.getEnum(),
+        .colorizeNicknames = getSettings()->colorizeNicknames,
+        .findAllUsernames = getSettings()->findAllUsernames,
+        .stackBits = getSettings()->stackBits,
+        .enableZeroWidthEmotes = getSettings()->enableZeroWidthEmotes,
+        .useCustomFfzModeratorBadges =
+            getSettings()->useCustomFfzModeratorBadges,
+        .useCustomFfzVipBadges = getSettings()->useCustomFfzVipBadges,
+        .highlightInlineWhispers = getSettings()->highlightInlineWhispers,
+        .userData = app->getUserData(),
+        .highlights = app->getHighlights(),
+        .twitchBadges = app->getTwitchBadges(),
+        .ffzBadges = app->getFfzBadges(),
+        .chatterinoBadges = app->getChatterinoBadges(),
+        .seventvBadges = app->getSeventvBadges(),
+        .emojis = app->getEmotes()->getEmojis(),
+        .twitchEmotes = app->getEmotes()->getTwitchEmotes(),
+    };
+
+    // Replacements look up their emotes in the current account on first use
+    for (const auto &phrase : *context.ignoredPhrases)
+    {
+        if (!phrase.isBlock())
+        {
+            phrase.containsEmote();
+        }
+    }
+
+    return context;
+}
+
 MessagePtr makeSystemMessage(const QString &text)
 {
     return MessageBuilder(systemMessage, text).release();
@@ -960,6 +1000,10 @@ MessagePtrMut MessageBuilder::release()
 {
     std::shared_ptr<Message> ptr;
     this->message_.swap(ptr);
+    if (ptr)
+    {
+        ptr->compact();
+    }
     return ptr;
 }
 
@@ -968,6 +1012,11 @@ std::weak_ptr<const Message> MessageBuilder::weakOf()
     return this->message_;
 }
 
+MessageElementArena &MessageBuilder::elementArena()
+{
+    return this->message().elementArena;
+}
+
 void MessageBuilder::append(std::unique_ptr<MessageElement> element)
 {
     this->message().elements.push_back(std::move(element));
@@ -1011,8 +1060,6 @@ void MessageBuilder::addLink(const linkparser::Parsed &parsedLink,
         this->emplace<TextElement>(parsedLink.suffix(source).toString(),
                                    MessageElementFlag::Text, this->textColor_);
     }
-
-    getApp()->getLinkResolver()->resolve(el->linkInfo());
 }
 
 bool MessageBuilder::isIgnored(const QString &originalMessage,
@@ -1499,19 +1546,44 @@ MessagePtrMut MessageBuilder::makeClearChatMessage(const QDateTime &now,
 }
 
 std::pair<MessagePtrMut, HighlightAlert> MessageBuilder::makeIrcMessage(
-    /* mutable */ Channel *channel, const Communi::IrcMessage *ircMessage,
-    const MessageParseArgs &args, /* mutable */ QString content,
+    Channel *channel, const Communi::IrcMessage *ircMessage,
+    const MessageParseArgs &args, QString content,
     const QString::size_type messageOffset,
     const std::shared_ptr<MessageThread> &thread, const MessagePtr &parent)
 {
     assert(ircMessage != nullptr);
+
+    return MessageBuilder::makeIrcMessage(
+        channel, TwitchIrcLine::fromMessage(*ircMessage), args,
+        std::move(content), messageOffset, thread, parent);
+}
+
+std::pair<MessagePtrMut, HighlightAlert> MessageBuilder::makeIrcMessage(
+    Channel *channel, const TwitchIrcLine &ircMessage,
+    const MessageParseArgs &args, QString content,
+    const QString::size_type messageOffset,
+    const std::shared_ptr<MessageThread> &thread, const MessagePtr &parent)
+{
+    return MessageBuilder::makeIrcMessage(
+        MessageBuildContext::fromApp(), channel, ircMessage, args,
+        std::move(content), messageOffset, thread, parent);
+}
+
+std::pair<MessagePtrMut, HighlightAlert> MessageBuilder::makeIrcMessage(
+    const MessageBuildContext &context, /* mutable */ Channel *channel,
+    const TwitchIrcLine &ircMessage, const MessageParseArgs &args,
+    /* mutable */ QString content, const QString::size_type messageOffset,
+    const std::shared_ptr<MessageThread> &thread, const MessagePtr &parent)
+{
     assert(channel != nullptr);
 
-    auto tags = ircMessage->tags();
+    TRACE_ZONE("message build");
+    auto timer = MESSAGE_BUILD_TIME.time();
+
+    auto userID = ircMessage.tag(TwitchTag::UserId);
     if (args.allowIgnore)
     {
-        bool ignored = MessageBuilder::isIgnored(
-            content, tags.value("user-id").toString(), channel);
+        bool ignored = MessageBuilder::isIgnored(content, userID, channel);
         if (ignored)
         {
             return {};
@@ -1520,10 +1592,9 @@ std::pair<MessagePtrMut, HighlightAlert> MessageBuilder::makeIrcMessage(
 
     auto *twitchChannel = dynamic_cast<TwitchChannel *>(channel);
 
-    auto userID = tags.value("user-id").toString();
-
     MessageBuilder builder;
-    builder.parseUsernameColor(tags, userID);
+    builder.context_ = &context;
+    builder.parseUsernameColor(ircMessage, userID);
     builder->userID = userID;
 
     if (args.isAction)
@@ -1541,10 +1612,10 @@ std::pair<MessagePtrMut, HighlightAlert> MessageBuilder::makeIrcMessage(
 
     builder->channelName = channel->getName();
 
-    builder.parseMessageID(tags);
+    builder.parseMessageID(ircMessage);
 
-    MessageBuilder::parseRoomID(tags, twitchChannel);
-    twitchChannel = builder.parseSharedChatInfo(tags, twitchChannel);
+    MessageBuilder::parseRoomID(ircMessage, twitchChannel);
+    twitchChannel = builder.parseSharedChatInfo(ircMessage, twitchChannel);
 
     // If it is a reward it has to be appended first
     if (!args.channelPointRewardId.isEmpty())
@@ -1562,34 +1633,33 @@ std::pair<MessagePtrMut, HighlightAlert> MessageBuilder::makeIrcMessage(
 
     builder.appendChannelName(channel);
 
-    if (tags.contains("rm-deleted"))
+    if (ircMessage.hasTag(TwitchTag::RmDeleted))
     {
         builder->flags.set(MessageFlag::Disabled);
     }
 
-    if (tags.contains("msg-id") &&
-        tags["msg-id"].toString().split(';').contains("highlighted-message"))
+    if (ircMessage.rawTag(TwitchTag::MsgId) == "highlighted-message")
     {
         builder->flags.set(MessageFlag::RedeemedHighlight);
     }
 
-    if (tags.contains("first-msg") && tags["first-msg"].toString() == "1")
+    if (ircMessage.rawTag(TwitchTag::FirstMsg) == "1")
     {
         builder->flags.set(MessageFlag::FirstMessage);
     }
 
-    if (tags.contains("pinned-chat-paid-amount"))
+    if (ircMessage.hasTag(TwitchTag::PinnedChatPaidAmount))
     {
         builder->flags.set(MessageFlag::ElevatedMessage);
     }
 
-    if (tags.contains("bits"))
+    if (ircMessage.hasTag(TwitchTag::Bits))
     {
         builder->flags.set(MessageFlag::CheerMessage);
     }
 
     // reply threads
-    builder.parseThread(content, tags, channel, thread, parent);
+    builder.parseThread(content, ircMessage, channel, thread, parent);
 
     // timestamp
     builder->serverReceivedTime = calculateMessageTime(ircMessage);
@@ -1602,7 +1672,7 @@ std::pair<MessagePtrMut, HighlightAlert> MessageBuilder::makeIrcMessage(
             return false;
         }
 
-        if (tags.value("user-type").toString() == "mod" &&
+        if (ircMessage.rawTag(TwitchTag::UserType) == "mod" &&
             !args.isStaffOrBroadcaster)
         {
             // You cannot timeout moderators UNLESS you are Twitch Staff or the broadcaster of the channel
@@ -1616,32 +1686,38 @@ std::pair<MessagePtrMut, HighlightAlert> MessageBuilder::makeIrcMessage(
         builder.emplace<TwitchModerationElement>();
     }
 
-    builder.appendTwitchBadges(tags, twitchChannel);
+    builder.appendTwitchBadges(ircMessage, twitchChannel);
 
     builder.appendChatterinoBadges(userID);
     builder.appendFfzBadges(twitchChannel, userID);
     builder.appendSeventvBadges(userID);
 
-    builder.appendUsername(tags, args);
+    builder.appendUsername(ircMessage, args);
 
-    TextState textState{.twitchChannel = twitchChannel};
+    TextState textState{
+        .twitchChannel = twitchChannel,
+        .emoteIndex = context.emoteIndex,
+    };
+    if (!textState.emoteIndex && twitchChannel != nullptr)
+    {
+        textState.emoteIndex = twitchChannel->emoteIndex();
+    }
     QString bits;
 
-    auto iterator = tags.find("bits");
-    if (iterator != tags.end())
+    if (ircMessage.hasTag(TwitchTag::Bits))
     {
         textState.hasBits = true;
-        textState.bitsLeft = iterator.value().toInt();
-        bits = iterator.value().toString();
+        bits = ircMessage.tag(TwitchTag::Bits);
+        textState.bitsLeft = bits.toInt();
     }
 
     // Twitch emotes
     auto twitchEmotes =
-        parseTwitchEmotes(tags, content, static_cast<int>(messageOffset));
+        parseTwitchEmotes(ircMessage, content, static_cast<int>(messageOffset),
+                          *context.twitchEmotes);
 
     // This runs through all ignored phrases and runs its replacements on content
-    processIgnorePhrases(*getSettings()->ignoredMessages.readOnly(), content,
-                         twitchEmotes);
+    processIgnorePhrases(*context.ignoredPhrases, content, twitchEmotes);
 
     std::ranges::sort(twitchEmotes, [](const auto &a, const auto &b) {
         return a.start < b.start;
@@ -1658,7 +1734,7 @@ std::pair<MessagePtrMut, HighlightAlert> MessageBuilder::makeIrcMessage(
     builder.addWords(splits, twitchEmotes, textState);
 
     QString stylizedUsername =
-        stylizeUsername(builder->loginName, builder.message());
+        stylizeUsername(builder->loginName, builder.message(), context);
 
     builder->messageText = content;
     builder->searchText = stylizedUsername + " " + builder->localizedName +
@@ -1666,22 +1742,24 @@ std::pair<MessagePtrMut, HighlightAlert> MessageBuilder::makeIrcMessage(
                           builder->searchText;
 
     // highlights
-    HighlightAlert highlight = builder.parseHighlights(tags, content, args);
-    if (tags.contains("historical"))
+    HighlightAlert highlight =
+        builder.parseHighlights(ircMessage, content, args);
+    if (ircMessage.hasTag(TwitchTag::Historical))
     {
         highlight.playSound = false;
         highlight.windowAlert = false;
     }
 
     // highlighting incoming whispers if requested per setting
-    if (args.isReceivedWhisper && getSettings()->highlightInlineWhispers)
+    if (args.isReceivedWhisper && context.highlightInlineWhispers)
     {
         builder->flags.set(MessageFlag::HighlightedWhisper);
         builder->highlightColor =
             ColorProvider::instance().color(ColorType::Whisper);
     }
 
-    if (!args.isReceivedWhisper && tags.value("msg-id") != "announcement")
+    if (!args.isReceivedWhisper &&
+        ircMessage.rawTag(TwitchTag::MsgId) != "announcement")
     {
         if (thread)
         {
@@ -1724,7 +1802,7 @@ void MessageBuilder::addTextOrEmote(TextState &state, QString string)
     // Emote name: "forsenPuke" - if string in ignoredEmotes
     // Will match emote regardless of source (i.e. bttv, ffz)
     // Emote source + name: "bttv:nyanPls"
-    if (this->tryAppendEmote(state.twitchChannel, {string}))
+    if (this->tryAppendEmote(state, {string}))
     {
         // Successfully appended an emote
         return;
@@ -1775,7 +1853,7 @@ void MessageBuilder::addTextOrEmote(TextState &state, QString string)
         }
     }
 
-    if (state.twitchChannel != nullptr && getSettings()->findAllUsernames)
+    if (state.twitchChannel != nullptr && this->context_->findAllUsernames)
     {
         auto match = allUsernamesMentionRegex.match(string);
         QString username = match.captured(1);
@@ -1820,13 +1898,11 @@ MessageElement &MessageBuilder::back()
     return *this->message().elements.back();
 }
 
-std::unique_ptr<MessageElement> MessageBuilder::releaseBack()
+void MessageBuilder::popBack()
 {
     assert(!this->isEmpty());
 
-    auto ptr = std::move(this->message().elements.back());
     this->message().elements.pop_back();
-    return ptr;
 }
 
 TextElement *MessageBuilder::emplaceSystemTextAndUpdate(const QString &text,
@@ -1837,10 +1913,10 @@ TextElement *MessageBuilder::emplaceSystemTextAndUpdate(const QString &text,
                                       MessageColor::System);
 }
 
-void MessageBuilder::parseUsernameColor(const QVariantMap &tags,
+void MessageBuilder::parseUsernameColor(const TwitchIrcLine &line,
                                         const QString &userID)
 {
-    const auto *userData = getApp()->getUserData();
+    const auto *userData = this->context_->userData;
     assert(userData != nullptr);
 
     if (const auto &user = userData->getUser(userID))
@@ -1853,10 +1929,9 @@ void MessageBuilder::parseUsernameColor(const QVariantMap &tags,
         }
     }
 
-    const auto iterator = tags.find("color");
-    if (iterator != tags.end())
+    if (line.hasTag(TwitchTag::Color))
     {
-        if (const auto color = iterator.value().toString(); !color.isEmpty())
+        if (const auto color = line.tag(TwitchTag::Color); !color.isEmpty())
         {
             this->usernameColor_ = QColor(color);
             this->message().usernameColor = this->usernameColor_;
@@ -1864,23 +1939,24 @@ void MessageBuilder::parseUsernameColor(const QVariantMap &tags,
         }
     }
 
-    if (getSettings()->colorizeNicknames && tags.contains("user-id"))
+    if (this->context_->colorizeNicknames && line.hasTag(TwitchTag::UserId))
     {
-        this->usernameColor_ = getRandomColor(tags.value("user-id").toString());
+        this->usernameColor_ = getRandomColor(line.tag(TwitchTag::UserId));
         this->message().usernameColor = this->usernameColor_;
     }
 }
 
-void MessageBuilder::parseUsername(const Communi::IrcMessage *ircMessage,
+void MessageBuilder::parseUsername(const TwitchIrcLine &ircMessage,
                                    TwitchChannel *twitchChannel,
                                    bool trimSubscriberUsername)
 {
     // username
-    auto userName = ircMessage->nick();
+    auto nick = ircMessage.nick();
+    auto userName = nick;
 
     if (userName.isEmpty() || trimSubscriberUsername)
     {
-        userName = ircMessage->tag("login").toString();
+        userName = ircMessage.tag(TwitchTag::Login);
     }
 
     this->message_->loginName = userName;
@@ -1890,24 +1966,22 @@ void MessageBuilder::parseUsername(const Communi::IrcMessage *ircMessage,
     }
 
     // Update current user color if this is our message
-    auto currentUser = getApp()->getAccounts()->twitch.getCurrent();
-    if (ircMessage->nick() == currentUser->getUserName())
+    const auto &currentUser = this->context_->currentUser;
+    if (nick == currentUser->getUserName())
     {
         currentUser->setColor(this->message_->usernameColor);
     }
 }
 
-void MessageBuilder::parseMessageID(const QVariantMap &tags)
+void MessageBuilder::parseMessageID(const TwitchIrcLine &line)
 {
-    auto iterator = tags.find("id");
-
-    if (iterator != tags.end())
+    if (line.hasTag(TwitchTag::Id))
     {
-        this->message().id = iterator.value().toString();
+        this->message().id = line.tag(TwitchTag::Id);
     }
 }
 
-QString MessageBuilder::parseRoomID(const QVariantMap &tags,
+QString MessageBuilder::parseRoomID(const TwitchIrcLine &line,
                                     TwitchChannel *twitchChannel)
 {
     if (twitchChannel == nullptr)
@@ -1915,11 +1989,9 @@ QString MessageBuilder::parseRoomID(const QVariantMap &tags,
         return {};
     }
 
-    auto iterator = tags.find("room-id");
-
-    if (iterator != std::end(tags))
+    if (line.hasTag(TwitchTag::RoomId))
     {
-        auto roomID = iterator->toString();
+        auto roomID = line.tag(TwitchTag::RoomId);
         if (twitchChannel->roomId() != roomID)
         {
             if (twitchChannel->roomId().isEmpty())
@@ -1940,7 +2012,7 @@ QString MessageBuilder::parseRoomID(const QVariantMap &tags,
     return {};
 }
 
-TwitchChannel *MessageBuilder::parseSharedChatInfo(const QVariantMap &tags,
+TwitchChannel *MessageBuilder::parseSharedChatInfo(const TwitchIrcLine &line,
                                                    TwitchChannel *twitchChannel)
 {
     if (!twitchChannel)
@@ -1948,9 +2020,9 @@ TwitchChannel *MessageBuilder::parseSharedChatInfo(const QVariantMap &tags,
         return twitchChannel;
     }
 
-    if (auto it = tags.find("source-room-id"); it != tags.end())
+    if (line.hasTag(TwitchTag::SourceRoomId))
     {
-        auto sourceRoom = it.value().toString();
+        auto sourceRoom = line.tag(TwitchTag::SourceRoomId);
         if (twitchChannel->roomId() != sourceRoom)
         {
             this->message().flags.set(MessageFlag::SharedMessage);
@@ -1975,7 +2047,7 @@ TwitchChannel *MessageBuilder::parseSharedChatInfo(const QVariantMap &tags,
 }
 
 void MessageBuilder::parseThread(const QString &messageContent,
-                                 const QVariantMap &tags,
+                                 const TwitchIrcLine &line,
                                  const Channel *channel,
                                  const std::shared_ptr<MessageThread> &thread,
                                  const MessagePtr &parent)
@@ -2005,8 +2077,8 @@ void MessageBuilder::parseThread(const QString &messageContent,
             threadRoot = parent;
         }
 
-        QString usernameText =
-            stylizeUsername(threadRoot->loginName, *threadRoot);
+        QString usernameText = stylizeUsername(threadRoot->loginName,
+                                               *threadRoot, *this->context_);
 
         this->emplace<ReplyCurveElement>();
 
@@ -2035,15 +2107,13 @@ void MessageBuilder::parseThread(const QString &messageContent,
                 color, FontStyle::ChatMediumSmall)
             ->setLink({Link::ViewThread, thread->rootId()});
     }
-    else if (tags.find("reply-parent-msg-id") != tags.end())
+    else if (line.hasTag(TwitchTag::ReplyParentMsgId))
     {
         // Message is a reply but we couldn't find the original message.
         // Render the message using the additional reply tags
 
-        auto replyDisplayName = tags.find("reply-parent-display-name");
-        auto replyBody = tags.find("reply-parent-msg-body");
-
-        if (replyDisplayName != tags.end() && replyBody != tags.end())
+        if (line.hasTag(TwitchTag::ReplyParentDisplayName) &&
+            line.hasTag(TwitchTag::ReplyParentMsgBody))
         {
             QString body;
 
@@ -2053,7 +2123,7 @@ void MessageBuilder::parseThread(const QString &messageContent,
                 MessageColor::System, FontStyle::ChatMediumSmall);
 
             bool ignored = MessageBuilder::isIgnored(
-                messageContent, tags.value("reply-parent-user-id").toString(),
+                messageContent, line.tag(TwitchTag::ReplyParentUserId),
                 channel);
             if (ignored)
             {
@@ -2061,8 +2131,9 @@ void MessageBuilder::parseThread(const QString &messageContent,
             }
             else
             {
-                auto name = replyDisplayName->toString();
-                body = parseTagString(replyBody->toString());
+                auto name = line.tag(TwitchTag::ReplyParentDisplayName);
+                body =
+                    parseTagString(line.tag(TwitchTag::ReplyParentMsgBody));
 
                 this->emplace<TextElement>(
                         "@" + name + ":", MessageElementFlag::RepliedMessage,
@@ -2079,18 +2150,21 @@ void MessageBuilder::parseThread(const QString &messageContent,
     }
 }
 
-HighlightAlert MessageBuilder::parseHighlights(const QVariantMap &tags,
+HighlightAlert MessageBuilder::parseHighlights(const TwitchIrcLine &line,
                                                const QString &originalMessage,
                                                const MessageParseArgs &args)
 {
-    if (getSettings()->isBlacklistedUser(this->message().loginName))
+    for (const auto &blacklistedUser : *this->context_->blacklistedUsers)
     {
-        // Do nothing. We ignore highlights from this user.
-        return {};
+        if (blacklistedUser.isMatch(this->message().loginName))
+        {
+            // Do nothing. We ignore highlights from this user.
+            return {};
+        }
     }
 
-    auto badges = parseBadgeTag(tags);
-    auto [highlighted, highlightResult] = getApp()->getHighlights()->check(
+    auto badges = parseBadgeTag(line);
+    auto [highlighted, highlightResult] = this->context_->highlights->check(
         args, badges, this->message().loginName, originalMessage,
         this->message().flags);
 
@@ -2134,19 +2208,16 @@ void MessageBuilder::appendChannelName(const Channel *channel)
         ->setLink(link);
 }
 
-void MessageBuilder::appendUsername(const QVariantMap &tags,
+void MessageBuilder::appendUsername(const TwitchIrcLine &line,
                                     const MessageParseArgs &args)
 {
-    auto *app = getApp();
-
     QString username = this->message_->loginName;
     QString localizedName;
 
-    auto iterator = tags.find("display-name");
-    if (iterator != tags.end())
+    if (line.hasTag(TwitchTag::DisplayName))
     {
         QString displayName =
-            parseTagString(iterator.value().toString()).trimmed();
+            parseTagString(line.tag(TwitchTag::DisplayName)).trimmed();
 
         if (QString::compare(displayName, username, Qt::CaseInsensitive) == 0)
         {
@@ -2163,7 +2234,8 @@ void MessageBuilder::appendUsername(const QVariantMap &tags,
         }
     }
 
-    QString usernameText = stylizeUsername(username, this->message());
+    QString usernameText =
+        stylizeUsername(username, this->message(), *this->context_);
 
     if (args.isSentWhisper)
     {
@@ -2179,7 +2251,7 @@ void MessageBuilder::appendUsername(const QVariantMap &tags,
                                    FontStyle::ChatMediumBold)
             ->setLink({Link::UserWhisper, this->message().displayName});
 
-        auto currentUser = app->getAccounts()->twitch.getCurrent();
+        const auto &currentUser = this->context_->currentUser;
 
         // Separator
         this->emplace<TextElement>("->", MessageElementFlag::Username,
@@ -2208,33 +2280,33 @@ void MessageBuilder::appendUsername(const QVariantMap &tags,
     }
 }
 
-Outcome MessageBuilder::tryAppendEmote(TwitchChannel *twitchChannel,
+Outcome MessageBuilder::tryAppendEmote(const TextState &state,
                                        const EmoteName &name)
 {
-    auto [emote, flags] = parseEmote(twitchChannel, name);
+    auto [emote, flags] = parseEmote(state.emoteIndex.get(), name);
 
     if (!emote)
     {
         return Failure;
     }
 
-    if ((*emote)->zeroWidth && getSettings()->enableZeroWidthEmotes &&
+    if ((*emote)->zeroWidth && this->context_->enableZeroWidthEmotes &&
         !this->isEmpty())
     {
         // Attempt to merge current zero-width emote into any previous emotes
         auto *asEmote = dynamic_cast<EmoteElement *>(&this->back());
         if (asEmote)
         {
-            // Make sure to access asEmote before taking ownership when releasing
+            // Make sure to access asEmote before it's destroyed
             auto baseEmote = asEmote->getEmote();
+            auto baseFlags = asEmote->getFlags();
             // Need to remove EmoteElement and replace with LayeredEmoteElement
-            auto baseEmoteElement = this->releaseBack();
+            this->popBack();
 
             std::vector<LayeredEmoteElement::Emote> layers = {
-                {baseEmote, baseEmoteElement->getFlags()}, {*emote, flags}};
+                {baseEmote, baseFlags}, {*emote, flags}};
             this->emplace<LayeredEmoteElement>(
-                std::move(layers), baseEmoteElement->getFlags() | flags,
-                this->textColor_);
+                std::move(layers), baseFlags | flags, this->textColor_);
             return Success;
         }
 
@@ -2305,8 +2377,7 @@ void MessageBuilder::addWords(
 
             // 1. Add text before the emote
             QString preText = word.left(currentTwitchEmote.start - cursor);
-            for (auto variant :
-                 getApp()->getEmotes()->getEmojis()->parse(preText))
+            for (auto variant : this->context_->emojis->parse(preText))
             {
                 boost::apply_visitor(variant::Overloaded{
                                          [&](const EmotePtr &emote) {
@@ -2331,7 +2402,7 @@ void MessageBuilder::addWords(
         }
 
         // split words
-        for (auto variant : getApp()->getEmotes()->getEmojis()->parse(word))
+        for (auto variant : this->context_->emojis->parse(word))
         {
             boost::apply_visitor(variant::Overloaded{
                                      [&](const EmotePtr &emote) {
@@ -2349,7 +2420,7 @@ void MessageBuilder::addWords(
     }
 }
 
-void MessageBuilder::appendTwitchBadges(const QVariantMap &tags,
+void MessageBuilder::appendTwitchBadges(const TwitchIrcLine &line,
                                         TwitchChannel *twitchChannel)
 {
     if (twitchChannel == nullptr)
@@ -2359,7 +2430,7 @@ void MessageBuilder::appendTwitchBadges(const QVariantMap &tags,
 
     if (this->message().flags.has(MessageFlag::SharedMessage))
     {
-        const QString sourceId = tags["source-room-id"].toString();
+        const QString sourceId = line.tag(TwitchTag::SourceRoomId);
         QString sourceName;
         QString sourceProfilePicture;
         QString sourceLogin;
@@ -2390,14 +2461,14 @@ void MessageBuilder::appendTwitchBadges(const QVariantMap &tags,
             MessageElementFlag::BadgeSharedChannel);
     }
 
-    auto badgeInfos = parseBadgeInfoTag(tags);
-    auto badges = parseBadgeTag(tags);
-    appendBadges(this, badges, badgeInfos, twitchChannel);
+    auto badgeInfos = parseBadgeInfoTag(line);
+    auto badges = parseBadgeTag(line);
+    appendBadges(this, badges, badgeInfos, twitchChannel, *this->context_);
 }
 
 void MessageBuilder::appendChatterinoBadges(const QString &userID)
 {
-    if (auto badge = getApp()->getChatterinoBadges()->getBadge({userID}))
+    if (auto badge = this->context_->chatterinoBadges->getBadge({userID}))
     {
         this->emplace<BadgeElement>(*badge,
                                     MessageElementFlag::BadgeChatterino);
@@ -2407,7 +2478,8 @@ void MessageBuilder::appendChatterinoBadges(const QString &userID)
 void MessageBuilder::appendFfzBadges(TwitchChannel *twitchChannel,
                                      const QString &userID)
 {
-    for (const auto &badge : getApp()->getFfzBadges()->getUserBadges({userID}))
+    for (const auto &badge :
+         this->context_->ffzBadges->getUserBadges({userID}))
     {
         this->emplace<FfzBadgeElement>(
             badge.emote, MessageElementFlag::BadgeFfz, badge.color);
@@ -2418,7 +2490,8 @@ void MessageBuilder::appendFfzBadges(TwitchChannel *twitchChannel,
         return;
     }
 
-    for (const auto &badge : twitchChannel->ffzChannelBadges(userID))
+    for (const auto &badge : twitchChannel->ffzChannelBadges(
+             userID, *this->context_->ffzBadges))
     {
         this->emplace<FfzBadgeElement>(
             badge.emote, MessageElementFlag::BadgeFfz, badge.color);
@@ -2427,7 +2500,7 @@ void MessageBuilder::appendFfzBadges(TwitchChannel *twitchChannel,
 
 void MessageBuilder::appendSeventvBadges(const QString &userID)
 {
-    if (auto badge = getApp()->getSeventvBadges()->getBadge({userID}))
+    if (auto badge = this->context_->seventvBadges->getBadge({userID}))
     {
         this->emplace<BadgeElement>(*badge, MessageElementFlag::BadgeSevenTV);
     }
@@ -2458,7 +2531,7 @@ Outcome MessageBuilder::tryAppendCheermote(TextState &state,
 
     int cheerValue = match.captured(1).toInt();
 
-    if (getSettings()->stackBits)
+    if (this->context_->stackBits)
     {
         if (state.bitsStacked)
         {
@@ -3,6 +3,7 @@
 #include "common/Aliases.hpp"
 #include "common/Outcome.hpp"
 #include "messages/MessageColor.hpp"
+#include "messages/MessageElementArena.hpp"
 #include "messages/MessageFlag.hpp"
 
 #include <IrcMessage>
@@ -15,6 +16,7 @@
 #include <ctime>
 #include <memory>
 #include <utility>
+#include <vector>
 
 namespace chatterino {
 
@@ -25,12 +27,26 @@ using MessagePtrMut = std::shared_ptr<Message>;
 class MessageElement;
 class TextElement;
 struct Emote;
+class EmoteIndex;
 using EmotePtr = std::shared_ptr<const Emote>;
 
 class Channel;
 class TwitchChannel;
+class TwitchIrcLine;
 class MessageThread;
 class IgnorePhrase;
+class Nickname;
+class HighlightBlacklistUser;
+enum UsernameDisplayMode : int;
+class TwitchAccount;
+class IUserDataController;
+class HighlightController;
+class TwitchBadges;
+class FfzBadges;
+class IChatterinoBadges;
+class SeventvBadges;
+class IEmojis;
+class ITwitchEmotes;
 struct HelixVip;
 using HelixModerator = HelixVip;
 struct ChannelPointReward;
@@ -88,6 +104,50 @@ struct HighlightAlert {
     bool playSound = false;
     bool windowAlert = false;
 };
+
+/// @brief The application state needed to build IRC messages
+///
+/// Most getters of the application may only be called from the GUI thread.
+/// To build a message on another thread, take the context on the GUI thread
+/// and pass it along. The services referenced here synchronize their state
+/// internally. Everything else is a snapshot.
+struct MessageBuildContext {
+    /// Takes the context from the current application.
+    /// This may only be called from the GUI thread.
+    static MessageBuildContext fromApp();
+
+    /// The account that was current when the context was taken
+    std::shared_ptr<TwitchAccount> currentUser;
+    /// The ignored phrases when the context was taken. The emotes of
+    /// replacements are already resolved.
+    std::shared_ptr<const std::vector<IgnorePhrase>> ignoredPhrases;
+    /// The emote index of the channel the message is built for. If this is
+    /// empty, the index is taken from the channel while building, which is
+    /// only allowed on the GUI thread.
+    std::shared_ptr<const EmoteIndex> emoteIndex;
+
+    /// The settings read while building, as they were when the context was
+    /// taken
+    std::shared_ptr<const std::vector<Nickname>> nicknames;
+    std::shared_ptr<const std::vector<HighlightBlacklistUser>> blacklistedUsers;
+    UsernameDisplayMode usernameDisplayMode{};
+    bool colorizeNicknames = false;
+    bool findAllUsernames = false;
+    bool stackBits = false;
+    bool enableZeroWidthEmotes = false;
+    bool useCustomFfzModeratorBadges = false;
+    bool useCustomFfzVipBadges = false;
+    bool highlightInlineWhispers = false;
+
+    IUserDataController *userData = nullptr;
+    HighlightController *highlights = nullptr;
+    TwitchBadges *twitchBadges = nullptr;
+    FfzBadges *ffzBadges = nullptr;
+    IChatterinoBadges *chatterinoBadges = nullptr;
+    SeventvBadges *seventvBadges = nullptr;
+    IEmojis *emojis = nullptr;
+    ITwitchEmotes *twitchEmotes = nullptr;
+};
 class MessageBuilder
 {
 public:
@@ -138,6 +198,8 @@ public:
     MessagePtrMut release();
     std::weak_ptr<const Message> weakOf();
 
+    /// Appends an element that was allocated on its own. Prefer emplace, which
+    /// allocates the element together with the other elements of the message.
     void append(std::unique_ptr<MessageElement> element);
     void addLink(const linkparser::Parsed &parsedLink, const QString &source);
 
@@ -147,7 +209,8 @@ public:
         static_assert(std::is_base_of_v<MessageElement, T>,
                       "T must extend MessageElement");
 
-        auto unique = std::make_unique<T>(std::forward<Args>(args)...);
+        auto unique =
+            this->elementArena().make<T>(std::forward<Args>(args)...);
         auto pointer = unique.get();
         this->append(std::move(unique));
         return pointer;
@@ -202,7 +265,8 @@ public:
     /// @param channel The channel this message was sent to. Must not be
     ///                `nullptr`.
     /// @param ircMessage The original message. This can be any message
-    ///                   (PRIVMSG, USERNOTICE, etc.). Its content is not
+    ///                   (PRIVMSG, USERNOTICE, etc.). Messages from Communi
+    ///                   are converted to a TwitchIrcLine. Its content is not
     ///                   accessed through this parameter but through `content`,
     ///                   as the content might be inside a tag (e.g. gifts in a
     ///                   USERNOTICE).
@@ -226,6 +290,23 @@ public:
     /// @returns The built message and a highlight result. If the message is
     ///          ignored (e.g. from a blocked user), then the returned pointer
     ///          will be en empty `shared_ptr`.
+    ///
+    /// The overloads without a @a context take it from the application and
+    /// may only be called from the GUI thread. With a context, PRIVMSGs
+    /// without replies or rewards can be built on any thread, as long as
+    /// `args.allowIgnore` is false.
+    static std::pair<MessagePtrMut, HighlightAlert> makeIrcMessage(
+        const MessageBuildContext &context, Channel *channel,
+        const TwitchIrcLine &ircMessage, const MessageParseArgs &args,
+        QString content, QString::size_type messageOffset,
+        const std::shared_ptr<MessageThread> &thread = {},
+        const MessagePtr &parent = {});
+    static std::pair<MessagePtrMut, HighlightAlert> makeIrcMessage(
+        Channel *channel, const TwitchIrcLine &ircMessage,
+        const MessageParseArgs &args, QString content,
+        QString::size_type messageOffset,
+        const std::shared_ptr<MessageThread> &thread = {},
+        const MessagePtr &parent = {});
     static std::pair<MessagePtrMut, HighlightAlert> makeIrcMessage(
         Channel *channel, const Communi::IrcMessage *ircMessage,
         const MessageParseArgs &args, QString content,
@@ -253,8 +334,14 @@ public:
                                               uint32_t count = 1);
 
 private:
+    /// The arena of the message being built
+    MessageElementArena &elementArena();
+
     struct TextState {
         TwitchChannel *twitchChannel = nullptr;
+        /// Fetched once per message, so every word is looked up in the same
+        /// snapshot of the channel's emotes
+        std::shared_ptr<const EmoteIndex> emoteIndex;
         bool hasBits = false;
         bool bitsStacked = false;
         int bitsLeft = 0;
@@ -263,54 +350,57 @@ private:
     void addTextOrEmote(TextState &state, QString string);
 
     Outcome tryAppendCheermote(TextState &state, const QString &string);
-    Outcome tryAppendEmote(TwitchChannel *twitchChannel, const EmoteName &name);
+    Outcome tryAppendEmote(const TextState &state, const EmoteName &name);
 
     bool isEmpty() const;
     MessageElement &back();
-    std::unique_ptr<MessageElement> releaseBack();
+    /// Removes and destroys the last element. Elements can't be taken out of
+    /// the builder, since most of them live in the message's arena.
+    void popBack();
 
     void parse();
-    void parseUsernameColor(const QVariantMap &tags, const QString &userID);
-    void parseUsername(const Communi::IrcMessage *ircMessage,
+    void parseUsernameColor(const TwitchIrcLine &line, const QString &userID);
+    void parseUsername(const TwitchIrcLine &ircMessage,
                        TwitchChannel *twitchChannel,
                        bool trimSubscriberUsername);
-    void parseMessageID(const QVariantMap &tags);
+    void parseMessageID(const TwitchIrcLine &line);
 
     /// Parses the room-ID this message was received in
     ///
     /// @returns The room-ID
-    static QString parseRoomID(const QVariantMap &tags,
+    static QString parseRoomID(const TwitchIrcLine &line,
                                TwitchChannel *twitchChannel);
 
     /// Parses the shared-chat information from this message.
     ///
-    /// @param tags The tags of the received message
+    /// @param line The received message
     /// @param twitchChannel The channel this message was received in
     /// @returns The source channel - the channel this message originated from.
     ///          If there's no channel currently open, @a twitchChannel is
     ///          returned.
-    TwitchChannel *parseSharedChatInfo(const QVariantMap &tags,
+    TwitchChannel *parseSharedChatInfo(const TwitchIrcLine &line,
                                        TwitchChannel *twitchChannel);
 
     // Parse & build thread information into the message
     // Will read information from thread_ or from IRC tags
-    void parseThread(const QString &messageContent, const QVariantMap &tags,
+    void parseThread(const QString &messageContent, const TwitchIrcLine &line,
                      const Channel *channel,
                      const std::shared_ptr<MessageThread> &thread,
                      const MessagePtr &parent);
     // parseHighlights only updates the visual state of the message, but leaves the playing of alerts and sounds to the triggerHighlights function
-    HighlightAlert parseHighlights(const QVariantMap &tags,
+    HighlightAlert parseHighlights(const TwitchIrcLine &line,
                                    const QString &originalMessage,
                                    const MessageParseArgs &args);
 
     void appendChannelName(const Channel *channel);
-    void appendUsername(const QVariantMap &tags, const MessageParseArgs &args);
+    void appendUsername(const TwitchIrcLine &line,
+                        const MessageParseArgs &args);
 
     void addWords(const QStringList &words,
                   const std::vector<TwitchEmoteOccurrence> &twitchEmotes,
                   TextState &state);
 
-    void appendTwitchBadges(const QVariantMap &tags,
+    void appendTwitchBadges(const TwitchIrcLine &line,
                             TwitchChannel *twitchChannel);
     void appendChatterinoBadges(const QString &userID);
     void appendFfzBadges(TwitchChannel *twitchChannel, const QString &userID);
@@ -323,6 +413,9 @@ private:
     std::shared_ptr<Message> message_;
     MessageColor textColor_ = MessageColor::Text;
 
+    /// Set while an IRC message is being built
+    const MessageBuildContext *context_ = nullptr;
+
     QColor usernameColor_ = {153, 153, 153};
 };
 
@@ -10,10 +10,12 @@
 #include "messages/layouts/MessageLayoutContext.hpp"
 #include "messages/layouts/MessageLayoutElement.hpp"
 #include "providers/emoji/Emojis.hpp"
+#include "providers/links/LinkInfoCache.hpp"
+#include "providers/links/LinkResolver.hpp"
 #include "singletons/Emotes.hpp"
 #include "singletons/Settings.hpp"
 #include "singletons/Theme.hpp"
-#include "util/DebugCount.hpp"
+#include "util/Metrics.hpp"
 #include "util/Variant.hpp"
 
 #include <QJsonArray>
@@ -30,6 +32,9 @@ using namespace literals;
 
 namespace {
 
+const metrics::Counter MESSAGE_ELEMENTS("message elements");
+const metrics::Counter MEASURED_WORDS("measured text element words");
+
 // Computes the bounding box for the given vector of images
 QSizeF getBoundingBoxSize(const std::vector<ImagePtr> &images)
 {
@@ -50,23 +55,45 @@ QSizeF getBoundingBoxSize(const std::vector<ImagePtr> &images)
 MessageElement::MessageElement(MessageElementFlags flags)
     : flags_(flags)
 {
-    DebugCount::increase("message elements");
+    MESSAGE_ELEMENTS.increase();
 }
 
 MessageElement::~MessageElement()
 {
-    DebugCount::decrease("message elements");
+    MESSAGE_ELEMENTS.decrease();
+}
+
+void MessageElement::operator delete(MessageElement *element,
+                                     std::destroying_delete_t)
+{
+    bool inArena = element->inArena_;
+    element->~MessageElement();
+    if (!inArena)
+    {
+        ::operator delete(element);
+    }
+}
+
+void MessageElement::operator delete(void *ptr)
+{
+    ::operator delete(ptr);
 }
 
 MessageElement *MessageElement::setLink(const Link &link)
 {
-    this->link_ = link;
+    if (this->extra_ || link.type != Link::None)
+    {
+        this->extra().link = link;
+    }
     return this;
 }
 
 MessageElement *MessageElement::setTooltip(const QString &tooltip)
 {
-    this->tooltip_ = tooltip;
+    if (this->extra_ || !tooltip.isEmpty())
+    {
+        this->extra().tooltip = tooltip;
+    }
     return this;
 }
 
@@ -78,12 +105,13 @@ MessageElement *MessageElement::setTrailingSpace(bool value)
 
 const QString &MessageElement::getTooltip() const
 {
-    return this->tooltip_;
+    static const QString empty;
+    return this->extra_ ? this->extra_->tooltip : empty;
 }
 
 Link MessageElement::getLink() const
 {
-    return this->link_;
+    return this->extra_ ? this->extra_->link : Link{};
 }
 
 bool MessageElement::hasTrailingSpace() const
@@ -101,18 +129,28 @@ void MessageElement::addFlags(MessageElementFlags flags)
     this->flags_.set(flags);
 }
 
+MessageElement::Extra &MessageElement::extra()
+{
+    if (!this->extra_)
+    {
+        this->extra_ = std::make_unique<Extra>();
+    }
+    return *this->extra_;
+}
+
 QJsonObject MessageElement::toJson() const
 {
+    auto link = MessageElement::getLink();
     return {
         {"trailingSpace"_L1, this->trailingSpace},
         {
             "link"_L1,
             {{
-                {"type"_L1, qmagicenum::enumNameString(this->link_.type)},
-                {"value"_L1, this->link_.value},
+                {"type"_L1, qmagicenum::enumNameString(link.type)},
+                {"value"_L1, link.value},
             }},
         },
-        {"tooltip"_L1, this->tooltip_},
+        {"tooltip"_L1, this->getTooltip()},
         {"flags"_L1, qmagicenum::enumFlagsName(this->flags_.value())},
     };
 }
@@ -603,8 +641,11 @@ void TextElement::addToContainer(MessageLayoutContainer &container,
         auto metrics =
             app->getFonts()->getFontMetrics(this->style_, container.getScale());
 
-        for (const auto &word : this->words_)
+        const auto &widths = this->measureWords(container.getScale());
+
+        for (qsizetype i = 0; i < this->words_.size(); i++)
         {
+            const auto &word = this->words_.at(i);
             auto wordId = container.nextWordId();
 
             auto getTextLayoutElement = [&](QString text, qreal width,
@@ -622,7 +663,7 @@ void TextElement::addToContainer(MessageLayoutContainer &container,
                 return e;
             };
 
-            auto width = metrics.horizontalAdvance(word);
+            auto width = widths[i];
 
             // see if the text fits in the current line
             if (container.fitsInLine(width))
@@ -784,6 +825,8 @@ FontStyle TextElement::fontStyle() const noexcept
 
 void TextElement::appendText(QStringView text)
 {
+    this->wordWidths_.clear();
+
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
     for (auto word : text.split(' '))  // creates a QList
 #else
@@ -796,6 +839,8 @@ void TextElement::appendText(QStringView text)
 
 void TextElement::appendText(const QString &text)
 {
+    this->wordWidths_.clear();
+
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
     this->appendText(QStringView{text});
 #else
@@ -815,6 +860,42 @@ void TextElement::appendText(const QString &text)
 #endif
 }
 
+void TextElement::setWords(const QStringList &words)
+{
+    if (this->words_ == words)
+    {
+        return;
+    }
+
+    this->words_ = words;
+    this->wordWidths_.clear();
+}
+
+const std::vector<qreal> &TextElement::measureWords(float scale)
+{
+    auto *fonts = getApp()->getFonts();
+
+    if (this->wordWidths_.size() == static_cast<size_t>(this->words_.size()) &&
+        this->measuredScale_ == scale &&
+        this->measuredGeneration_ == fonts->generation())
+    {
+        return this->wordWidths_;
+    }
+
+    this->wordWidths_.clear();
+    this->wordWidths_.reserve(this->words_.size());
+    for (const auto &word : this->words_)
+    {
+        this->wordWidths_.push_back(
+            fonts->getWordWidth(this->style_, scale, word));
+    }
+    MEASURED_WORDS.increase(static_cast<int64_t>(this->words_.size()));
+    this->measuredScale_ = scale;
+    this->measuredGeneration_ = fonts->generation();
+
+    return this->wordWidths_;
+}
+
 QJsonObject TextElement::toJson() const
 {
     auto base = MessageElement::toJson();
@@ -973,7 +1054,7 @@ LinkElement::LinkElement(const Parsed &parsed, const QString &fullUrl,
                          MessageElementFlags flags, const MessageColor &color,
                          FontStyle style)
     : TextElement({}, flags, color, style)
-    , linkInfo_(fullUrl)
+    , linkInfo_(LinkInfoCache::instance().get(fullUrl))
     , lowercase_({parsed.lowercase})
     , original_({parsed.original})
 {
@@ -983,21 +1064,27 @@ LinkElement::LinkElement(const Parsed &parsed, const QString &fullUrl,
 void LinkElement::addToContainer(MessageLayoutContainer &container,
                                  const MessageLayoutContext &ctx)
 {
-    this->words_ =
-        getSettings()->lowercaseDomains ? this->lowercase_ : this->original_;
+    // Links are only resolved once they're shown
+    if (this->linkInfo_->isPending())
+    {
+        getApp()->getLinkResolver()->resolve(this->linkInfo_.get());
+    }
+
+    this->setWords(getSettings()->lowercaseDomains ? this->lowercase_
+                                                   : this->original_);
     TextElement::addToContainer(container, ctx);
 }
 
 Link LinkElement::getLink() const
 {
-    return {Link::Url, this->linkInfo_.url()};
+    return {Link::Url, this->linkInfo_->url()};
 }
 
 QJsonObject LinkElement::toJson() const
 {
     auto base = TextElement::toJson();
     base["type"_L1] = u"LinkElement"_s;
-    base["link"_L1] = this->linkInfo_.originalUrl();
+    base["link"_L1] = this->linkInfo_->originalUrl();
     base["lowercase"_L1] = QJsonArray::fromStringList(this->lowercase_);
     base["original"_L1] = QJsonArray::fromStringList(this->original_);
 
@@ -13,8 +13,10 @@
 #include <QString>
 #include <QTime>
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <new>
 #include <vector>
 
 class QJsonObject;
@@ -24,6 +26,7 @@ class Channel;
 struct MessageLayoutContainer;
 class MessageLayoutElement;
 struct MessageLayoutContext;
+class MessageElementArena;
 
 class Image;
 using ImagePtr = std::shared_ptr<Image>;
@@ -194,14 +197,32 @@ public:
 
     virtual QJsonObject toJson() const;
 
+    /// Destroys the element and frees it, unless it lives in a
+    /// MessageElementArena
+    static void operator delete(MessageElement *element,
+                                std::destroying_delete_t);
+    /// Frees an element whose constructor threw
+    static void operator delete(void *ptr);
+
 protected:
     MessageElement(MessageElementFlags flags);
     bool trailingSpace = true;
 
 private:
-    Link link_;
-    QString tooltip_;
+    /// Most elements have neither a link nor a tooltip, so they're only
+    /// allocated when they're set.
+    struct Extra {
+        Link link;
+        QString tooltip;
+    };
+
+    Extra &extra();
+
+    bool inArena_ = false;
     MessageElementFlags flags_;
+    std::unique_ptr<Extra> extra_;
+
+    friend class MessageElementArena;
 };
 
 // contains a simple image
@@ -258,10 +279,25 @@ public:
     void appendText(const QString &text);
 
 protected:
+    /// Replaces the words, keeping the measured widths if they're unchanged
+    void setWords(const QStringList &words);
+
     QStringList words_;
 
     MessageColor color_;
     FontStyle style_;
+
+private:
+    /// @brief Returns the widths of `words_` at `scale`
+    ///
+    /// The widths are kept until the scale or the fonts change, so laying out
+    /// the element again for a different width doesn't measure any text.
+    const std::vector<qreal> &measureWords(float scale);
+
+    std::vector<qreal> wordWidths_;
+    float measuredScale_ = 0;
+    /// Fonts::generation() of `wordWidths_`
+    size_t measuredGeneration_ = 0;
 };
 
 // contains a text that will be truncated to one line
@@ -316,13 +352,14 @@ public:
 
     [[nodiscard]] LinkInfo *linkInfo()
     {
-        return &this->linkInfo_;
+        return this->linkInfo_.get();
     }
 
     QJsonObject toJson() const override;
 
 private:
-    LinkInfo linkInfo_;
+    /// Shared with other links to the same URL
+    std::shared_ptr<LinkInfo> linkInfo_;
     // these are implicitly shared
     QStringList lowercase_;
     QStringList original_;
@@ -0,0 +1,59 @@
+#include "messages/MessageElementArena.hpp"
+
+#include "messages/MessageElement.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <new>
+
+namespace chatterino {
+
+MessageElementArena::~MessageElementArena()
+{
+    while (this->block_ != nullptr)
+    {
+        auto *previous = this->block_->previous;
+        ::operator delete(this->block_);
+        this->block_ = previous;
+    }
+}
+
+void *MessageElementArena::allocate(size_t size, size_t alignment)
+{
+    // Blocks are aligned like `new`, and so is the end of their header
+    static_assert(sizeof(Block) % alignof(std::max_align_t) == 0);
+    assert(alignment <= alignof(std::max_align_t));
+
+    size_t offset = (this->used_ + alignment - 1) & ~(alignment - 1);
+    if (this->block_ == nullptr || offset + size > this->block_->size)
+    {
+        auto blockSize = std::max(
+            size, this->block_ == nullptr
+                      ? FIRST_BLOCK_SIZE
+                      : std::min(this->block_->size * 2, MAX_BLOCK_SIZE));
+
+        auto *block = static_cast<Block *>(
+            ::operator new(sizeof(Block) + blockSize));
+        block->previous = this->block_;
+        block->size = blockSize;
+
+        this->block_ = block;
+        this->reserved_ += sizeof(Block) + blockSize;
+        offset = 0;
+    }
+
+    this->used_ = offset + size;
+    return reinterpret_cast<std::byte *>(this->block_ + 1) + offset;
+}
+
+size_t MessageElementArena::reservedBytes() const
+{
+    return this->reserved_;
+}
+
+void MessageElementArena::markInArena(MessageElement *element)
+{
+    element->inArena_ = true;
+}
+
+}  // namespace chatterino
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace chatterino {
+
+class MessageElement;
+
+/// @brief Bump allocator for the elements of one message
+///
+/// A message's elements are allocated together in a few blocks instead of
+/// one heap allocation each. Memory is only released when the arena is
+/// destroyed, so the arena must outlive all elements made with make()
+/// (Message declares it before its elements). Elements made with make() are
+/// deleted like any other element.
+///
+/// This isn't thread-safe, a message is only built from one thread.
+class MessageElementArena
+{
+public:
+    /// The size of the first block, later blocks are larger
+    static constexpr size_t FIRST_BLOCK_SIZE = 512;
+    static constexpr size_t MAX_BLOCK_SIZE = 4096;
+
+    MessageElementArena() = default;
+    ~MessageElementArena();
+
+    MessageElementArena(const MessageElementArena &) = delete;
+    MessageElementArena &operator=(const MessageElementArena &) = delete;
+    MessageElementArena(MessageElementArena &&) = delete;
+    MessageElementArena &operator=(MessageElementArena &&) = delete;
+
+    /// Constructs a T in this arena
+    template <typename T, typename... Args>
+    std::unique_ptr<T> make(Args &&...args)
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t));
+
+        auto *element = ::new (this->allocate(sizeof(T), alignof(T)))
+            T(std::forward<Args>(args)...);
+        markInArena(element);
+        return std::unique_ptr<T>(element);
+    }
+
+    /// Returns uninitialized memory that's valid until the arena is destroyed
+    void *allocate(size_t size, size_t alignment);
+
+    /// The number of bytes reserved for blocks
+    size_t reservedBytes() const;
+
+private:
+    struct Block {
+        Block *previous;
+        size_t size;
+    };
+
+    static void markInArena(MessageElement *element);
+
+    Block *block_ = nullptr;
+    /// Offset of the free memory in `block_` (from the end of the header)
+    size_t used_ = 0;
+    size_t reserved_ = 0;
+};
+
+}  // namespace chatterino
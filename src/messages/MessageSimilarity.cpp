@@ -7,80 +7,179 @@
 #include "singletons/Settings.hpp"
 
 #include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
 #include <vector>
 
 namespace {
 
 using namespace chatterino;
 
-float relativeSimilarity(QStringView str1, QStringView str2)
+static_assert(std::is_same_v<decltype(Message::similaritySketch),
+                             SimilaritySketch>);
+
+const SimilaritySketch &sketchOf(const Message &message)
 {
-    using SizeType = QStringView::size_type;
+    std::call_once(message.similaritySketchOnce, [&] {
+        message.similaritySketch = makeSimilaritySketch(message.messageText);
+    });
+    return message.similaritySketch;
+}
 
-    // Longest Common Substring Problem
-    std::vector<std::vector<int>> tree(str1.size(),
-                                       std::vector<int>(str2.size(), 0));
-    int z = 0;
+/// Returns an upper bound for the number of bigrams two texts share. Bigrams
+/// that hash to the same bucket can only make this larger.
+qsizetype commonBigrams(const SimilaritySketch &a, const SimilaritySketch &b)
+{
+    qsizetype common = 0;
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        common += std::min(a[i], b[i]);
+    }
+    return common;
+}
 
-    for (SizeType i = 0; i < str1.size(); ++i)
+/// Returns the length of the longest common substring, or any length of at
+/// least `stopAt` once a common substring of that length was found.
+qsizetype longestCommonSubstring(QStringView a, QStringView b, qsizetype stopAt)
+{
+    if (a.size() < b.size())
     {
-        for (SizeType j = 0; j < str2.size(); ++j)
+        std::swap(a, b);
+    }
+
+    // Only the previous row of the DP table is needed. The row is reused
+    // between calls, so this doesn't allocate after the first few messages.
+    thread_local std::vector<qsizetype> row;
+    row.assign(static_cast<size_t>(b.size()) + 1, 0);
+
+    qsizetype longest = 0;
+    for (auto ca : a)
+    {
+        // Going backwards, row[j] still has the value of the previous row
+        for (auto j = b.size(); j > 0; --j)
         {
-            if (str1[i] == str2[j])
+            auto &cell = row[static_cast<size_t>(j)];
+            if (ca == b[j - 1])
             {
-                if (i == 0 || j == 0)
+                cell = row[static_cast<size_t>(j - 1)] + 1;
+                if (cell > longest)
                 {
-                    tree[i][j] = 1;
+                    longest = cell;
+                    if (longest >= stopAt)
+                    {
+                        return longest;
+                    }
                 }
-                else
-                {
-                    tree[i][j] = tree[i - 1][j - 1] + 1;
-                }
-                z = std::max(tree[i][j], z);
             }
             else
             {
-                tree[i][j] = 0;
+                cell = 0;
             }
         }
     }
 
-    // ensure that no div by 0
-    if (z == 0)
+    return longest;
+}
+
+/// Returns the shortest common substring length that makes two texts with
+/// the given maximum length more similar than `threshold`.
+qsizetype requiredLength(qsizetype maxLength, float threshold)
+{
+    auto exceeds = [&](qsizetype length) {
+        return float(length) / float(maxLength) > threshold;
+    };
+
+    // Start at the exact solution and correct float rounding, so this agrees
+    // with comparing relativeSimilarity against the threshold
+    auto length = std::max<qsizetype>(
+        0, static_cast<qsizetype>(
+               std::floor(double(threshold) * double(maxLength))) +
+               1);
+    while (length > 0 && exceeds(length - 1))
     {
-        return 0.F;
+        length--;
+    }
+    while (length <= maxLength && !exceeds(length))
+    {
+        length++;
+    }
+    return length;
+}
+
+/// Shared by exceedsSimilarity and its overload with sketches. The sketches
+/// are only computed if the length check doesn't already rule out a match.
+template <typename SketchA, typename SketchB>
+bool exceedsSimilarityImpl(QStringView a, QStringView b, float threshold,
+                           SketchA &&sketchA, SketchB &&sketchB)
+{
+    auto maxLength = std::max({qsizetype{1}, a.size(), b.size()});
+    auto required = requiredLength(maxLength, threshold);
+
+    // Cheap checks first: the common substring can't be longer than the
+    // shorter text
+    if (std::min(a.size(), b.size()) < required)
+    {
+        return false;
+    }
+
+    // A common substring of length n contains n - 1 common bigrams. Counts in
+    // the sketch saturate, so it's only a bound for shorter texts.
+    if constexpr (!std::is_same_v<std::remove_cvref_t<SketchA>,
+                                  std::nullptr_t>)
+    {
+        if (maxLength < UINT16_MAX &&
+            commonBigrams(sketchA(), sketchB()) + 1 < required)
+        {
+            return false;
+        }
     }
 
-    auto div = std::max<>({static_cast<SizeType>(1), str1.size(), str2.size()});
+    return longestCommonSubstring(a, b, required) >= required;
+}
 
-    return float(z) / float(div);
+bool messagesExceedSimilarity(const Message &a, const Message &b,
+                              float threshold)
+{
+    return exceedsSimilarityImpl(
+        a.messageText, b.messageText, threshold,
+        [&]() -> const SimilaritySketch & {
+            return sketchOf(a);
+        },
+        [&]() -> const SimilaritySketch & {
+            return sketchOf(b);
+        });
 }
 
 template <std::ranges::bidirectional_range T>
-float inMessages(const MessagePtr &msg, const T &messages)
+bool isSimilarToPrevious(const MessagePtr &msg, const T &messages)
 {
-    float similarityPercent = 0.0F;
+    const auto maxMessages = getSettings()->hideSimilarMaxMessagesToCheck;
+    const auto maxDelay = getSettings()->hideSimilarMaxDelay;
+    const bool bySameUser = getSettings()->hideSimilarBySameUser;
+    const float threshold = getSettings()->similarityPercentage;
+    const auto now = QTime::currentTime();
 
     for (const auto &prevMsg :
-         messages | std::views::reverse |
-             std::views::take(getSettings()->hideSimilarMaxMessagesToCheck))
+         messages | std::views::reverse | std::views::take(maxMessages))
     {
-        if (prevMsg->parseTime.secsTo(QTime::currentTime()) >=
-            getSettings()->hideSimilarMaxDelay)
+        if (prevMsg->parseTime.secsTo(now) >= maxDelay)
         {
             break;
         }
-        if (getSettings()->hideSimilarBySameUser &&
-            msg->loginName != prevMsg->loginName)
+        if (bySameUser && msg->loginName != prevMsg->loginName)
         {
             continue;
         }
-        similarityPercent = std::max(
-            similarityPercent,
-            relativeSimilarity(msg->messageText, prevMsg->messageText));
+        if (messagesExceedSimilarity(*msg, *prevMsg, threshold))
+        {
+            return true;
+        }
     }
 
-    return similarityPercent;
+    return false;
 }
 
 }  // namespace
@@ -102,7 +201,7 @@ void setSimilarityFlags(const MessagePtr &message, const T &messages)
             return;
         }
 
-        if (inMessages(message, messages) > getSettings()->similarityPercentage)
+        if (isSimilarToPrevious(message, messages))
         {
             message->flags.set(MessageFlag::Similar);
             if (getSettings()->colorSimilarDisabled)
@@ -118,4 +217,55 @@ template void setSimilarityFlags<std::vector<MessagePtr>>(
 template void setSimilarityFlags<LimitedQueueSnapshot<MessagePtr>>(
     const MessagePtr &msg, const LimitedQueueSnapshot<MessagePtr> &messages);
 
+float relativeSimilarity(QStringView a, QStringView b)
+{
+    auto longest = longestCommonSubstring(a, b, a.size() + b.size() + 1);
+
+    // ensure that no div by 0
+    if (longest == 0)
+    {
+        return 0.F;
+    }
+
+    auto div = std::max({qsizetype{1}, a.size(), b.size()});
+    return float(longest) / float(div);
+}
+
+bool exceedsSimilarity(QStringView a, QStringView b, float threshold)
+{
+    return exceedsSimilarityImpl(a, b, threshold, nullptr, nullptr);
+}
+
+bool exceedsSimilarity(QStringView a, const SimilaritySketch &sketchA,
+                       QStringView b, const SimilaritySketch &sketchB,
+                       float threshold)
+{
+    return exceedsSimilarityImpl(
+        a, b, threshold,
+        [&]() -> const SimilaritySketch & {
+            return sketchA;
+        },
+        [&]() -> const SimilaritySketch & {
+            return sketchB;
+        });
+}
+
+SimilaritySketch makeSimilaritySketch(QStringView text)
+{
+    SimilaritySketch sketch{};
+    for (qsizetype i = 1; i < text.size(); i++)
+    {
+        auto bigram = (uint32_t{text[i - 1].unicode()} << 16) |
+                      uint32_t{text[i].unicode()};
+        // Fibonacci hashing: the top bits of the product are well mixed
+        auto bucket = (bigram * 2654435769U) >> 27;
+        auto &count = sketch[bucket];
+        if (count < UINT16_MAX)
+        {
+            count++;
+        }
+    }
+    return sketch;
+}
+
 }  // namespace chatterino
@@ -2,10 +2,35 @@
 
 #include "messages/Message.hpp"
 
+#include <QStringView>
+
+#include <array>
+#include <cstdint>
 #include <ranges>
+
 namespace chatterino {
 
 template <std::ranges::bidirectional_range T>
 void setSimilarityFlags(const MessagePtr &message, const T &messages);
 
+/// Returns the length of the longest common substring of `a` and `b` relative
+/// to the length of the longer string.
+float relativeSimilarity(QStringView a, QStringView b);
+
+/// Returns true if `relativeSimilarity(a, b) > threshold`, but stops as soon
+/// as the longest common substring is long enough.
+bool exceedsSimilarity(QStringView a, QStringView b, float threshold);
+
+/// Counts of the bigrams of a text, hashed into 32 buckets. Two sketches give
+/// an upper bound for the number of bigrams the texts share.
+using SimilaritySketch = std::array<uint16_t, 32>;
+
+SimilaritySketch makeSimilaritySketch(QStringView text);
+
+/// Same as exceedsSimilarity(a, b, threshold), but rules out most dissimilar
+/// texts with their sketches before comparing them.
+bool exceedsSimilarity(QStringView a, const SimilaritySketch &sketchA,
+                       QStringView b, const SimilaritySketch &sketchB,
+                       float threshold);
+
 }  // namespace chatterino
@@ -2,7 +2,7 @@
 
 #include "common/Literals.hpp"
 #include "messages/Message.hpp"
-#include "util/DebugCount.hpp"
+#include "util/Metrics.hpp"
 #include "util/QMagicEnum.hpp"
 
 #include <QJsonArray>
@@ -13,18 +13,24 @@
 
 namespace chatterino {
 
+namespace {
+
+const metrics::Counter MESSAGE_THREADS("message threads");
+
+}  // namespace
+
 using namespace literals;
 
 MessageThread::MessageThread(std::shared_ptr<const Message> rootMessage)
     : rootMessageId_(rootMessage->id)
     , rootMessage_(std::move(rootMessage))
 {
-    DebugCount::increase("message threads");
+    MESSAGE_THREADS.increase();
 }
 
 MessageThread::~MessageThread()
 {
-    DebugCount::decrease("message threads");
+    MESSAGE_THREADS.decrease();
 }
 
 void MessageThread::addToThread(const std::shared_ptr<const Message> &message)
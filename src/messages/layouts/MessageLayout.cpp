@@ -1,6 +1,8 @@
 #include "messages/layouts/MessageLayout.hpp"
 
 #include "Application.hpp"
+#include "debug/Trace.hpp"
+#include "messages/layouts/MessageLayoutCache.hpp"
 #include "messages/layouts/MessageLayoutContainer.hpp"
 #include "messages/layouts/MessageLayoutContext.hpp"
 #include "messages/layouts/MessageLayoutElement.hpp"
@@ -11,7 +13,7 @@
 #include "singletons/Settings.hpp"
 #include "singletons/StreamerMode.hpp"
 #include "singletons/WindowManager.hpp"
-#include "util/DebugCount.hpp"
+#include "util/Metrics.hpp"
 
 #include <QApplication>
 #include <QDebug>
@@ -23,6 +25,9 @@ namespace chatterino {
 
 namespace {
 
+const metrics::Counter MESSAGE_LAYOUTS("message layout");
+const metrics::Histogram MESSAGE_LAYOUT_TIME("message layout time");
+
 QColor blendColors(const QColor &base, const QColor &apply)
 {
     const qreal &alpha = apply.alphaF();
@@ -37,12 +42,12 @@ QColor blendColors(const QColor &base, const QColor &apply)
 MessageLayout::MessageLayout(MessagePtr message)
     : message_(std::move(message))
 {
-    DebugCount::increase("message layout");
+    MESSAGE_LAYOUTS.increase();
 }
 
 MessageLayout::~MessageLayout()
 {
-    DebugCount::decrease("message layout");
+    MESSAGE_LAYOUTS.decrease();
 }
 
 const Message *MessageLayout::getMessage()
@@ -58,12 +63,12 @@ const MessagePtr &MessageLayout::getMessagePtr() const
 // Height
 int MessageLayout::getHeight() const
 {
-    return static_cast<int>(this->container_.getHeight());
+    return static_cast<int>(this->container().getHeight());
 }
 
 int MessageLayout::getWidth() const
 {
-    return static_cast<int>(this->container_.getWidth());
+    return static_cast<int>(this->container().getWidth());
 }
 
 // Layout
@@ -71,8 +76,6 @@ int MessageLayout::getWidth() const
 bool MessageLayout::layout(const MessageLayoutContext &ctx,
                            bool shouldInvalidateBuffer)
 {
-    //    BenchmarkGuard benchmark("MessageLayout::layout()");
-
     bool layoutRequired = false;
 
     // check if width changed
@@ -93,6 +96,14 @@ bool MessageLayout::layout(const MessageLayoutContext &ctx,
     layoutRequired |= this->currentWordFlags_ != ctx.flags;
     this->currentWordFlags_ = ctx.flags;  // getSettings()->getWordTypeMask();
 
+    // check if the message's flags changed (e.g. it was disabled by a timeout)
+    if (this->currentMessageFlags_ != this->message_->flags)
+    {
+        layoutRequired = true;
+        this->flags.set(MessageLayoutFlag::RequiresBufferUpdate);
+        this->currentMessageFlags_ = this->message_->flags;
+    }
+
     // check if layout was requested manually
     layoutRequired |= this->flags.has(MessageLayoutFlag::RequiresLayout);
     this->flags.unset(MessageLayoutFlag::RequiresLayout);
@@ -113,23 +124,61 @@ bool MessageLayout::layout(const MessageLayoutContext &ctx,
         return false;
     }
 
-    qreal oldHeight = this->container_.getHeight();
+    auto oldData = this->data_;
     this->actuallyLayout(ctx);
-    if (widthChanged || this->container_.getHeight() != oldHeight)
+    if (this->data_ != oldData)
     {
+        // Buffers belong to a layout, another view might have one already
         this->deleteBuffer();
     }
-    this->invalidateBuffer();
+    else
+    {
+        this->invalidateBuffer();
+    }
 
     return true;
 }
 
 void MessageLayout::actuallyLayout(const MessageLayoutContext &ctx)
 {
+    TRACE_ZONE("message layout");
+    auto timer = MESSAGE_LAYOUT_TIME.time();
+
 #ifdef FOURTF
     this->layoutCount_++;
 #endif
 
+    MessageLayoutCache::Key key{
+        .message = this->message_.get(),
+        .messageFlags = this->message_->flags,
+        .elementFlags = ctx.flags,
+        .width = ctx.width,
+        .scale = this->scale_,
+        .imageScale = this->imageScale_,
+        .generation = getApp()->getWindows()->getGeneration(),
+        .expanded = this->flags.has(MessageLayoutFlag::Expanded),
+        .regularText = ctx.messageColors.regularText.rgba(),
+        .linkText = ctx.messageColors.linkText.rgba(),
+        .systemText = ctx.messageColors.systemText.rgba(),
+    };
+    this->data_ = MessageLayoutCache::instance().find(key);
+    if (!this->data_)
+    {
+        this->data_ = MessageLayoutCache::instance().create(key);
+        this->layoutContainer(this->data_->container, ctx);
+    }
+
+    // collapsed state
+    this->flags.unset(MessageLayoutFlag::Collapsed);
+    if (this->data_->container.isCollapsed())
+    {
+        this->flags.set(MessageLayoutFlag::Collapsed);
+    }
+}
+
+void MessageLayout::layoutContainer(MessageLayoutContainer &container,
+                                    const MessageLayoutContext &ctx) const
+{
     auto messageFlags = this->message_->flags;
 
     if (this->flags.has(MessageLayoutFlag::Expanded) ||
@@ -147,8 +196,8 @@ void MessageLayout::actuallyLayout(const MessageLayoutContext &ctx)
     bool hideSimilar = getSettings()->hideSimilar;
     bool hideReplies = !ctx.flags.has(MessageElementFlag::RepliedMessage);
 
-    this->container_.beginLayout(ctx.width, this->scale_, this->imageScale_,
-                                 messageFlags);
+    container.beginLayout(ctx.width, this->scale_, this->imageScale_,
+                          messageFlags);
 
     for (const auto &element : this->message_->elements)
     {
@@ -199,23 +248,10 @@ void MessageLayout::actuallyLayout(const MessageLayoutContext &ctx)
             continue;
         }
 
-        element->addToContainer(this->container_, ctx);
-    }
-
-    if (this->height_ != this->container_.getHeight())
-    {
-        this->deleteBuffer();
+        element->addToContainer(container, ctx);
     }
 
-    this->container_.endLayout();
-    this->height_ = this->container_.getHeight();
-
-    // collapsed state
-    this->flags.unset(MessageLayoutFlag::Collapsed);
-    if (this->container_.isCollapsed())
-    {
-        this->flags.set(MessageLayoutFlag::Collapsed);
-    }
+    container.endLayout();
 }
 
 // Painting
@@ -223,24 +259,25 @@ MessagePaintResult MessageLayout::paint(const MessagePaintContext &ctx)
 {
     MessagePaintResult result;
 
-    QPixmap *pixmap = this->ensureBuffer(ctx.painter, ctx.canvasWidth,
-                                         ctx.messageColors.hasTransparency);
+    auto &buffer = this->ensureBuffer(ctx);
+    QPixmap *pixmap = &buffer.pixmap;
 
-    if (!this->bufferValid_)
+    if (!buffer.valid)
     {
         if (ctx.messageColors.hasTransparency)
         {
             pixmap->fill(Qt::transparent);
         }
         this->updateBuffer(pixmap, ctx);
+        buffer.valid = true;
     }
 
     // draw on buffer
     ctx.painter.drawPixmap(QPoint{0, ctx.y}, *pixmap);
 
     // draw gif emotes
-    result.hasAnimatedElements =
-        this->container_.paintAnimatedElements(ctx.painter, ctx.y);
+    result.hasAnimatedElements = this->container().paintAnimatedElements(
+        ctx.painter, ctx.y, result.animationArea);
 
     // draw disabled
     if (this->message_->flags.has(MessageFlag::Disabled))
@@ -286,7 +323,7 @@ MessagePaintResult MessageLayout::paint(const MessagePaintContext &ctx)
     // draw selection
     if (!ctx.selection.isEmpty())
     {
-        this->container_.paintSelection(ctx.painter, ctx.messageIndex,
+        this->container().paintSelection(ctx.painter, ctx.messageIndex,
                                         ctx.selection, ctx.y);
     }
 
@@ -297,7 +334,7 @@ MessagePaintResult MessageLayout::paint(const MessagePaintContext &ctx)
             QRectF{
                 0.0,
                 static_cast<qreal>(ctx.y),
-                this->container_.getWidth() + 64,
+                this->container().getWidth() + 64,
                 1.0,
             },
             ctx.messageColors.messageSeperator);
@@ -323,40 +360,52 @@ MessagePaintResult MessageLayout::paint(const MessagePaintContext &ctx)
         ctx.painter.fillRect(
             QRectF{
                 0,
-                ctx.y + this->container_.getHeight() - 1,
+                ctx.y + this->container().getHeight() - 1,
                 static_cast<qreal>(pixmap->width()),
                 1,
             },
             brush);
     }
 
-    this->bufferValid_ = true;
-
     return result;
 }
 
-QPixmap *MessageLayout::ensureBuffer(QPainter &painter, qreal width, bool clear)
+MessageLayoutBuffer &MessageLayout::ensureBuffer(const MessagePaintContext &ctx)
 {
     if (this->buffer_ != nullptr)
     {
-        return this->buffer_.get();
+        return *this->buffer_;
+    }
+
+    if (!this->data_)
+    {
+        // Painted before being laid out
+        this->data_ = std::make_shared<MessageLayoutData>();
     }
 
-    // Create new buffer
-    this->buffer_ = std::make_unique<QPixmap>(
-        static_cast<int>(width * painter.device()->devicePixelRatioF()),
-        static_cast<int>(this->container_.getHeight() *
-                         painter.device()->devicePixelRatioF()));
-    this->buffer_->setDevicePixelRatio(painter.device()->devicePixelRatioF());
+    this->buffer_ = this->data_->getBuffer({
+        .alternateBackground =
+            this->flags.has(MessageLayoutFlag::AlternateBackground),
+        .ignoreHighlights = this->flags.has(MessageLayoutFlag::IgnoreHighlights),
+        .hasTransparency = ctx.messageColors.hasTransparency,
+        .canvasWidth = ctx.canvasWidth,
+        .devicePixelRatio = ctx.painter.device()->devicePixelRatioF(),
+        .regularBg = ctx.messageColors.regularBg.rgba(),
+        .alternateBg = ctx.messageColors.alternateBg.rgba(),
+        .systemText = ctx.messageColors.systemText.rgba(),
+    });
+    return *this->buffer_;
+}
 
-    if (clear)
+const MessageLayoutContainer &MessageLayout::container() const
+{
+    if (this->data_)
     {
-        this->buffer_->fill(Qt::transparent);
+        return this->data_->container;
     }
 
-    this->bufferValid_ = false;
-    DebugCount::increase("message drawing buffers");
-    return this->buffer_.get();
+    static const MessageLayoutContainer empty;
+    return empty;
 }
 
 void MessageLayout::updateBuffer(QPixmap *buffer,
@@ -450,7 +499,7 @@ void MessageLayout::updateBuffer(QPixmap *buffer,
     painter.fillRect(buffer->rect(), backgroundColor);
 
     // draw message
-    this->container_.paintElements(painter, ctx);
+    this->container().paintElements(painter, ctx);
 
 #ifdef FOURTF
     // debug
@@ -461,7 +510,7 @@ void MessageLayout::updateBuffer(QPixmap *buffer,
     QTextOption option;
     option.setAlignment(Qt::AlignRight | Qt::AlignTop);
 
-    painter.drawText(QRectF(1, 1, this->container_.getWidth() - 3, 1000),
+    painter.drawText(QRectF(1, 1, this->container().getWidth() - 3, 1000),
                      QString::number(this->layoutCount_) + ", " +
                          QString::number(++this->bufferUpdatedCount_),
                      option);
@@ -470,17 +519,16 @@ void MessageLayout::updateBuffer(QPixmap *buffer,
 
 void MessageLayout::invalidateBuffer()
 {
-    this->bufferValid_ = false;
+    if (this->buffer_ != nullptr)
+    {
+        this->buffer_->valid = false;
+    }
 }
 
 void MessageLayout::deleteBuffer()
 {
-    if (this->buffer_ != nullptr)
-    {
-        DebugCount::decrease("message drawing buffers");
-
-        this->buffer_ = nullptr;
-    }
+    // The buffer is deleted once no other layout uses it
+    this->buffer_ = nullptr;
 }
 
 void MessageLayout::deleteCache()
@@ -488,7 +536,7 @@ void MessageLayout::deleteCache()
     this->deleteBuffer();
 
 #ifdef XD
-    this->container_.clear();
+    this->data_ = nullptr;
 #endif
 }
 
@@ -501,7 +549,7 @@ void MessageLayout::deleteCache()
 const MessageLayoutElement *MessageLayout::getElementAt(QPointF point) const
 {
     // go through all words and return the first one that contains the point.
-    return this->container_.getElementAt(point);
+    return this->container().getElementAt(point);
 }
 
 std::pair<int, int> MessageLayout::getWordBounds(
@@ -511,7 +559,7 @@ std::pair<int, int> MessageLayout::getWordBounds(
     // elements in the container
     if (hoveredElement->getWordId() != -1)
     {
-        return this->container_.getWordBounds(hoveredElement);
+        return this->container().getWordBounds(hoveredElement);
     }
 
     const auto wordStart = this->getSelectionIndex(relativePos) -
@@ -525,23 +573,23 @@ std::pair<int, int> MessageLayout::getWordBounds(
 
 size_t MessageLayout::getLastCharacterIndex() const
 {
-    return this->container_.getLastCharacterIndex();
+    return this->container().getLastCharacterIndex();
 }
 
 size_t MessageLayout::getFirstMessageCharacterIndex() const
 {
-    return this->container_.getFirstMessageCharacterIndex();
+    return this->container().getFirstMessageCharacterIndex();
 }
 
 size_t MessageLayout::getSelectionIndex(QPointF position) const
 {
-    return this->container_.getSelectionIndex(position);
+    return this->container().getSelectionIndex(position);
 }
 
 void MessageLayout::addSelectionText(QString &str, uint32_t from, uint32_t to,
                                      CopyMode copymode)
 {
-    this->container_.addSelectionText(str, from, to, copymode);
+    this->container().addSelectionText(str, from, to, copymode);
 }
 
 }  // namespace chatterino
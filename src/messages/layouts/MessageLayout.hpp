@@ -3,8 +3,10 @@
 #include "common/Common.hpp"
 #include "common/FlagsEnum.hpp"
 #include "messages/layouts/MessageLayoutContainer.hpp"
+#include "messages/MessageFlag.hpp"
 
 #include <QPixmap>
+#include <QRegion>
 
 #include <cinttypes>
 #include <memory>
@@ -16,6 +18,8 @@ using MessagePtr = std::shared_ptr<const Message>;
 
 struct Selection;
 struct MessageLayoutContainer;
+struct MessageLayoutData;
+struct MessageLayoutBuffer;
 class MessageLayoutElement;
 struct MessagePaintContext;
 struct MessageLayoutContext;
@@ -35,6 +39,8 @@ using MessageLayoutFlags = FlagsEnum<MessageLayoutFlag>;
 
 struct MessagePaintResult {
     bool hasAnimatedElements = false;
+    /// The area covered by animated elements, relative to the canvas
+    QRegion animationArea;
 };
 
 class MessageLayout
@@ -114,23 +120,29 @@ public:
 private:
     // methods
     void actuallyLayout(const MessageLayoutContext &ctx);
+    void layoutContainer(MessageLayoutContainer &container,
+                         const MessageLayoutContext &ctx) const;
     void updateBuffer(QPixmap *buffer, const MessagePaintContext &ctx);
 
-    // Create new buffer if required, returning the buffer
-    QPixmap *ensureBuffer(QPainter &painter, qreal width, bool clear);
+    // Find or create the buffer for the current layout, returning the buffer
+    MessageLayoutBuffer &ensureBuffer(const MessagePaintContext &ctx);
+
+    const MessageLayoutContainer &container() const;
 
     // variables
     const MessagePtr message_;
-    MessageLayoutContainer container_;
-    std::unique_ptr<QPixmap> buffer_;
-    bool bufferValid_ = false;
+    /// Shared with other MessageLayouts of the same message, see
+    /// MessageLayoutCache
+    std::shared_ptr<MessageLayoutData> data_;
+    std::shared_ptr<MessageLayoutBuffer> buffer_;
 
-    qreal height_ = 0;
     int currentLayoutWidth_ = -1;
     int layoutState_ = -1;
     float scale_ = -1;
     float imageScale_ = -1.F;
     MessageElementFlags currentWordFlags_;
+    /// The flags of the message when it was last laid out
+    MessageFlags currentMessageFlags_;
 
 #ifdef FOURTF
     // Debug counters
@@ -0,0 +1,120 @@
+#include "messages/layouts/MessageLayoutCache.hpp"
+
+#include "util/Metrics.hpp"
+
+#include <QHashFunctions>
+
+namespace chatterino {
+
+namespace {
+
+const metrics::Counter DRAWING_BUFFERS("message drawing buffers");
+const metrics::Counter BUFFER_CACHE_HITS("message buffer cache hits");
+const metrics::Counter BUFFER_CACHE_MISSES("message buffer cache misses");
+const metrics::Counter LAYOUT_CACHE_HITS("message layout cache hits");
+const metrics::Counter LAYOUT_CACHE_MISSES("message layout cache misses");
+const metrics::Counter LAYOUT_CACHE_ENTRIES("message layout cache entries");
+
+}  // namespace
+
+MessageLayoutBuffer::MessageLayoutBuffer(const Key &key, qreal height)
+    : pixmap(static_cast<int>(key.canvasWidth * key.devicePixelRatio),
+             static_cast<int>(height * key.devicePixelRatio))
+{
+    this->pixmap.setDevicePixelRatio(key.devicePixelRatio);
+
+    if (key.hasTransparency)
+    {
+        this->pixmap.fill(Qt::transparent);
+    }
+
+    DRAWING_BUFFERS.increase();
+}
+
+MessageLayoutBuffer::~MessageLayoutBuffer()
+{
+    DRAWING_BUFFERS.decrease();
+}
+
+std::shared_ptr<MessageLayoutBuffer> MessageLayoutData::getBuffer(
+    const MessageLayoutBuffer::Key &key)
+{
+    // There are only a few buffers per layout, usually one per view
+    std::erase_if(this->buffers_, [](const auto &entry) {
+        return entry.second.expired();
+    });
+
+    for (const auto &[bufferKey, weak] : this->buffers_)
+    {
+        if (bufferKey == key)
+        {
+            if (auto buffer = weak.lock())
+            {
+                BUFFER_CACHE_HITS.increase();
+                return buffer;
+            }
+        }
+    }
+
+    BUFFER_CACHE_MISSES.increase();
+    auto buffer = std::make_shared<MessageLayoutBuffer>(
+        key, this->container.getHeight());
+    this->buffers_.emplace_back(key, buffer);
+    return buffer;
+}
+
+MessageLayoutCache &MessageLayoutCache::instance()
+{
+    // Never destroyed, MessageLayouts might outlive static destruction
+    static auto *cache = new MessageLayoutCache;
+    return *cache;
+}
+
+std::shared_ptr<MessageLayoutData> MessageLayoutCache::find(const Key &key)
+{
+    auto it = this->entries_.find(key);
+    if (it != this->entries_.end())
+    {
+        if (auto data = it->second.lock())
+        {
+            LAYOUT_CACHE_HITS.increase();
+            return data;
+        }
+    }
+
+    LAYOUT_CACHE_MISSES.increase();
+    return nullptr;
+}
+
+std::shared_ptr<MessageLayoutData> MessageLayoutCache::create(const Key &key)
+{
+    // The entry is removed when the last MessageLayout releases the data
+    std::shared_ptr<MessageLayoutData> data(
+        new MessageLayoutData, [this, key](MessageLayoutData *data) {
+            auto it = this->entries_.find(key);
+            if (it != this->entries_.end() && it->second.expired())
+            {
+                this->entries_.erase(it);
+                LAYOUT_CACHE_ENTRIES.decrease();
+            }
+            delete data;
+        });
+
+    auto [it, inserted] = this->entries_.insert_or_assign(key, data);
+    if (inserted)
+    {
+        LAYOUT_CACHE_ENTRIES.increase();
+    }
+    return data;
+}
+
+size_t MessageLayoutCache::KeyHash::operator()(const Key &key) const
+{
+    return qHashMulti(0, key.message,
+                      static_cast<quint64>(key.messageFlags.value()),
+                      static_cast<quint64>(key.elementFlags.value()), key.width,
+                      key.scale, key.imageScale, key.generation, key.expanded,
+                      key.regularText, key.linkText, key.systemText);
+}
+
+}  // namespace chatterino
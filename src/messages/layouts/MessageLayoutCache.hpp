@@ -0,0 +1,114 @@
+#pragma once
+
+#include "messages/layouts/MessageLayoutContainer.hpp"
+#include "messages/MessageElement.hpp"
+#include "messages/MessageFlag.hpp"
+
+#include <QPixmap>
+#include <QRgb>
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace chatterino {
+
+struct Message;
+
+/// A pixmap a MessageLayoutData was painted to
+struct MessageLayoutBuffer {
+    /// Everything the painted pixels depend on besides the layout
+    struct Key {
+        bool alternateBackground = false;
+        bool ignoreHighlights = false;
+        bool hasTransparency = false;
+        int canvasWidth = 0;
+        qreal devicePixelRatio = 1;
+        QRgb regularBg = 0;
+        QRgb alternateBg = 0;
+        QRgb systemText = 0;
+
+        bool operator==(const Key &other) const = default;
+    };
+
+    MessageLayoutBuffer(const Key &key, qreal height);
+    ~MessageLayoutBuffer();
+
+    MessageLayoutBuffer(const MessageLayoutBuffer &) = delete;
+    MessageLayoutBuffer &operator=(const MessageLayoutBuffer &) = delete;
+    MessageLayoutBuffer(MessageLayoutBuffer &&) = delete;
+    MessageLayoutBuffer &operator=(MessageLayoutBuffer &&) = delete;
+
+    QPixmap pixmap;
+    /// False if the pixmap has to be painted again
+    bool valid = false;
+};
+
+/// The result of laying out a message. It's shared by all MessageLayouts that
+/// lay out the same message with the same parameters and isn't modified once
+/// it's laid out.
+struct MessageLayoutData {
+    MessageLayoutContainer container;
+
+    /// Returns the buffer painted with `key`, creating an empty one if no
+    /// MessageLayout holds one anymore.
+    std::shared_ptr<MessageLayoutBuffer> getBuffer(
+        const MessageLayoutBuffer::Key &key);
+
+private:
+    std::vector<std::pair<MessageLayoutBuffer::Key,
+                          std::weak_ptr<MessageLayoutBuffer>>>
+        buffers_;
+};
+
+/// @brief Shares laid out messages between views.
+///
+/// When the same channel is shown in multiple views (e.g. a split, a popup and
+/// /mentions), their MessageLayouts look up the result of laying out a message
+/// here before doing it themselves. Entries are removed as soon as no
+/// MessageLayout holds them.
+///
+/// This must only be used from the GUI thread.
+class MessageLayoutCache
+{
+public:
+    /// Everything a layout depends on
+    struct Key {
+        const Message *message = nullptr;
+        MessageFlags messageFlags;
+        MessageElementFlags elementFlags;
+        int width = 0;
+        float scale = 0;
+        float imageScale = 0;
+        /// WindowManager::getGeneration()
+        int generation = 0;
+        bool expanded = false;
+        QRgb regularText = 0;
+        QRgb linkText = 0;
+        QRgb systemText = 0;
+
+        bool operator==(const Key &other) const = default;
+    };
+
+    static MessageLayoutCache &instance();
+
+    /// Returns the layout for `key` if any MessageLayout still holds it
+    std::shared_ptr<MessageLayoutData> find(const Key &key);
+
+    /// Creates an empty layout for `key`, replacing any previous one
+    std::shared_ptr<MessageLayoutData> create(const Key &key);
+
+private:
+    MessageLayoutCache() = default;
+
+    struct KeyHash {
+        size_t operator()(const Key &key) const;
+    };
+
+    std::unordered_map<Key, std::weak_ptr<MessageLayoutData>, KeyHash>
+        entries_;
+};
+
+}  // namespace chatterino
@@ -262,12 +262,17 @@ void MessageLayoutContainer::paintElements(QPainter &painter,
 }
 
 bool MessageLayoutContainer::paintAnimatedElements(QPainter &painter,
-                                                   qreal yOffset) const
+                                                   qreal yOffset,
+                                                   QRegion &area) const
 {
     bool anyAnimatedElement = false;
     for (const auto &element : this->elements_)
     {
-        anyAnimatedElement |= element->paintAnimated(painter, yOffset);
+        if (element->paintAnimated(painter, yOffset))
+        {
+            anyAnimatedElement = true;
+            area += element->getRect().translated(0, yOffset).toAlignedRect();
+        }
     }
     return anyAnimatedElement;
 }
@@ -6,6 +6,7 @@
 
 #include <QPoint>
 #include <QRect>
+#include <QRegion>
 
 #include <memory>
 #include <optional>
@@ -71,9 +72,11 @@ struct MessageLayoutContainer {
 
     /**
      * Paint the animated elements in this message
+     * @param area The rectangles of all animated elements are added to this
      * @returns true if this container contains at least one animated element
      */
-    bool paintAnimatedElements(QPainter &painter, qreal yOffset) const;
+    bool paintAnimatedElements(QPainter &painter, qreal yOffset,
+                               QRegion &area) const;
 
     /**
      * Paint the selection for this container
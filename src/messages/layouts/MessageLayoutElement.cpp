@@ -6,7 +6,7 @@
 #include "messages/layouts/MessageLayoutContext.hpp"
 #include "messages/MessageElement.hpp"
 #include "providers/twitch/TwitchEmotes.hpp"
-#include "util/DebugCount.hpp"
+#include "util/Metrics.hpp"
 
 #include <QDebug>
 #include <QPainter>
@@ -14,6 +14,8 @@
 
 namespace {
 
+const chatterino::metrics::Counter MESSAGE_LAYOUT_ELEMENTS("message layout elements");
+
 const QChar RTL_EMBED(0x202B);
 
 void alignRectBottomCenter(QRectF &rect, const QRectF &reference)
@@ -36,12 +38,12 @@ MessageLayoutElement::MessageLayoutElement(MessageElement &creator, QSizeF size)
     : rect_(QPointF{}, size)
     , creator_(creator)
 {
-    DebugCount::increase("message layout elements");
+    MESSAGE_LAYOUT_ELEMENTS.increase();
 }
 
 MessageLayoutElement::~MessageLayoutElement()
 {
-    DebugCount::decrease("message layout elements");
+    MESSAGE_LAYOUT_ELEMENTS.decrease();
 }
 
 MessageElement &MessageLayoutElement::getCreator() const
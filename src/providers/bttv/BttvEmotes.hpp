@@ -43,11 +43,14 @@ public:
     std::optional<EmotePtr> emote(const EmoteName &name) const;
     void loadEmotes();
     void setEmotes(std::shared_ptr<const EmoteMap> emotes);
+    /// `finallyCallback` is called once the request finished, whether it
+    /// succeeded or not.
     static void loadChannel(std::weak_ptr<Channel> channel,
                             const QString &channelId,
                             const QString &channelDisplayName,
                             std::function<void(EmoteMap &&)> callback,
-                            bool manualRefresh, bool cacheHit);
+                            bool manualRefresh, bool cacheHit,
+                            std::function<void()> finallyCallback = {});
 
     /**
      * Adds an emote to the `channelEmoteMap`.
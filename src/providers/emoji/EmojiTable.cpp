@@ -0,0 +1,58 @@
+#include "providers/emoji/EmojiTable.hpp"
+
+#include <algorithm>
+
+namespace chatterino::emoji {
+
+std::optional<EmojiMatch> matchEmoji(std::u16string_view text)
+{
+    const auto &trie = EMOJI_TABLE.trie;
+
+    std::optional<EmojiMatch> match;
+    const auto *node = &trie[0];
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        auto children = trie.subspan(node->firstChild, node->childCount);
+        auto child = std::ranges::lower_bound(children, text[i], {},
+                                              &EmojiTrieNode::unit);
+        if (child == children.end() || child->unit != text[i])
+        {
+            break;
+        }
+
+        node = &*child;
+        if (node->emoji != EmojiTrieNode::NO_EMOJI)
+        {
+            match = EmojiMatch{
+                .emoji = node->emoji,
+                .length = i + 1,
+            };
+        }
+    }
+
+    return match;
+}
+
+std::optional<uint32_t> findShortCode(std::u16string_view name)
+{
+    const auto &seeds = EMOJI_TABLE.shortCodeSeeds;
+    const auto &slots = EMOJI_TABLE.shortCodeSlots;
+
+    auto bucket = shortCodeHash(name, 0) % seeds.size();
+    auto slot = shortCodeHash(name, seeds[bucket]) % slots.size();
+    auto index = slots[slot];
+    if (index == EmojiTable::NO_SHORT_CODE)
+    {
+        return std::nullopt;
+    }
+
+    const auto &shortCode = EMOJI_TABLE.shortCodes[index];
+    if (EMOJI_TABLE.text.substr(shortCode.name.offset,
+                                shortCode.name.length) != name)
+    {
+        return std::nullopt;
+    }
+    return shortCode.emoji;
+}
+
+}  // namespace chatterino::emoji
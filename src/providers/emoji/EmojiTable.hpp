@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+
+/// The emoji table is generated from resources/emoji.json at build time by
+/// tools/emoji-table. This header is shared with the generator, so it must
+/// only depend on the standard library.
+namespace chatterino::emoji {
+
+/// A range of `EmojiTable::text` or `EmojiTable::shortCodes`
+struct EmojiTableRange {
+    uint32_t offset = 0;
+    uint32_t length = 0;
+};
+
+struct EmojiTableEntry {
+    /// The fully qualified emoji (UTF-16)
+    EmojiTableRange value;
+    /// The non qualified emoji (UTF-16), empty if there's none
+    EmojiTableRange nonQualified;
+    /// e.g. "1F427"
+    EmojiTableRange unifiedCode;
+    EmojiTableRange nonQualifiedCode;
+    /// The short codes of this emoji in `EmojiTable::shortCodes`
+    EmojiTableRange shortCodes;
+    /// EmojiStyle flags
+    uint8_t capabilities = 0;
+};
+
+struct EmojiShortCode {
+    /// e.g. "penguin"
+    EmojiTableRange name;
+    /// Index into `EmojiTable::emojis`
+    uint32_t emoji = 0;
+};
+
+/// A node in the trie of the UTF-16 code units of all emojis. The children
+/// of a node are stored next to each other and are sorted by their unit.
+struct EmojiTrieNode {
+    char16_t unit = 0;
+    uint16_t childCount = 0;
+    uint32_t firstChild = 0;
+    /// The emoji ending at this node or NO_EMOJI
+    uint32_t emoji = NO_EMOJI;
+
+    static constexpr uint32_t NO_EMOJI = UINT32_MAX;
+};
+
+struct EmojiTable {
+    /// All emojis in the order of emoji.json, skin tone variations follow
+    /// their base emoji
+    std::span<const EmojiTableEntry> emojis;
+    /// The short codes of all emojis in the order of `emojis`
+    std::span<const EmojiShortCode> shortCodes;
+    /// Indices into `shortCodes` sorted by the name of the short code
+    std::span<const uint16_t> sortedShortCodes;
+    /// The strings all ranges point into
+    std::u16string_view text;
+
+    /// The root is the first node
+    std::span<const EmojiTrieNode> trie;
+    /// Bit `c` is set if an emoji starts with the ASCII character `c`
+    uint64_t asciiStarts[2]{};
+
+    /// The displacement of each bucket of the perfect hash of short codes
+    std::span<const uint16_t> shortCodeSeeds;
+    /// Index into `shortCodes` for each slot or NO_SHORT_CODE
+    std::span<const uint16_t> shortCodeSlots;
+
+    static constexpr uint16_t NO_SHORT_CODE = UINT16_MAX;
+};
+
+extern const EmojiTable EMOJI_TABLE;
+
+/// Hashes a short code for the perfect hash in EmojiTable
+constexpr uint32_t shortCodeHash(std::u16string_view name, uint32_t seed)
+{
+    // FNV-1a, finalized like MurmurHash3
+    uint32_t hash = 2166136261U ^ (seed * 16777619U);
+    for (auto c : name)
+    {
+        hash ^= c;
+        hash *= 16777619U;
+    }
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bU;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35U;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+struct EmojiMatch {
+    /// Index into `EmojiTable::emojis`
+    uint32_t emoji = 0;
+    /// The number of UTF-16 code units matched
+    size_t length = 0;
+};
+
+/// Returns false if no emoji starts with @a unit. This is only a quick check
+/// for ASCII characters, all others might start an emoji.
+inline bool mayStartEmoji(char16_t unit)
+{
+    if (unit >= 128)
+    {
+        return true;
+    }
+    return ((EMOJI_TABLE.asciiStarts[unit / 64] >> (unit % 64)) & 1) != 0;
+}
+
+/// Returns the longest (fully or non qualified) emoji @a text starts with
+std::optional<EmojiMatch> matchEmoji(std::u16string_view text);
+
+/// Returns the index of the emoji with the short code @a name
+std::optional<uint32_t> findShortCode(std::u16string_view name);
+
+}  // namespace chatterino::emoji
@@ -1,152 +1,40 @@
 #include "providers/emoji/Emojis.hpp"
 
-#include "common/QLogging.hpp"
 #include "messages/Emote.hpp"
 #include "messages/Image.hpp"
+#include "providers/emoji/EmojiTable.hpp"
 #include "singletons/Settings.hpp"
 #include "util/QCompareTransparent.hpp"
 #include "util/QMagicEnum.hpp"
-#include "util/RapidjsonHelpers.hpp"
 
 #include <boost/variant.hpp>
-#include <QFile>
-#include <rapidjson/error/en.h>
-#include <rapidjson/error/error.h>
-#include <rapidjson/rapidjson.h>
 
 #include <map>
 #include <memory>
+#include <string_view>
 
 namespace {
 
 using namespace chatterino;
+using namespace chatterino::emoji;
 
-const std::map<QString, QString> TONE_NAMES{
-    {"1F3FB", "tone1"}, {"1F3FC", "tone2"}, {"1F3FD", "tone3"},
-    {"1F3FE", "tone4"}, {"1F3FF", "tone5"},
-};
-
-void parseEmoji(const std::shared_ptr<EmojiData> &emojiData,
-                const rapidjson::Value &unparsedEmoji,
-                const QString &shortCode = {})
+/// Returns the string at @a range of the emoji table without copying it
+QString tableString(EmojiTableRange range)
 {
-    std::vector<char32_t> unicodeBytes{};
-
-    struct {
-        bool apple;
-        bool google;
-        bool twitter;
-        bool facebook;
-    } capabilities{};
-
-    if (!shortCode.isEmpty())
-    {
-        emojiData->shortCodes.push_back(shortCode);
-    }
-    else
-    {
-        // Load short codes from the suggested short_names
-        const auto &shortNames = unparsedEmoji["short_names"];
-        for (const auto &shortName : shortNames.GetArray())
-        {
-            emojiData->shortCodes.emplace_back(shortName.GetString());
-        }
-    }
-
-    rj::getSafe(unparsedEmoji, "non_qualified", emojiData->nonQualifiedCode);
-    rj::getSafe(unparsedEmoji, "unified", emojiData->unifiedCode);
-    assert(!emojiData->unifiedCode.isEmpty());
-
-    rj::getSafe(unparsedEmoji, "has_img_apple", capabilities.apple);
-    rj::getSafe(unparsedEmoji, "has_img_google", capabilities.google);
-    rj::getSafe(unparsedEmoji, "has_img_twitter", capabilities.twitter);
-    rj::getSafe(unparsedEmoji, "has_img_facebook", capabilities.facebook);
-
-    if (capabilities.apple)
-    {
-        emojiData->capabilities.set(EmojiData::Capability::Apple);
-    }
-    if (capabilities.google)
+    if (range.length == 0)
     {
-        emojiData->capabilities.set(EmojiData::Capability::Google);
+        return {};
     }
-    if (capabilities.twitter)
-    {
-        emojiData->capabilities.set(EmojiData::Capability::Twitter);
-    }
-    if (capabilities.facebook)
-    {
-        emojiData->capabilities.set(EmojiData::Capability::Facebook);
-    }
-
-    QStringList unicodeCharacters = emojiData->unifiedCode.toLower().split('-');
 
-    for (const QString &unicodeCharacter : unicodeCharacters)
-    {
-        bool ok{false};
-        unicodeBytes.push_back(unicodeCharacter.toUInt(&ok, 16));
-        if (!ok)
-        {
-            qCWarning(chatterinoEmoji)
-                << "Failed to parse emoji" << emojiData->shortCodes;
-            return;
-        }
-    }
-
-    // We can safely do a narrowing static cast since unicodeBytes will never be a large number
-    emojiData->value =
-        QString::fromUcs4(unicodeBytes.data(),
-                          static_cast<QString::size_type>(unicodeBytes.size()));
-
-    if (!emojiData->nonQualifiedCode.isEmpty())
-    {
-        QStringList nonQualifiedCharacters =
-            emojiData->nonQualifiedCode.toLower().split('-');
-        std::vector<char32_t> nonQualifiedBytes{};
-        for (const QString &unicodeCharacter : nonQualifiedCharacters)
-        {
-            bool ok{false};
-            nonQualifiedBytes.push_back(
-                QString(unicodeCharacter).toUInt(&ok, 16));
-            if (!ok)
-            {
-                qCWarning(chatterinoEmoji)
-                    << "Failed to parse emoji nonQualified"
-                    << emojiData->shortCodes;
-                return;
-            }
-        }
-
-        // We can safely do a narrowing static cast since unicodeBytes will never be a large number
-        emojiData->nonQualified = QString::fromUcs4(
-            nonQualifiedBytes.data(),
-            static_cast<QString::size_type>(nonQualifiedBytes.size()));
-    }
+    return QString::fromRawData(
+        reinterpret_cast<const QChar *>(EMOJI_TABLE.text.data() + range.offset),
+        static_cast<QString::size_type>(range.length));
 }
 
-// getToneNames takes a tones and returns their names in the same order
-// The format of the tones is: "1F3FB-1F3FB" or "1F3FB"
-// The output of the tone names is: "tone1-tone1" or "tone1"
-QString getToneNames(const QString &tones)
+std::u16string_view toU16View(QStringView text)
 {
-    auto toneParts = tones.split('-');
-    QStringList toneNameResults;
-    for (const auto &tonePart : toneParts)
-    {
-        auto toneNameIt = TONE_NAMES.find(tonePart);
-        if (toneNameIt == TONE_NAMES.end())
-        {
-            qDebug() << "Tone with key" << tonePart
-                     << "does not exist in tone names map";
-            continue;
-        }
-
-        toneNameResults.append(toneNameIt->second);
-    }
-
-    assert(!toneNameResults.isEmpty());
-
-    return toneNameResults.join('-');
+    return {reinterpret_cast<const char16_t *>(text.utf16()),
+            static_cast<size_t>(text.size())};
 }
 
 }  // namespace
@@ -163,84 +51,40 @@ void Emojis::load()
 
     this->loadEmojis();
 
-    this->sortEmojis();
-
     this->loadEmojiSet();
 }
 
 void Emojis::loadEmojis()
 {
+    // The table is generated from resources/emoji.json when building
     // Current version: https://github.com/iamcal/emoji-data/blob/v15.1.1/emoji.json (Emoji version 15.1 (2023))
-    QFile file(":/emoji.json");
-    file.open(QFile::ReadOnly);
-    QTextStream s1(&file);
-    QString data = s1.readAll();
-    rapidjson::Document root;
-    rapidjson::ParseResult result = root.Parse(data.toUtf8(), data.length());
-
-    if (result.Code() != rapidjson::kParseErrorNone)
-    {
-        qCWarning(chatterinoEmoji)
-            << "JSON parse error:" << rapidjson::GetParseError_En(result.Code())
-            << "(" << result.Offset() << ")";
-        return;
-    }
-
-    for (const auto &unparsedEmoji : root.GetArray())
+    this->emojis.reserve(EMOJI_TABLE.emojis.size());
+    for (const auto &entry : EMOJI_TABLE.emojis)
     {
         auto emojiData = std::make_shared<EmojiData>();
-        parseEmoji(emojiData, unparsedEmoji);
-
-        for (const auto &shortCode : emojiData->shortCodes)
+        emojiData->value = tableString(entry.value);
+        emojiData->nonQualified = tableString(entry.nonQualified);
+        emojiData->unifiedCode = tableString(entry.unifiedCode);
+        emojiData->nonQualifiedCode = tableString(entry.nonQualifiedCode);
+        emojiData->capabilities =
+            EmojiData::Capabilities(static_cast<EmojiStyle>(entry.capabilities));
+
+        emojiData->shortCodes.reserve(entry.shortCodes.length);
+        for (const auto &shortCode : EMOJI_TABLE.shortCodes.subspan(
+                 entry.shortCodes.offset, entry.shortCodes.length))
         {
-            this->emojiShortCodeToEmoji_.insert(shortCode, emojiData);
-            this->shortCodes.emplace_back(shortCode);
+            emojiData->shortCodes.push_back(tableString(shortCode.name));
         }
 
-        this->emojiFirstByte_[emojiData->value.at(0)].append(emojiData);
-
-        this->emojis.push_back(emojiData);
-
-        if (unparsedEmoji.HasMember("skin_variations"))
-        {
-            for (const auto &skinVariation :
-                 unparsedEmoji["skin_variations"].GetObject())
-            {
-                auto toneName = getToneNames(skinVariation.name.GetString());
-                const auto &variation = skinVariation.value;
-
-                auto variationEmojiData = std::make_shared<EmojiData>();
-
-                parseEmoji(variationEmojiData, variation,
-                           emojiData->shortCodes[0] + "_" + toneName);
-
-                this->emojiShortCodeToEmoji_.insert(
-                    variationEmojiData->shortCodes[0], variationEmojiData);
-                this->shortCodes.push_back(variationEmojiData->shortCodes[0]);
-
-                this->emojiFirstByte_[variationEmojiData->value.at(0)].append(
-                    variationEmojiData);
-
-                this->emojis.push_back(variationEmojiData);
-            }
-        }
+        this->emojis.push_back(std::move(emojiData));
     }
-}
 
-void Emojis::sortEmojis()
-{
-    for (auto &p : this->emojiFirstByte_)
+    this->shortCodes.reserve(EMOJI_TABLE.sortedShortCodes.size());
+    for (auto index : EMOJI_TABLE.sortedShortCodes)
     {
-        std::stable_sort(p.begin(), p.end(),
-                         [](const auto &lhs, const auto &rhs) {
-                             return lhs->value.length() > rhs->value.length();
-                         });
+        this->shortCodes.push_back(
+            tableString(EMOJI_TABLE.shortCodes[index].name));
     }
-
-    auto &p = this->shortCodes;
-    std::stable_sort(p.begin(), p.end(), [](const auto &lhs, const auto &rhs) {
-        return lhs < rhs;
-    });
 }
 
 void Emojis::loadEmojiSet()
@@ -250,6 +94,7 @@ void Emojis::loadEmojiSet()
                                  emojiSet, qmagicenum::CASE_INSENSITIVE)
                                  .value_or(EmojiData::Capability::Google);
 
+        std::unique_lock lock(this->emotesMutex_);
         for (const auto &emoji : this->emojis)
         {
             QString emojiSetToUse = emojiSet;
@@ -305,75 +150,26 @@ std::vector<boost::variant<EmotePtr, QString>> Emojis::parse(
     auto result = std::vector<boost::variant<EmotePtr, QString>>();
     QString::size_type lastParsedEmojiEndIndex = 0;
 
-    for (qsizetype i = 0; i < text.length(); ++i)
+    // Nothing can be matched before the emojis are loaded
+    auto view = this->loaded_ ? toU16View(text) : std::u16string_view{};
+    for (size_t i = 0; i < view.size(); ++i)
     {
-        const QChar character = text.at(i);
-
-        if (character.isLowSurrogate())
-        {
-            continue;
-        }
-
-        auto it = this->emojiFirstByte_.find(character);
-        if (it == this->emojiFirstByte_.end())
+        if (!mayStartEmoji(view[i]))
         {
-            // No emoji starts with this character
+            // Most messages are plain ASCII, skip those characters early
             continue;
         }
 
-        const auto &possibleEmojis = it.value();
-
-        auto remainingCharacters = text.length() - i - 1;
-
-        std::shared_ptr<EmojiData> matchedEmoji;
-
-        QString::size_type matchedEmojiLength = 0;
-
-        for (const std::shared_ptr<EmojiData> &emoji : possibleEmojis)
-        {
-            auto emojiNonQualifiedExtraCharacters =
-                emoji->nonQualified.length() - 1;
-            auto emojiExtraCharacters = emoji->value.length() - 1;
-            if (remainingCharacters >= emojiExtraCharacters)
-            {
-                // look in emoji->value
-                bool match = QStringView{emoji->value}.mid(1) ==
-                             QStringView{text}.mid(i + 1, emojiExtraCharacters);
-
-                if (match)
-                {
-                    matchedEmoji = emoji;
-                    matchedEmojiLength = emoji->value.length();
-
-                    break;
-                }
-            }
-            if (!emoji->nonQualified.isNull() &&
-                remainingCharacters >= emojiNonQualifiedExtraCharacters)
-            {
-                // This checking here relies on the fact that the nonQualified string
-                // always starts with the same byte as value (the unified string)
-                bool match = QStringView{emoji->nonQualified}.mid(1) ==
-                             QStringView{text}.mid(
-                                 i + 1, emojiNonQualifiedExtraCharacters);
-
-                if (match)
-                {
-                    matchedEmoji = emoji;
-                    matchedEmojiLength = emoji->nonQualified.length();
-
-                    break;
-                }
-            }
-        }
-
-        if (matchedEmojiLength == 0)
+        auto match = matchEmoji(view.substr(i));
+        if (!match)
         {
             continue;
         }
 
-        auto currentParsedEmojiFirstIndex = i;
-        auto currentParsedEmojiEndIndex = i + (matchedEmojiLength);
+        auto currentParsedEmojiFirstIndex = static_cast<QString::size_type>(i);
+        auto currentParsedEmojiEndIndex =
+            currentParsedEmojiFirstIndex +
+            static_cast<QString::size_type>(match->length);
 
         auto charactersFromLastParsedEmoji =
             currentParsedEmojiFirstIndex - lastParsedEmojiEndIndex;
@@ -386,11 +182,14 @@ std::vector<boost::variant<EmotePtr, QString>> Emojis::parse(
         }
 
         // Push the emoji as a word to parsedWords
-        result.emplace_back(matchedEmoji->emote);
+        {
+            std::shared_lock lock(this->emotesMutex_);
+            result.emplace_back(this->emojis[match->emoji]->emote);
+        }
 
         lastParsedEmojiEndIndex = currentParsedEmojiEndIndex;
 
-        i += matchedEmojiLength - 1;
+        i += match->length - 1;
     }
 
     if (lastParsedEmojiEndIndex < text.length())
@@ -404,6 +203,11 @@ std::vector<boost::variant<EmotePtr, QString>> Emojis::parse(
 
 QString Emojis::replaceShortCodes(const QString &text) const
 {
+    if (!this->loaded_)
+    {
+        return text;
+    }
+
     QString ret(text);
     auto it = this->findShortCodesRegex_.globalMatch(text);
 
@@ -418,14 +222,13 @@ QString Emojis::replaceShortCodes(const QString &text) const
         QString matchString =
             capturedString.toLower().mid(1, capturedString.size() - 2);
 
-        auto emojiIt = this->emojiShortCodeToEmoji_.constFind(matchString);
-
-        if (emojiIt == this->emojiShortCodeToEmoji_.constEnd())
+        auto emojiIndex = findShortCode(toU16View(matchString));
+        if (!emojiIndex)
         {
             continue;
         }
 
-        const auto &emojiData = emojiIt.value();
+        const auto &emojiData = this->emojis[*emojiIndex];
 
         ret.replace(offset + match.capturedStart(), match.capturedLength(),
                     emojiData->value);
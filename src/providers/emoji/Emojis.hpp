@@ -4,11 +4,10 @@
 #include "providers/emoji/EmojiStyle.hpp"
 
 #include <boost/variant.hpp>
-#include <QMap>
 #include <QRegularExpression>
-#include <QVector>
 
 #include <memory>
+#include <shared_mutex>
 #include <vector>
 
 namespace chatterino {
@@ -71,21 +70,17 @@ public:
 
 private:
     void loadEmojis();
-    void sortEmojis();
     void loadEmojiSet();
 
     std::vector<EmojiPtr> emojis;
 
+    /// Guards the emote of each emoji, which is replaced when the emoji set
+    /// changes. parse() may be called from any thread.
+    mutable std::shared_mutex emotesMutex_;
+
     /// Emojis
     QRegularExpression findShortCodesRegex_{":([-+\\w]+):"};
 
-    // shortCodeToEmoji maps strings like "sunglasses" to its emoji
-    QMap<QString, std::shared_ptr<EmojiData>> emojiShortCodeToEmoji_;
-
-    // Maps the first character of the emoji unicode string to a vector of
-    // possible emojis
-    QMap<QChar, QVector<std::shared_ptr<EmojiData>>> emojiFirstByte_;
-
     bool loaded_ = false;
 };
 
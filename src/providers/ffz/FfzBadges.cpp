@@ -26,7 +26,7 @@ std::vector<FfzBadges::Badge> FfzBadges::getUserBadges(const UserId &id)
     {
         for (const auto &badgeID : it->second)
         {
-            if (auto badge = this->getBadge(badgeID); badge)
+            if (auto badge = this->findBadge(badgeID); badge)
             {
                 badges.emplace_back(*badge);
             }
@@ -38,7 +38,13 @@ std::vector<FfzBadges::Badge> FfzBadges::getUserBadges(const UserId &id)
 
 std::optional<FfzBadges::Badge> FfzBadges::getBadge(const int badgeID) const
 {
-    this->tgBadges.guard();
+    std::shared_lock lock(this->mutex_);
+
+    return this->findBadge(badgeID);
+}
+
+std::optional<FfzBadges::Badge> FfzBadges::findBadge(const int badgeID) const
+{
     auto it = this->badges.find(badgeID);
     if (it != this->badges.end())
     {
@@ -57,7 +63,6 @@ void FfzBadges::load()
             std::unique_lock lock(this->mutex_);
 
             auto jsonRoot = result.parseJson();
-            this->tgBadges.guard();
             for (const auto &jsonBadge_ : jsonRoot.value("badges").toArray())
             {
                 auto jsonBadge = jsonBadge_.toObject();
@@ -1,7 +1,6 @@
 #pragma once
 
 #include "common/Aliases.hpp"
-#include "util/ThreadGuard.hpp"
 
 #include <QColor>
 
@@ -36,14 +35,16 @@ public:
     void load();
 
 private:
-    std::shared_mutex mutex_;
+    /// Looks up a badge without locking. The caller must hold mutex_.
+    std::optional<Badge> findBadge(int badgeID) const;
+
+    mutable std::shared_mutex mutex_;
 
     // userBadges points a user ID to the list of badges they have
     std::unordered_map<QString, std::set<int>> userBadges;
 
     // badges points a badge ID to the information about the badge
     std::unordered_map<int, Badge> badges;
-    ThreadGuard tgBadges;
 };
 
 }  // namespace chatterino
@@ -4,6 +4,7 @@
 #include "common/network/NetworkResult.hpp"
 #include "common/QLogging.hpp"
 #include "messages/Emote.hpp"
+#include "messages/EmoteIndex.hpp"
 #include "messages/Image.hpp"
 #include "messages/MessageBuilder.hpp"
 #include "providers/ffz/FfzUtil.hpp"
@@ -264,6 +265,7 @@ void FfzEmotes::loadEmotes()
 void FfzEmotes::setEmotes(std::shared_ptr<const EmoteMap> emotes)
 {
     this->global_.set(std::move(emotes));
+    EmoteIndex::invalidateGlobals();
 }
 
 void FfzEmotes::loadChannel(
@@ -272,7 +274,7 @@ void FfzEmotes::loadChannel(
     std::function<void(std::optional<EmotePtr>)> modBadgeCallback,
     std::function<void(std::optional<EmotePtr>)> vipBadgeCallback,
     std::function<void(FfzChannelBadgeMap &&)> channelBadgesCallback,
-    bool manualRefresh, bool cacheHit)
+    bool manualRefresh, bool cacheHit, std::function<void()> finallyCallback)
 {
     qCDebug(LOG) << "Reload FFZ Channel Emotes for channel" << channelID;
 
@@ -348,6 +350,7 @@ void FfzEmotes::loadChannel(
                     }
                 }
             })
+        .finally(std::move(finallyCallback))
         .execute();
 }
 
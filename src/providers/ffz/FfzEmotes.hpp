@@ -43,13 +43,16 @@ public:
     std::optional<EmotePtr> emote(const EmoteName &name) const;
     void loadEmotes();
     void setEmotes(std::shared_ptr<const EmoteMap> emotes);
+    /// `finallyCallback` is called once the request finished, whether it
+    /// succeeded or not.
     static void loadChannel(
         std::weak_ptr<Channel> channel, const QString &channelId,
         std::function<void(EmoteMap &&)> emoteCallback,
         std::function<void(std::optional<EmotePtr>)> modBadgeCallback,
         std::function<void(std::optional<EmotePtr>)> vipBadgeCallback,
         std::function<void(FfzChannelBadgeMap &&)> channelBadgesCallback,
-        bool manualRefresh, bool cacheHit);
+        bool manualRefresh, bool cacheHit,
+        std::function<void()> finallyCallback = {});
 
 private:
     Atomic<std::shared_ptr<const EmoteMap>> global_;
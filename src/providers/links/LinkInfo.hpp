@@ -2,12 +2,15 @@
 
 #include "messages/Image.hpp"
 
+#include <atomic>
+
 namespace chatterino {
 
 /// @brief Rich info about a URL with tooltip and thumbnail
 ///
 /// This is only a data class - it doesn't do the resolving.
-/// It can only be used from the GUI thread.
+/// It can only be used from the GUI thread (except for #state()). Infos are
+/// shared between links to the same URL through LinkInfoCache.
 class LinkInfo : public QObject
 {
     Q_OBJECT
@@ -129,7 +132,8 @@ private:
     QString tooltip_;
     ImagePtr thumbnail_;
 
-    State state_ = State::Created;
+    // Read by LinkInfoCache from other threads
+    std::atomic<State> state_ = State::Created;
 };
 
 }  // namespace chatterino
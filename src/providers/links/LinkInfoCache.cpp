@@ -0,0 +1,94 @@
+#include "providers/links/LinkInfoCache.hpp"
+
+#include "debug/AssertInGuiThread.hpp"
+#include "providers/links/LinkInfo.hpp"
+#include "util/Metrics.hpp"
+
+#include <QThread>
+
+namespace {
+
+using namespace chatterino;
+
+const metrics::Counter LINK_INFOS("link infos");
+const metrics::Counter LINK_INFO_CACHE_HITS("link info cache hits");
+const metrics::Counter LINK_INFO_CACHE_MISSES("link info cache misses");
+
+std::shared_ptr<LinkInfo> makeLinkInfo(const QString &url)
+{
+    auto *info = new LinkInfo(url);
+    if (!isGuiThread())
+    {
+        // LinkInfo is a QObject, it has to live on the GUI thread
+        info->moveToThread(QCoreApplication::instance()->thread());
+    }
+
+    LINK_INFOS.increase();
+    return {info, [](LinkInfo *info) {
+                LINK_INFOS.decrease();
+
+                // The last message holding the info might be dropped on a
+                // worker thread
+                if (info->thread() == QThread::currentThread())
+                {
+                    delete info;
+                }
+                else
+                {
+                    info->deleteLater();
+                }
+            }};
+}
+
+}  // namespace
+
+namespace chatterino {
+
+LinkInfoCache::LinkInfoCache(size_t limit)
+    : entries_(limit)
+{
+}
+
+LinkInfoCache &LinkInfoCache::instance()
+{
+    static LinkInfoCache cache;
+    return cache;
+}
+
+std::shared_ptr<LinkInfo> LinkInfoCache::get(const QString &url,
+                                             Clock::time_point now)
+{
+    std::unique_lock lock(this->mutex_);
+
+    if (this->entries_.exists(url))
+    {
+        const auto &entry = this->entries_.get(url);
+        if (!isExpired(entry, now))
+        {
+            LINK_INFO_CACHE_HITS.increase();
+            return entry.info;
+        }
+    }
+
+    LINK_INFO_CACHE_MISSES.increase();
+    auto info = makeLinkInfo(url);
+    this->entries_.put(url, {.info = info, .created = now});
+    return info;
+}
+
+size_t LinkInfoCache::size() const
+{
+    std::unique_lock lock(this->mutex_);
+    return this->entries_.size();
+}
+
+bool LinkInfoCache::isExpired(const Entry &entry, Clock::time_point now)
+{
+    if (entry.info->hasError())
+    {
+        return now - entry.created >= ERRORED_TTL;
+    }
+    return now - entry.created >= RESOLVED_TTL;
+}
+
+}  // namespace chatterino
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <lrucache/lrucache.hpp>
+#include <QString>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+namespace chatterino {
+
+class LinkInfo;
+
+/// @brief Shares LinkInfos between all links to the same URL
+///
+/// When a URL is posted many times, all LinkElements share one LinkInfo, so
+/// the link is only resolved once and only one tooltip and thumbnail is kept.
+/// Because a LinkInfo that's currently loading isn't resolved again, requests
+/// for the same URL are coalesced as well.
+///
+/// The cache holds at most #LIMIT URLs. Entries expire after #RESOLVED_TTL
+/// (or #ERRORED_TTL if resolving failed), after which the URL is resolved
+/// again. Elements keep their LinkInfo after it's evicted.
+///
+/// This can be used from any thread.
+class LinkInfoCache
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t LIMIT = 1000;
+    static constexpr std::chrono::minutes RESOLVED_TTL{10};
+    static constexpr std::chrono::minutes ERRORED_TTL{1};
+
+    LinkInfoCache(size_t limit = LIMIT);
+
+    static LinkInfoCache &instance();
+
+    /// @brief Returns the LinkInfo for @a url, creating it if necessary
+    ///
+    /// LinkInfos created off the GUI thread are moved to the GUI thread.
+    /// Nothing is resolved here (see LinkResolver::resolve).
+    std::shared_ptr<LinkInfo> get(const QString &url,
+                                  Clock::time_point now = Clock::now());
+
+    /// Returns the number of cached URLs
+    size_t size() const;
+
+private:
+    struct Entry {
+        std::shared_ptr<LinkInfo> info;
+        Clock::time_point created;
+    };
+
+    static bool isExpired(const Entry &entry, Clock::time_point now);
+
+    mutable std::mutex mutex_;
+    cache::lru_cache<QString, Entry> entries_;
+};
+
+}  // namespace chatterino
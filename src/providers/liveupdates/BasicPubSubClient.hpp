@@ -3,8 +3,8 @@
 #include "common/QLogging.hpp"
 #include "providers/liveupdates/BasicPubSubWebsocket.hpp"
 #include "singletons/Settings.hpp"
-#include "util/DebugCount.hpp"
 #include "util/Helpers.hpp"
+#include "util/Metrics.hpp"
 
 #include <pajlada/signals/signal.hpp>
 
@@ -14,6 +14,13 @@
 
 namespace chatterino {
 
+namespace detail {
+
+inline const metrics::Counter LIVE_UPDATES_SUBSCRIPTIONS(
+    "LiveUpdates subscriptions");
+
+}  // namespace detail
+
 /**
  * This class manages a single connection
  * that has at most #maxSubscriptions subscriptions.
@@ -94,7 +101,7 @@ protected:
         }
 
         qCDebug(chatterinoLiveupdates) << "Subscribing to" << subscription;
-        DebugCount::increase("LiveUpdates subscriptions");
+        detail::LIVE_UPDATES_SUBSCRIPTIONS.increase();
 
         QByteArray encoded = subscription.encodeSubscribe();
         this->send(encoded);
@@ -114,7 +121,7 @@ protected:
         }
 
         qCDebug(chatterinoLiveupdates) << "Unsubscribing from" << subscription;
-        DebugCount::decrease("LiveUpdates subscriptions");
+        detail::LIVE_UPDATES_SUBSCRIPTIONS.decrease();
 
         QByteArray encoded = subscription.encodeUnsubscribe();
         this->send(encoded);
@@ -6,8 +6,8 @@
 #include "providers/liveupdates/BasicPubSubWebsocket.hpp"
 #include "providers/NetworkConfigurationProvider.hpp"
 #include "providers/twitch/PubSubHelpers.hpp"
-#include "util/DebugCount.hpp"
 #include "util/ExponentialBackoff.hpp"
+#include "util/Metrics.hpp"
 #include "util/OnceFlag.hpp"
 #include "util/RenameThread.hpp"
 
@@ -31,6 +31,17 @@
 
 namespace chatterino {
 
+namespace detail {
+
+inline const metrics::Counter LIVE_UPDATES_SUBSCRIPTION_BACKLOG(
+    "LiveUpdates subscription backlog");
+inline const metrics::Counter LIVE_UPDATES_CONNECTIONS(
+    "LiveUpdates connections");
+inline const metrics::Counter LIVE_UPDATES_FAILED_CONNECTIONS(
+    "LiveUpdates failed connections");
+
+}  // namespace detail
+
 /**
  * This class is the basis for connecting and interacting with
  * simple PubSub servers over the Websocket protocol.
@@ -230,13 +241,13 @@ protected:
 
         this->addClient();
         this->pendingSubscriptions_.emplace_back(subscription);
-        DebugCount::increase("LiveUpdates subscription backlog");
+        detail::LIVE_UPDATES_SUBSCRIPTION_BACKLOG.increase();
     }
 
 private:
     void onConnectionOpen(websocketpp::connection_hdl hdl)
     {
-        DebugCount::increase("LiveUpdates connections");
+        detail::LIVE_UPDATES_CONNECTIONS.increase();
         this->addingClient_ = false;
         this->diag.connectionsOpened.fetch_add(1, std::memory_order_acq_rel);
 
@@ -268,7 +279,7 @@ private:
                 // TODO: should we try to add a new client here?
                 return;
             }
-            DebugCount::decrease("LiveUpdates subscription backlog");
+            detail::LIVE_UPDATES_SUBSCRIPTION_BACKLOG.decrease();
             pendingSubsToTake--;
         }
 
@@ -280,7 +291,7 @@ private:
 
     void onConnectionFail(websocketpp::connection_hdl hdl)
     {
-        DebugCount::increase("LiveUpdates failed connections");
+        detail::LIVE_UPDATES_FAILED_CONNECTIONS.increase();
         this->diag.connectionsFailed.fetch_add(1, std::memory_order_acq_rel);
 
         if (auto conn = this->websocketClient_.get_con_from_hdl(std::move(hdl)))
@@ -308,7 +319,7 @@ private:
     void onConnectionClose(websocketpp::connection_hdl hdl)
     {
         qCDebug(chatterinoLiveupdates) << "Connection closed";
-        DebugCount::decrease("LiveUpdates connections");
+        detail::LIVE_UPDATES_CONNECTIONS.decrease();
         this->diag.connectionsClosed.fetch_add(1, std::memory_order_acq_rel);
 
         auto clientIt = this->clients_.find(hdl);
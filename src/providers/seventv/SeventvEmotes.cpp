@@ -5,6 +5,7 @@
 #include "common/network/NetworkResult.hpp"
 #include "common/QLogging.hpp"
 #include "messages/Emote.hpp"
+#include "messages/EmoteIndex.hpp"
 #include "messages/Image.hpp"
 #include "messages/ImageSet.hpp"
 #include "messages/MessageBuilder.hpp"
@@ -261,20 +262,21 @@ void SeventvEmotes::loadGlobalEmotes()
 void SeventvEmotes::setGlobalEmotes(std::shared_ptr<const EmoteMap> emotes)
 {
     this->global_.set(std::move(emotes));
+    EmoteIndex::invalidateGlobals();
 }
 
 void SeventvEmotes::loadChannelEmotes(
     const std::weak_ptr<Channel> &channel, const QString &channelId,
     std::function<void(EmoteMap &&, ChannelInfo)> callback, bool manualRefresh,
-    bool cacheHit)
+    bool cacheHit, std::function<void()> finallyCallback)
 {
     qCDebug(chatterinoSeventv)
         << "Reloading 7TV Channel Emotes" << channelId << manualRefresh;
 
     getApp()->getSeventvAPI()->getUserByTwitchID(
         channelId,
-        [callback = std::move(callback), channel, channelId,
-         manualRefresh](const auto &json) {
+        [callback = std::move(callback), channel, channelId, manualRefresh,
+         finallyCallback](const auto &json) {
             writeProviderEmotesCache(channelId, "seventv",
                                      QJsonDocument(json).toJson());
             const auto emoteSet = json["emote_set"].toObject();
@@ -305,6 +307,10 @@ void SeventvEmotes::loadChannelEmotes(
                          {user["id"].toString(), emoteSet["id"].toString(),
                           connectionIdx});
             }
+            if (finallyCallback)
+            {
+                finallyCallback();
+            }
 
             auto shared = channel.lock();
             if (!shared)
@@ -324,7 +330,13 @@ void SeventvEmotes::loadChannelEmotes(
                 }
             }
         },
-        [channelId, channel, manualRefresh, cacheHit](const auto &result) {
+        [channelId, channel, manualRefresh, cacheHit,
+         finallyCallback](const auto &result) {
+            if (finallyCallback)
+            {
+                finallyCallback();
+            }
+
             auto shared = channel.lock();
             if (!shared)
             {
@@ -364,14 +376,12 @@ std::optional<EmotePtr> SeventvEmotes::addEmote(
     Atomic<std::shared_ptr<const EmoteMap>> &map,
     const EmoteAddDispatch &dispatch)
 {
-    // Check for visibility first, so we don't copy the map.
     auto emoteData = dispatch.emoteJson["data"].toObject();
     if (emoteData.empty() || !checkEmoteVisibility(emoteData))
     {
         return std::nullopt;
     }
 
-    // This copies the map.
     EmoteMap updatedMap = *map.get();
     auto result = createEmote(dispatch.emoteJson, emoteData, false);
     if (!result.hasImages)
@@ -399,8 +409,7 @@ std::optional<EmotePtr> SeventvEmotes::updateEmote(
         return std::nullopt;
     }
 
-    // This copies the map.
-    EmoteMap updatedMap = *map.get();
+    EmoteMap updatedMap = *oldMap;
     updatedMap.erase(oldEmote->second->name);
 
     auto emote = createUpdatedEmote(oldEmote->second, dispatch);
@@ -414,13 +423,10 @@ std::optional<EmotePtr> SeventvEmotes::removeEmote(
     Atomic<std::shared_ptr<const EmoteMap>> &map,
     const EmoteRemoveDispatch &dispatch)
 {
-    // This copies the map.
     EmoteMap updatedMap = *map.get();
     auto it = updatedMap.findEmote(dispatch.emoteName, dispatch.emoteID);
     if (it == updatedMap.end())
     {
-        // We already copied the map at this point and are now discarding the copy.
-        // This is fine, because this case should be really rare.
         return std::nullopt;
     }
     auto emote = it->second;
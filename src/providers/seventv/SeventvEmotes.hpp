@@ -105,10 +105,13 @@ public:
     std::optional<EmotePtr> globalEmote(const EmoteName &name) const;
     void loadGlobalEmotes();
     void setGlobalEmotes(std::shared_ptr<const EmoteMap> emotes);
+    /// `finallyCallback` is called once the request finished, whether it
+    /// succeeded or not.
     static void loadChannelEmotes(
         const std::weak_ptr<Channel> &channel, const QString &channelId,
         std::function<void(EmoteMap &&, ChannelInfo)> callback,
-        bool manualRefresh, bool cacheHit);
+        bool manualRefresh, bool cacheHit,
+        std::function<void()> finallyCallback = {});
 
     /**
      * Adds an emote to the `map` if it's valid.
@@ -18,6 +18,7 @@
 #include "providers/twitch/TwitchAccountManager.hpp"
 #include "providers/twitch/TwitchChannel.hpp"
 #include "providers/twitch/TwitchHelpers.hpp"
+#include "providers/twitch/TwitchIrcLine.hpp"
 #include "providers/twitch/TwitchIrcServer.hpp"
 #include "providers/twitch/UserColor.hpp"
 #include "singletons/Settings.hpp"
@@ -85,7 +86,7 @@ MessagePtr generateBannedMessage(bool confirmedBan)
     return builder.release();
 }
 
-int stripLeadingReplyMention(const QVariantMap &tags, QString &content)
+int stripLeadingReplyMention(const TwitchIrcLine &line, QString &content)
 {
     if (!getSettings()->stripReplyMention)
     {
@@ -97,10 +98,9 @@ int stripLeadingReplyMention(const QVariantMap &tags, QString &content)
         return 0;
     }
 
-    if (const auto it = tags.find("reply-parent-display-name");
-        it != tags.end())
+    if (line.hasTag(TwitchTag::ReplyParentDisplayName))
     {
-        auto displayName = it.value().toString();
+        auto displayName = line.tag(TwitchTag::ReplyParentDisplayName);
 
         if (content.length() <= 1 + displayName.length())
         {
@@ -120,7 +120,7 @@ int stripLeadingReplyMention(const QVariantMap &tags, QString &content)
     return 0;
 }
 
-void checkThreadSubscription(const QVariantMap &tags,
+void checkThreadSubscription(const TwitchIrcLine &line,
                              const QString &senderLogin,
                              std::shared_ptr<MessageThread> &thread)
 {
@@ -138,10 +138,9 @@ void checkThreadSubscription(const QVariantMap &tags,
         {
             thread->markSubscribed();
         }
-        else if (const auto it = tags.find("reply-parent-user-login");
-                 it != tags.end())
+        else if (line.hasTag(TwitchTag::ReplyParentUserLogin))
         {
-            auto name = it.value().toString();
+            auto name = line.tag(TwitchTag::ReplyParentUserLogin);
             if (name == currentLogin)
             {
                 thread->markSubscribed();
@@ -277,6 +276,92 @@ MessagePtr parseNoticeMessage(Communi::IrcNoticeMessage *message)
                              calculateMessageTime(message).time());
 }
 
+/// Updates the mod/VIP/staff state of the channel if the message is from the
+/// current user
+void updateSelfBadges(const TwitchIrcLine &line, TwitchChannel *channel)
+{
+    auto currentUser = getApp()->getAccounts()->twitch.getCurrent();
+    if (line.hasTag(TwitchTag::UserId) &&
+        line.tag(TwitchTag::UserId) == currentUser->getUserId())
+    {
+        if (line.hasTag(TwitchTag::Badges))
+        {
+            auto parsedBadges = parseBadges(line.tag(TwitchTag::Badges));
+            channel->setMod(parsedBadges.contains("moderator"));
+            channel->setVIP(parsedBadges.contains("vip"));
+            channel->setStaff(parsedBadges.contains("staff"));
+        }
+    }
+}
+
+/// Applies similarity filters, triggers highlights and adds the built message
+/// to the sink (and the mentions channel).
+void commitBuiltMessage(const MessagePtrMut &msg, const HighlightAlert &alert,
+                        MessageSink &sink, TwitchChannel *chan,
+                        ITwitchIrcServer &twitch)
+{
+    sink.applySimilarityFilters(msg);
+
+    if (!msg->flags.has(MessageFlag::Similar) ||
+        (!getSettings()->hideSimilar &&
+         getSettings()->shownSimilarTriggerHighlights))
+    {
+        MessageBuilder::triggerHighlights(chan, alert);
+    }
+
+    const auto highlighted = msg->flags.has(MessageFlag::Highlighted);
+    const auto showInMentions = msg->flags.has(MessageFlag::ShowInMentions);
+
+    if (highlighted && showInMentions &&
+        sink.sinkTraits().has(MessageSinkTrait::AddMentionsToGlobalChannel))
+    {
+        twitch.getMentionsChannel()->addMessage(msg, MessageContext::Original);
+    }
+
+    sink.addMessage(msg, MessageContext::Original);
+    chan->addRecentChatter(msg->displayName);
+}
+
+/// Returns true if the PRIVMSG needs state that's only safe to access from
+/// the GUI thread while it's being built.
+bool requiresGuiThreadBuild(const TwitchIrcLine &line,
+                            const TwitchChannel &channel)
+{
+    // The first message might set the room-id of the channel
+    if (channel.roomId().isEmpty())
+    {
+        return true;
+    }
+
+    // Shared chat messages from other channels look up the source channel
+    // and its user
+    if (line.hasTag(TwitchTag::SourceRoomId) &&
+        line.tag(TwitchTag::SourceRoomId) != channel.roomId())
+    {
+        return true;
+    }
+
+    // Replies look up and modify the reply threads of the channel
+    if (line.hasTag(TwitchTag::ReplyThreadParentMsgId))
+    {
+        return true;
+    }
+
+    // Rewards might have to be queued until PubSub tells us about them
+    if (line.hasTag(TwitchTag::CustomRewardId))
+    {
+        return true;
+    }
+    const auto msgId = line.rawTag(TwitchTag::MsgId);
+    if (msgId == "animated-message" || msgId == "gigantified-emote-message")
+    {
+        return true;
+    }
+
+    // Hype chats add a second message
+    return line.hasTag(TwitchTag::PinnedChatPaidAmount);
+}
+
 }  // namespace
 
 namespace chatterino {
@@ -383,28 +468,87 @@ void IrcMessageHandler::handlePrivMessage(Communi::IrcPrivateMessage *message,
     parsePrivMessageInto(message, *twitchChannel, twitchChannel);
 }
 
-void IrcMessageHandler::parsePrivMessageInto(
-    Communi::IrcPrivateMessage *message, MessageSink &sink,
-    TwitchChannel *channel)
+OrderedTaskQueue::Build IrcMessageHandler::prepareAsyncPrivMessage(
+    Communi::IrcPrivateMessage *message, ITwitchIrcServer &twitchServer)
 {
-    auto currentUser = getApp()->getAccounts()->twitch.getCurrent();
-    if (message->tag("user-id") == currentUser->getUserId())
+    auto chan = channelOrEmptyByTarget(message->target(), twitchServer);
+    auto twitchChannel = std::dynamic_pointer_cast<TwitchChannel>(chan);
+    if (!twitchChannel)
     {
-        auto badgesTag = message->tag("badges");
-        if (badgesTag.isValid())
+        return {};
+    }
+
+    // The message is owned by the connection and deleted after it's handled,
+    // the line shares the raw data of the message
+    auto line = TwitchIrcLine::fromMessage(*message);
+    if (requiresGuiThreadBuild(line, *twitchChannel))
+    {
+        return {};
+    }
+
+    updateSelfBadges(line, twitchChannel.get());
+
+    auto content = unescapeZeroWidthJoiner(message->content());
+
+    // Everything that reads the account or the settings' phrases is done here,
+    // on the GUI thread. The worker only gets the context.
+    if (isIgnoredMessage({
+            .message = content,
+            .twitchUserID = line.tag(TwitchTag::UserId),
+            .isMod = twitchChannel->isMod(),
+            .isBroadcaster = twitchChannel->isBroadcaster(),
+        }))
+    {
+        return [] {
+            return OrderedTaskQueue::Commit{};
+        };
+    }
+
+    MessageParseArgs args;
+    args.isStaffOrBroadcaster = twitchChannel->isBroadcaster();
+    args.isAction = message->isAction();
+    args.allowIgnore = false;
+
+    auto context = MessageBuildContext::fromApp();
+    context.emoteIndex = twitchChannel->emoteIndex();
+
+    return [twitchChannel = std::move(twitchChannel), line = std::move(line),
+            content = std::move(content), args,
+            context = std::move(context)]() -> OrderedTaskQueue::Commit {
+        auto built = MessageBuilder::makeIrcMessage(
+            context, twitchChannel.get(), line, args, content, 0);
+        auto msg = std::move(built.first);
+        auto alert = std::move(built.second);
+        if (!msg)
         {
-            auto parsedBadges = parseBadges(badgesTag.toString());
-            channel->setMod(parsedBadges.contains("moderator"));
-            channel->setVIP(parsedBadges.contains("vip"));
-            channel->setStaff(parsedBadges.contains("staff"));
+            return {};
         }
-    }
+
+        return [twitchChannel, msg, alert] {
+            if (isAppAboutToQuit())
+            {
+                return;
+            }
+
+            commitBuiltMessage(msg, alert, *twitchChannel, twitchChannel.get(),
+                               *getApp()->getTwitch());
+        };
+    };
+}
+
+void IrcMessageHandler::parsePrivMessageInto(
+    Communi::IrcPrivateMessage *message, MessageSink &sink,
+    TwitchChannel *channel)
+{
+    auto line = TwitchIrcLine::fromMessage(*message);
+    updateSelfBadges(line, channel);
 
     IrcMessageHandler::addMessage(
-        message, sink, channel, unescapeZeroWidthJoiner(message->content()),
-        *getApp()->getTwitch(), false, message->isAction());
+        message, line, sink, channel,
+        unescapeZeroWidthJoiner(message->content()), *getApp()->getTwitch(),
+        false, message->isAction());
 
-    if (message->tags().contains(u"pinned-chat-paid-amount"_s))
+    if (line.hasTag(TwitchTag::PinnedChatPaidAmount))
     {
         auto ptr = MessageBuilder::buildHypeChatMessage(message);
         if (ptr)
@@ -510,9 +654,8 @@ void IrcMessageHandler::handleClearChatMessage(Communi::IrcMessage *message)
 
     if (getSettings()->hideModerated)
     {
-        // XXX: This is expensive. We could use a layout request if the layout
-        //      would store the previous message flags.
-        getApp()->getWindows()->forceLayoutChannelViews();
+        // Only the layouts of messages with changed flags are updated
+        getApp()->getWindows()->layoutChannelViews();
     }
 }
 
@@ -562,9 +705,8 @@ void IrcMessageHandler::handleClearMessageMessage(Communi::IrcMessage *message)
 
     if (getSettings()->hideModerated && !tags.contains("historical"))
     {
-        // XXX: This is expensive. We could use a layout request if the layout
-        //      would store the previous message flags.
-        getApp()->getWindows()->forceLayoutChannelViews();
+        // Only the layouts of messages with changed flags are updated
+        getApp()->getWindows()->layoutChannelViews();
     }
 }
 
@@ -1015,6 +1157,18 @@ void IrcMessageHandler::addMessage(Communi::IrcMessage *message,
                                    const QString &originalContent,
                                    ITwitchIrcServer &twitch, bool isSub,
                                    bool isAction)
+{
+    IrcMessageHandler::addMessage(message, TwitchIrcLine::fromMessage(*message),
+                                  sink, chan, originalContent, twitch, isSub,
+                                  isAction);
+}
+
+void IrcMessageHandler::addMessage(Communi::IrcMessage *message,
+                                   const TwitchIrcLine &line, MessageSink &sink,
+                                   TwitchChannel *chan,
+                                   const QString &originalContent,
+                                   ITwitchIrcServer &twitch, bool isSub,
+                                   bool isAction)
 {
     assert(chan);
 
@@ -1031,16 +1185,15 @@ void IrcMessageHandler::addMessage(Communi::IrcMessage *message,
     }
     args.isAction = isAction;
 
-    const auto &tags = message->tags();
     QString rewardId;
-    if (const auto it = tags.find("custom-reward-id"); it != tags.end())
+    if (line.hasTag(TwitchTag::CustomRewardId))
     {
-        rewardId = it.value().toString();
+        rewardId = line.tag(TwitchTag::CustomRewardId);
     }
-    else if (const auto typeIt = tags.find("msg-id"); typeIt != tags.end())
+    else if (line.hasTag(TwitchTag::MsgId))
     {
         // slight hack to treat bits power-ups as channel point redemptions
-        const auto msgId = typeIt.value().toString();
+        const auto msgId = line.tag(TwitchTag::MsgId);
         if (msgId == "animated-message" || msgId == "gigantified-emote-message")
         {
             rewardId = msgId;
@@ -1060,21 +1213,20 @@ void IrcMessageHandler::addMessage(Communi::IrcMessage *message,
     args.channelPointRewardId = rewardId;
 
     QString content = originalContent;
-    int messageOffset = stripLeadingReplyMention(tags, content);
+    int messageOffset = stripLeadingReplyMention(line, content);
 
     ReplyContext replyCtx;
 
-    if (const auto it = tags.find("reply-thread-parent-msg-id");
-        it != tags.end())
+    if (line.hasTag(TwitchTag::ReplyThreadParentMsgId))
     {
-        const QString replyID = it.value().toString();
+        const QString replyID = line.tag(TwitchTag::ReplyThreadParentMsgId);
         auto threadIt = chan->threads().find(replyID);
         std::shared_ptr<MessageThread> rootThread;
         if (threadIt != chan->threads().end() && !threadIt->second.expired())
         {
             // Thread already exists (has a reply)
             auto thread = threadIt->second.lock();
-            checkThreadSubscription(tags, message->nick(), thread);
+            checkThreadSubscription(line, line.nick(), thread);
             replyCtx.thread = thread;
             rootThread = thread;
         }
@@ -1086,7 +1238,7 @@ void IrcMessageHandler::addMessage(Communi::IrcMessage *message,
             {
                 // Found root reply message
                 auto newThread = std::make_shared<MessageThread>(root);
-                checkThreadSubscription(tags, message->nick(), newThread);
+                checkThreadSubscription(line, line.nick(), newThread);
 
                 replyCtx.thread = newThread;
                 rootThread = newThread;
@@ -1095,10 +1247,9 @@ void IrcMessageHandler::addMessage(Communi::IrcMessage *message,
             }
         }
 
-        if (const auto parentIt = tags.find("reply-parent-msg-id");
-            parentIt != tags.end())
+        if (line.hasTag(TwitchTag::ReplyParentMsgId))
         {
-            const QString parentID = parentIt.value().toString();
+            const QString parentID = line.tag(TwitchTag::ReplyParentMsgId);
             if (replyID == parentID)
             {
                 if (rootThread)
@@ -1131,7 +1282,7 @@ void IrcMessageHandler::addMessage(Communi::IrcMessage *message,
 
     args.allowIgnore = !isSub;
     auto [msg, alert] = MessageBuilder::makeIrcMessage(
-        chan, message, args, content, messageOffset, replyCtx.thread,
+        chan, line, args, content, messageOffset, replyCtx.thread,
         replyCtx.parent);
 
     if (msg)
@@ -1140,7 +1291,7 @@ void IrcMessageHandler::addMessage(Communi::IrcMessage *message,
         {
             msg->flags.set(MessageFlag::Subscription);
 
-            if (tags.value("msg-id") != "announcement")
+            if (line.rawTag(TwitchTag::MsgId) != "announcement")
             {
                 // Announcements are currently tagged as subscriptions,
                 // but we want them to be able to show up in mentions
@@ -1148,27 +1299,7 @@ void IrcMessageHandler::addMessage(Communi::IrcMessage *message,
             }
         }
 
-        sink.applySimilarityFilters(msg);
-
-        if (!msg->flags.has(MessageFlag::Similar) ||
-            (!getSettings()->hideSimilar &&
-             getSettings()->shownSimilarTriggerHighlights))
-        {
-            MessageBuilder::triggerHighlights(chan, alert);
-        }
-
-        const auto highlighted = msg->flags.has(MessageFlag::Highlighted);
-        const auto showInMentions = msg->flags.has(MessageFlag::ShowInMentions);
-
-        if (highlighted && showInMentions &&
-            sink.sinkTraits().has(MessageSinkTrait::AddMentionsToGlobalChannel))
-        {
-            twitch.getMentionsChannel()->addMessage(msg,
-                                                    MessageContext::Original);
-        }
-
-        sink.addMessage(msg, MessageContext::Original);
-        chan->addRecentChatter(msg->displayName);
+        commitBuiltMessage(msg, alert, sink, chan, twitch);
     }
 }
 
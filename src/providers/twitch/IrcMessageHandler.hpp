@@ -1,6 +1,7 @@
 #pragma once
 
 #include "messages/LimitedQueueSnapshot.hpp"
+#include "util/OrderedTaskQueue.hpp"
 
 #include <IrcMessage>
 
@@ -15,6 +16,7 @@ using ChannelPtr = std::shared_ptr<Channel>;
 struct Message;
 using MessagePtr = std::shared_ptr<const Message>;
 class TwitchChannel;
+class TwitchIrcLine;
 class TwitchMessageBuilder;
 class MessageSink;
 
@@ -39,6 +41,21 @@ public:
 
     void handlePrivMessage(Communi::IrcPrivateMessage *message,
                            ITwitchIrcServer &twitchServer);
+
+    /**
+     * @brief Prepares building a PRIVMSG off the GUI thread
+     *
+     * The returned function builds the message and returns a function that
+     * adds it to its channel on the GUI thread. This must be called from the
+     * GUI thread, as it takes everything the build needs from the
+     * application. For ignored messages, the returned function does nothing.
+     *
+     * @returns An empty function if the message needs to be handled on the
+     *          GUI thread through #handlePrivMessage (e.g. replies or
+     *          channel point redemptions).
+     **/
+    OrderedTaskQueue::Build prepareAsyncPrivMessage(
+        Communi::IrcPrivateMessage *message, ITwitchIrcServer &twitchServer);
     static void parsePrivMessageInto(Communi::IrcPrivateMessage *message,
                                      MessageSink &sink, TwitchChannel *channel);
 
@@ -62,6 +79,11 @@ public:
     static void addMessage(Communi::IrcMessage *message, MessageSink &sink,
                            TwitchChannel *chan, const QString &originalContent,
                            ITwitchIrcServer &twitch, bool isSub, bool isAction);
+    /// Like addMessage() with the already parsed @a line of @a message
+    static void addMessage(Communi::IrcMessage *message,
+                           const TwitchIrcLine &line, MessageSink &sink,
+                           TwitchChannel *chan, const QString &originalContent,
+                           ITwitchIrcServer &twitch, bool isSub, bool isAction);
 
 private:
     static float similarity(const MessagePtr &msg,
@@ -3,10 +3,17 @@
 #include "common/QLogging.hpp"
 #include "providers/twitch/PubSubHelpers.hpp"
 #include "providers/twitch/PubSubMessages.hpp"
-#include "util/DebugCount.hpp"
+#include "util/Metrics.hpp"
 
 namespace chatterino {
 
+namespace {
+
+const metrics::Counter PENDING_LISTENS("PubSub topic pending listens");
+const metrics::Counter PENDING_UNLISTENS("PubSub topic pending unlistens");
+
+}  // namespace
+
 static const char *PING_PAYLOAD = R"({"type":"PING"})";
 
 PubSubClient::PubSubClient(WebsocketClient &websocketClient,
@@ -76,8 +83,7 @@ bool PubSubClient::listen(const PubSubListenMessage &msg)
         return false;
     }
     this->numListens_ += numRequestedListens;
-    DebugCount::increase("PubSub topic pending listens",
-                         static_cast<int64_t>(numRequestedListens));
+    PENDING_LISTENS.increase(static_cast<int64_t>(numRequestedListens));
 
     for (const auto &topic : msg.topics)
     {
@@ -126,8 +132,7 @@ PubSubClient::UnlistenPrefixResponse PubSubClient::unlistenPrefix(
     auto numRequestedUnlistens = topics.size();
 
     this->numListens_ -= numRequestedUnlistens;
-    DebugCount::increase("PubSub topic pending unlistens",
-                         static_cast<int64_t>(numRequestedUnlistens));
+    PENDING_UNLISTENS.increase(static_cast<int64_t>(numRequestedUnlistens));
 
     PubSubUnlistenMessage message(topics);
 
@@ -6,7 +6,7 @@
 #include "providers/twitch/PubSubClient.hpp"
 #include "providers/twitch/PubSubHelpers.hpp"
 #include "providers/twitch/PubSubMessages.hpp"
-#include "util/DebugCount.hpp"
+#include "util/Metrics.hpp"
 #include "util/RenameThread.hpp"
 
 #include <QJsonArray>
@@ -24,6 +24,19 @@ using namespace std::chrono_literals;
 
 namespace chatterino {
 
+namespace {
+
+const metrics::Counter TOPIC_BACKLOG("PubSub topic backlog");
+const metrics::Counter CONNECTIONS("PubSub connections");
+const metrics::Counter FAILED_CONNECTIONS("PubSub failed connections");
+const metrics::Counter PENDING_LISTENS("PubSub topic pending listens");
+const metrics::Counter FAILED_LISTENS("PubSub topic failed listens");
+const metrics::Counter LISTENING("PubSub topic listening");
+const metrics::Counter PENDING_UNLISTENS("PubSub topic pending unlistens");
+const metrics::Counter FAILED_UNLISTENS("PubSub topic failed unlistens");
+
+}  // namespace
+
 PubSub::PubSub(const QString &host, std::chrono::seconds pingInterval)
     : host_(host)
     , clientOptions_({
@@ -198,7 +211,7 @@ void PubSub::listen(PubSubListenMessage msg)
     std::copy(msg.topics.begin(), msg.topics.end(),
               std::back_inserter(this->requests));
 
-    DebugCount::increase("PubSub topic backlog", msg.topics.size());
+    TOPIC_BACKLOG.increase(msg.topics.size());
 }
 
 bool PubSub::tryListen(PubSubListenMessage msg)
@@ -318,7 +331,7 @@ void PubSub::onConnectionOpen(WebsocketHandle hdl)
 {
     this->diag.connectionsOpened += 1;
 
-    DebugCount::increase("PubSub connections");
+    CONNECTIONS.increase();
     this->addingClient = false;
 
     this->connectBackoff.reset();
@@ -352,7 +365,7 @@ void PubSub::onConnectionOpen(WebsocketHandle hdl)
                                     << "new topics on new client";
         return;
     }
-    DebugCount::decrease("PubSub topic backlog", msg.topics.size());
+    TOPIC_BACKLOG.decrease(msg.topics.size());
 
     this->registerNonce(msg.nonce, {
                                        client,
@@ -371,7 +384,7 @@ void PubSub::onConnectionFail(WebsocketHandle hdl)
 {
     this->diag.connectionsFailed += 1;
 
-    DebugCount::increase("PubSub failed connections");
+    FAILED_CONNECTIONS.increase();
     if (auto conn = this->websocketClient.get_con_from_hdl(std::move(hdl)))
     {
         qCDebug(chatterinoPubSub) << "PubSub connection attempt failed (error: "
@@ -399,7 +412,7 @@ void PubSub::onConnectionClose(WebsocketHandle hdl)
     qCDebug(chatterinoPubSub) << "Connection closed";
     this->diag.connectionsClosed += 1;
 
-    DebugCount::decrease("PubSub connections");
+    CONNECTIONS.decrease();
     auto clientIt = this->clients.find(hdl);
 
     // If this assert goes off, there's something wrong with the connection
@@ -493,32 +506,32 @@ void PubSub::handleResponse(const PubSubMessage &message)
 
 void PubSub::handleListenResponse(const NonceInfo &info, bool failed)
 {
-    DebugCount::decrease("PubSub topic pending listens", info.topicCount);
+    PENDING_LISTENS.decrease(info.topicCount);
     if (failed)
     {
         this->diag.failedListenResponses++;
-        DebugCount::increase("PubSub topic failed listens", info.topicCount);
+        FAILED_LISTENS.increase(info.topicCount);
     }
     else
     {
         this->diag.listenResponses++;
-        DebugCount::increase("PubSub topic listening", info.topicCount);
+        LISTENING.increase(info.topicCount);
     }
 }
 
 void PubSub::handleUnlistenResponse(const NonceInfo &info, bool failed)
 {
     this->diag.unlistenResponses++;
-    DebugCount::decrease("PubSub topic pending unlistens", info.topicCount);
+    PENDING_UNLISTENS.decrease(info.topicCount);
     if (failed)
     {
         qCDebug(chatterinoPubSub) << "Failed unlistening to" << info.topics;
-        DebugCount::increase("PubSub topic failed unlistens", info.topicCount);
+        FAILED_UNLISTENS.increase(info.topicCount);
     }
     else
     {
         qCDebug(chatterinoPubSub) << "Successful unlistened to" << info.topics;
-        DebugCount::decrease("PubSub topic listening", info.topicCount);
+        LISTENING.decrease(info.topicCount);
     }
 }
 
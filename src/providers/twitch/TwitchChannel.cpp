@@ -10,7 +10,9 @@
 #include "controllers/accounts/AccountController.hpp"
 #include "controllers/notifications/NotificationController.hpp"
 #include "controllers/twitch/LiveController.hpp"
+#include "debug/AssertInGuiThread.hpp"
 #include "messages/Emote.hpp"
+#include "messages/EmoteIndex.hpp"
 #include "messages/Image.hpp"
 #include "messages/Link.hpp"
 #include "messages/Message.hpp"
@@ -118,6 +120,7 @@ TwitchChannel::TwitchChannel(const QString &name)
     , bttvEmotes_(std::make_shared<EmoteMap>())
     , ffzEmotes_(std::make_shared<EmoteMap>())
     , seventvEmotes_(std::make_shared<EmoteMap>())
+    , emoteIndex_(std::make_shared<const EmoteIndex>())
 {
     qCDebug(chatterinoTwitch) << "[TwitchChannel" << name << "] Opened";
 
@@ -137,7 +140,10 @@ TwitchChannel::TwitchChannel(const QString &name)
         getApp()->getAccounts()->twitch.currentUserChanged.connect([this] {
             this->setMod(false);
             this->refreshPubSub();
-            this->refreshTwitchChannelEmotes(false);
+            if (!this->hydrationDeferred_)
+            {
+                this->refreshTwitchChannelEmotes(false);
+            }
         }));
 
     this->refreshPubSub();
@@ -160,7 +166,10 @@ TwitchChannel::TwitchChannel(const QString &name)
 
     // timers
     QObject::connect(&this->chattersListTimer_, &QTimer::timeout, [this] {
-        this->refreshChatters();
+        if (!this->hydrationDeferred_)
+        {
+            this->refreshChatters();
+        }
     });
 
     this->chattersListTimer_.start(5 * 60 * 1000);
@@ -243,6 +252,56 @@ void TwitchChannel::initialize()
     this->refreshBadges();
 }
 
+void TwitchChannel::deferHydration()
+{
+    if (!this->roomId().isEmpty())
+    {
+        // Everything was already requested
+        return;
+    }
+
+    this->hydrationDeferred_ = true;
+}
+
+void TwitchChannel::hydrate()
+{
+    if (!this->hydrationDeferred_)
+    {
+        return;
+    }
+    this->hydrationDeferred_ = false;
+
+    if (this->roomId().isEmpty() || getApp()->isTest())
+    {
+        // roomIdChanged will load everything once we know the room ID
+        return;
+    }
+
+    qCDebug(chatterinoTwitch)
+        << "[TwitchChannel" << this->getName() << "] Hydrating";
+
+    // Messages were received while the channel was deferred. They're
+    // replaced with the ones from the history, so the history is only loaded
+    // once the emotes and badges it's built with are there.
+    this->loadRoomData([weak = weakOf<Channel>(this)] {
+        auto shared = weak.lock();
+        if (!shared)
+        {
+            return;
+        }
+        if (auto *tc = dynamic_cast<TwitchChannel *>(shared.get()))
+        {
+            tc->loadRecentMessages(true);
+        }
+    });
+    this->refreshChatters();
+}
+
+bool TwitchChannel::isHydrated() const
+{
+    return !this->hydrationDeferred_;
+}
+
 bool TwitchChannel::isEmpty() const
 {
     return this->getName().isEmpty();
@@ -349,11 +408,17 @@ void TwitchChannel::refreshTwitchChannelEmotes(bool manualRefresh)
         });
 }
 
-void TwitchChannel::refreshBTTVChannelEmotes(bool manualRefresh)
+void TwitchChannel::refreshBTTVChannelEmotes(
+    bool manualRefresh, std::function<void()> finallyCallback)
 {
     if (!Settings::instance().enableBTTVChannelEmotes)
     {
         this->bttvEmotes_.set(EMPTY_EMOTE_MAP);
+        this->invalidateEmoteIndex();
+        if (finallyCallback)
+        {
+            finallyCallback();
+        }
         return;
     }
 
@@ -376,14 +441,20 @@ void TwitchChannel::refreshBTTVChannelEmotes(bool manualRefresh)
                 this->setBttvEmotes(std::make_shared<const EmoteMap>(emoteMap));
             }
         },
-        manualRefresh, cacheHit);
+        manualRefresh, cacheHit, std::move(finallyCallback));
 }
 
-void TwitchChannel::refreshFFZChannelEmotes(bool manualRefresh)
+void TwitchChannel::refreshFFZChannelEmotes(
+    bool manualRefresh, std::function<void()> finallyCallback)
 {
     if (!Settings::instance().enableFFZChannelEmotes)
     {
         this->ffzEmotes_.set(EMPTY_EMOTE_MAP);
+        this->invalidateEmoteIndex();
+        if (finallyCallback)
+        {
+            finallyCallback();
+        }
         return;
     }
 
@@ -418,19 +489,24 @@ void TwitchChannel::refreshFFZChannelEmotes(bool manualRefresh)
         [this, weak = weakOf<Channel>(this)](auto &&channelBadges) {
             if (auto shared = weak.lock())
             {
-                this->tgFfzChannelBadges_.guard();
-                this->ffzChannelBadges_ =
-                    std::forward<decltype(channelBadges)>(channelBadges);
+                this->setFfzChannelBadges(
+                    std::forward<decltype(channelBadges)>(channelBadges));
             }
         },
-        manualRefresh, cacheHit);
+        manualRefresh, cacheHit, std::move(finallyCallback));
 }
 
-void TwitchChannel::refreshSevenTVChannelEmotes(bool manualRefresh)
+void TwitchChannel::refreshSevenTVChannelEmotes(
+    bool manualRefresh, std::function<void()> finallyCallback)
 {
     if (!Settings::instance().enableSevenTVChannelEmotes)
     {
         this->seventvEmotes_.set(EMPTY_EMOTE_MAP);
+        this->invalidateEmoteIndex();
+        if (finallyCallback)
+        {
+            finallyCallback();
+        }
         return;
     }
 
@@ -457,22 +533,25 @@ void TwitchChannel::refreshSevenTVChannelEmotes(bool manualRefresh)
                     channelInfo.twitchConnectionIndex;
             }
         },
-        manualRefresh, cacheHit);
+        manualRefresh, cacheHit, std::move(finallyCallback));
 }
 
 void TwitchChannel::setBttvEmotes(std::shared_ptr<const EmoteMap> &&map)
 {
     this->bttvEmotes_.set(std::move(map));
+    this->invalidateEmoteIndex();
 }
 
 void TwitchChannel::setFfzEmotes(std::shared_ptr<const EmoteMap> &&map)
 {
     this->ffzEmotes_.set(std::move(map));
+    this->invalidateEmoteIndex();
 }
 
 void TwitchChannel::setSeventvEmotes(std::shared_ptr<const EmoteMap> &&map)
 {
     this->seventvEmotes_.set(std::move(map));
+    this->invalidateEmoteIndex();
 }
 
 void TwitchChannel::addQueuedRedemption(const QString &rewardId,
@@ -738,16 +817,34 @@ void TwitchChannel::roomIdChanged()
         return;
     }
     this->refreshPubSub();
-    this->refreshBadges();
+    getApp()->getTwitchLiveController()->add(
+        std::dynamic_pointer_cast<TwitchChannel>(shared_from_this()));
+
+    if (!this->hydrationDeferred_)
+    {
+        this->loadRoomData();
+    }
+}
+
+void TwitchChannel::loadRoomData(std::function<void()> onLoaded)
+{
+    // Called on the GUI thread once each of the four loads below finished
+    auto finished = [pending = std::make_shared<int>(4),
+                     onLoaded = std::move(onLoaded)] {
+        if (--*pending == 0 && onLoaded)
+        {
+            onLoaded();
+        }
+    };
+
+    this->refreshBadges(finished);
     this->refreshCheerEmotes();
     this->refreshTwitchChannelEmotes(false);
-    this->refreshFFZChannelEmotes(false);
-    this->refreshBTTVChannelEmotes(false);
-    this->refreshSevenTVChannelEmotes(false);
+    this->refreshFFZChannelEmotes(false, finished);
+    this->refreshBTTVChannelEmotes(false, finished);
+    this->refreshSevenTVChannelEmotes(false, finished);
     this->joinBttvChannel();
     this->listenSevenTVCosmetics();
-    getApp()->getTwitchLiveController()->add(
-        std::dynamic_pointer_cast<TwitchChannel>(shared_from_this()));
 }
 
 QString TwitchChannel::prepareMessage(const QString &message) const
@@ -972,7 +1069,10 @@ void TwitchChannel::setRoomId(const QString &id)
         if (!getApp()->isTest())
         {
             this->roomIdChanged();
-            this->loadRecentMessages();
+            if (!this->hydrationDeferred_)
+            {
+                this->loadRecentMessages();
+            }
         }
         this->disconnected_ = false;
         this->lastConnectedAt_ = std::chrono::system_clock::now();
@@ -1076,6 +1176,68 @@ std::shared_ptr<const EmoteMap> TwitchChannel::seventvEmotes() const
     return this->seventvEmotes_.get();
 }
 
+std::shared_ptr<const EmoteIndex> TwitchChannel::emoteIndex()
+{
+    // The global emotes may only be read on the GUI thread. Builds on other
+    // threads get the index through their MessageBuildContext.
+    assertInGuiThread();
+
+    auto index = this->emoteIndex_.get();
+    auto generation = EmoteIndex::globalsGeneration();
+    bool rebuild = this->emoteIndexOutdated_.load(std::memory_order_acquire) ||
+                   index->builtWithGlobalsGeneration() != generation;
+    if (!rebuild && this->changedEmoteNames_.empty())
+    {
+        return index;
+    }
+
+    // Clear the flag before reading the maps, so changes made while we're
+    // building cause another rebuild
+    this->emoteIndexOutdated_.store(false, std::memory_order_release);
+
+    auto ffzChannel = this->ffzEmotes_.get();
+    auto bttvChannel = this->bttvEmotes_.get();
+    auto seventvChannel = this->seventvEmotes_.get();
+    auto ffzGlobal = getApp()->getFfzEmotes()->emotes();
+    auto bttvGlobal = getApp()->getBttvEmotes()->emotes();
+    auto seventvGlobal = getApp()->getSeventvEmotes()->globalEmotes();
+
+    // Same order as the lookups in MessageBuilder used to be
+    std::vector<EmoteIndex::Source> sources{
+        {ffzChannel.get(), MessageElementFlag::FfzEmote},
+        {bttvChannel.get(), MessageElementFlag::BttvEmote},
+        {seventvChannel.get(), MessageElementFlag::SevenTVEmote},
+        {ffzGlobal.get(), MessageElementFlag::FfzEmote},
+        {bttvGlobal.get(), MessageElementFlag::BttvEmote},
+        {seventvGlobal.get(), MessageElementFlag::SevenTVEmote},
+    };
+    if (rebuild)
+    {
+        index = std::make_shared<const EmoteIndex>(sources, generation);
+    }
+    else
+    {
+        // Live updates only touch single emotes, so only those are resolved
+        // again and everything else is shared with the previous index
+        index = std::make_shared<const EmoteIndex>(
+            index->withChanges(sources, this->changedEmoteNames_));
+    }
+    this->changedEmoteNames_.clear();
+    this->emoteIndex_.set(index);
+    return index;
+}
+
+void TwitchChannel::invalidateEmoteIndex()
+{
+    this->emoteIndexOutdated_.store(true, std::memory_order_release);
+}
+
+void TwitchChannel::invalidateEmoteNames(std::initializer_list<QString> names)
+{
+    assertInGuiThread();
+    this->changedEmoteNames_.insert(this->changedEmoteNames_.end(), names);
+}
+
 const QString &TwitchChannel::seventvUserID() const
 {
     return this->seventvUserID_;
@@ -1105,6 +1267,7 @@ void TwitchChannel::addBttvEmote(
 {
     auto emote = BttvEmotes::addEmote(this->getDisplayName(), this->bttvEmotes_,
                                       message);
+    this->invalidateEmoteNames({emote->name.string});
 
     this->addOrReplaceLiveUpdatesAddRemove(true, "BTTV", QString() /*actor*/,
                                            emote->name.string);
@@ -1121,6 +1284,8 @@ void TwitchChannel::updateBttvEmote(
     }
 
     const auto [oldEmote, newEmote] = *updated;
+    this->invalidateEmoteNames({oldEmote->name.string, newEmote->name.string});
+
     if (oldEmote->name == newEmote->name)
     {
         return;  // only the creator changed
@@ -1140,6 +1305,7 @@ void TwitchChannel::removeBttvEmote(
     {
         return;
     }
+    this->invalidateEmoteNames({(*removed)->name.string});
 
     this->addOrReplaceLiveUpdatesAddRemove(false, "BTTV", QString() /*actor*/,
                                            (*removed)->name.string);
@@ -1148,10 +1314,12 @@ void TwitchChannel::removeBttvEmote(
 void TwitchChannel::addSeventvEmote(
     const seventv::eventapi::EmoteAddDispatch &dispatch)
 {
-    if (!SeventvEmotes::addEmote(this->seventvEmotes_, dispatch))
+    auto added = SeventvEmotes::addEmote(this->seventvEmotes_, dispatch);
+    if (!added)
     {
         return;
     }
+    this->invalidateEmoteNames({(*added)->name.string});
 
     this->addOrReplaceLiveUpdatesAddRemove(
         true, "7TV", dispatch.actorName, dispatch.emoteJson["name"].toString());
@@ -1164,6 +1332,7 @@ void TwitchChannel::updateSeventvEmote(
     {
         return;
     }
+    this->invalidateEmoteNames({dispatch.oldEmoteName, dispatch.emoteName});
 
     auto builder =
         MessageBuilder(liveUpdatesUpdateEmoteMessage, "7TV", dispatch.actorName,
@@ -1179,6 +1348,7 @@ void TwitchChannel::removeSeventvEmote(
     {
         return;
     }
+    this->invalidateEmoteNames({(*removed)->name.string});
 
     this->addOrReplaceLiveUpdatesAddRemove(false, "7TV", dispatch.actorName,
                                            (*removed)->name.string);
@@ -1203,6 +1373,7 @@ void TwitchChannel::updateSeventvUser(
                 {
                     this->seventvEmotes_.set(
                         std::make_shared<EmoteMap>(emotes));
+                    this->invalidateEmoteIndex();
                     auto builder =
                         MessageBuilder(liveUpdatesUpdateEmoteSetMessage, "7TV",
                                        dispatch.actorName, name);
@@ -1216,6 +1387,7 @@ void TwitchChannel::updateSeventvUser(
                 if (auto shared = weak.lock())
                 {
                     this->seventvEmotes_.set(EMPTY_EMOTE_MAP);
+                    this->invalidateEmoteIndex();
                     this->addSystemMessage(
                         QString("Failed updating 7TV emote set (%1).")
                             .arg(reason));
@@ -1409,7 +1581,7 @@ void TwitchChannel::markDisconnected()
     this->disconnected_ = true;
 }
 
-void TwitchChannel::loadRecentMessages()
+void TwitchChannel::loadRecentMessages(bool fillIn)
 {
     if (!getSettings()->loadTwitchMessageHistoryOnConnect)
     {
@@ -1424,7 +1596,7 @@ void TwitchChannel::loadRecentMessages()
     auto weak = weakOf<Channel>(this);
     recentmessages::load(
         this->getName(), weak,
-        [weak](const auto &messages) {
+        [weak, fillIn](const auto &messages) {
             assert(!isAppAboutToQuit());
             auto shared = weak.lock();
             if (!shared)
@@ -1438,7 +1610,38 @@ void TwitchChannel::loadRecentMessages()
                 return;
             }
 
-            tc->addMessagesAtStart(messages);
+            if (fillIn)
+            {
+                // Messages received while the channel was deferred were built
+                // without its emotes and badges. Replace the ones the history
+                // contains with their rebuilt versions. Older ones keep how
+                // they looked. The replacements were received live, so they
+                // aren't shown as history.
+                for (const auto &msg : messages)
+                {
+                    if (msg->id.isEmpty() ||
+                        msg->flags.has(MessageFlag::System))
+                    {
+                        continue;
+                    }
+                    auto existing = tc->findMessageByID(msg->id);
+                    if (!existing || existing == msg)
+                    {
+                        continue;
+                    }
+                    msg->flags.unset(MessageFlag::RecentMessage);
+                    if (existing->flags.has(MessageFlag::Disabled))
+                    {
+                        msg->flags.set(MessageFlag::Disabled);
+                    }
+                    tc->replaceMessage(existing, msg);
+                }
+                tc->fillInMissingMessages(messages);
+            }
+            else
+            {
+                tc->addMessagesAtStart(messages);
+            }
             tc->loadingRecentMessages_.clear();
 
             std::vector<MessagePtr> msgs;
@@ -1796,17 +1999,22 @@ void TwitchChannel::cleanUpReplyThreads()
     }
 }
 
-void TwitchChannel::refreshBadges()
+void TwitchChannel::refreshBadges(std::function<void()> finallyCallback)
 {
     if (this->roomId().isEmpty())
     {
+        if (finallyCallback)
+        {
+            finallyCallback();
+        }
         return;
     }
 
     getHelix()->getChannelBadges(
         this->roomId(),
         // successCallback
-        [this, weak = weakOf<Channel>(this)](const auto &channelBadges) {
+        [this, weak = weakOf<Channel>(this),
+         finallyCallback](const auto &channelBadges) {
             auto shared = weak.lock();
             if (!shared)
             {
@@ -1815,9 +2023,19 @@ void TwitchChannel::refreshBadges()
             }
 
             this->addTwitchBadgeSets(channelBadges);
+            if (finallyCallback)
+            {
+                finallyCallback();
+            }
         },
         // failureCallback
-        [this, weak = weakOf<Channel>(this)](auto error, auto message) {
+        [this, weak = weakOf<Channel>(this),
+         finallyCallback](auto error, auto message) {
+            if (finallyCallback)
+            {
+                finallyCallback();
+            }
+
             auto shared = weak.lock();
             if (!shared)
             {
@@ -2173,23 +2391,21 @@ std::optional<EmotePtr> TwitchChannel::twitchBadge(const QString &set,
 }
 
 std::vector<FfzBadges::Badge> TwitchChannel::ffzChannelBadges(
-    const QString &userID) const
+    const QString &userID, const FfzBadges &ffzBadges) const
 {
-    this->tgFfzChannelBadges_.guard();
+    auto channelBadges = this->ffzChannelBadges_.accessConst();
 
-    auto it = this->ffzChannelBadges_.find(userID);
-    if (it == this->ffzChannelBadges_.end())
+    auto it = channelBadges->find(userID);
+    if (it == channelBadges->end())
     {
         return {};
     }
 
     std::vector<FfzBadges::Badge> badges;
 
-    const auto *ffzBadges = getApp()->getFfzBadges();
-
     for (const auto &badgeID : it->second)
     {
-        auto badge = ffzBadges->getBadge(badgeID);
+        auto badge = ffzBadges.getBadge(badgeID);
         if (badge.has_value())
         {
             badges.emplace_back(*badge);
@@ -2201,8 +2417,7 @@ std::vector<FfzBadges::Badge> TwitchChannel::ffzChannelBadges(
 
 void TwitchChannel::setFfzChannelBadges(FfzChannelBadgeMap map)
 {
-    this->tgFfzChannelBadges_.guard();
-    this->ffzChannelBadges_ = std::move(map);
+    *this->ffzChannelBadges_.access() = std::move(map);
 }
 
 std::optional<EmotePtr> TwitchChannel::ffzCustomModBadge() const
@@ -11,7 +11,6 @@
 #include "providers/twitch/eventsub/SubscriptionHandle.hpp"
 #include "providers/twitch/TwitchEmotes.hpp"
 #include "util/QStringHash.hpp"
-#include "util/ThreadGuard.hpp"
 
 #include <boost/circular_buffer/space_optimized.hpp>
 #include <boost/signals2.hpp>
@@ -22,6 +21,7 @@
 #include <QRegularExpression>
 
 #include <atomic>
+#include <functional>
 #include <mutex>
 #include <optional>
 #include <unordered_map>
@@ -36,6 +36,7 @@ enum class HighlightState;
 struct Emote;
 using EmotePtr = std::shared_ptr<const Emote>;
 class EmoteMap;
+class EmoteIndex;
 
 class TwitchBadges;
 class FfzEmotes;
@@ -169,6 +170,20 @@ public:
 
     void initialize();
 
+    /// Defers loading the channel's emotes, badges, chatters and recent
+    /// messages until hydrate() is called. The channel is still joined, so
+    /// messages are received, logged and checked for mentions.
+    ///
+    /// This only has an effect before the room ID is known.
+    void deferHydration();
+    /// Loads everything that was deferred by deferHydration()
+    ///
+    /// Messages received while the channel was deferred were built without
+    /// its emotes and badges. Once those are loaded, the ones still in the
+    /// recent messages history are rebuilt, older ones aren't.
+    void hydrate();
+    bool isHydrated() const;
+
     // Channel methods
     bool isEmpty() const override;
     bool canSendMessage() const override;
@@ -222,10 +237,24 @@ public:
     std::shared_ptr<const EmoteMap> ffzEmotes() const;
     std::shared_ptr<const EmoteMap> seventvEmotes() const;
 
+    /// Returns the channel's FFZ, BTTV and 7TV emotes merged with the global
+    /// ones into a single index. The index is rebuilt on demand after any of
+    /// these emote sets was replaced. Live emote updates only update the
+    /// changed names.
+    ///
+    /// This may only be called from the GUI thread. The returned index is
+    /// immutable and can be handed to other threads.
+    std::shared_ptr<const EmoteIndex> emoteIndex();
+
     void refreshTwitchChannelEmotes(bool manualRefresh);
-    void refreshBTTVChannelEmotes(bool manualRefresh);
-    void refreshFFZChannelEmotes(bool manualRefresh);
-    void refreshSevenTVChannelEmotes(bool manualRefresh);
+    /// `finallyCallback` is called once the emotes are loaded or loading
+    /// them failed.
+    void refreshBTTVChannelEmotes(bool manualRefresh,
+                                  std::function<void()> finallyCallback = {});
+    void refreshFFZChannelEmotes(bool manualRefresh,
+                                 std::function<void()> finallyCallback = {});
+    void refreshSevenTVChannelEmotes(
+        bool manualRefresh, std::function<void()> finallyCallback = {});
 
     void setBttvEmotes(std::shared_ptr<const EmoteMap> &&map);
     void setFfzEmotes(std::shared_ptr<const EmoteMap> &&map);
@@ -264,8 +293,11 @@ public:
                                         const QString &version) const;
     /**
      * Returns a list of channel-specific FrankerFaceZ badges for the given user
+     *
+     * The badges are looked up in @a ffzBadges
      */
-    std::vector<FfzBadges::Badge> ffzChannelBadges(const QString &userID) const;
+    std::vector<FfzBadges::Badge> ffzChannelBadges(
+        const QString &userID, const FfzBadges &ffzBadges) const;
     void setFfzChannelBadges(FfzChannelBadgeMap map);
     void setFfzCustomModBadge(std::optional<EmotePtr> badge);
     void setFfzCustomVipBadge(std::optional<EmotePtr> badge);
@@ -364,9 +396,12 @@ private:
 
     void refreshPubSub();
     void refreshChatters();
-    void refreshBadges();
+    void refreshBadges(std::function<void()> finallyCallback = {});
     void refreshCheerEmotes();
-    void loadRecentMessages();
+    /// @param fillIn Merge the messages with the ones already in the channel
+    ///               instead of adding them to the start. Messages that are
+    ///               already in the channel are replaced with the loaded ones.
+    void loadRecentMessages(bool fillIn = false);
     void loadRecentMessagesReconnect();
     void cleanUpReplyThreads();
     void showLoginMessage();
@@ -374,6 +409,12 @@ private:
     /// roomIdChanged is called whenever this channel's ID has been changed
     /// This should only happen once per channel, whenever the ID goes from unset to set
     void roomIdChanged();
+    /// Loads the emotes and badges of this channel and joins the live
+    /// updates. Requires the room ID.
+    ///
+    /// `onLoaded` is called once the channel's BTTV, FFZ and 7TV emotes and
+    /// its badges are loaded or failed to load.
+    void loadRoomData(std::function<void()> onLoaded = {});
 
     /** Joins (subscribes to) a Twitch channel for updates on BTTV. */
     void joinBttvChannel() const;
@@ -450,6 +491,7 @@ private:
     UniqueAccess<StreamStatus> streamStatus_;
     UniqueAccess<RoomModes> roomModes;
     bool disconnected_{};
+    bool hydrationDeferred_{};
     std::optional<std::chrono::time_point<std::chrono::system_clock>>
         lastConnectedAt_{};
     std::atomic_flag loadingRecentMessages_ = ATOMIC_FLAG_INIT;
@@ -463,13 +505,24 @@ protected:
     Atomic<std::shared_ptr<const EmoteMap>> bttvEmotes_;
     Atomic<std::shared_ptr<const EmoteMap>> ffzEmotes_;
     Atomic<std::shared_ptr<const EmoteMap>> seventvEmotes_;
+    Atomic<std::shared_ptr<const EmoteIndex>> emoteIndex_;
+    std::atomic<bool> emoteIndexOutdated_{true};
+    /// Names changed by live emote updates since emoteIndex_ was last updated.
+    /// Only accessed from the GUI thread.
+    std::vector<QString> changedEmoteNames_;
     Atomic<std::optional<EmotePtr>> ffzCustomModBadge_;
     Atomic<std::optional<EmotePtr>> ffzCustomVipBadge_;
 
-    FfzChannelBadgeMap ffzChannelBadges_;
-    ThreadGuard tgFfzChannelBadges_;
+    UniqueAccess<FfzChannelBadgeMap> ffzChannelBadges_;
 
 private:
+    /// Marks emoteIndex_ as outdated. Call this after replacing any of the
+    /// channel's emote maps.
+    void invalidateEmoteIndex();
+    /// Marks the given names in emoteIndex_ as outdated. Call this after
+    /// adding, updating or removing single emotes. GUI thread only.
+    void invalidateEmoteNames(std::initializer_list<QString> names);
+
     // Badges
     UniqueAccess<std::map<QString, std::map<QString, EmotePtr>>>
         badgeSets_;  // "subscribers": { "0": ... "3": ... "6": ...
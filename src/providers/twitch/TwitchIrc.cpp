@@ -3,6 +3,7 @@
 #include "Application.hpp"
 #include "common/Aliases.hpp"
 #include "common/QLogging.hpp"
+#include "providers/twitch/TwitchIrcLine.hpp"
 #include "singletons/Emotes.hpp"
 #include "util/IrcHelpers.hpp"
 
@@ -14,9 +15,9 @@ void appendTwitchEmoteOccurrences(const QString &emote,
                                   std::vector<TwitchEmoteOccurrence> &vec,
                                   const std::vector<int> &correctPositions,
                                   const QString &originalMessage,
-                                  int messageOffset)
+                                  int messageOffset,
+                                  ITwitchEmotes &twitchEmotes)
 {
-    auto *app = getApp();
     if (!emote.contains(':'))
     {
         return;
@@ -69,7 +70,7 @@ void appendTwitchEmoteOccurrences(const QString &emote,
         TwitchEmoteOccurrence emoteOccurrence{
             start,
             end,
-            app->getEmotes()->getTwitchEmotes()->getOrCreateEmote(id, name),
+            twitchEmotes.getOrCreateEmote(id, name),
             name,
         };
         if (emoteOccurrence.ptr == nullptr)
@@ -81,21 +82,11 @@ void appendTwitchEmoteOccurrences(const QString &emote,
     }
 }
 
-}  // namespace
-
-namespace chatterino {
-
-std::unordered_map<QString, QString> parseBadgeInfoTag(const QVariantMap &tags)
+std::unordered_map<QString, QString> badgeInfosFromTag(const QString &value)
 {
     std::unordered_map<QString, QString> infoMap;
 
-    auto infoIt = tags.constFind("badge-info");
-    if (infoIt == tags.end())
-    {
-        return infoMap;
-    }
-
-    auto info = infoIt.value().toString().split(',', Qt::SkipEmptyParts);
+    auto info = value.split(',', Qt::SkipEmptyParts);
 
     for (const QString &badge : info)
     {
@@ -105,17 +96,11 @@ std::unordered_map<QString, QString> parseBadgeInfoTag(const QVariantMap &tags)
     return infoMap;
 }
 
-std::vector<Badge> parseBadgeTag(const QVariantMap &tags)
+std::vector<Badge> badgesFromTag(const QString &value)
 {
     std::vector<Badge> b;
 
-    auto badgesIt = tags.constFind("badges");
-    if (badgesIt == tags.end())
-    {
-        return b;
-    }
-
-    auto badges = badgesIt.value().toString().split(',', Qt::SkipEmptyParts);
+    auto badges = value.split(',', Qt::SkipEmptyParts);
 
     for (const QString &badge : badges)
     {
@@ -131,21 +116,13 @@ std::vector<Badge> parseBadgeTag(const QVariantMap &tags)
     return b;
 }
 
-std::vector<TwitchEmoteOccurrence> parseTwitchEmotes(const QVariantMap &tags,
-                                                     const QString &content,
-                                                     int messageOffset)
+std::vector<TwitchEmoteOccurrence> twitchEmotesFromTag(
+    const QString &value, const QString &content, int messageOffset,
+    ITwitchEmotes &emotes)
 {
-    // Twitch emotes
     std::vector<TwitchEmoteOccurrence> twitchEmotes;
 
-    auto emotesTag = tags.find("emotes");
-
-    if (emotesTag == tags.end())
-    {
-        return twitchEmotes;
-    }
-
-    QStringList emoteString = emotesTag.value().toString().split('/');
+    QStringList emoteString = value.split('/');
     std::vector<int> correctPositions;
     for (int i = 0; i < content.size(); ++i)
     {
@@ -157,10 +134,94 @@ std::vector<TwitchEmoteOccurrence> parseTwitchEmotes(const QVariantMap &tags,
     for (const QString &emote : emoteString)
     {
         appendTwitchEmoteOccurrences(emote, twitchEmotes, correctPositions,
-                                     content, messageOffset);
+                                     content, messageOffset, emotes);
     }
 
     return twitchEmotes;
 }
 
+}  // namespace
+
+namespace chatterino {
+
+std::unordered_map<QString, QString> parseBadgeInfoTag(const QVariantMap &tags)
+{
+    auto infoIt = tags.constFind("badge-info");
+    if (infoIt == tags.end())
+    {
+        return {};
+    }
+
+    return badgeInfosFromTag(infoIt.value().toString());
+}
+
+std::unordered_map<QString, QString> parseBadgeInfoTag(
+    const TwitchIrcLine &line)
+{
+    if (!line.hasTag(TwitchTag::BadgeInfo))
+    {
+        return {};
+    }
+
+    return badgeInfosFromTag(line.tag(TwitchTag::BadgeInfo));
+}
+
+std::vector<Badge> parseBadgeTag(const QVariantMap &tags)
+{
+    auto badgesIt = tags.constFind("badges");
+    if (badgesIt == tags.end())
+    {
+        return {};
+    }
+
+    return badgesFromTag(badgesIt.value().toString());
+}
+
+std::vector<Badge> parseBadgeTag(const TwitchIrcLine &line)
+{
+    if (!line.hasTag(TwitchTag::Badges))
+    {
+        return {};
+    }
+
+    return badgesFromTag(line.tag(TwitchTag::Badges));
+}
+
+std::vector<TwitchEmoteOccurrence> parseTwitchEmotes(const QVariantMap &tags,
+                                                     const QString &content,
+                                                     int messageOffset)
+{
+    auto emotesTag = tags.find("emotes");
+
+    if (emotesTag == tags.end())
+    {
+        return {};
+    }
+
+    return twitchEmotesFromTag(emotesTag.value().toString(), content,
+                               messageOffset,
+                               *getApp()->getEmotes()->getTwitchEmotes());
+}
+
+std::vector<TwitchEmoteOccurrence> parseTwitchEmotes(const TwitchIrcLine &line,
+                                                     const QString &content,
+                                                     int messageOffset)
+{
+    return parseTwitchEmotes(line, content, messageOffset,
+                             *getApp()->getEmotes()->getTwitchEmotes());
+}
+
+std::vector<TwitchEmoteOccurrence> parseTwitchEmotes(
+    const TwitchIrcLine &line, const QString &content, int messageOffset,
+    ITwitchEmotes &twitchEmotes)
+{
+    if (!line.hasTag(TwitchTag::Emotes))
+    {
+        return {};
+    }
+
+    return twitchEmotesFromTag(line.tag(TwitchTag::Emotes), content,
+                               messageOffset, twitchEmotes);
+}
+
 }  // namespace chatterino
@@ -10,6 +10,9 @@
 
 namespace chatterino {
 
+class ITwitchEmotes;
+class TwitchIrcLine;
+
 struct TwitchEmoteOccurrence {
     int start;
     int end;
@@ -34,6 +37,8 @@ struct TwitchEmoteOccurrence {
 /// @param tags The tags of the IRC message
 /// @returns A map of badge-names to their values
 std::unordered_map<QString, QString> parseBadgeInfoTag(const QVariantMap &tags);
+std::unordered_map<QString, QString> parseBadgeInfoTag(
+    const TwitchIrcLine &line);
 
 /// @brief Parses the `badges` tag of an IRC message
 ///
@@ -47,6 +52,7 @@ std::unordered_map<QString, QString> parseBadgeInfoTag(const QVariantMap &tags);
 /// @param tags The tags of the IRC message
 /// @returns A list of badges (name and version)
 std::vector<Badge> parseBadgeTag(const QVariantMap &tags);
+std::vector<Badge> parseBadgeTag(const TwitchIrcLine &line);
 
 /// @brief Parses Twitch emotes in an IRC message
 ///
@@ -59,9 +65,18 @@ std::vector<Badge> parseBadgeTag(const QVariantMap &tags);
 ///                      `content` excludes the first three characters of the
 ///                      original message (`@a foo` (original message) -> `foo`
 ///                      (content)).
+/// @param twitchEmotes Where emotes are looked up. The overloads without this
+///                     parameter use the application's and may only be called
+///                     from the GUI thread.
 /// @returns A list of emotes and their positions
 std::vector<TwitchEmoteOccurrence> parseTwitchEmotes(const QVariantMap &tags,
                                                      const QString &content,
                                                      int messageOffset);
+std::vector<TwitchEmoteOccurrence> parseTwitchEmotes(const TwitchIrcLine &line,
+                                                     const QString &content,
+                                                     int messageOffset);
+std::vector<TwitchEmoteOccurrence> parseTwitchEmotes(
+    const TwitchIrcLine &line, const QString &content, int messageOffset,
+    ITwitchEmotes &twitchEmotes);
 
 }  // namespace chatterino
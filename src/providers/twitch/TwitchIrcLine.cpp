@@ -0,0 +1,398 @@
+#include "providers/twitch/TwitchIrcLine.hpp"
+
+#include <IrcMessage>
+
+#include <algorithm>
+#include <string_view>
+
+namespace {
+
+using namespace chatterino;
+using namespace std::string_view_literals;
+
+constexpr size_t TAG_COUNT = static_cast<size_t>(TwitchTag::Count);
+
+/// The keys of all TwitchTags, indexed by the tag
+constexpr std::array<std::string_view, TAG_COUNT> TAG_KEYS{
+    "badge-info"sv,
+    "badges"sv,
+    "bits"sv,
+    "color"sv,
+    "custom-reward-id"sv,
+    "display-name"sv,
+    "emotes"sv,
+    "first-msg"sv,
+    "historical"sv,
+    "id"sv,
+    "login"sv,
+    "msg-id"sv,
+    "pinned-chat-paid-amount"sv,
+    "reply-parent-display-name"sv,
+    "reply-parent-msg-body"sv,
+    "reply-parent-msg-id"sv,
+    "reply-parent-user-id"sv,
+    "reply-parent-user-login"sv,
+    "reply-thread-parent-msg-id"sv,
+    "rm-deleted"sv,
+    "rm-received-ts"sv,
+    "room-id"sv,
+    "source-room-id"sv,
+    "time"sv,
+    "tmi-sent-ts"sv,
+    "user-id"sv,
+    "user-type"sv,
+};
+
+static_assert(TAG_COUNT <= 32, "TwitchIrcLine::presentTags_ is too small");
+
+/// All TwitchTags sorted by their key, so they can be binary searched
+constexpr auto SORTED_TAGS = [] {
+    std::array<TwitchTag, TAG_COUNT> tags{};
+    for (size_t i = 0; i < TAG_COUNT; i++)
+    {
+        tags[i] = static_cast<TwitchTag>(i);
+    }
+    std::ranges::sort(tags, {}, [](TwitchTag tag) {
+        return TAG_KEYS[static_cast<size_t>(tag)];
+    });
+    return tags;
+}();
+
+std::string_view toStringView(QByteArrayView view)
+{
+    return {view.data(), static_cast<size_t>(view.size())};
+}
+
+}  // namespace
+
+namespace chatterino {
+
+std::optional<TwitchIrcLine> TwitchIrcLine::parse(QByteArray data)
+{
+    while (data.endsWith('\n') || data.endsWith('\r'))
+    {
+        data.chop(1);
+    }
+
+    TwitchIrcLine line;
+    line.data_ = std::move(data);
+
+    const char *begin = line.data_.constData();
+    const auto size = static_cast<uint32_t>(line.data_.size());
+    uint32_t pos = 0;
+
+    auto skipSpaces = [&] {
+        while (pos < size && begin[pos] == ' ')
+        {
+            pos++;
+        }
+    };
+    // Advances to the next space (or the end) and returns the skipped span
+    auto takeWord = [&] {
+        Span span{.offset = pos};
+        while (pos < size && begin[pos] != ' ')
+        {
+            pos++;
+        }
+        span.length = pos - span.offset;
+        return span;
+    };
+
+    if (pos < size && begin[pos] == '@')
+    {
+        pos++;
+        while (pos < size && begin[pos] != ' ')
+        {
+            Span key{.offset = pos};
+            while (pos < size && begin[pos] != ' ' && begin[pos] != ';' &&
+                   begin[pos] != '=')
+            {
+                pos++;
+            }
+            key.length = pos - key.offset;
+
+            Span value{.offset = pos};
+            if (pos < size && begin[pos] == '=')
+            {
+                pos++;
+                value.offset = pos;
+                while (pos < size && begin[pos] != ' ' && begin[pos] != ';')
+                {
+                    pos++;
+                }
+                value.length = pos - value.offset;
+            }
+            if (pos < size && begin[pos] == ';')
+            {
+                pos++;
+            }
+
+            if (key.length == 0)
+            {
+                continue;
+            }
+
+            auto known = tagFromKey(line.view(key));
+            if (known)
+            {
+                auto idx = static_cast<size_t>(*known);
+                line.tags_[idx] = value;
+                line.presentTags_ |= 1U << idx;
+            }
+            else
+            {
+                line.otherTags_.emplace_back(key, value);
+            }
+        }
+        skipSpaces();
+    }
+
+    if (pos < size && begin[pos] == ':')
+    {
+        pos++;
+        line.prefix_ = takeWord();
+        skipSpaces();
+    }
+
+    line.command_ = takeWord();
+    if (line.command_.length == 0)
+    {
+        return std::nullopt;
+    }
+
+    while (true)
+    {
+        skipSpaces();
+        if (pos >= size)
+        {
+            break;
+        }
+        if (begin[pos] == ':')
+        {
+            line.parameters_.append({
+                .offset = pos + 1,
+                .length = size - pos - 1,
+            });
+            break;
+        }
+        line.parameters_.append(takeWord());
+    }
+
+    return line;
+}
+
+TwitchIrcLine TwitchIrcLine::fromMessage(const Communi::IrcMessage &message)
+{
+    auto line = parse(message.toData());
+    if (line && (line->presentTags_ != 0 || !line->otherTags_.empty() ||
+                 message.tags().isEmpty()))
+    {
+        return *line;
+    }
+
+    // The message was constructed manually (e.g. in tests). Communi doesn't
+    // add tags to IrcMessage::toData() in that case, so assemble the line.
+    QByteArray data;
+    const auto tags = message.tags();
+    if (!tags.isEmpty())
+    {
+        data += '@';
+        for (auto it = tags.begin(); it != tags.end(); ++it)
+        {
+            if (it != tags.begin())
+            {
+                data += ';';
+            }
+            data += it.key().toUtf8();
+            data += '=';
+            data += it.value().toString().toUtf8();
+        }
+        data += ' ';
+    }
+    if (!message.prefix().isEmpty())
+    {
+        data += ':';
+        data += message.prefix().toUtf8();
+        data += ' ';
+    }
+    data += message.command().isEmpty() ? QByteArray("UNKNOWN")
+                                        : message.command().toUtf8();
+    const auto params = message.parameters();
+    for (qsizetype i = 0; i < params.size(); i++)
+    {
+        data += ' ';
+        if (i == params.size() - 1)
+        {
+            data += ':';
+        }
+        data += params[i].toUtf8();
+    }
+
+    // There's always a command, so this can't fail
+    return *parse(std::move(data));
+}
+
+std::optional<TwitchTag> TwitchIrcLine::tagFromKey(QByteArrayView key)
+{
+    auto needle = toStringView(key);
+    const auto *it = std::ranges::lower_bound(
+        SORTED_TAGS, needle, {}, [](TwitchTag tag) {
+            return TAG_KEYS[static_cast<size_t>(tag)];
+        });
+    if (it == SORTED_TAGS.end() ||
+        TAG_KEYS[static_cast<size_t>(*it)] != needle)
+    {
+        return std::nullopt;
+    }
+    return *it;
+}
+
+QByteArrayView TwitchIrcLine::keyOf(TwitchTag tag)
+{
+    auto key = TAG_KEYS[static_cast<size_t>(tag)];
+    return {key.data(), static_cast<qsizetype>(key.size())};
+}
+
+bool TwitchIrcLine::hasTag(TwitchTag tag) const
+{
+    return (this->presentTags_ & (1U << static_cast<size_t>(tag))) != 0;
+}
+
+bool TwitchIrcLine::hasTag(QByteArrayView key) const
+{
+    return this->findTag(key) != nullptr;
+}
+
+QByteArrayView TwitchIrcLine::rawTag(TwitchTag tag) const
+{
+    if (!this->hasTag(tag))
+    {
+        return {};
+    }
+    return this->view(this->tags_[static_cast<size_t>(tag)]);
+}
+
+QByteArrayView TwitchIrcLine::rawTag(QByteArrayView key) const
+{
+    const auto *span = this->findTag(key);
+    if (span == nullptr)
+    {
+        return {};
+    }
+    return this->view(*span);
+}
+
+QString TwitchIrcLine::tag(TwitchTag tag) const
+{
+    if (!this->hasTag(tag))
+    {
+        return {};
+    }
+    return QString::fromUtf8(this->rawTag(tag));
+}
+
+QString TwitchIrcLine::tag(QByteArrayView key) const
+{
+    const auto *span = this->findTag(key);
+    if (span == nullptr)
+    {
+        return {};
+    }
+    return QString::fromUtf8(this->view(*span));
+}
+
+QVariantMap TwitchIrcLine::tags() const
+{
+    QVariantMap tags;
+    for (size_t i = 0; i < TAG_COUNT; i++)
+    {
+        auto tag = static_cast<TwitchTag>(i);
+        if (this->hasTag(tag))
+        {
+            tags.insert(QString::fromUtf8(keyOf(tag)), this->tag(tag));
+        }
+    }
+    for (const auto &[key, value] : this->otherTags_)
+    {
+        tags.insert(QString::fromUtf8(this->view(key)),
+                    QString::fromUtf8(this->view(value)));
+    }
+    return tags;
+}
+
+QByteArrayView TwitchIrcLine::rawPrefix() const
+{
+    return this->view(this->prefix_);
+}
+
+QString TwitchIrcLine::nick() const
+{
+    auto prefix = this->rawPrefix();
+    auto bang = prefix.indexOf('!');
+    if (bang >= 0)
+    {
+        prefix = prefix.first(bang);
+    }
+    return QString::fromUtf8(prefix);
+}
+
+QByteArrayView TwitchIrcLine::command() const
+{
+    return this->view(this->command_);
+}
+
+qsizetype TwitchIrcLine::parameterCount() const
+{
+    return this->parameters_.size();
+}
+
+QByteArrayView TwitchIrcLine::rawParameter(qsizetype i) const
+{
+    if (i < 0 || i >= this->parameters_.size())
+    {
+        return {};
+    }
+    return this->view(this->parameters_[i]);
+}
+
+QString TwitchIrcLine::parameter(qsizetype i) const
+{
+    if (i < 0 || i >= this->parameters_.size())
+    {
+        return {};
+    }
+    return QString::fromUtf8(this->view(this->parameters_[i]));
+}
+
+const QByteArray &TwitchIrcLine::data() const
+{
+    return this->data_;
+}
+
+QByteArrayView TwitchIrcLine::view(Span span) const
+{
+    return QByteArrayView{this->data_}.sliced(span.offset, span.length);
+}
+
+const TwitchIrcLine::Span *TwitchIrcLine::findTag(QByteArrayView key) const
+{
+    if (auto known = tagFromKey(key))
+    {
+        if (!this->hasTag(*known))
+        {
+            return nullptr;
+        }
+        return &this->tags_[static_cast<size_t>(*known)];
+    }
+
+    for (const auto &[otherKey, value] : this->otherTags_)
+    {
+        if (this->view(otherKey) == key)
+        {
+            return &value;
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace chatterino
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+#include <QVariantMap>
+#include <QVarLengthArray>
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace Communi {
+class IrcMessage;
+}  // namespace Communi
+
+namespace chatterino {
+
+/// The IRCv3 tags Twitch sends that are looked up when building messages
+enum class TwitchTag : uint8_t {
+    BadgeInfo,               // badge-info
+    Badges,                  // badges
+    Bits,                    // bits
+    Color,                   // color
+    CustomRewardId,          // custom-reward-id
+    DisplayName,             // display-name
+    Emotes,                  // emotes
+    FirstMsg,                // first-msg
+    Historical,              // historical
+    Id,                      // id
+    Login,                   // login
+    MsgId,                   // msg-id
+    PinnedChatPaidAmount,    // pinned-chat-paid-amount
+    ReplyParentDisplayName,  // reply-parent-display-name
+    ReplyParentMsgBody,      // reply-parent-msg-body
+    ReplyParentMsgId,        // reply-parent-msg-id
+    ReplyParentUserId,       // reply-parent-user-id
+    ReplyParentUserLogin,    // reply-parent-user-login
+    ReplyThreadParentMsgId,  // reply-thread-parent-msg-id
+    RmDeleted,               // rm-deleted
+    RmReceivedTs,            // rm-received-ts
+    RoomId,                  // room-id
+    SourceRoomId,            // source-room-id
+    Time,                    // time
+    TmiSentTs,               // tmi-sent-ts
+    UserId,                  // user-id
+    UserType,                // user-type
+
+    // don't remove this value
+    Count,
+};
+
+/// @brief A parsed IRC line from Twitch
+///
+/// The line is parsed in a single pass without copying it. Tags, the prefix,
+/// the command and the parameters are kept as offsets into the raw UTF-8 line
+/// and are only converted to QStrings when they're accessed. The tags in
+/// TwitchTag are resolved to fixed slots while parsing, so looking them up
+/// doesn't compare strings.
+///
+/// Like Communi::IrcMessage::tags(), tag values are returned as they were
+/// sent, without unescaping them (see parseTagString).
+///
+/// Copying a line is cheap, it shares the raw data.
+class TwitchIrcLine
+{
+public:
+    /// Parses @a data (without or with a trailing CRLF)
+    ///
+    /// @returns The parsed line or std::nullopt if the line has no command
+    static std::optional<TwitchIrcLine> parse(QByteArray data);
+
+    /// Parses the raw line of @a message. If the message wasn't created from a
+    /// raw line, it's assembled from the parsed parts of the message.
+    static TwitchIrcLine fromMessage(const Communi::IrcMessage &message);
+
+    /// Returns the tag for @a key or std::nullopt if it's not a TwitchTag
+    static std::optional<TwitchTag> tagFromKey(QByteArrayView key);
+    static QByteArrayView keyOf(TwitchTag tag);
+
+    bool hasTag(TwitchTag tag) const;
+    bool hasTag(QByteArrayView key) const;
+
+    /// Returns the raw value of @a tag. The view is valid as long as this
+    /// line (or a copy of it) exists.
+    QByteArrayView rawTag(TwitchTag tag) const;
+    QByteArrayView rawTag(QByteArrayView key) const;
+
+    /// Returns the value of @a tag or a null string if it's not present
+    QString tag(TwitchTag tag) const;
+    QString tag(QByteArrayView key) const;
+
+    /// Returns all tags like Communi::IrcMessage::tags()
+    QVariantMap tags() const;
+
+    QByteArrayView rawPrefix() const;
+    /// The part of the prefix before the '!' (like Communi::IrcMessage::nick())
+    QString nick() const;
+
+    QByteArrayView command() const;
+
+    qsizetype parameterCount() const;
+    QByteArrayView rawParameter(qsizetype i) const;
+    /// Returns the parameter at @a i or a null string if there's none
+    QString parameter(qsizetype i) const;
+
+    const QByteArray &data() const;
+
+private:
+    TwitchIrcLine() = default;
+
+    struct Span {
+        uint32_t offset = 0;
+        uint32_t length = 0;
+    };
+
+    QByteArrayView view(Span span) const;
+    const Span *findTag(QByteArrayView key) const;
+
+    QByteArray data_;
+
+    /// Bit `i` is set if the tag `TwitchTag(i)` is present
+    uint32_t presentTags_ = 0;
+    std::array<Span, static_cast<size_t>(TwitchTag::Count)> tags_{};
+    /// All other tags (key and value)
+    std::vector<std::pair<Span, Span>> otherTags_;
+
+    Span prefix_;
+    Span command_;
+    QVarLengthArray<Span, 4> parameters_;
+};
+
+}  // namespace chatterino
@@ -7,6 +7,7 @@
 #include "common/Literals.hpp"
 #include "common/QLogging.hpp"
 #include "controllers/accounts/AccountController.hpp"
+#include "debug/Trace.hpp"
 #include "messages/LimitedQueueSnapshot.hpp"
 #include "messages/Message.hpp"
 #include "messages/MessageBuilder.hpp"
@@ -34,7 +35,9 @@
 #include <pajlada/signals/signalholder.hpp>
 #include <QCoreApplication>
 #include <QMetaEnum>
+#include <QThread>
 
+#include <algorithm>
 #include <cassert>
 #include <functional>
 #include <mutex>
@@ -141,6 +144,7 @@ TwitchIrcServer::TwitchIrcServer()
     , liveChannel(new Channel("/live", Channel::Type::TwitchLive))
     , automodChannel(new Channel("/automod", Channel::Type::TwitchAutomod))
     , watchingChannel(Channel::getEmpty(), Channel::Type::TwitchWatching)
+    , messageBuildQueue_(std::clamp(QThread::idealThreadCount() / 2, 1, 4))
 {
     // Initialize the connections
     // XXX: don't create write connection if there is no separate write connection.
@@ -343,18 +347,59 @@ std::shared_ptr<Channel> TwitchIrcServer::createChannel(
 void TwitchIrcServer::privateMessageReceived(
     Communi::IrcPrivateMessage *message)
 {
-    IrcMessageHandler::instance().handlePrivMessage(message, *this);
+    TRACE_ZONE("irc receive (privmsg)");
+
+    auto &handler = IrcMessageHandler::instance();
+
+    if (auto build = handler.prepareAsyncPrivMessage(message, *this))
+    {
+        this->messageBuildQueue_.push(std::move(build));
+        return;
+    }
+
+    this->handleInOrder(message, [this](Communi::IrcMessage *msg) {
+        IrcMessageHandler::instance().handlePrivMessage(
+            static_cast<Communi::IrcPrivateMessage *>(msg), *this);
+    });
 }
 
 void TwitchIrcServer::readConnectionMessageReceived(
     Communi::IrcMessage *message)
 {
+    TRACE_ZONE("irc receive");
+
     if (message->type() == Communi::IrcMessage::Type::Private)
     {
         // We already have a handler for private messages
         return;
     }
 
+    this->handleInOrder(message, [this](Communi::IrcMessage *msg) {
+        this->handleReadConnectionMessage(msg);
+    });
+}
+
+void TwitchIrcServer::handleInOrder(
+    Communi::IrcMessage *message,
+    const std::function<void(Communi::IrcMessage *)> &handler)
+{
+    if (this->messageBuildQueue_.idle())
+    {
+        handler(message);
+        return;
+    }
+
+    // Messages are still being built, so this one has to wait for them to be
+    // added (e.g. a CLEARMSG must not overtake the message it deletes).
+    // The message is owned by the connection and deleted after it's handled.
+    std::shared_ptr<Communi::IrcMessage> copy(message->clone(), DeleteLater{});
+    this->messageBuildQueue_.pushCommit([handler, copy] {
+        handler(copy.get());
+    });
+}
+
+void TwitchIrcServer::handleReadConnectionMessage(Communi::IrcMessage *message)
+{
     const QString &command = message->command();
 
     auto &handler = IrcMessageHandler::instance();
@@ -945,7 +990,9 @@ void TwitchIrcServer::initEventAPIs(BttvLiveUpdates *bttvLiveUpdates,
 void TwitchIrcServer::reloadAllBTTVChannelEmotes()
 {
     this->forEachChannel([](const auto &chan) {
-        if (auto *channel = dynamic_cast<TwitchChannel *>(chan.get()))
+        auto *channel = dynamic_cast<TwitchChannel *>(chan.get());
+        // Deferred channels load their emotes once they're hydrated
+        if (channel && channel->isHydrated())
         {
             channel->refreshBTTVChannelEmotes(false);
         }
@@ -955,7 +1002,8 @@ void TwitchIrcServer::reloadAllBTTVChannelEmotes()
 void TwitchIrcServer::reloadAllFFZChannelEmotes()
 {
     this->forEachChannel([](const auto &chan) {
-        if (auto *channel = dynamic_cast<TwitchChannel *>(chan.get()))
+        auto *channel = dynamic_cast<TwitchChannel *>(chan.get());
+        if (channel && channel->isHydrated())
         {
             channel->refreshFFZChannelEmotes(false);
         }
@@ -965,7 +1013,8 @@ void TwitchIrcServer::reloadAllFFZChannelEmotes()
 void TwitchIrcServer::reloadAllSevenTVChannelEmotes()
 {
     this->forEachChannel([](const auto &chan) {
-        if (auto *channel = dynamic_cast<TwitchChannel *>(chan.get()))
+        auto *channel = dynamic_cast<TwitchChannel *>(chan.get());
+        if (channel && channel->isHydrated())
         {
             channel->refreshSevenTVChannelEmotes(false);
         }
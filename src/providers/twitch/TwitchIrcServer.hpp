@@ -4,6 +4,7 @@
 #include "common/Channel.hpp"
 #include "common/Common.hpp"
 #include "providers/irc/IrcConnection2.hpp"
+#include "util/OrderedTaskQueue.hpp"
 #include "util/RatelimitBucket.hpp"
 
 #include <IrcMessage>
@@ -170,6 +171,7 @@ protected:
 
     void privateMessageReceived(Communi::IrcPrivateMessage *message);
     void readConnectionMessageReceived(Communi::IrcMessage *message);
+    void handleReadConnectionMessage(Communi::IrcMessage *message);
     void writeConnectionMessageReceived(Communi::IrcMessage *message);
 
     void onReadConnected(IrcConnection *connection);
@@ -188,6 +190,12 @@ private:
 
     bool prepareToSend(const std::shared_ptr<TwitchChannel> &channel);
 
+    /// Runs @a handler after all messages that are currently being built
+    /// were added to their channels
+    void handleInOrder(
+        Communi::IrcMessage *message,
+        const std::function<void(Communi::IrcMessage *)> &handler);
+
     QMap<QString, std::weak_ptr<Channel>> channels;
     std::mutex channelMutex;
 
@@ -205,6 +213,10 @@ private:
 
     pajlada::Signals::SignalHolder signalHolder;
 
+    /// Builds PRIVMSGs on a thread pool and adds them to their channels in
+    /// the order they were received
+    OrderedTaskQueue messageBuildQueue_;
+
     std::mutex lastMessageMutex_;
     std::queue<std::chrono::steady_clock::time_point> lastMessagePleb_;
     std::queue<std::chrono::steady_clock::time_point> lastMessageMod_;
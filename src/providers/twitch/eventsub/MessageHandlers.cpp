@@ -24,9 +24,8 @@ void handleModerateMessage(
             MessageBuilder::makeClearChatMessage(time, actor), time);
         if (getSettings()->hideModerated)
         {
-            // XXX: This is expensive. We could use a layout request if the layout
-            //      would store the previous message flags.
-            getApp()->getWindows()->forceLayoutChannelViews();
+            // Only the layouts of messages with changed flags are updated
+            getApp()->getWindows()->layoutChannelViews();
         }
     });
 }
@@ -189,6 +189,7 @@ Fonts::Fonts(Settings &settings)
         {
             map.clear();
         }
+        this->generation_++;
         this->fontChanged.invoke();
     });
     this->fontChangedListener.addSetting(settings.chatFontFamily);
@@ -207,6 +208,25 @@ QFontMetricsF Fonts::getFontMetrics(FontStyle type, float scale)
     return this->getOrCreateFontData(type, scale).metrics;
 }
 
+qreal Fonts::getWordWidth(FontStyle type, float scale, const QString &word)
+{
+    auto &data = this->getOrCreateFontData(type, scale);
+
+    if (data.wordWidths.exists(word))
+    {
+        return data.wordWidths.get(word);
+    }
+
+    auto width = data.metrics.horizontalAdvance(word);
+    data.wordWidths.put(word, width);
+    return width;
+}
+
+size_t Fonts::generation() const
+{
+    return this->generation_;
+}
+
 Fonts::FontData &Fonts::getOrCreateFontData(FontStyle type, float scale)
 {
     assertInGuiThread();
@@ -2,10 +2,13 @@
 
 #include "pajlada/settings/settinglistener.hpp"
 
+#include <lrucache/lrucache.hpp>
 #include <pajlada/signals/signal.hpp>
 #include <QFont>
 #include <QFontMetrics>
+#include <QString>
 
+#include <cstddef>
 #include <unordered_map>
 #include <vector>
 
@@ -49,8 +52,21 @@ public:
     QFont getFont(FontStyle type, float scale);
     QFontMetricsF getFontMetrics(FontStyle type, float scale);
 
+    /// @brief Returns the horizontal advance of `word` in the given font
+    ///
+    /// The most recently used widths are cached per font, so common words
+    /// (emote names, usernames, timestamps) are only measured once.
+    qreal getWordWidth(FontStyle type, float scale, const QString &word);
+
+    /// Incremented whenever the fonts change. Widths measured with an older
+    /// generation are outdated.
+    size_t generation() const;
+
     pajlada::Signals::NoArgSignal fontChanged;
 
+    /// The number of word widths cached per font
+    static constexpr size_t WORD_WIDTH_CACHE_SIZE = 4096;
+
 private:
     struct FontData {
         FontData(const QFont &_font)
@@ -61,6 +77,7 @@ private:
 
         const QFont font;
         const QFontMetricsF metrics;
+        cache::lru_cache<QString, qreal> wordWidths{WORD_WIDTH_CACHE_SIZE};
     };
 
     struct ChatFontData {
@@ -79,6 +96,7 @@ private:
     static FontData createFontData(FontStyle type, float scale);
 
     std::vector<std::unordered_map<float, FontData>> fontsByType_;
+    size_t generation_ = 0;
 
     pajlada::SettingListener fontChangedListener;
 };
@@ -1,19 +1,36 @@
 #include "singletons/Logging.hpp"
 
 #include "messages/Message.hpp"
-#include "singletons/helper/LoggingChannel.hpp"
+#include "singletons/helper/LogWriter.hpp"
+#include "singletons/Paths.hpp"
 #include "singletons/Settings.hpp"
 
-#include <QDir>
-#include <QStandardPaths>
-
+#include <algorithm>
 #include <memory>
 #include <utility>
 
 namespace chatterino {
 
-Logging::Logging(Settings &settings)
+Logging::Logging(Settings &settings, const Paths &paths)
+    : settings_(settings)
+    , paths_(paths)
 {
+    this->writerOptionsListener_.addSetting(settings.logPath);
+    this->writerOptionsListener_.addSetting(settings.logTimestampFormat);
+    this->writerOptionsListener_.addSetting(settings.tryUseTwitchTimestamps);
+    this->writerOptionsListener_.addSetting(
+        settings.separatelyStoreStreamLogs);
+    this->writerOptionsListener_.addSetting(settings.stripReplyMention);
+    this->writerOptionsListener_.addSetting(settings.hideReplyContext);
+    this->writerOptionsListener_.addSetting(settings.logFlushInterval);
+    this->writerOptionsListener_.addSetting(settings.logFlushThreshold);
+    this->writerOptionsListener_.setCB([this] {
+        if (this->writer_)
+        {
+            this->writer_->setOptions(this->makeWriterOptions());
+        }
+    });
+
     // We can safely ignore this signal connection since settings are only-ever destroyed
     // on application exit
     // NOTE: SETTINGS_LIFETIME
@@ -31,6 +48,10 @@ Logging::Logging(Settings &settings)
         });
 }
 
+// Defined here so the destructor of LogWriter is known. Destroying the
+// writer flushes and closes all open log files.
+Logging::~Logging() = default;
+
 void Logging::addMessage(const QString &channelName, MessagePtr message,
                          const QString &platformName, const QString &streamID)
 {
@@ -54,44 +75,46 @@ void Logging::addMessage(const QString &channelName, MessagePtr message,
         }
     }
 
-    auto platIt = this->loggingChannels_.find(platformName);
-    if (platIt == this->loggingChannels_.end())
+    if (!this->writer_)
     {
-        auto *channel = new LoggingChannel(channelName, platformName);
-        channel->addMessage(message, streamID);
-        auto map = std::map<QString, std::unique_ptr<LoggingChannel>>();
-        this->loggingChannels_[platformName] = std::move(map);
-        auto &ref = this->loggingChannels_.at(platformName);
-        ref.emplace(channelName, channel);
-        return;
-    }
-    auto chanIt = platIt->second.find(channelName);
-    if (chanIt == platIt->second.end())
-    {
-        auto *channel = new LoggingChannel(channelName, platformName);
-        channel->addMessage(message, streamID);
-        platIt->second.emplace(channelName, channel);
-    }
-    else
-    {
-        chanIt->second->addMessage(message, streamID);
+        this->writer_ =
+            std::make_unique<LogWriter>(this->makeWriterOptions());
     }
+
+    this->writer_->addMessage(channelName, platformName, std::move(message),
+                              streamID);
 }
 
 void Logging::closeChannel(const QString &channelName,
                            const QString &platformName)
 {
-    if (platformName.isEmpty())
+    if (platformName.isEmpty() || !this->writer_)
     {
         return;
     }
 
-    auto platIt = this->loggingChannels_.find(platformName);
-    if (platIt == this->loggingChannels_.end())
-    {
-        return;
-    }
-    platIt->second.erase(channelName);
+    this->threadGuard.guard();
+
+    this->writer_->closeChannel(channelName, platformName);
+}
+
+LogWriterOptions Logging::makeWriterOptions() const
+{
+    const QString logPath = this->settings_.logPath;
+
+    return {
+        .baseDirectory =
+            logPath.isEmpty() ? this->paths_.messageLogDirectory : logPath,
+        .timestampFormat = this->settings_.logTimestampFormat,
+        .tryUseTwitchTimestamps = this->settings_.tryUseTwitchTimestamps,
+        .separatelyStoreStreamLogs = this->settings_.separatelyStoreStreamLogs,
+        .stripReplyMention = this->settings_.stripReplyMention,
+        .hideReplyContext = this->settings_.hideReplyContext,
+        .flushInterval = std::chrono::milliseconds{
+            std::max(this->settings_.logFlushInterval.getValue(), 10)},
+        .flushThreshold =
+            std::max(this->settings_.logFlushThreshold.getValue(), 0),
+    };
 }
 
 }  // namespace chatterino
@@ -3,18 +3,20 @@
 #include "util/QStringHash.hpp"
 #include "util/ThreadGuard.hpp"
 
+#include <pajlada/settings/settinglistener.hpp>
 #include <QString>
 
-#include <map>
 #include <memory>
 #include <unordered_set>
 
 namespace chatterino {
 
 class Settings;
+class Paths;
 struct Message;
 using MessagePtr = std::shared_ptr<const Message>;
-class LoggingChannel;
+class LogWriter;
+struct LogWriterOptions;
 
 class ILogging
 {
@@ -29,10 +31,20 @@ public:
                               const QString &platformName) = 0;
 };
 
+/// Decides which messages get logged and hands them to a `LogWriter`.
+///
+/// Everything on disk is done on the writer thread - the GUI thread only
+/// enqueues the message.
 class Logging : public ILogging
 {
 public:
-    Logging(Settings &settings);
+    Logging(Settings &settings, const Paths &paths);
+    ~Logging() override;
+
+    Logging(const Logging &) = delete;
+    Logging &operator=(const Logging &) = delete;
+    Logging(Logging &&) = delete;
+    Logging &operator=(Logging &&) = delete;
 
     void addMessage(const QString &channelName, MessagePtr message,
                     const QString &platformName,
@@ -42,14 +54,17 @@ public:
                       const QString &platformName) override;
 
 private:
-    using PlatformName = QString;
-    using ChannelName = QString;
-    std::map<PlatformName,
-             std::map<ChannelName, std::unique_ptr<LoggingChannel>>>
-        loggingChannels_;
+    LogWriterOptions makeWriterOptions() const;
+
+    Settings &settings_;
+    const Paths &paths_;
+
+    // Started with the first logged message
+    std::unique_ptr<LogWriter> writer_;
+    pajlada::SettingListener writerOptionsListener_;
 
     // Keeps the value of the `loggedChannels` settings
-    std::unordered_set<ChannelName> onlyLogListedChannels;
+    std::unordered_set<QString> onlyLogListedChannels;
     ThreadGuard threadGuard;
 };
 
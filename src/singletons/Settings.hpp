@@ -588,6 +588,10 @@ public:
         false,
     };
     QStringSetting logPath = {"/logging/path", ""};
+    /// How often pending log lines are written to disk (in milliseconds)
+    IntSetting logFlushInterval = {"/logging/flushInterval", 1000};
+    /// Write a channel's log early once this many bytes are pending
+    IntSetting logFlushThreshold = {"/logging/flushThreshold", 64 * 1024};
 
     QStringSetting pathHighlightSound = {"/highlighting/highlightSoundPath",
                                          ""};
@@ -684,6 +688,8 @@ public:
         ThumbnailPreviewMode::AlwaysShow,
     };
     QStringSetting cachePath = {"/cache/path", ""};
+    /// Size limit of cached HTTP responses (e.g. emotes) in MiB
+    IntSetting cacheSizeLimit = {"/cache/sizeLimit", 512};
     BoolSetting attachExtensionToAnyProcess = {
         "/misc/attachExtensionToAnyProcess", false};
     BoolSetting askOnImageUpload = {"/misc/askOnImageUpload", true};
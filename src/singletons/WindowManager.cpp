@@ -5,6 +5,7 @@
 #include "common/QLogging.hpp"
 #include "debug/AssertInGuiThread.hpp"
 #include "messages/MessageElement.hpp"
+#include "providers/twitch/TwitchChannel.hpp"
 #include "providers/twitch/TwitchIrcServer.hpp"
 #include "singletons/Paths.hpp"
 #include "singletons/Settings.hpp"
@@ -36,6 +37,13 @@
 
 namespace {
 
+using namespace std::chrono_literals;
+
+/// Time after startup until channels in hidden tabs are loaded
+constexpr auto DEFERRED_CHANNELS_DELAY = 5s;
+/// Time between loading two channels in hidden tabs
+constexpr auto DEFERRED_CHANNELS_INTERVAL = 500ms;
+
 std::optional<bool> &shouldMoveOutOfBoundsWindow()
 {
     static std::optional<bool> x;
@@ -182,6 +190,12 @@ WindowManager::WindowManager(const Args &appArgs_, const Paths &paths,
         getApp()->getWindows()->save();
     });
 
+    this->deferredChannelsTimer_.setSingleShot(true);
+    QObject::connect(&this->deferredChannelsTimer_, &QTimer::timeout, this,
+                     [this] {
+                         this->hydrateNextDeferredChannel();
+                     });
+
     this->updateWordTypeMask();
 }
 
@@ -430,6 +444,7 @@ void WindowManager::initialize()
         this->emotePopupBounds_ = windowLayout.emotePopupBounds_;
 
         this->applyWindowLayout(windowLayout);
+        this->deferHiddenChannels();
     }
 
     if (this->appArgs.isFramelessEmbed)
@@ -615,6 +630,71 @@ void WindowManager::toggleAllOverlayInertia()
     }
 }
 
+void WindowManager::deferHiddenChannels()
+{
+    auto visible = this->getVisibleChannelNames();
+
+    for (auto *window : this->windows_)
+    {
+        auto &notebook = window->getNotebook();
+        for (int i = 0; i < notebook.getPageCount(); i++)
+        {
+            auto *page =
+                dynamic_cast<SplitContainer *>(notebook.getPageAt(i));
+            if (!page)
+            {
+                continue;
+            }
+
+            for (auto *split : page->getSplits())
+            {
+                auto channel = std::dynamic_pointer_cast<TwitchChannel>(
+                    split->getChannel());
+                if (!channel || !channel->isHydrated() ||
+                    visible.contains(channel->getName()))
+                {
+                    continue;
+                }
+
+                channel->deferHydration();
+                if (!channel->isHydrated())
+                {
+                    this->deferredChannels_.emplace_back(channel);
+                }
+            }
+        }
+    }
+
+    if (!this->deferredChannels_.empty())
+    {
+        qCDebug(chatterinoWindowmanager)
+            << "Deferring" << this->deferredChannels_.size()
+            << "channels in hidden tabs";
+        this->deferredChannelsTimer_.start(DEFERRED_CHANNELS_DELAY);
+    }
+}
+
+void WindowManager::hydrateNextDeferredChannel()
+{
+    while (!this->deferredChannels_.empty())
+    {
+        auto channel = this->deferredChannels_.front().lock();
+        this->deferredChannels_.pop_front();
+
+        // Channels that were shown in the meantime are already loaded
+        if (channel && !channel->isHydrated())
+        {
+            channel->hydrate();
+            break;
+        }
+    }
+
+    if (!this->deferredChannels_.empty())
+    {
+        this->deferredChannelsTimer_.start(DEFERRED_CHANNELS_INTERVAL);
+    }
+}
+
 std::set<QString> WindowManager::getVisibleChannelNames() const
 {
     std::set<QString> visible;
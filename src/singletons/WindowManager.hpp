@@ -9,6 +9,7 @@
 #include <QPoint>
 #include <QTimer>
 
+#include <deque>
 #include <memory>
 #include <set>
 
@@ -24,6 +25,7 @@ class Split;
 struct SplitDescriptor;
 class Channel;
 using ChannelPtr = std::shared_ptr<Channel>;
+class TwitchChannel;
 struct Message;
 using MessagePtr = std::shared_ptr<const Message>;
 class WindowLayout;
@@ -165,6 +167,12 @@ private:
     // Apply a window layout for this window manager.
     void applyWindowLayout(const WindowLayout &layout);
 
+    /// Defers loading the Twitch channels that aren't in any visible split
+    /// (see TwitchChannel::deferHydration). They're loaded once a split
+    /// showing them becomes visible or in the background, one at a time.
+    void deferHiddenChannels();
+    void hydrateNextDeferredChannel();
+
     // Contains the full path to the window layout file, e.g. /home/pajlada/.local/share/Chatterino/Settings/window-layout.json
     const QString windowLayoutFilePath;
 
@@ -184,6 +192,10 @@ private:
 
     QTimer *saveTimer;
 
+    /// Channels from hidden tabs in the order they're loaded in
+    std::deque<std::weak_ptr<TwitchChannel>> deferredChannels_;
+    QTimer deferredChannelsTimer_;
+
     pajlada::Signals::SignalHolder signalHolder;
 
     SignalListener updateWordTypeMaskListener;
@@ -14,6 +14,7 @@ void GIFTimer::initialize()
     this->timer.setTimerType(Qt::PreciseTimer);
 
     getSettings()->animateEmotes.connect([this](bool enabled, auto) {
+        this->enabled_ = enabled;
         if (enabled)
         {
             this->timer.start();
@@ -32,10 +33,28 @@ void GIFTimer::initialize()
             return;
         }
 
+        if (!this->animationShown_)
+        {
+            // Nothing animated was painted since the last frame. Painting an
+            // animated image starts the timer again.
+            this->timer.stop();
+            return;
+        }
+        this->animationShown_ = false;
+
         this->position_ += GIF_FRAME_LENGTH;
         this->signal.invoke();
         getApp()->getWindows()->repaintGifEmotes();
     });
 }
 
+void GIFTimer::markAnimationShown()
+{
+    this->animationShown_ = true;
+    if (this->enabled_ && !this->timer.isActive())
+    {
+        this->timer.start();
+    }
+}
+
 }  // namespace chatterino
@@ -18,6 +18,11 @@ public:
         return this->position_;
     }
 
+    /// Called whenever an animated image is painted. The timer only keeps
+    /// running while animated images are being painted, so nothing runs
+    /// while none are visible.
+    void markAnimationShown();
+
     void registerOpenOverlayWindow()
     {
         this->openOverlayWindows_++;
@@ -33,6 +38,8 @@ private:
     QTimer timer;
     long unsigned position_{};
     size_t openOverlayWindows_ = 0;
+    bool enabled_ = false;
+    bool animationShown_ = false;
 };
 
 }  // namespace chatterino
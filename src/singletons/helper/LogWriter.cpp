@@ -0,0 +1,292 @@
+#include "singletons/helper/LogWriter.hpp"
+
+#include "common/QLogging.hpp"
+#include "messages/Message.hpp"
+#include "singletons/helper/LoggingChannel.hpp"
+#include "util/Metrics.hpp"
+#include "util/RenameThread.hpp"
+
+namespace {
+
+using namespace chatterino;
+
+const metrics::Counter SPILLED_LINES("log lines spilled");
+
+}  // namespace
+
+namespace chatterino {
+
+LogWriter::LogWriter(LogWriterOptions options, size_t queueCapacity)
+    : queueCapacity_(queueCapacity)
+    , queue_(queueCapacity)
+    , options_(std::move(options))
+{
+    this->thread_ = std::make_unique<std::thread>([this] {
+        this->run();
+    });
+    renameThread(*this->thread_, "LogWriter");
+}
+
+LogWriter::~LogWriter()
+{
+    {
+        std::lock_guard lock(this->mutex_);
+        this->stopping_ = true;
+    }
+    this->condvar_.notify_one();
+
+    if (this->thread_->joinable())
+    {
+        this->thread_->join();
+    }
+}
+
+void LogWriter::addMessage(const QString &channelName,
+                           const QString &platformName, MessagePtr message,
+                           const QString &streamID)
+{
+    bool isReply = message->flags.has(MessageFlag::ReplyMessage);
+    this->push({
+        .channelName = channelName,
+        .platformName = platformName,
+        .message = std::move(message),
+        .streamID = streamID,
+        .isReply = isReply,
+    });
+}
+
+void LogWriter::closeChannel(const QString &channelName,
+                             const QString &platformName)
+{
+    this->push({
+        .channelName = channelName,
+        .platformName = platformName,
+        .message = nullptr,
+        .streamID = {},
+    });
+}
+
+void LogWriter::setOptions(LogWriterOptions options)
+{
+    {
+        std::lock_guard lock(this->mutex_);
+        this->options_ = std::move(options);
+        this->wakeRequested_ = true;
+    }
+    this->condvar_.notify_one();
+}
+
+void LogWriter::push(Entry &&entry)
+{
+    if (!this->spilling_ && this->queue_.push(entry))
+    {
+        // Don't wait for the next flush interval if the queue is filling up
+        if (this->queue_.write_available() < this->queueCapacity_ / 2)
+        {
+            this->wake();
+        }
+        return;
+    }
+
+    {
+        std::lock_guard lock(this->mutex_);
+        // Once the writer took the overflow list, it writes those entries
+        // before it looks at the queue again, so the queue can be used again
+        if (this->spilling_ && this->overflow_.empty() &&
+            this->queue_.push(entry))
+        {
+            this->spilling_ = false;
+            return;
+        }
+
+        this->overflow_.push_back(std::move(entry));
+        this->spilling_ = true;
+        this->wakeRequested_ = true;
+    }
+    this->condvar_.notify_one();
+    SPILLED_LINES.increase();
+
+    if (!this->warnedFull_)
+    {
+        this->warnedFull_ = true;
+        qCWarning(chatterinoHelper)
+            << "Log writer can't keep up, buffering lines in memory";
+    }
+}
+
+void LogWriter::wake()
+{
+    {
+        std::lock_guard lock(this->mutex_);
+        this->wakeRequested_ = true;
+    }
+    this->condvar_.notify_one();
+}
+
+#ifdef CHATTERINO_WITH_TESTS
+void LogWriter::pauseForTesting()
+{
+    std::unique_lock lock(this->mutex_);
+    this->paused_ = true;
+    this->wakeRequested_ = true;
+    this->condvar_.notify_one();
+    this->pausedCondvar_.wait(lock, [this] {
+        return this->parked_;
+    });
+}
+
+void LogWriter::resumeForTesting()
+{
+    {
+        std::lock_guard lock(this->mutex_);
+        this->paused_ = false;
+    }
+    this->condvar_.notify_one();
+}
+#endif
+
+void LogWriter::run()
+{
+    auto lastFlush = std::chrono::steady_clock::now();
+
+    while (true)
+    {
+        LogWriterOptions options;
+        bool stopping = false;
+        {
+            std::unique_lock lock(this->mutex_);
+            this->condvar_.wait_for(lock, this->options_.flushInterval, [this] {
+                return this->stopping_ || this->wakeRequested_;
+            });
+            this->wakeRequested_ = false;
+#ifdef CHATTERINO_WITH_TESTS
+            if (this->paused_ && !this->stopping_)
+            {
+                this->parked_ = true;
+                this->pausedCondvar_.notify_all();
+                this->condvar_.wait(lock, [this] {
+                    return !this->paused_ || this->stopping_;
+                });
+                this->parked_ = false;
+            }
+#endif
+            options = this->options_;
+            stopping = this->stopping_;
+        }
+
+        this->drain(options);
+
+        auto now = std::chrono::steady_clock::now();
+        if (stopping || now - lastFlush >= options.flushInterval)
+        {
+            this->flushAll();
+            lastFlush = now;
+        }
+
+        if (stopping)
+        {
+            break;
+        }
+    }
+
+    this->closeAll();
+}
+
+void LogWriter::drain(const LogWriterOptions &options)
+{
+    if (options.baseDirectory != this->currentBaseDirectory_)
+    {
+        this->currentBaseDirectory_ = options.baseDirectory;
+        for (auto &[platform, channels] : this->channels_)
+        {
+            for (auto &[name, channel] : channels)
+            {
+                channel->setBaseDirectory(this->currentBaseDirectory_);
+            }
+        }
+    }
+
+    while (true)
+    {
+        Entry entry;
+        while (this->queue_.pop(entry))
+        {
+            this->write(entry, options);
+        }
+        // don't keep the last message alive until the next drain
+        entry = {};
+
+        // Everything in the overflow list is newer than what we just took
+        // from the queue. The producer only uses the queue again once we took
+        // the list, and we write the whole list before popping again.
+        std::deque<Entry> overflow;
+        {
+            std::lock_guard lock(this->mutex_);
+            overflow.swap(this->overflow_);
+        }
+        if (overflow.empty())
+        {
+            break;
+        }
+        for (auto &spilled : overflow)
+        {
+            this->write(spilled, options);
+        }
+    }
+}
+
+void LogWriter::write(Entry &entry, const LogWriterOptions &options)
+{
+    if (!entry.message)
+    {
+        auto platIt = this->channels_.find(entry.platformName);
+        if (platIt != this->channels_.end())
+        {
+            platIt->second.erase(entry.channelName);
+        }
+        return;
+    }
+
+    auto &channel = this->channelFor(entry, options);
+    channel.addMessage(entry.message, entry.streamID, entry.isReply, options);
+    if (channel.pendingBytes() >= options.flushThreshold)
+    {
+        channel.flush();
+    }
+}
+
+void LogWriter::flushAll()
+{
+    for (auto &[platform, channels] : this->channels_)
+    {
+        for (auto &[name, channel] : channels)
+        {
+            channel->flush();
+        }
+    }
+}
+
+void LogWriter::closeAll()
+{
+    // LoggingChannel's destructor writes the closing line and flushes
+    this->channels_.clear();
+}
+
+LoggingChannel &LogWriter::channelFor(const Entry &entry,
+                                      const LogWriterOptions &options)
+{
+    auto &channels = this->channels_[entry.platformName];
+    auto it = channels.find(entry.channelName);
+    if (it == channels.end())
+    {
+        it = channels
+                 .emplace(entry.channelName,
+                          new LoggingChannel(entry.channelName,
+                                             entry.platformName,
+                                             options.baseDirectory))
+                 .first;
+    }
+    return *it->second;
+}
+
+}  // namespace chatterino
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <boost/lockfree/spsc_queue.hpp>
+#include <QString>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace chatterino {
+
+struct Message;
+using MessagePtr = std::shared_ptr<const Message>;
+class LoggingChannel;
+
+/// Snapshot of the logging settings the writer thread needs.
+///
+/// `Logging` builds this whenever one of the settings changes and hands a
+/// copy to the writer, so the writer formats every line with one consistent
+/// set of options instead of seeing a setting change halfway through.
+struct LogWriterOptions {
+    QString baseDirectory;
+    QString timestampFormat;
+    bool tryUseTwitchTimestamps = false;
+    bool separatelyStoreStreamLogs = false;
+    bool stripReplyMention = false;
+    bool hideReplyContext = false;
+
+    /// Pending lines are written at least this often
+    std::chrono::milliseconds flushInterval{1000};
+    /// A channel is written early once it has this many bytes pending
+    qsizetype flushThreshold = 64 * 1024;
+};
+
+/// @brief Writes chat logs to disk from a dedicated thread.
+///
+/// The GUI thread only pushes entries into a bounded single-producer
+/// single-consumer queue. The writer thread owns all `LoggingChannel`s: it
+/// formats the lines, rotates the date and stream files and group-commits
+/// the pending lines of every channel once per flush interval (or earlier if
+/// a channel exceeds the byte threshold).
+///
+/// If the queue is full (e.g. because the disk is stalled), entries are
+/// appended to an unbounded overflow list instead, so the GUI thread never
+/// waits for the disk and no line is lost. Until the writer took the overflow
+/// list, later entries go there too to keep their order. Spilled entries are
+/// counted in the "log lines spilled" metric.
+///
+/// Destroying the writer drains the queue, writes everything that's pending
+/// and closes all files.
+class LogWriter
+{
+public:
+    static constexpr size_t DEFAULT_QUEUE_CAPACITY = 8192;
+
+    explicit LogWriter(LogWriterOptions options,
+                       size_t queueCapacity = DEFAULT_QUEUE_CAPACITY);
+    ~LogWriter();
+
+    LogWriter(const LogWriter &) = delete;
+    LogWriter &operator=(const LogWriter &) = delete;
+    LogWriter(LogWriter &&) = delete;
+    LogWriter &operator=(LogWriter &&) = delete;
+
+    /// Queue a message to be logged. Must be called from a single thread.
+    void addMessage(const QString &channelName, const QString &platformName,
+                    MessagePtr message, const QString &streamID);
+
+    /// Queue closing the log files of a channel. Must be called from the same
+    /// thread as `addMessage`.
+    void closeChannel(const QString &channelName, const QString &platformName);
+
+    /// Replace the options used by the writer thread. Thread safe.
+    void setOptions(LogWriterOptions options);
+
+#ifdef CHATTERINO_WITH_TESTS
+    /// Stops the writer thread before it drains the queue the next time and
+    /// waits until it's stopped. Used to simulate a stalled disk.
+    void pauseForTesting();
+    void resumeForTesting();
+#endif
+
+private:
+    struct Entry {
+        QString channelName;
+        QString platformName;
+        /// If this is null, the channel should be closed
+        MessagePtr message;
+        QString streamID;
+        /// Snapshot of `MessageFlag::ReplyMessage`, since flags may be
+        /// modified on the GUI thread while we format the message
+        bool isReply = false;
+    };
+
+    void push(Entry &&entry);
+    void wake();
+
+    void run();
+    void drain(const LogWriterOptions &options);
+    void write(Entry &entry, const LogWriterOptions &options);
+    void flushAll();
+    void closeAll();
+
+    LoggingChannel &channelFor(const Entry &entry,
+                               const LogWriterOptions &options);
+
+    const size_t queueCapacity_;
+    boost::lockfree::spsc_queue<Entry> queue_;
+
+    std::mutex mutex_;
+    std::condition_variable condvar_;
+    /// Entries that didn't fit into `queue_`. They're newer than everything
+    /// in `queue_` when they're added.
+    std::deque<Entry> overflow_;
+    LogWriterOptions options_;
+    bool wakeRequested_ = false;
+    bool stopping_ = false;
+#ifdef CHATTERINO_WITH_TESTS
+    std::condition_variable pausedCondvar_;
+    bool paused_ = false;
+    bool parked_ = false;
+#endif
+
+    // Only accessed from the writer thread
+    using PlatformName = QString;
+    using ChannelName = QString;
+    std::map<PlatformName,
+             std::map<ChannelName, std::unique_ptr<LoggingChannel>>>
+        channels_;
+    QString currentBaseDirectory_;
+
+    // Only accessed from the thread calling `addMessage`
+    /// Entries are added to `overflow_` until the writer took it
+    bool spilling_ = false;
+    bool warnedFull_ = false;
+
+    std::unique_ptr<std::thread> thread_;
+};
+
+}  // namespace chatterino
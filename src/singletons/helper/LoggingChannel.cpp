@@ -1,11 +1,9 @@
 #include "singletons/helper/LoggingChannel.hpp"
 
-#include "Application.hpp"
 #include "common/QLogging.hpp"
 #include "messages/Message.hpp"
 #include "messages/MessageThread.hpp"
-#include "singletons/Paths.hpp"
-#include "singletons/Settings.hpp"
+#include "singletons/helper/LogWriter.hpp"
 
 #include <QDateTime>
 #include <QDir>
@@ -14,13 +12,26 @@ namespace {
 
 const QByteArray ENDLINE("\n");
 
-void appendLine(QFile &fileHandle, const QString &line)
+void appendLine(QByteArray &pending, const QString &line)
 {
-    assert(fileHandle.isOpen());
-    assert(fileHandle.isWritable());
+    pending.append(line.toUtf8());
+}
+
+void writePending(QFile &fileHandle, QByteArray &pending)
+{
+    if (pending.isEmpty())
+    {
+        return;
+    }
+
+    if (fileHandle.isOpen() && fileHandle.isWritable())
+    {
+        fileHandle.write(pending);
+        fileHandle.flush();
+    }
 
-    fileHandle.write(line.toUtf8());
-    fileHandle.flush();
+    // keep the allocation around for the next batch
+    pending.resize(0);
 }
 
 QString generateOpeningString(
@@ -56,9 +67,11 @@ QString generateDateString(const QDateTime &now)
 
 namespace chatterino {
 
-LoggingChannel::LoggingChannel(QString _channelName, QString _platform)
+LoggingChannel::LoggingChannel(QString _channelName, QString _platform,
+                               QString _baseDirectory)
     : channelName(std::move(_channelName))
     , platform(std::move(_platform))
+    , baseDirectory(std::move(_baseDirectory))
 {
     if (this->channelName.startsWith("/whispers"))
     {
@@ -86,21 +99,41 @@ LoggingChannel::LoggingChannel(QString _channelName, QString _platform)
     this->subDirectory = platform[0].toUpper() + platform.mid(1).toLower() +
                          QDir::separator() + this->subDirectory;
 
-    getSettings()->logPath.connect([this](const QString &logPath, auto) {
-        this->baseDirectory = logPath.isEmpty()
-                                  ? getApp()->getPaths().messageLogDirectory
-                                  : logPath;
-        this->openLogFile();
-    });
+    this->openLogFile();
 }
 
 LoggingChannel::~LoggingChannel()
 {
-    appendLine(this->fileHandle, generateClosingString());
+    appendLine(this->pending, generateClosingString());
+    this->flush();
     this->fileHandle.close();
     this->currentStreamFileHandle.close();
 }
 
+void LoggingChannel::flush()
+{
+    writePending(this->fileHandle, this->pending);
+    writePending(this->currentStreamFileHandle, this->pendingStream);
+}
+
+qsizetype LoggingChannel::pendingBytes() const
+{
+    return this->pending.size() + this->pendingStream.size();
+}
+
+void LoggingChannel::setBaseDirectory(const QString &baseDirectory)
+{
+    if (this->baseDirectory == baseDirectory)
+    {
+        return;
+    }
+
+    this->baseDirectory = baseDirectory;
+    this->openLogFile();
+    // the stream log is reopened with the next message of the stream
+    this->closeStreamLogFile();
+}
+
 void LoggingChannel::openLogFile()
 {
     QDateTime now = QDateTime::currentDateTime();
@@ -108,7 +141,7 @@ void LoggingChannel::openLogFile()
 
     if (this->fileHandle.isOpen())
     {
-        this->fileHandle.flush();
+        writePending(this->fileHandle, this->pending);
         this->fileHandle.close();
     }
 
@@ -130,19 +163,26 @@ void LoggingChannel::openLogFile()
 
     this->fileHandle.open(QIODevice::Append);
 
-    appendLine(this->fileHandle, generateOpeningString(now));
+    appendLine(this->pending, generateOpeningString(now));
 }
 
-void LoggingChannel::openStreamLogFile(const QString &streamID)
+void LoggingChannel::closeStreamLogFile()
 {
-    QDateTime now = QDateTime::currentDateTime();
-    this->currentStreamID = streamID;
-
     if (this->currentStreamFileHandle.isOpen())
     {
-        this->currentStreamFileHandle.flush();
+        writePending(this->currentStreamFileHandle, this->pendingStream);
         this->currentStreamFileHandle.close();
     }
+    this->pendingStream.resize(0);
+    this->currentStreamID.clear();
+}
+
+void LoggingChannel::openStreamLogFile(const QString &streamID)
+{
+    QDateTime now = QDateTime::currentDateTime();
+
+    this->closeStreamLogFile();
+    this->currentStreamID = streamID;
 
     QString baseFileName = this->channelName + "-" + streamID + ".log";
 
@@ -160,14 +200,15 @@ void LoggingChannel::openStreamLogFile(const QString &streamID)
     this->currentStreamFileHandle.setFileName(fileName);
 
     this->currentStreamFileHandle.open(QIODevice::Append);
-    appendLine(this->currentStreamFileHandle, generateOpeningString(now));
+    appendLine(this->pendingStream, generateOpeningString(now));
 }
 
 void LoggingChannel::addMessage(const MessagePtr &message,
-                                const QString &streamID)
+                                const QString &streamID, bool isReply,
+                                const LogWriterOptions &options)
 {
     QDateTime messageTimestamp;
-    if (getSettings()->tryUseTwitchTimestamps &&
+    if (options.tryUseTwitchTimestamps &&
         !message->serverReceivedTime.isNull())
     {
         messageTimestamp = message->serverReceivedTime;
@@ -191,7 +232,7 @@ void LoggingChannel::addMessage(const MessagePtr &message,
         str.append("#" + message->channelName + " ");
     }
 
-    QString logTimestampFormat = getSettings()->logTimestampFormat;
+    const QString &logTimestampFormat = options.timestampFormat;
     if (logTimestampFormat != "Disable")
     {
         str.append('[');
@@ -219,9 +260,7 @@ void LoggingChannel::addMessage(const MessagePtr &message,
         }
     }
 
-    if ((message->flags.has(MessageFlag::ReplyMessage) &&
-         getSettings()->stripReplyMention) &&
-        !getSettings()->hideReplyContext)
+    if ((isReply && options.stripReplyMention) && !options.hideReplyContext)
     {
         qsizetype colonIndex = messageText.indexOf(':');
         if (colonIndex != -1)
@@ -243,16 +282,16 @@ void LoggingChannel::addMessage(const MessagePtr &message,
     str.append(messageText);
     str.append(ENDLINE);
 
-    appendLine(this->fileHandle, str);
+    appendLine(this->pending, str);
 
-    if (!streamID.isEmpty() && getSettings()->separatelyStoreStreamLogs)
+    if (!streamID.isEmpty() && options.separatelyStoreStreamLogs)
     {
         if (this->currentStreamID != streamID)
         {
             this->openStreamLogFile(streamID);
         }
 
-        appendLine(this->currentStreamFileHandle, str);
+        appendLine(this->pendingStream, str);
     }
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QByteArray>
 #include <QFile>
 #include <QString>
 
@@ -7,13 +8,19 @@
 
 namespace chatterino {
 
-class Logging;
+class LogWriter;
+struct LogWriterOptions;
 struct Message;
 using MessagePtr = std::shared_ptr<const Message>;
 
+/// Log files of a single channel.
+///
+/// This is only ever used from the writer thread of `LogWriter`. Lines are
+/// collected in memory and written to disk on `flush`.
 class LoggingChannel
 {
-    explicit LoggingChannel(QString _channelName, QString _platform);
+    explicit LoggingChannel(QString _channelName, QString _platform,
+                            QString _baseDirectory);
 
 public:
     ~LoggingChannel();
@@ -24,11 +31,22 @@ public:
     LoggingChannel(LoggingChannel &&) = delete;
     LoggingChannel &operator=(LoggingChannel &&) = delete;
 
-    void addMessage(const MessagePtr &message, const QString &streamID);
+    void addMessage(const MessagePtr &message, const QString &streamID,
+                    bool isReply, const LogWriterOptions &options);
+
+    /// Write all pending lines to disk
+    void flush();
+
+    /// Number of bytes not yet written to disk
+    qsizetype pendingBytes() const;
+
+    /// Reopen the log files in a new base directory
+    void setBaseDirectory(const QString &baseDirectory);
 
 private:
     void openLogFile();
     void openStreamLogFile(const QString &streamID);
+    void closeStreamLogFile();
 
     const QString channelName;
     const QString platform;
@@ -39,9 +57,12 @@ private:
     QFile currentStreamFileHandle;
     QString currentStreamID;
 
+    QByteArray pending;
+    QByteArray pendingStream;
+
     QString dateString;
 
-    friend class Logging;
+    friend class LogWriter;
 };
 
 }  // namespace chatterino
@@ -15,11 +15,11 @@ namespace chatterino {
 ///                       - replace `buffer[i]` (=toReplace) with `replacement`
 /// @param addMessage A function of type `void (MessagePtr message)`
 ///                   - adds the `message`.
-/// @param disableUserMessages If set, disables all message by the timed out user.
+/// @see disableUserMessages() to disable the messages of the timed out user.
 template <typename Buf, typename Replace, typename Add>
 void addOrReplaceChannelTimeout(const Buf &buffer, MessagePtr message,
                                 const QDateTime &now, Replace replaceMessage,
-                                Add addMessage, bool disableUserMessages)
+                                Add addMessage)
 {
     // NOTE: This function uses the messages PARSE time to figure out whether they should be replaced
     // This works as expected for incoming messages, but not for historic messages.
@@ -107,27 +107,30 @@ void addOrReplaceChannelTimeout(const Buf &buffer, MessagePtr message,
         }
     }
 
-    // disable the messages from the user
-    if (disableUserMessages)
+    if (shouldAddMessage)
     {
-        for (qsizetype i = 0; i < snapshotLength; i++)
-        {
-            auto &s = buffer[i];
-            if (s->loginName == message->timeoutUser &&
-                s->flags.hasNone(
-                    {MessageFlag::ModerationAction, MessageFlag::Whisper}))
-            {
-                // FOURTF: disabled for now
-                // PAJLADA: Shitty solution described in Message.hpp
-                s->flags.set(MessageFlag::Disabled);
-                s->flags.set(MessageFlag::InvalidReplyTarget);
-            }
-        }
+        addMessage(message);
     }
+}
 
-    if (shouldAddMessage)
+/// Disables all messages in `messages` sent by the user with the login
+/// `timeoutUser`.
+/// This function accepts any range of messages, usually only the user's
+/// messages are passed (see Channel::findMessagesByUser()).
+template <typename Range>
+void disableUserMessages(const Range &messages, const QString &timeoutUser)
+{
+    for (const MessagePtr &s : messages)
     {
-        addMessage(message);
+        if (s->loginName == timeoutUser &&
+            s->flags.hasNone(
+                {MessageFlag::ModerationAction, MessageFlag::Whisper}))
+        {
+            // FOURTF: disabled for now
+            // PAJLADA: Shitty solution described in Message.hpp
+            s->flags.set(MessageFlag::Disabled);
+            s->flags.set(MessageFlag::InvalidReplyTarget);
+        }
     }
 }
 
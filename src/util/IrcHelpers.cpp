@@ -1,41 +1,46 @@
 #include "util/IrcHelpers.hpp"
 
 #include "Application.hpp"
+#include "providers/twitch/TwitchIrcLine.hpp"
+
+#include <optional>
 
 namespace {
 
 using namespace chatterino;
 
-QDateTime calculateMessageTimeBase(const Communi::IrcMessage *message)
+/// @param tag Returns the value of a tag or std::nullopt if the tag isn't
+///            present
+template <typename TagFn>
+QDateTime calculateMessageTimeBase(const TagFn &tag)
 {
     // Check if message is from recent-messages API
-    if (message->tags().contains("historical"))
+    if (tag(TwitchTag::Historical))
     {
         bool customReceived = false;
-        auto ts =
-            message->tags().value("rm-received-ts").toLongLong(&customReceived);
+        auto ts = tag(TwitchTag::RmReceivedTs)
+                      .value_or(QString())
+                      .toLongLong(&customReceived);
         if (!customReceived)
         {
-            ts = message->tags().value("tmi-sent-ts").toLongLong();
+            ts = tag(TwitchTag::TmiSentTs).value_or(QString()).toLongLong();
         }
 
         return QDateTime::fromMSecsSinceEpoch(ts);
     }
 
     // If present, handle tmi-sent-ts tag and use it as timestamp
-    if (message->tags().contains("tmi-sent-ts"))
+    if (auto sentTs = tag(TwitchTag::TmiSentTs))
     {
-        auto ts = message->tags().value("tmi-sent-ts").toLongLong();
+        auto ts = sentTs->toLongLong();
         return QDateTime::fromMSecsSinceEpoch(ts);
     }
 
     // Some IRC Servers might have server-time tag containing UTC date in ISO format, use it as timestamp
     // See: https://ircv3.net/irc/#server-time
-    if (message->tags().contains("time"))
+    if (auto timedate = tag(TwitchTag::Time))
     {
-        QString timedate = message->tags().value("time").toString();
-
-        auto date = QDateTime::fromString(timedate, Qt::ISODate);
+        auto date = QDateTime::fromString(*timedate, Qt::ISODate);
         date.setTimeZone(QTimeZone::utc());
         return date.toLocalTime();
     }
@@ -51,13 +56,10 @@ QDateTime calculateMessageTimeBase(const Communi::IrcMessage *message)
     return QDateTime::currentDateTime();
 }
 
-}  // namespace
-
-namespace chatterino {
-
-QDateTime calculateMessageTime(const Communi::IrcMessage *message)
+template <typename TagFn>
+QDateTime calculateMessageTimeImpl(const TagFn &tag)
 {
-    auto dt = calculateMessageTimeBase(message);
+    auto dt = calculateMessageTimeBase(tag);
 
 #ifdef CHATTERINO_WITH_TESTS
     if (getApp()->isTest())
@@ -69,4 +71,35 @@ QDateTime calculateMessageTime(const Communi::IrcMessage *message)
     return dt;
 }
 
+}  // namespace
+
+namespace chatterino {
+
+QDateTime calculateMessageTime(const Communi::IrcMessage *message)
+{
+    auto tags = message->tags();
+    return calculateMessageTimeImpl(
+        [&](TwitchTag tag) -> std::optional<QString> {
+            auto it = tags.constFind(
+                QString::fromUtf8(TwitchIrcLine::keyOf(tag)));
+            if (it == tags.constEnd())
+            {
+                return std::nullopt;
+            }
+            return it->toString();
+        });
+}
+
+QDateTime calculateMessageTime(const TwitchIrcLine &line)
+{
+    return calculateMessageTimeImpl(
+        [&](TwitchTag tag) -> std::optional<QString> {
+            if (!line.hasTag(tag))
+            {
+                return std::nullopt;
+            }
+            return line.tag(tag);
+        });
+}
+
 }  // namespace chatterino
@@ -0,0 +1,449 @@
+#include "util/Metrics.hpp"
+
+#include "common/QLogging.hpp"
+#include "debug/AssertInGuiThread.hpp"
+
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocale>
+#include <QSaveFile>
+#include <QStringBuilder>
+#include <QTimer>
+
+#include <algorithm>
+#include <bit>
+#include <mutex>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace {
+
+using namespace chatterino::metrics;
+
+using MetricData = std::variant<detail::CounterData *, detail::GaugeData *,
+                                detail::HistogramData *>;
+
+struct Metric {
+    QString name;
+    /// The name of the metric family in the OpenMetrics export
+    QString openMetricsName;
+    Unit unit = Unit::None;
+    MetricData data;
+};
+
+/// "message layout cache hits" -> "chatterino_message_layout_cache_hits"
+QString openMetricsName(const QString &name, Unit unit, bool isHistogram)
+{
+    QString out = QStringLiteral("chatterino_");
+    bool lastWasSeparator = true;
+    for (auto c : name)
+    {
+        if (c.isLetterOrNumber() && c.unicode() < 128)
+        {
+            out += c.toLower();
+            lastWasSeparator = false;
+        }
+        else if (!lastWasSeparator)
+        {
+            out += '_';
+            lastWasSeparator = true;
+        }
+    }
+    if (out.endsWith('_'))
+    {
+        out.chop(1);
+    }
+
+    if (unit == Unit::Bytes && !out.endsWith(u"_bytes"))
+    {
+        out += u"_bytes";
+    }
+    if (isHistogram)
+    {
+        out += u"_seconds";
+    }
+    return out;
+}
+
+/// Metrics are only added, never removed, so handles can point into the
+/// registry for as long as the program runs.
+class Registry
+{
+public:
+    static Registry &instance()
+    {
+        // Leaked, so handles in static objects stay valid during shutdown
+        static auto *registry = new Registry;
+        return *registry;
+    }
+
+    template <typename T>
+    T *get(const QString &name, Unit unit)
+    {
+        std::lock_guard guard(this->mutex_);
+
+        for (const auto &metric : this->metrics_)
+        {
+            if (metric.name != name)
+            {
+                continue;
+            }
+
+            if (auto *const *data = std::get_if<T *>(&metric.data))
+            {
+                return *data;
+            }
+
+            // A name must always be used for the same kind of metric. The
+            // handle still works, but its values aren't exported.
+            qCWarning(chatterinoApp)
+                << "Metric" << name
+                << "is already registered as a different kind of metric";
+            return new T;
+        }
+
+        auto exportedName = openMetricsName(
+            name, unit, std::is_same_v<T, detail::HistogramData>);
+        for (const auto &metric : this->metrics_)
+        {
+            if (metric.openMetricsName == exportedName)
+            {
+                // The export can't tell the two metrics apart. The handle
+                // still works, but its values aren't exported.
+                qCWarning(chatterinoApp)
+                    << "Metric" << name << "is exported as" << exportedName
+                    << "like" << metric.name;
+                return new T;
+            }
+        }
+
+        auto *data = new T;
+        this->metrics_.push_back({
+            .name = name,
+            .openMetricsName = exportedName,
+            .unit = unit,
+            .data = data,
+        });
+        return data;
+    }
+
+    /// All metrics sorted by their name
+    std::vector<Metric> metrics() const
+    {
+        std::vector<Metric> metrics;
+        {
+            std::lock_guard guard(this->mutex_);
+            metrics = this->metrics_;
+        }
+        std::ranges::sort(metrics, {}, &Metric::name);
+        return metrics;
+    }
+
+private:
+    Registry() = default;
+
+    mutable std::mutex mutex_;
+    std::vector<Metric> metrics_;
+};
+
+size_t bucketIndex(std::chrono::nanoseconds duration)
+{
+    // Rounding up keeps durations in the bucket whose bound is >= them
+    auto us = std::chrono::ceil<std::chrono::microseconds>(duration).count();
+    if (us <= 1)
+    {
+        return 0;
+    }
+    return std::min<size_t>(std::bit_width(static_cast<uint64_t>(us - 1)),
+                            detail::HISTOGRAM_BUCKETS - 1);
+}
+
+/// The upper bound of the bucket @a i, the last bucket has none
+std::chrono::microseconds bucketBound(size_t i)
+{
+    return std::chrono::microseconds{int64_t{1} << i};
+}
+
+QString formatValue(int64_t value, Unit unit)
+{
+    static const QLocale locale(QLocale::English);
+
+    if (unit == Unit::Bytes)
+    {
+        return locale.formattedDataSize(value);
+    }
+    return locale.toString(static_cast<qlonglong>(value));
+}
+
+QString formatDuration(std::chrono::microseconds us)
+{
+    if (us.count() >= 1000)
+    {
+        return QString::number(us.count() / 1000) % u"ms";
+    }
+    return QString::number(us.count()) % u"us";
+}
+
+int64_t counterValue(const detail::CounterData &data)
+{
+    int64_t sum = 0;
+    for (const auto &shard : data.shards)
+    {
+        sum += shard.value.load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+int64_t valueOf(const Metric &metric)
+{
+    if (const auto *counter =
+            std::get_if<detail::CounterData *>(&metric.data))
+    {
+        return counterValue(**counter);
+    }
+    if (const auto *gauge = std::get_if<detail::GaugeData *>(&metric.data))
+    {
+        return (*gauge)->value.load(std::memory_order_relaxed);
+    }
+    return 0;
+}
+
+Histogram::Snapshot snapshotOf(const detail::HistogramData &data)
+{
+    Histogram::Snapshot snapshot;
+    uint64_t sumNs = 0;
+    for (const auto &shard : data.shards)
+    {
+        for (size_t i = 0; i < detail::HISTOGRAM_BUCKETS; i++)
+        {
+            auto n = shard.buckets[i].load(std::memory_order_relaxed);
+            snapshot.buckets[i] += n;
+            snapshot.count += n;
+        }
+        sumNs += shard.sumNs.load(std::memory_order_relaxed);
+    }
+    snapshot.sum = std::chrono::nanoseconds{static_cast<int64_t>(sumNs)};
+    return snapshot;
+}
+
+void writeExport(const QString &path)
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qCWarning(chatterinoApp)
+            << "Failed to open metrics file" << path << file.errorString();
+        return;
+    }
+
+    if (path.endsWith(u".json", Qt::CaseInsensitive))
+    {
+        file.write(toJson());
+    }
+    else
+    {
+        file.write(toOpenMetrics().toUtf8());
+    }
+
+    if (!file.commit())
+    {
+        qCWarning(chatterinoApp)
+            << "Failed to write metrics file" << path << file.errorString();
+    }
+}
+
+}  // namespace
+
+namespace chatterino::metrics {
+
+namespace detail {
+
+size_t shardIndex() noexcept
+{
+    static std::atomic<size_t> nextShard{0};
+    thread_local const size_t shard =
+        nextShard.fetch_add(1, std::memory_order_relaxed) % SHARD_COUNT;
+    return shard;
+}
+
+}  // namespace detail
+
+Counter::Counter(const QString &name, Unit unit)
+    : data_(Registry::instance().get<detail::CounterData>(name, unit))
+{
+}
+
+int64_t Counter::value() const noexcept
+{
+    return counterValue(*this->data_);
+}
+
+Gauge::Gauge(const QString &name, Unit unit)
+    : data_(Registry::instance().get<detail::GaugeData>(name, unit))
+{
+}
+
+Histogram::Histogram(const QString &name)
+    : data_(Registry::instance().get<detail::HistogramData>(name, Unit::None))
+{
+}
+
+void Histogram::record(std::chrono::nanoseconds duration) const noexcept
+{
+    auto &shard = this->data_->shards[detail::shardIndex()];
+    shard.buckets[bucketIndex(duration)].fetch_add(1,
+                                                   std::memory_order_relaxed);
+    shard.sumNs.fetch_add(static_cast<uint64_t>(std::max<int64_t>(
+                              duration.count(), 0)),
+                          std::memory_order_relaxed);
+}
+
+Histogram::Snapshot Histogram::snapshot() const noexcept
+{
+    return snapshotOf(*this->data_);
+}
+
+std::chrono::microseconds Histogram::Snapshot::quantile(double q) const
+{
+    if (this->count == 0)
+    {
+        return {};
+    }
+
+    auto target = static_cast<uint64_t>(q * static_cast<double>(this->count));
+    target = std::clamp<uint64_t>(target, 1, this->count);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i + 1 < detail::HISTOGRAM_BUCKETS; i++)
+    {
+        seen += this->buckets[i];
+        if (seen >= target)
+        {
+            return bucketBound(i);
+        }
+    }
+    return bucketBound(detail::HISTOGRAM_BUCKETS - 2);
+}
+
+QString debugText()
+{
+    QString text;
+    for (const auto &metric : Registry::instance().metrics())
+    {
+        if (const auto *histogram =
+                std::get_if<detail::HistogramData *>(&metric.data))
+        {
+            auto snapshot = snapshotOf(**histogram);
+            text += metric.name % u": n=" % QString::number(snapshot.count) %
+                    u" p50<=" % formatDuration(snapshot.quantile(0.5)) %
+                    u" p99<=" % formatDuration(snapshot.quantile(0.99)) %
+                    '\n';
+            continue;
+        }
+
+        text += metric.name % u": " %
+                formatValue(valueOf(metric), metric.unit) % '\n';
+    }
+    return text;
+}
+
+QString toOpenMetrics()
+{
+    QString text;
+    for (const auto &metric : Registry::instance().metrics())
+    {
+        const auto &name = metric.openMetricsName;
+        const auto *histogram =
+            std::get_if<detail::HistogramData *>(&metric.data);
+        if (!histogram)
+        {
+            // Counters can be decreased, so they're gauges for OpenMetrics
+            text += u"# TYPE " % name % u" gauge\n" % name % ' ' %
+                    QString::number(valueOf(metric)) % '\n';
+            continue;
+        }
+
+        auto snapshot = snapshotOf(**histogram);
+        text += u"# TYPE " % name % u" histogram\n";
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i + 1 < detail::HISTOGRAM_BUCKETS; i++)
+        {
+            cumulative += snapshot.buckets[i];
+            auto bound = std::chrono::duration<double>(bucketBound(i)).count();
+            text += name % u"_bucket{le=\"" % QString::number(bound, 'g', 10) %
+                    u"\"} " % QString::number(cumulative) % '\n';
+        }
+        text += name % u"_bucket{le=\"+Inf\"} " %
+                QString::number(snapshot.count) % '\n';
+        text += name % u"_count " % QString::number(snapshot.count) % '\n';
+        text += name % u"_sum " %
+                QString::number(
+                    std::chrono::duration<double>(snapshot.sum).count(), 'g',
+                    10) %
+                '\n';
+    }
+    text += u"# EOF\n";
+    return text;
+}
+
+QByteArray toJson()
+{
+    QJsonObject values;
+    QJsonObject histograms;
+    for (const auto &metric : Registry::instance().metrics())
+    {
+        const auto *histogram =
+            std::get_if<detail::HistogramData *>(&metric.data);
+        if (!histogram)
+        {
+            values.insert(metric.name,
+                          static_cast<qint64>(valueOf(metric)));
+            continue;
+        }
+
+        auto snapshot = snapshotOf(**histogram);
+        QJsonArray buckets;
+        for (auto n : snapshot.buckets)
+        {
+            buckets.append(static_cast<qint64>(n));
+        }
+        histograms.insert(
+            metric.name,
+            QJsonObject{
+                {"count", static_cast<qint64>(snapshot.count)},
+                {"sumNs", static_cast<qint64>(snapshot.sum.count())},
+                {"p50Us", static_cast<qint64>(snapshot.quantile(0.5).count())},
+                {"p99Us",
+                 static_cast<qint64>(snapshot.quantile(0.99).count())},
+                {"bucketsUs", buckets},
+            });
+    }
+
+    return QJsonDocument(QJsonObject{
+                             {"timestamp", QDateTime::currentMSecsSinceEpoch()},
+                             {"values", values},
+                             {"histograms", histograms},
+                         })
+        .toJson(QJsonDocument::Indented);
+}
+
+void startExport(const QString &path, std::chrono::milliseconds interval)
+{
+    assertInGuiThread();
+
+    qCDebug(chatterinoApp) << "Exporting metrics to" << path << "every"
+                           << interval.count() << "ms";
+
+    // Lives for as long as the application
+    auto *timer = new QTimer;
+    QObject::connect(timer, &QTimer::timeout, [path] {
+        writeExport(path);
+    });
+    timer->start(interval);
+    writeExport(path);
+}
+
+}  // namespace chatterino::metrics
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <QString>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/// Counters, gauges and histograms for debugging and monitoring.
+///
+/// Metrics are registered once by name (usually as a static in the file that
+/// updates them) and updated through their handle. Updates don't take any
+/// locks, so they're fine to use in hot paths.
+///
+/// Names that only differ in case or punctuation have the same OpenMetrics
+/// name. Only the first of them is exported, the others just have a value.
+///
+/// All metrics are shown in the debug popup (Ctrl+F10) and can be exported
+/// periodically (see metrics::startExport).
+namespace chatterino::metrics {
+
+enum class Unit : uint8_t {
+    None,
+    /// The value is a data size in bytes
+    Bytes,
+};
+
+namespace detail {
+
+/// The number of atomics each counter is split into. Threads are assigned a
+/// shard round robin, so threads rarely write to the same cache line.
+inline constexpr size_t SHARD_COUNT = 16;
+
+/// The shard of the current thread
+size_t shardIndex() noexcept;
+
+struct alignas(64) CounterShard {
+    std::atomic<int64_t> value{0};
+};
+
+struct CounterData {
+    std::array<CounterShard, SHARD_COUNT> shards;
+};
+
+struct alignas(64) GaugeData {
+    std::atomic<int64_t> value{0};
+};
+
+/// Bucket `i` counts durations in (2^(i-1), 2^i] microseconds, bucket 0
+/// durations up to 1us and the last one all durations above.
+inline constexpr size_t HISTOGRAM_BUCKETS = 26;
+
+struct alignas(64) HistogramShard {
+    std::array<std::atomic<uint64_t>, HISTOGRAM_BUCKETS> buckets{};
+    std::atomic<uint64_t> sumNs{0};
+};
+
+struct HistogramData {
+    std::array<HistogramShard, SHARD_COUNT> shards;
+};
+
+}  // namespace detail
+
+/// A count that's increased and decreased from any thread (e.g. the number
+/// of alive objects of a type)
+class Counter
+{
+public:
+    /// Registers (or looks up) the counter @a name. Counters with the same
+    /// name share their value.
+    explicit Counter(const QString &name, Unit unit = Unit::None);
+
+    void increase(int64_t amount = 1) const noexcept
+    {
+        this->data_->shards[detail::shardIndex()].value.fetch_add(
+            amount, std::memory_order_relaxed);
+    }
+
+    void decrease(int64_t amount = 1) const noexcept
+    {
+        this->increase(-amount);
+    }
+
+    /// Sums up all shards
+    int64_t value() const noexcept;
+
+private:
+    detail::CounterData *data_;
+};
+
+/// A value that's set as a whole (e.g. the result of the last run of a job)
+class Gauge
+{
+public:
+    explicit Gauge(const QString &name, Unit unit = Unit::None);
+
+    void set(int64_t value) const noexcept
+    {
+        this->data_->value.store(value, std::memory_order_relaxed);
+    }
+
+    int64_t value() const noexcept
+    {
+        return this->data_->value.load(std::memory_order_relaxed);
+    }
+
+private:
+    detail::GaugeData *data_;
+};
+
+/// A distribution of durations in power-of-two buckets
+class Histogram
+{
+public:
+    explicit Histogram(const QString &name);
+
+    void record(std::chrono::nanoseconds duration) const noexcept;
+
+    /// Records the time until it's destroyed
+    class Timer
+    {
+    public:
+        explicit Timer(const Histogram &histogram) noexcept
+            : histogram_(histogram)
+            , start_(std::chrono::steady_clock::now())
+        {
+        }
+
+        ~Timer()
+        {
+            this->histogram_.record(std::chrono::steady_clock::now() -
+                                    this->start_);
+        }
+
+        Timer(const Timer &) = delete;
+        Timer(Timer &&) = delete;
+        Timer &operator=(const Timer &) = delete;
+        Timer &operator=(Timer &&) = delete;
+
+    private:
+        const Histogram &histogram_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    [[nodiscard]] Timer time() const noexcept
+    {
+        return Timer(*this);
+    }
+
+    struct Snapshot {
+        std::array<uint64_t, detail::HISTOGRAM_BUCKETS> buckets{};
+        uint64_t count = 0;
+        std::chrono::nanoseconds sum{0};
+
+        /// Returns the upper bound of the bucket containing the quantile @a q
+        /// (0..1). The last bucket has no upper bound, its lower bound is
+        /// returned instead.
+        std::chrono::microseconds quantile(double q) const;
+    };
+
+    Snapshot snapshot() const noexcept;
+
+private:
+    detail::HistogramData *data_;
+};
+
+/// A human readable summary of all metrics for the debug popup
+QString debugText();
+
+/// All metrics in the OpenMetrics text format
+QString toOpenMetrics();
+
+/// All metrics as a JSON object
+QByteArray toJson();
+
+/// Writes all metrics to @a path every @a interval. If @a path ends in
+/// ".json", the JSON format is used, otherwise the OpenMetrics text format.
+///
+/// Must be called from the GUI thread.
+void startExport(const QString &path, std::chrono::milliseconds interval);
+
+}  // namespace chatterino::metrics
@@ -0,0 +1,113 @@
+#include "util/OrderedTaskQueue.hpp"
+
+#include "debug/AssertInGuiThread.hpp"
+#include "debug/Trace.hpp"
+#include "util/PostToThread.hpp"
+
+#include <cassert>
+#include <deque>
+#include <optional>
+
+namespace chatterino {
+
+struct OrderedTaskQueue::State {
+    struct Task {
+        uint64_t id;
+        /// Set once the build step has finished
+        std::optional<Commit> commit;
+    };
+
+    std::deque<Task> tasks;
+    uint64_t nextID = 0;
+    bool alive = true;
+
+    void finish(uint64_t id, Commit commit)
+    {
+        if (!this->alive || this->tasks.empty())
+        {
+            return;
+        }
+
+        auto index = id - this->tasks.front().id;
+        assert(index < this->tasks.size());
+        this->tasks[index].commit = std::move(commit);
+
+        this->drain();
+    }
+
+    void drain()
+    {
+        while (this->alive && !this->tasks.empty() &&
+               this->tasks.front().commit)
+        {
+            // The commit might push new tasks, so take it out of the queue
+            // before running it.
+            auto commit = std::move(*this->tasks.front().commit);
+            this->tasks.pop_front();
+
+            if (commit)
+            {
+                TRACE_ZONE("message commit");
+                commit();
+            }
+        }
+    }
+};
+
+OrderedTaskQueue::OrderedTaskQueue(int maxThreads)
+    : state_(std::make_shared<State>())
+{
+    this->pool_.setMaxThreadCount(maxThreads);
+}
+
+OrderedTaskQueue::~OrderedTaskQueue()
+{
+    this->state_->alive = false;
+    this->state_->tasks.clear();
+    this->pool_.waitForDone();
+}
+
+void OrderedTaskQueue::push(Build build)
+{
+    assertInGuiThread();
+
+    auto id = this->state_->nextID++;
+    this->state_->tasks.push_back({.id = id, .commit = std::nullopt});
+
+    this->pool_.start([state = this->state_, id,
+                       build = std::move(build)]() mutable {
+        auto commit = [&] {
+            TRACE_ZONE("message build task");
+            return build();
+        }();
+
+        // Hand the build step back as well, so its captures are released on
+        // the GUI thread.
+        postToThread([state = std::move(state), id,
+                      build = std::move(build),
+                      commit = std::move(commit)]() mutable {
+            state->finish(id, std::move(commit));
+        });
+    });
+}
+
+void OrderedTaskQueue::pushCommit(Commit commit)
+{
+    assertInGuiThread();
+
+    if (this->state_->tasks.empty())
+    {
+        commit();
+        return;
+    }
+
+    auto id = this->state_->nextID++;
+    this->state_->tasks.push_back({.id = id, .commit = std::move(commit)});
+}
+
+bool OrderedTaskQueue::idle() const
+{
+    return this->state_->tasks.empty();
+}
+
+}  // namespace chatterino
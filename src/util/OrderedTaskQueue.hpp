@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QThreadPool>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace chatterino {
+
+/// @brief Runs tasks on a thread pool and applies their results in order.
+///
+/// A task consists of a build step that runs on a worker thread and returns a
+/// commit step which is then run on the GUI thread. Commits are run in the
+/// order their tasks were pushed, no matter in which order the build steps
+/// finish. Commit-only tasks (see #pushCommit) wait for all tasks that were
+/// pushed before them.
+///
+/// Both steps (and everything they capture) are destroyed on the GUI thread.
+///
+/// All functions must be called from the GUI thread.
+class OrderedTaskQueue
+{
+public:
+    using Commit = std::function<void()>;
+    using Build = std::function<Commit()>;
+
+    /// @param maxThreads The maximum number of build steps running at once
+    explicit OrderedTaskQueue(int maxThreads);
+    ~OrderedTaskQueue();
+
+    OrderedTaskQueue(const OrderedTaskQueue &) = delete;
+    OrderedTaskQueue &operator=(const OrderedTaskQueue &) = delete;
+    OrderedTaskQueue(OrderedTaskQueue &&) = delete;
+    OrderedTaskQueue &operator=(OrderedTaskQueue &&) = delete;
+
+    /// Run @a build on the thread pool and its result in order on the GUI thread
+    void push(Build build);
+
+    /// @brief Run @a commit after all previously pushed tasks are committed
+    ///
+    /// If no task is pending, @a commit is run immediately.
+    void pushCommit(Commit commit);
+
+    /// Returns true if no task is waiting to be committed
+    bool idle() const;
+
+private:
+    struct State;
+    std::shared_ptr<State> state_;
+    QThreadPool pool_;
+};
+
+}  // namespace chatterino
@@ -0,0 +1,595 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace chatterino {
+
+/// @brief A hash map whose copies share their storage
+///
+/// The map is a hash array mapped trie: every node branches on five bits of
+/// the key's hash and stores up to 32 entries and children. Copying a map only
+/// copies the pointer to its root. Modifying a map copies the nodes on the path
+/// to the modified entry if they're shared with another map and modifies them
+/// in place otherwise. A single insertion or removal therefore touches
+/// O(log n) nodes instead of the whole map.
+///
+/// Nodes are never modified while they're shared, so a map can be read from
+/// one thread while a copy of it is modified on another. To update a map that
+/// was published to other threads, modify a copy of it and publish that. The
+/// copy shares all nodes but the modified ones with the published map.
+///
+/// The interface follows std::unordered_map. Iterators and references are
+/// invalidated by any modification.
+template <typename Key, typename T, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class PersistentHashMap
+{
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using reference = const value_type &;
+    using const_reference = const value_type &;
+
+private:
+    static constexpr unsigned BITS = 5;
+    static constexpr size_t HASH_BITS = sizeof(size_t) * 8;
+    /// Nodes at this depth don't branch, they hold entries with equal hashes
+    static constexpr size_t MAX_DEPTH = (HASH_BITS + BITS - 1) / BITS;
+
+    struct Node;
+    using NodePtr = std::shared_ptr<Node>;
+
+    struct Node {
+        /// Bit i is set if entries contains the entry for fragment i
+        uint32_t entryMap = 0;
+        /// Bit i is set if children contains the child for fragment i
+        uint32_t childMap = 0;
+        std::vector<value_type> entries;
+        std::vector<NodePtr> children;
+    };
+
+    static uint32_t fragment(size_t hash, size_t depth)
+    {
+        return static_cast<uint32_t>(hash >> (depth * BITS)) & 31U;
+    }
+
+    static size_t indexOf(uint32_t bitmap, uint32_t bit)
+    {
+        return static_cast<size_t>(std::popcount(bitmap & (bit - 1)));
+    }
+
+public:
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = PersistentHashMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type *;
+        using reference = const value_type &;
+
+        const_iterator() = default;
+
+        reference operator*() const
+        {
+            const auto &frame = this->stack_[this->depth_ - 1];
+            return frame.node->entries[frame.entry];
+        }
+
+        pointer operator->() const
+        {
+            return &**this;
+        }
+
+        const_iterator &operator++()
+        {
+            this->stack_[this->depth_ - 1].entry++;
+            this->settle();
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        bool operator==(const const_iterator &other) const
+        {
+            if (this->depth_ != other.depth_)
+            {
+                return false;
+            }
+            if (this->depth_ == 0)
+            {
+                return true;
+            }
+            const auto &a = this->stack_[this->depth_ - 1];
+            const auto &b = other.stack_[other.depth_ - 1];
+            return a.node == b.node && a.entry == b.entry;
+        }
+
+    private:
+        friend class PersistentHashMap;
+
+        /// Entries of a node are visited before its children
+        struct Frame {
+            const Node *node = nullptr;
+            /// The current entry, entries.size() once all were visited
+            size_t entry = 0;
+            /// The next child to visit
+            size_t child = 0;
+        };
+
+        void push(const Node *node, size_t entry, size_t child)
+        {
+            assert(this->depth_ < this->stack_.size());
+            this->stack_[this->depth_++] = {
+                .node = node,
+                .entry = entry,
+                .child = child,
+            };
+        }
+
+        /// Moves to the next entry if the current frame has none left
+        void settle()
+        {
+            while (this->depth_ > 0)
+            {
+                auto &frame = this->stack_[this->depth_ - 1];
+                if (frame.entry < frame.node->entries.size())
+                {
+                    return;
+                }
+                if (frame.child < frame.node->children.size())
+                {
+                    const auto *child = frame.node->children[frame.child].get();
+                    frame.child++;
+                    this->push(child, 0, 0);
+                    continue;
+                }
+                this->depth_--;
+            }
+        }
+
+        std::array<Frame, MAX_DEPTH + 1> stack_{};
+        size_t depth_ = 0;
+    };
+    using iterator = const_iterator;
+
+    PersistentHashMap() = default;
+
+    PersistentHashMap(std::initializer_list<value_type> init)
+    {
+        for (const auto &value : init)
+        {
+            this->insert(value);
+        }
+    }
+
+    const_iterator begin() const
+    {
+        const_iterator it;
+        if (this->root_)
+        {
+            it.push(this->root_.get(), 0, 0);
+            it.settle();
+        }
+        return it;
+    }
+
+    const_iterator end() const
+    {
+        return {};
+    }
+
+    const_iterator cbegin() const
+    {
+        return this->begin();
+    }
+
+    const_iterator cend() const
+    {
+        return this->end();
+    }
+
+    size_type size() const
+    {
+        return this->size_;
+    }
+
+    bool empty() const
+    {
+        return this->size_ == 0;
+    }
+
+    /// If `Hash` and `KeyEqual` are transparent, any type they accept can be
+    /// looked up without converting it to `Key`.
+    template <typename K = Key>
+        requires std::is_same_v<K, Key> ||
+                 (requires {
+                     typename Hash::is_transparent;
+                     typename KeyEqual::is_transparent;
+                 })
+    const_iterator find(const K &key) const
+    {
+        const_iterator it;
+        const Node *node = this->root_.get();
+        if (!node)
+        {
+            return it;
+        }
+
+        auto hash = Hash{}(key);
+        for (size_t depth = 0; depth < MAX_DEPTH; depth++)
+        {
+            auto bit = 1U << fragment(hash, depth);
+            if ((node->entryMap & bit) != 0)
+            {
+                auto idx = indexOf(node->entryMap, bit);
+                if (!KeyEqual{}(node->entries[idx].first, key))
+                {
+                    return {};
+                }
+                it.push(node, idx, 0);
+                return it;
+            }
+            if ((node->childMap & bit) == 0)
+            {
+                return {};
+            }
+
+            auto idx = indexOf(node->childMap, bit);
+            // Continue with the next child once this one is done
+            it.push(node, node->entries.size(), idx + 1);
+            node = node->children[idx].get();
+        }
+
+        for (size_t i = 0; i < node->entries.size(); i++)
+        {
+            if (KeyEqual{}(node->entries[i].first, key))
+            {
+                it.push(node, i, 0);
+                return it;
+            }
+        }
+        return {};
+    }
+
+    bool contains(const Key &key) const
+    {
+        return this->find(key) != this->end();
+    }
+
+    size_type count(const Key &key) const
+    {
+        return this->contains(key) ? 1 : 0;
+    }
+
+    const T &at(const Key &key) const
+    {
+        auto it = this->find(key);
+        assert(it != this->end());
+        return it->second;
+    }
+
+    T &operator[](const Key &key)
+    {
+        return *this->insertImpl(key, T{}, false).first;
+    }
+
+    std::pair<iterator, bool> insert(const value_type &value)
+    {
+        auto inserted = this->insertImpl(value.first, value.second, false);
+        return {this->find(value.first), inserted.second};
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args &&...args)
+    {
+        value_type value(std::forward<Args>(args)...);
+        auto inserted =
+            this->insertImpl(value.first, std::move(value.second), false);
+        return {this->find(value.first), inserted.second};
+    }
+
+    template <typename M>
+    std::pair<iterator, bool> try_emplace(const Key &key, M &&mapped)
+    {
+        auto inserted = this->insertImpl(key, std::forward<M>(mapped), false);
+        return {this->find(key), inserted.second};
+    }
+
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(const Key &key, M &&mapped)
+    {
+        auto inserted = this->insertImpl(key, std::forward<M>(mapped), true);
+        return {this->find(key), inserted.second};
+    }
+
+    size_type erase(const Key &key)
+    {
+        if (!this->contains(key))
+        {
+            // Don't copy any shared nodes
+            return 0;
+        }
+
+        eraseFrom(this->root_, Hash{}(key), key, 0);
+        this->size_--;
+        return 1;
+    }
+
+    /// Unlike std::unordered_map::erase, this doesn't return the next iterator
+    void erase(const_iterator it)
+    {
+        assert(it != this->end());
+        this->erase(Key(it->first));
+    }
+
+    void clear()
+    {
+        this->root_.reset();
+        this->size_ = 0;
+    }
+
+    /// Returns true if both maps share their storage (e.g. one is a copy of
+    /// the other and neither was modified)
+    bool sharesStorageWith(const PersistentHashMap &other) const
+    {
+        return this->root_ == other.root_;
+    }
+
+private:
+    /// Makes sure `node` isn't shared with another map
+    static Node &ensureUnique(NodePtr &node)
+    {
+        if (!node)
+        {
+            node = std::make_shared<Node>();
+        }
+        else if (node.use_count() != 1)
+        {
+            // Another map or a reader might hold it, modify a copy instead
+            node = std::make_shared<Node>(*node);
+        }
+        else
+        {
+            // Reads through maps that released the node happen before our
+            // writes to it
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        return *node;
+    }
+
+    static void insertEntry(std::vector<value_type> &entries, size_t idx,
+                            value_type &&value)
+    {
+        // value_type isn't assignable, so the entries are rebuilt
+        std::vector<value_type> updated;
+        updated.reserve(entries.size() + 1);
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            if (i == idx)
+            {
+                updated.emplace_back(std::move(value));
+            }
+            updated.emplace_back(std::move(entries[i]));
+        }
+        if (idx == entries.size())
+        {
+            updated.emplace_back(std::move(value));
+        }
+        entries = std::move(updated);
+    }
+
+    static value_type takeEntry(std::vector<value_type> &entries, size_t idx)
+    {
+        value_type taken(std::move(entries[idx]));
+        std::vector<value_type> updated;
+        updated.reserve(entries.size() - 1);
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            if (i != idx)
+            {
+                updated.emplace_back(std::move(entries[i]));
+            }
+        }
+        entries = std::move(updated);
+        return taken;
+    }
+
+    /// Creates a node for two entries with different keys
+    static NodePtr makeNode(value_type &&a, size_t hashA, value_type &&b,
+                            size_t hashB, size_t depth)
+    {
+        auto node = std::make_shared<Node>();
+        if (depth >= MAX_DEPTH)
+        {
+            node->entries.reserve(2);
+            node->entries.emplace_back(std::move(a));
+            node->entries.emplace_back(std::move(b));
+            return node;
+        }
+
+        auto fragA = fragment(hashA, depth);
+        auto fragB = fragment(hashB, depth);
+        if (fragA == fragB)
+        {
+            node->childMap = 1U << fragA;
+            node->children.emplace_back(
+                makeNode(std::move(a), hashA, std::move(b), hashB, depth + 1));
+            return node;
+        }
+
+        node->entryMap = (1U << fragA) | (1U << fragB);
+        node->entries.reserve(2);
+        if (fragA < fragB)
+        {
+            node->entries.emplace_back(std::move(a));
+            node->entries.emplace_back(std::move(b));
+        }
+        else
+        {
+            node->entries.emplace_back(std::move(b));
+            node->entries.emplace_back(std::move(a));
+        }
+        return node;
+    }
+
+    /// Inserts or assigns `mapped`, returning the mapped value in the map and
+    /// whether it was inserted
+    template <typename M>
+    std::pair<T *, bool> insertImpl(const Key &key, M &&mapped, bool assign)
+    {
+        auto hash = Hash{}(key);
+        NodePtr *slot = &this->root_;
+
+        for (size_t depth = 0; depth < MAX_DEPTH; depth++)
+        {
+            auto &node = ensureUnique(*slot);
+            auto bit = 1U << fragment(hash, depth);
+
+            if ((node.entryMap & bit) != 0)
+            {
+                auto idx = indexOf(node.entryMap, bit);
+                auto &entry = node.entries[idx];
+                if (KeyEqual{}(entry.first, key))
+                {
+                    if (assign)
+                    {
+                        entry.second = std::forward<M>(mapped);
+                    }
+                    return {&entry.second, false};
+                }
+
+                // Both entries move into a new child
+                auto existing = takeEntry(node.entries, idx);
+                auto existingHash = Hash{}(existing.first);
+                node.entryMap &= ~bit;
+                node.childMap |= bit;
+                auto childIdx = indexOf(node.childMap, bit);
+                node.children.insert(
+                    node.children.begin() + static_cast<ptrdiff_t>(childIdx),
+                    makeNode(std::move(existing), existingHash,
+                             value_type(key, std::forward<M>(mapped)), hash,
+                             depth + 1));
+                this->size_++;
+                return {this->findMapped(key), true};
+            }
+
+            if ((node.childMap & bit) != 0)
+            {
+                slot = &node.children[indexOf(node.childMap, bit)];
+                continue;
+            }
+
+            auto idx = indexOf(node.entryMap, bit);
+            insertEntry(node.entries, idx,
+                        value_type(key, std::forward<M>(mapped)));
+            node.entryMap |= bit;
+            this->size_++;
+            return {&node.entries[idx].second, true};
+        }
+
+        // All bits of the hash are equal
+        auto &node = ensureUnique(*slot);
+        for (auto &entry : node.entries)
+        {
+            if (KeyEqual{}(entry.first, key))
+            {
+                if (assign)
+                {
+                    entry.second = std::forward<M>(mapped);
+                }
+                return {&entry.second, false};
+            }
+        }
+        node.entries.emplace_back(key, std::forward<M>(mapped));
+        this->size_++;
+        return {&node.entries.back().second, true};
+    }
+
+    /// Finds the mapped value of a key in nodes that aren't shared
+    T *findMapped(const Key &key)
+    {
+        auto it = std::as_const(*this).find(key);
+        assert(it != this->end());
+        return const_cast<T *>(&it->second);
+    }
+
+    /// Removes an existing key below `slot`
+    static void eraseFrom(NodePtr &slot, size_t hash, const Key &key,
+                          size_t depth)
+    {
+        auto &node = ensureUnique(slot);
+
+        if (depth >= MAX_DEPTH)
+        {
+            for (size_t i = 0; i < node.entries.size(); i++)
+            {
+                if (KeyEqual{}(node.entries[i].first, key))
+                {
+                    takeEntry(node.entries, i);
+                    return;
+                }
+            }
+            assert(false && "erased key must exist");
+            return;
+        }
+
+        auto bit = 1U << fragment(hash, depth);
+        if ((node.entryMap & bit) != 0)
+        {
+            takeEntry(node.entries, indexOf(node.entryMap, bit));
+            node.entryMap &= ~bit;
+            return;
+        }
+
+        assert((node.childMap & bit) != 0);
+        auto childIdx = indexOf(node.childMap, bit);
+        auto &child = node.children[childIdx];
+        eraseFrom(child, hash, key, depth + 1);
+
+        if (!child->children.empty() || child->entries.size() > 1)
+        {
+            return;
+        }
+
+        // Keep the trie compact: a child with at most one entry is merged
+        // into its parent
+        auto remaining = std::move(child->entries);
+        node.children.erase(node.children.begin() +
+                            static_cast<ptrdiff_t>(childIdx));
+        node.childMap &= ~bit;
+        if (!remaining.empty())
+        {
+            insertEntry(node.entries, indexOf(node.entryMap, bit),
+                        std::move(remaining.front()));
+            node.entryMap |= bit;
+        }
+    }
+
+    NodePtr root_;
+    size_t size_ = 0;
+};
+
+}  // namespace chatterino
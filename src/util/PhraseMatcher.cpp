@@ -0,0 +1,330 @@
+#include "util/PhraseMatcher.hpp"
+
+#include <QStringBuilder>
+#include <QStringView>
+
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <utility>
+
+namespace {
+
+/// Matches regex constructs that change meaning (or break the pattern) when
+/// the regex is wrapped in a group and combined with other regexes:
+/// numbered/relative backreferences and recursion, \Q without a matching \E
+/// in the same branch, and extended mode comments which run until the end of
+/// the combined pattern.
+const QRegularExpression UNCOMBINABLE_REGEX(
+    R"(\\[1-9gkQ]|\(\?(?:P[=>]|[+-]?\d|R|&|\(|[a-zA-Z^-]*x))");
+
+/// PCRE's \w with UseUnicodePropertiesOption
+bool isWordCharacter(QChar c)
+{
+    return c.isLetterOrNumber() || c == u'_';
+}
+
+/// Equivalent to `(?:\b|\s|^)` in front of `start`
+bool isStartBoundary(const QString &text, qsizetype start)
+{
+    if (start == 0)
+    {
+        return true;
+    }
+
+    auto before = text[start - 1];
+    return before.isSpace() ||
+           isWordCharacter(before) != isWordCharacter(text[start]);
+}
+
+/// Equivalent to `(?:\b|\s|$)` at `end`
+bool isEndBoundary(const QString &text, qsizetype end)
+{
+    if (end == text.size())
+    {
+        return true;
+    }
+
+    auto after = text[end];
+    return after.isSpace() ||
+           isWordCharacter(text[end - 1]) != isWordCharacter(after);
+}
+
+uint64_t edgeKey(uint32_t node, char16_t c)
+{
+    return (static_cast<uint64_t>(node) << 16) | c;
+}
+
+char16_t fold(QChar c)
+{
+    return c.toCaseFolded().unicode();
+}
+
+QRegularExpression::PatternOptions regexOptions(bool isCaseSensitive)
+{
+    return QRegularExpression::UseUnicodePropertiesOption |
+           (isCaseSensitive ? QRegularExpression::NoPatternOption
+                            : QRegularExpression::CaseInsensitiveOption);
+}
+
+}  // namespace
+
+namespace chatterino {
+
+PhraseMatcher::PhraseMatcher(const std::vector<Phrase> &phrases)
+    : phraseCount_(phrases.size())
+{
+    for (size_t i = 0; i < phrases.size(); i++)
+    {
+        if (!phrases[i].isRegex)
+        {
+            this->addLiteral(i, phrases[i]);
+        }
+    }
+    this->buildFailLinks();
+    this->buildRegexes(phrases);
+}
+
+std::vector<bool> PhraseMatcher::match(const QString &text) const
+{
+    std::vector<bool> matches(this->phraseCount_, false);
+
+    this->scanLiterals(text, [&](size_t phraseIndex) {
+        matches[phraseIndex] = true;
+        return true;
+    });
+
+    if (!this->combinedRegexes_.empty() &&
+        this->combinedRegex_.match(text).hasMatch())
+    {
+        for (const auto &phrase : this->combinedRegexes_)
+        {
+            if (phrase.regex.match(text).hasMatch())
+            {
+                matches[phrase.phraseIndex] = true;
+            }
+        }
+    }
+
+    for (const auto &phrase : this->separateRegexes_)
+    {
+        if (phrase.regex.match(text).hasMatch())
+        {
+            matches[phrase.phraseIndex] = true;
+        }
+    }
+
+    return matches;
+}
+
+bool PhraseMatcher::matchesAny(const QString &text) const
+{
+    bool found = false;
+    this->scanLiterals(text, [&](size_t /*phraseIndex*/) {
+        found = true;
+        return false;
+    });
+    if (found)
+    {
+        return true;
+    }
+
+    if (!this->combinedRegexes_.empty() &&
+        this->combinedRegex_.match(text).hasMatch())
+    {
+        return true;
+    }
+
+    return std::any_of(this->separateRegexes_.begin(),
+                       this->separateRegexes_.end(), [&](const auto &phrase) {
+                           return phrase.regex.match(text).hasMatch();
+                       });
+}
+
+size_t PhraseMatcher::size() const
+{
+    return this->phraseCount_;
+}
+
+void PhraseMatcher::addLiteral(size_t phraseIndex, const Phrase &phrase)
+{
+    if (phrase.pattern.isEmpty())
+    {
+        return;
+    }
+
+    uint32_t node = 0;
+    for (auto c : phrase.pattern)
+    {
+        auto key = edgeKey(node, fold(c));
+        auto it = this->children_.find(key);
+        if (it != this->children_.end())
+        {
+            node = it->second;
+            continue;
+        }
+
+        auto child = static_cast<uint32_t>(this->nodes_.size());
+        this->nodes_.emplace_back();
+        this->children_.emplace(key, child);
+        node = child;
+    }
+
+    this->nodes_[node].outputs.push_back(
+        static_cast<uint32_t>(this->literals_.size()));
+    this->literals_.push_back(Literal{
+        .phraseIndex = phraseIndex,
+        .pattern = phrase.pattern,
+        .isCaseSensitive = phrase.isCaseSensitive,
+        .wholeWord = phrase.wholeWord,
+    });
+}
+
+void PhraseMatcher::buildFailLinks()
+{
+    std::vector<std::vector<std::pair<char16_t, uint32_t>>> edges(
+        this->nodes_.size());
+    for (const auto &[key, child] : this->children_)
+    {
+        edges[key >> 16].emplace_back(static_cast<char16_t>(key & 0xFFFF),
+                                      child);
+    }
+
+    // Breadth-first, so the fail target of a node (which is always less deep)
+    // already has its outputs merged when we get to the node
+    std::deque<uint32_t> queue;
+    for (const auto &[c, child] : edges[0])
+    {
+        this->nodes_[child].fail = 0;
+        queue.push_back(child);
+    }
+
+    while (!queue.empty())
+    {
+        auto node = queue.front();
+        queue.pop_front();
+
+        for (const auto &[c, child] : edges[node])
+        {
+            auto fail = this->transition(this->nodes_[node].fail, c);
+            this->nodes_[child].fail = fail;
+
+            const auto &inherited = this->nodes_[fail].outputs;
+            auto &outputs = this->nodes_[child].outputs;
+            outputs.insert(outputs.end(), inherited.begin(), inherited.end());
+
+            queue.push_back(child);
+        }
+    }
+}
+
+void PhraseMatcher::buildRegexes(const std::vector<Phrase> &phrases)
+{
+    QStringList alternatives;
+    for (size_t i = 0; i < phrases.size(); i++)
+    {
+        const auto &phrase = phrases[i];
+        if (!phrase.isRegex || phrase.pattern.isEmpty())
+        {
+            continue;
+        }
+
+        QRegularExpression regex(phrase.pattern,
+                                 regexOptions(phrase.isCaseSensitive));
+        if (!regex.isValid())
+        {
+            continue;
+        }
+
+        if (UNCOMBINABLE_REGEX.match(phrase.pattern).hasMatch())
+        {
+            this->separateRegexes_.push_back({i, std::move(regex)});
+            continue;
+        }
+
+        QStringView prefix = phrase.isCaseSensitive ? u"(?-i:" : u"(?i:";
+        alternatives.append(prefix % phrase.pattern % QStringView(u")"));
+        this->combinedRegexes_.push_back({i, std::move(regex)});
+    }
+
+    if (this->combinedRegexes_.empty())
+    {
+        return;
+    }
+
+    this->combinedRegex_ =
+        QRegularExpression(alternatives.join(u'|'),
+                           QRegularExpression::UseUnicodePropertiesOption);
+    if (!this->combinedRegex_.isValid())
+    {
+        // e.g. two regexes use the same group name
+        std::move(this->combinedRegexes_.begin(), this->combinedRegexes_.end(),
+                  std::back_inserter(this->separateRegexes_));
+        this->combinedRegexes_.clear();
+        return;
+    }
+    this->combinedRegex_.optimize();
+}
+
+uint32_t PhraseMatcher::transition(uint32_t node, char16_t c) const
+{
+    while (true)
+    {
+        auto it = this->children_.find(edgeKey(node, c));
+        if (it != this->children_.end())
+        {
+            return it->second;
+        }
+        if (node == 0)
+        {
+            return 0;
+        }
+        node = this->nodes_[node].fail;
+    }
+}
+
+template <typename F>
+void PhraseMatcher::scanLiterals(const QString &text, F &&onMatch) const
+{
+    if (this->literals_.empty())
+    {
+        return;
+    }
+
+    uint32_t node = 0;
+    for (qsizetype i = 0; i < text.size(); i++)
+    {
+        node = this->transition(node, fold(text[i]));
+        for (auto literalIndex : this->nodes_[node].outputs)
+        {
+            const auto &literal = this->literals_[literalIndex];
+            auto start = i + 1 - literal.pattern.size();
+            if (this->literalMatchesAt(literal, text, start) &&
+                !onMatch(literal.phraseIndex))
+            {
+                return;
+            }
+        }
+    }
+}
+
+bool PhraseMatcher::literalMatchesAt(const Literal &literal,
+                                     const QString &text,
+                                     qsizetype start) const
+{
+    auto length = literal.pattern.size();
+    if (literal.isCaseSensitive &&
+        QStringView(text).mid(start, length) != literal.pattern)
+    {
+        return false;
+    }
+
+    if (!literal.wholeWord)
+    {
+        return true;
+    }
+
+    return isStartBoundary(text, start) && isEndBoundary(text, start + length);
+}
+
+}  // namespace chatterino
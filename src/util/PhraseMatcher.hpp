@@ -0,0 +1,99 @@
+#pragma once
+
+#include <QRegularExpression>
+#include <QString>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace chatterino {
+
+/// PhraseMatcher checks a text against many phrases at once.
+///
+/// Plain phrases are compiled into a single Aho-Corasick automaton over the
+/// case-folded text, so finding every occurrence of every plain phrase takes
+/// one pass over the text, independent of the number of phrases.
+///
+/// Regex phrases are combined into one alternation that acts as a prefilter:
+/// only if it matches are the individual regexes run to find out which of
+/// them matched. Regexes that can't safely be combined (e.g. because they
+/// contain backreferences) are always run individually.
+class PhraseMatcher
+{
+public:
+    struct Phrase {
+        QString pattern;
+        bool isRegex = false;
+        bool isCaseSensitive = false;
+
+        /// Only match plain phrases that start and end at a word boundary,
+        /// next to whitespace, or at the start/end of the text. This is the
+        /// same as surrounding the escaped pattern with `(?:\b|\s|^)` and
+        /// `(?:\b|\s|$)`, which is what highlight phrases do.
+        bool wholeWord = false;
+    };
+
+    PhraseMatcher() = default;
+    explicit PhraseMatcher(const std::vector<Phrase> &phrases);
+
+    /// Returns a vector with one entry per phrase, which is true if the phrase
+    /// matched the text. Empty and invalid phrases never match.
+    std::vector<bool> match(const QString &text) const;
+
+    /// Returns true if any phrase matches the text
+    bool matchesAny(const QString &text) const;
+
+    /// Returns the number of phrases this matcher was built with
+    size_t size() const;
+
+private:
+    struct Literal {
+        size_t phraseIndex;
+        QString pattern;
+        bool isCaseSensitive;
+        bool wholeWord;
+    };
+
+    struct Node {
+        uint32_t fail = 0;
+        /// Indices into literals_ of all literals ending at this node,
+        /// including the ones reachable through fail links
+        std::vector<uint32_t> outputs;
+    };
+
+    struct RegexPhrase {
+        size_t phraseIndex;
+        QRegularExpression regex;
+    };
+
+    void addLiteral(size_t phraseIndex, const Phrase &phrase);
+    void buildFailLinks();
+    void buildRegexes(const std::vector<Phrase> &phrases);
+
+    uint32_t transition(uint32_t node, char16_t c) const;
+
+    /// Calls onMatch(phraseIndex) for every literal occurrence that passes the
+    /// case and word boundary checks. Stops once onMatch returns false.
+    template <typename F>
+    void scanLiterals(const QString &text, F &&onMatch) const;
+
+    bool literalMatchesAt(const Literal &literal, const QString &text,
+                          qsizetype start) const;
+
+    size_t phraseCount_ = 0;
+
+    std::vector<Literal> literals_;
+    std::vector<Node> nodes_{Node{}};
+    /// (node << 16 | case-folded UTF-16 code unit) -> child node
+    std::unordered_map<uint64_t, uint32_t> children_;
+
+    /// Regexes that are part of combinedRegex_
+    std::vector<RegexPhrase> combinedRegexes_;
+    QRegularExpression combinedRegex_;
+    /// Regexes that always have to be run on their own
+    std::vector<RegexPhrase> separateRegexes_;
+};
+
+}  // namespace chatterino
@@ -3,6 +3,9 @@
 #include <boost/container_hash/hash_fwd.hpp>
 #include <QHash>
 #include <QString>
+#include <QStringView>
+
+#include <cstddef>
 
 namespace boost {
 
@@ -15,3 +18,18 @@ struct hash<QString> {
 };
 
 }  // namespace boost
+
+namespace chatterino {
+
+/// Hashes QStrings and QStringViews the same way, so QString keyed maps can be
+/// searched with a QStringView without creating a QString
+struct TransparentQStringHash {
+    using is_transparent = void;
+
+    std::size_t operator()(QStringView s) const noexcept
+    {
+        return qHash(s);
+    }
+};
+
+}  // namespace chatterino
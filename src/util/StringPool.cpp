@@ -0,0 +1,74 @@
+#include "util/StringPool.hpp"
+
+#include "util/Metrics.hpp"
+
+#include <algorithm>
+
+namespace chatterino {
+
+namespace {
+
+const metrics::Counter INTERNED_STRINGS("interned strings");
+
+}  // namespace
+
+StringPool::StringPool(size_t minCleanupSize)
+    : minCleanupSize_(minCleanupSize)
+    , cleanupSize_(minCleanupSize)
+{
+}
+
+StringPool &StringPool::instance()
+{
+    // Never destroyed, messages might be built during static destruction
+    static auto *pool = new StringPool;
+    return *pool;
+}
+
+QString StringPool::intern(const QString &string)
+{
+    if (string.isEmpty())
+    {
+        return string;
+    }
+
+    std::unique_lock lock(this->mutex_);
+
+    auto [it, inserted] = this->strings_.insert(string);
+    if (!inserted)
+    {
+        return *it;
+    }
+
+    INTERNED_STRINGS.increase();
+    if (this->strings_.size() >= this->cleanupSize_)
+    {
+        this->cleanup();
+    }
+    return string;
+}
+
+void StringPool::internInPlace(QString &string)
+{
+    string = this->intern(string);
+}
+
+size_t StringPool::size() const
+{
+    std::unique_lock lock(this->mutex_);
+    return this->strings_.size();
+}
+
+void StringPool::cleanup()
+{
+    // A string that's detached is only referenced by the pool
+    auto removed = std::erase_if(this->strings_, [](const QString &string) {
+        return string.isDetached();
+    });
+    INTERNED_STRINGS.decrease(static_cast<int64_t>(removed));
+
+    this->cleanupSize_ =
+        std::max(this->minCleanupSize_, this->strings_.size() * 2);
+}
+
+}  // namespace chatterino
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QString>
+
+#include <cstddef>
+#include <mutex>
+#include <unordered_set>
+
+namespace chatterino {
+
+/// @brief Interns strings that are repeated across many messages
+///
+/// Channel names, user names, user IDs and badges are the same for many
+/// messages. Passing them through intern() makes all messages share one copy
+/// of each string instead of keeping their own.
+///
+/// Strings that are only referenced by the pool are dropped once the pool grew
+/// to twice the size it had after the last cleanup.
+///
+/// This can be used from any thread.
+class StringPool
+{
+public:
+    /// The pool isn't cleaned up before it holds this many strings
+    static constexpr size_t MIN_CLEANUP_SIZE = 1024;
+
+    StringPool(size_t minCleanupSize = MIN_CLEANUP_SIZE);
+
+    static StringPool &instance();
+
+    /// Returns a string equal to @a string that shares its data with all
+    /// other strings interned while it's in the pool
+    QString intern(const QString &string);
+
+    /// Interns @a string in place
+    void internInPlace(QString &string);
+
+    /// Returns the number of strings in the pool
+    size_t size() const;
+
+private:
+    void cleanup();
+
+    mutable std::mutex mutex_;
+    std::unordered_set<QString> strings_;
+    const size_t minCleanupSize_;
+    size_t cleanupSize_;
+};
+
+}  // namespace chatterino
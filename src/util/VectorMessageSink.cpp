@@ -37,8 +37,7 @@ void VectorMessageSink::addOrReplaceTimeout(MessagePtr clearchatMessage,
         },
         [&](auto &&msg) {
             this->messages_.emplace_back(msg);
-        },
-        false);
+        });
 }
 
 void VectorMessageSink::addOrReplaceClearChat(MessagePtr clearchatMessage,
@@ -3,7 +3,7 @@
 #include "Application.hpp"
 #include "common/QLogging.hpp"
 #include "singletons/Settings.hpp"
-#include "util/DebugCount.hpp"
+#include "util/Metrics.hpp"
 #include "widgets/splits/Split.hpp"
 
 #include <QTimer>
@@ -24,6 +24,12 @@
 
 namespace chatterino {
 
+namespace {
+
+const metrics::Counter ATTACHED_WINDOWS("attached window");
+
+}  // namespace
+
 #ifdef USEWINSDK
 static thread_local std::vector<HWND> taskbarHwnds;
 
@@ -58,7 +64,7 @@ AttachedWindow::AttachedWindow(void *_target, int _yOffset)
     split->setSizePolicy(QSizePolicy::Maximum, QSizePolicy::MinimumExpanding);
     layout->addWidget(split);
 
-    DebugCount::increase("attached window");
+    ATTACHED_WINDOWS.increase();
 }
 
 AttachedWindow::~AttachedWindow()
@@ -72,7 +78,7 @@ AttachedWindow::~AttachedWindow()
         }
     }
 
-    DebugCount::decrease("attached window");
+    ATTACHED_WINDOWS.decrease();
 }
 
 AttachedWindow *AttachedWindow::get(void *target, const GetArgs &args)
@@ -5,7 +5,7 @@
 #include "singletons/Settings.hpp"
 #include "singletons/Theme.hpp"
 #include "singletons/WindowManager.hpp"
-#include "util/DebugCount.hpp"
+#include "util/Metrics.hpp"
 #include "util/PostToThread.hpp"
 #include "util/WindowsHelper.hpp"
 #include "widgets/buttons/LabelButton.hpp"
@@ -40,6 +40,8 @@ namespace {
 
 using namespace chatterino;
 
+const metrics::Counter BASE_WINDOWS("BaseWindow");
+
 #ifdef USEWINSDK
 
 // From kHiddenTaskbarSize in Firefox
@@ -268,12 +270,12 @@ BaseWindow::BaseWindow(FlagsEnum<Flags> _flags, QWidget *parent)
 #endif
 
     this->themeChangedEvent();
-    DebugCount::increase("BaseWindow");
+    BASE_WINDOWS.increase();
 }
 
 BaseWindow::~BaseWindow()
 {
-    DebugCount::decrease("BaseWindow");
+    BASE_WINDOWS.decrease();
 }
 
 void BaseWindow::setInitialBounds(QRect bounds, widgets::BoundsChecking mode)
@@ -108,23 +108,13 @@ bool checkMessageUserName(const QString &userName, MessagePtr message)
 
 ChannelPtr filterMessages(const QString &userName, ChannelPtr channel)
 {
-    LimitedQueueSnapshot<MessagePtr> snapshot = channel->getMessageSnapshot();
+    // A plain channel is enough to back the view, like in ChannelView
+    auto channelPtr = std::make_shared<Channel>(
+        channel->getName(), channel->isTwitchChannel() ? Channel::Type::Twitch
+                                                       : Channel::Type::None);
 
-    ChannelPtr channelPtr;
-    if (channel->isTwitchChannel())
+    for (const auto &message : channel->findMessagesByUser(userName))
     {
-        channelPtr = std::make_shared<TwitchChannel>(channel->getName());
-    }
-    else
-    {
-        channelPtr =
-            std::make_shared<Channel>(channel->getName(), Channel::Type::None);
-    }
-
-    for (size_t i = 0; i < snapshot.size(); i++)
-    {
-        MessagePtr message = snapshot[i];
-
         if (checkMessageUserName(userName, message))
         {
             channelPtr->addMessage(message, MessageContext::Repost);
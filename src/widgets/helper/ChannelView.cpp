@@ -7,7 +7,7 @@
 #include "controllers/commands/Command.hpp"
 #include "controllers/commands/CommandController.hpp"
 #include "controllers/filters/FilterSet.hpp"
-#include "debug/Benchmark.hpp"
+#include "debug/Trace.hpp"
 #include "messages/Emote.hpp"
 #include "messages/Image.hpp"
 #include "messages/layouts/MessageLayout.hpp"
@@ -33,12 +33,14 @@
 #include "util/DistanceBetweenPoints.hpp"
 #include "util/Helpers.hpp"
 #include "util/IncognitoBrowser.hpp"
+#include "util/Metrics.hpp"
 #include "util/QMagicEnum.hpp"
 #include "util/Twitch.hpp"
 #include "widgets/buttons/LabelButton.hpp"
 #include "widgets/dialogs/ReplyThreadPopup.hpp"
 #include "widgets/dialogs/SettingsDialog.hpp"
 #include "widgets/dialogs/UserInfoPopup.hpp"
+#include "widgets/helper/LayoutScheduler.hpp"
 #include "widgets/helper/ScrollbarHighlight.hpp"
 #include "widgets/helper/SearchPopup.hpp"
 #include "widgets/Notebook.hpp"
@@ -79,6 +81,9 @@ using namespace chatterino;
 
 constexpr int SCROLLBAR_PADDING = 8;
 
+const metrics::Histogram CHANNEL_VIEW_LAYOUT_TIME("channel view layout time");
+const metrics::Histogram CHANNEL_VIEW_PAINT_TIME("channel view paint time");
+
 void addEmoteContextMenuItems(QMenu *menu, const Emote &emote, QStringView kind)
 {
     auto *openAction = menu->addAction("&Open");
@@ -422,7 +427,8 @@ void ChannelView::initializeSignals()
 
     this->signalHolder_.managedConnect(
         getApp()->getWindows()->gifRepaintRequested, [&] {
-            if (!this->animationArea_.isEmpty())
+            // Hidden views don't paint, so their animations don't advance
+            if (this->isVisible() && !this->animationArea_.isEmpty())
             {
                 this->queueUpdate(this->animationArea_);
             }
@@ -636,7 +642,7 @@ void ChannelView::queueUpdate()
     this->update();
 }
 
-void ChannelView::queueUpdate(const QRect &area)
+void ChannelView::queueUpdate(const QRegion &area)
 {
     this->update(area);
 }
@@ -660,6 +666,18 @@ void ChannelView::queueLayout()
     }
 }
 
+void ChannelView::scheduleLayout()
+{
+    if (this->isVisible())
+    {
+        LayoutScheduler::instance().schedule(this);
+    }
+    else
+    {
+        this->layoutQueued_ = true;
+    }
+}
+
 void ChannelView::showEvent(QShowEvent * /*event*/)
 {
     if (this->layoutQueued_)
@@ -670,9 +688,10 @@ void ChannelView::showEvent(QShowEvent * /*event*/)
 
 void ChannelView::performLayout(bool causedByScrollbar, bool causedByShow)
 {
-    // BenchmarkGuard benchmark("layout");
+    TRACE_ZONE("channel view layout");
 
     this->layoutQueued_ = false;
+    this->layoutScheduled_ = false;
 
     /// Get messages and check if there are at least 1
     const auto &messages = this->getMessagesSnapshot();
@@ -695,6 +714,8 @@ void ChannelView::performLayout(bool causedByScrollbar, bool causedByShow)
 void ChannelView::layoutVisibleMessages(
     const LimitedQueueSnapshot<MessageLayoutPtr> &messages)
 {
+    auto timer = CHANNEL_VIEW_LAYOUT_TIME.time();
+
     const auto start = size_t(this->scrollBar_->getRelativeCurrentValue());
     const auto layoutWidth = this->getLayoutWidth();
     const auto flags = this->getFlags();
@@ -1127,6 +1148,8 @@ FilterSetPtr ChannelView::getFilterSet() const
 
 bool ChannelView::shouldIncludeMessage(const MessagePtr &m) const
 {
+    TRACE_ZONE("message filter");
+
     if (this->channelFilters_)
     {
         if (getSettings()->excludeUserMessagesFromFilter &&
@@ -1230,7 +1253,7 @@ void ChannelView::messageAppended(MessagePtr &message,
         this->scrollBar_->addHighlight(message->getScrollBarHighlight());
     }
 
-    this->queueLayout();
+    this->scheduleLayout();
 }
 
 void ChannelView::messageAddedAtStart(std::vector<MessagePtr> &messages)
@@ -1282,7 +1305,7 @@ void ChannelView::messageAddedAtStart(std::vector<MessagePtr> &messages)
         this->scrollBar_->addHighlightsAtStart(highlights);
     }
 
-    this->queueLayout();
+    this->scheduleLayout();
 }
 
 void ChannelView::messageReplaced(size_t hint, const MessagePtr &prev,
@@ -1308,7 +1331,7 @@ void ChannelView::messageReplaced(size_t hint, const MessagePtr &prev,
                                        replacement->getScrollBarHighlight());
 
     this->messages_.replaceItem(index, newItem);
-    this->queueLayout();
+    this->scheduleLayout();
 }
 
 void ChannelView::messagesUpdated()
@@ -1541,7 +1564,8 @@ void ChannelView::scrollToMessageLayout(MessageLayout *layout,
 
 void ChannelView::paintEvent(QPaintEvent *event)
 {
-    //    BenchmarkGuard benchmark("paint");
+    TRACE_ZONE("channel view paint");
+    auto timer = CHANNEL_VIEW_PAINT_TIME.time();
 
     QPainter painter(this);
 
@@ -1623,8 +1647,7 @@ void ChannelView::drawMessages(QPainter &painter, const QRect &area)
     };
     bool showLastMessageIndicator = getSettings()->showLastMessageIndicator;
 
-    // using QRect here, because we can only request updates with a rect
-    QRect animationArea;
+    QRegion animationArea;
     auto areaContainsY = [&area](auto y) {
         return y >= area.y() && y < area.y() + area.height();
     };
@@ -1649,21 +1672,7 @@ void ChannelView::drawMessages(QPainter &painter, const QRect &area)
             auto paintResult = layout->paint(ctx);
             if (paintResult.hasAnimatedElements)
             {
-                if (animationArea.isNull())
-                {
-                    animationArea = QRect{
-                        0,
-                        ctx.y,
-                        layout->getWidth(),
-                        layout->getHeight(),
-                    };
-                }
-                else
-                {
-                    animationArea.setBottom((ctx.y + layout->getHeight()));
-                    animationArea.setWidth(
-                        std::max(layout->getWidth(), animationArea.width()));
-                }
+                animationArea += paintResult.animationArea;
             }
 
             if (this->highlightedMessage_ == layout)
@@ -3265,6 +3274,11 @@ void ChannelView::setInputReply(const MessagePtr &message)
         // Message did not already have a thread attached, try to find or create one
         auto *tc =
             dynamic_cast<TwitchChannel *>(this->underlyingChannel_.get());
+        if (!tc && this->hasSourceChannel())
+        {
+            // Nested views (e.g. in user cards) show messages of their source
+            tc = dynamic_cast<TwitchChannel *>(this->sourceChannel_.get());
+        }
 
         if (tc)
         {
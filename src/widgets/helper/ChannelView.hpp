@@ -99,7 +99,7 @@ public:
                          size_t messagesLimit = 1000);
 
     void queueUpdate();
-    void queueUpdate(const QRect &area);
+    void queueUpdate(const QRegion &area);
     Scrollbar &getScrollBar();
 
     QString getSelectedText();
@@ -181,6 +181,9 @@ public:
     LimitedQueueSnapshot<MessageLayoutPtr> &getMessagesSnapshot();
 
     void queueLayout();
+    /// Like queueLayout, but the layout is deferred to the next frame and
+    /// coalesced with other layouts (see LayoutScheduler)
+    void scheduleLayout();
     void invalidateBuffers();
 
     void clearMessages();
@@ -331,14 +334,16 @@ private:
     ChannelViewID id_{};
 
     bool layoutQueued_ = false;
+    /// Set while this view is waiting for the LayoutScheduler
+    bool layoutScheduled_ = false;
     bool bufferInvalidationQueued_ = false;
 
     bool lastMessageHasAlternateBackground_ = false;
     bool lastMessageHasAlternateBackgroundReverse_ = true;
 
     /// Tracks the area of animated elements in the last full repaint.
-    /// If this is empty (QRect::isEmpty()), no animated element is shown.
-    QRect animationArea_;
+    /// If this is empty (QRegion::isEmpty()), no animated element is shown.
+    QRegion animationArea_;
 
     bool pausable_ = false;
     QTimer pauseTimer_;
@@ -462,6 +467,8 @@ private:
 
     /// Slot for the LinkInfo::stateChanged signal.
     void pendingLinkInfoStateChanged();
+
+    friend class LayoutScheduler;
 };
 
 }  // namespace chatterino
@@ -1,12 +1,14 @@
 #include "widgets/helper/DebugPopup.hpp"
 
 #include "common/Literals.hpp"
+#include "debug/Trace.hpp"
 #include "util/Clipboard.hpp"
-#include "util/DebugCount.hpp"
+#include "util/Metrics.hpp"
 
 #include <QFontDatabase>
 #include <QLabel>
 #include <QPushButton>
+#include <QStringBuilder>
 #include <QTimer>
 #include <QVBoxLayout>
 
@@ -22,10 +24,10 @@ DebugPopup::DebugPopup()
     auto *copyButton = new QPushButton(u"&Copy"_s);
 
     QObject::connect(timer, &QTimer::timeout, [text] {
-        text->setText(DebugCount::getDebugText());
+        text->setText(metrics::debugText());
     });
     timer->start(300);
-    text->setText(DebugCount::getDebugText());
+    text->setText(metrics::debugText());
 
     text->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
 
@@ -35,6 +37,21 @@ DebugPopup::DebugPopup()
     QObject::connect(copyButton, &QPushButton::clicked, this, [text] {
         crossPlatformCopy(text->text());
     });
+
+    if constexpr (trace::ENABLED)
+    {
+        auto *traceButton = new QPushButton(u"Save &trace"_s);
+        auto *traceLabel = new QLabel(this);
+        traceLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+        layout->addWidget(traceButton);
+        layout->addWidget(traceLabel);
+
+        QObject::connect(traceButton, &QPushButton::clicked, this,
+                         [traceLabel] {
+                             traceLabel->setText(u"Writing trace to "_s %
+                                                 trace::dump());
+                         });
+    }
 }
 
 }  // namespace chatterino
@@ -0,0 +1,148 @@
+#include "widgets/helper/LayoutScheduler.hpp"
+
+#include "debug/Trace.hpp"
+#include "util/Metrics.hpp"
+#include "widgets/helper/ChannelView.hpp"
+
+#include <QGuiApplication>
+#include <QScreen>
+#include <QTimer>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+const chatterino::metrics::Gauge LAYOUTS_SAVED_PER_SECOND(
+    "channel view layouts saved/s");
+
+std::chrono::milliseconds guessFrameLength()
+{
+    qreal refreshRate = 60;
+    if (auto *screen = QGuiApplication::primaryScreen())
+    {
+        refreshRate = std::clamp<qreal>(screen->refreshRate(), 30, 240);
+    }
+    return std::chrono::milliseconds{
+        static_cast<int64_t>(std::floor(1000.0 / refreshRate))};
+}
+
+}  // namespace
+
+namespace chatterino {
+
+LayoutScheduler &LayoutScheduler::instance()
+{
+    static LayoutScheduler scheduler;
+    return scheduler;
+}
+
+LayoutScheduler::LayoutScheduler()
+    : frameLength_(guessFrameLength())
+{
+}
+
+void LayoutScheduler::schedule(ChannelView *view)
+{
+    this->requested_++;
+    if (!this->statsTimerActive_)
+    {
+        this->statsTimerActive_ = true;
+        this->statsStart_ = std::chrono::steady_clock::now();
+        QTimer::singleShot(1s, qApp, [this] {
+            this->updateStats();
+        });
+    }
+
+    if (view->layoutScheduled_)
+    {
+        return;
+    }
+    view->layoutScheduled_ = true;
+    this->views_.emplace_back(view);
+
+    if (this->frameQueued_)
+    {
+        return;
+    }
+    this->frameQueued_ = true;
+
+    auto now = std::chrono::steady_clock::now();
+    auto untilNextFrame = std::max(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            this->lastFrame_ + this->frameLength_ - now),
+        0ms);
+
+    // A timeout of 0 runs after all events that are currently queued, so
+    // messages that arrive in the same event-loop iteration are still batched.
+    QTimer::singleShot(untilNextFrame, Qt::PreciseTimer, qApp, [this] {
+        this->runFrame();
+    });
+}
+
+void LayoutScheduler::runFrame()
+{
+    TRACE_ZONE("layout frame");
+
+    this->frameQueued_ = false;
+    this->lastFrame_ = std::chrono::steady_clock::now();
+
+    // Layouts might schedule new layouts (e.g. through the scrollbar)
+    auto views = std::move(this->views_);
+    this->views_.clear();
+
+    for (const auto &view : views)
+    {
+        // The view might have been laid out by other means in the meantime
+        if (!view || !view->layoutScheduled_)
+        {
+            continue;
+        }
+        view->layoutScheduled_ = false;
+
+        if (view->isVisible())
+        {
+            view->performLayout();
+            this->performed_++;
+        }
+        else
+        {
+            view->layoutQueued_ = true;
+        }
+    }
+}
+
+void LayoutScheduler::updateStats()
+{
+    auto now = std::chrono::steady_clock::now();
+    // A frame that was requested before the stats were reset can perform
+    // more layouts than were requested since then
+    auto saved = static_cast<double>(
+        std::max<int64_t>(static_cast<int64_t>(this->requested_) -
+                              static_cast<int64_t>(this->performed_),
+                          0));
+    auto seconds =
+        std::chrono::duration<double>(now - this->statsStart_).count();
+    LAYOUTS_SAVED_PER_SECOND.set(
+        static_cast<int64_t>(std::round(saved / std::max(seconds, 1.0))));
+
+    // Keep updating until a second passes without any layout requests, so
+    // the rate drops back to zero when messages stop coming in
+    bool idle = this->requested_ == 0;
+    this->requested_ = 0;
+    this->performed_ = 0;
+    this->statsStart_ = now;
+
+    if (idle)
+    {
+        this->statsTimerActive_ = false;
+        return;
+    }
+    QTimer::singleShot(1s, qApp, [this] {
+        this->updateStats();
+    });
+}
+
+}  // namespace chatterino
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QPointer>
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace chatterino {
+
+class ChannelView;
+
+/// @brief Coalesces layouts of ChannelViews caused by new messages.
+///
+/// Instead of laying out a view for every message it receives, views are
+/// marked dirty and laid out once per display frame. All views that became
+/// dirty during a frame are laid out in the same pass.
+///
+/// This is the message-arrival counterpart to the debounce in
+/// `detail::assignFrames`.
+class LayoutScheduler
+{
+public:
+    static LayoutScheduler &instance();
+
+    /// Lay out `view` with the next frame. Must be called from the GUI thread.
+    void schedule(ChannelView *view);
+
+private:
+    LayoutScheduler();
+
+    void runFrame();
+    /// Updates the "layouts saved" rate once per second while views are
+    /// scheduled
+    void updateStats();
+
+    std::vector<QPointer<ChannelView>> views_;
+    bool frameQueued_ = false;
+
+    std::chrono::milliseconds frameLength_;
+    std::chrono::steady_clock::time_point lastFrame_;
+
+    bool statsTimerActive_ = false;
+    // Number of layout requests and actual layouts since statsStart_
+    size_t requested_ = 0;
+    size_t performed_ = 0;
+    std::chrono::steady_clock::time_point statsStart_;
+};
+
+}  // namespace chatterino
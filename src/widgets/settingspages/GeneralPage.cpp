@@ -1000,6 +1000,17 @@ void GeneralPage::initLayout(GeneralPageView &layout)
         layout.addLayout(box);
     }
 
+    SettingWidget::intInput("Cache size limit", s.cacheSizeLimit,
+                            {
+                                .min = 16,
+                                .max = 16 * 1024,
+                                .singleStep = 64,
+                                .suffix = " MiB",
+                            })
+        ->setTooltip("When the cached files grow larger than this, the ones "
+                     "that weren't used for the longest time are deleted.")
+        ->addTo(layout);
+
     layout.addTitle("Advanced");
 
     layout.addSubtitle("Chat title");
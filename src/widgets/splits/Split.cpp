@@ -843,6 +843,11 @@ void Split::setChannel(IndirectChannel newChannel)
         this->roomModeChangedConnection_ = tc->roomModesChanged.connect([this] {
             this->header_->updateRoomModes();
         });
+
+        if (this->isVisible())
+        {
+            tc->hydrate();
+        }
     }
 
     this->indirectChannelChangedConnection_ =
@@ -985,6 +990,18 @@ void Split::resizeEvent(QResizeEvent *event)
     this->overlay_->setGeometry(this->rect());
 }
 
+void Split::showEvent(QShowEvent *event)
+{
+    // Channels in tabs that were hidden at startup are only loaded once
+    // they're shown (see WindowManager::deferHiddenChannels)
+    if (auto *tc = dynamic_cast<TwitchChannel *>(this->getChannel().get()))
+    {
+        tc->hydrate();
+    }
+
+    BaseWidget::showEvent(event);
+}
+
 void Split::enterEvent(QEnterEvent * /*event*/)
 {
     this->isMouseOver_ = true;
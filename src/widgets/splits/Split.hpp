@@ -110,6 +110,7 @@ protected:
     void keyPressEvent(QKeyEvent *event) override;
     void keyReleaseEvent(QKeyEvent *event) override;
     void resizeEvent(QResizeEvent *event) override;
+    void showEvent(QShowEvent *event) override;
     void enterEvent(QEnterEvent * /*event*/) override;
     void leaveEvent(QEvent *event) override;
 
@@ -169,3 +169,43 @@ TEST(Emojis, Parse)
         }
     }
 }
+
+TEST(Emojis, ParseEveryEmoji)
+{
+    Emojis emojis;
+
+    emojis.load();
+
+    for (const auto &emoji : emojis.getEmojis())
+    {
+        for (const auto &text : {emoji->value, emoji->nonQualified})
+        {
+            if (text.isNull())
+            {
+                continue;
+            }
+
+            auto output = emojis.parse(text);
+            ASSERT_EQ(output.size(), 1) << emoji->unifiedCode;
+            const auto *emote = boost::get<EmotePtr>(&output[0]);
+            ASSERT_NE(emote, nullptr) << emoji->unifiedCode;
+            EXPECT_EQ(emote->get(), emoji->emote.get()) << emoji->unifiedCode;
+        }
+    }
+}
+
+TEST(Emojis, EveryShortCode)
+{
+    Emojis emojis;
+
+    emojis.load();
+
+    for (const auto &emoji : emojis.getEmojis())
+    {
+        for (const auto &shortCode : emoji->shortCodes)
+        {
+            auto output = emojis.replaceShortCodes(':' + shortCode + ':');
+            EXPECT_FALSE(output.startsWith(':')) << shortCode;
+        }
+    }
+}
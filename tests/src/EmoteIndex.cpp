@@ -0,0 +1,155 @@
+#include "messages/EmoteIndex.hpp"
+
+#include "messages/Emote.hpp"
+#include "messages/MessageElement.hpp"
+#include "Test.hpp"
+
+using namespace chatterino;
+
+namespace {
+
+EmoteMap makeMap(const QString &provider, const QStringList &names)
+{
+    EmoteMap map;
+    for (const auto &name : names)
+    {
+        map[EmoteName{name}] = std::make_shared<const Emote>(Emote{
+            .name = EmoteName{name},
+            .author = EmoteAuthor{provider},
+        });
+    }
+    return map;
+}
+
+}  // namespace
+
+TEST(EmoteIndex, Empty)
+{
+    EmoteIndex index;
+    ASSERT_EQ(index.size(), 0U);
+    ASSERT_EQ(index.find(u"Kappa"), nullptr);
+    ASSERT_NE(index.builtWithGlobalsGeneration(),
+              EmoteIndex::globalsGeneration());
+
+    EmoteIndex empty({}, 1);
+    ASSERT_EQ(empty.size(), 0U);
+    ASSERT_EQ(empty.find(u"Kappa"), nullptr);
+}
+
+TEST(EmoteIndex, Precedence)
+{
+    auto ffz = makeMap("ffz", {"a", "shared"});
+    auto bttv = makeMap("bttv", {"b", "shared", "bttvAndSeventv"});
+    auto seventv = makeMap("seventv", {"c", "bttvAndSeventv"});
+
+    EmoteIndex index(
+        {
+            {&ffz, MessageElementFlag::FfzEmote},
+            {nullptr, MessageElementFlag::FfzEmote},
+            {&bttv, MessageElementFlag::BttvEmote},
+            {&seventv, MessageElementFlag::SevenTVEmote},
+        },
+        0);
+    ASSERT_EQ(index.size(), 5U);
+
+    struct Case {
+        QString name;
+        QString author;
+        MessageElementFlag flag;
+    };
+    std::vector<Case> cases{
+        {"a", "ffz", MessageElementFlag::FfzEmote},
+        {"b", "bttv", MessageElementFlag::BttvEmote},
+        {"c", "seventv", MessageElementFlag::SevenTVEmote},
+        {"shared", "ffz", MessageElementFlag::FfzEmote},
+        {"bttvAndSeventv", "bttv", MessageElementFlag::BttvEmote},
+    };
+    for (const auto &c : cases)
+    {
+        const auto *entry = index.find(c.name);
+        ASSERT_NE(entry, nullptr) << c.name;
+        ASSERT_EQ(entry->name, c.name);
+        ASSERT_EQ(entry->emote->author.string, c.author) << c.name;
+        ASSERT_EQ(entry->flag, c.flag) << c.name;
+    }
+
+    ASSERT_EQ(index.find(u"A"), nullptr);
+    ASSERT_EQ(index.find(u"d"), nullptr);
+    ASSERT_EQ(index.find(u""), nullptr);
+}
+
+TEST(EmoteIndex, ManyEmotes)
+{
+    QStringList names;
+    for (int i = 0; i < 5000; i++)
+    {
+        names.append(QString::number(i));
+    }
+    auto map = makeMap("bttv", names);
+
+    EmoteIndex index({{&map, MessageElementFlag::BttvEmote}}, 0);
+    ASSERT_EQ(index.size(), 5000U);
+    for (const auto &name : names)
+    {
+        const auto *entry = index.find(name);
+        ASSERT_NE(entry, nullptr) << name;
+        ASSERT_EQ(entry->name, name);
+    }
+    ASSERT_EQ(index.find(u"5000"), nullptr);
+    ASSERT_EQ(index.find(u"-1"), nullptr);
+}
+
+TEST(EmoteIndex, GlobalsGeneration)
+{
+    auto before = EmoteIndex::globalsGeneration();
+    EmoteIndex index({}, before);
+    ASSERT_EQ(index.builtWithGlobalsGeneration(),
+              EmoteIndex::globalsGeneration());
+
+    EmoteIndex::invalidateGlobals();
+    ASSERT_GT(EmoteIndex::globalsGeneration(), before);
+    ASSERT_NE(index.builtWithGlobalsGeneration(),
+              EmoteIndex::globalsGeneration());
+}
+
+TEST(EmoteIndex, WithChanges)
+{
+    auto ffz = makeMap("ffz", {"a", "shared"});
+    auto bttv = makeMap("bttv", {"b", "shared"});
+    std::vector<EmoteIndex::Source> sources{
+        {&ffz, MessageElementFlag::FfzEmote},
+        {&bttv, MessageElementFlag::BttvEmote},
+    };
+    EmoteIndex index(sources, 0);
+    ASSERT_EQ(index.size(), 3U);
+
+    // Removing a shadowing emote reveals the next source's emote
+    ffz.erase(EmoteName{"shared"});
+    auto removed = index.withChanges(sources, {"shared"});
+    ASSERT_EQ(removed.size(), 3U);
+    ASSERT_EQ(removed.find(u"shared")->emote->author.string, "bttv");
+    ASSERT_EQ(removed.find(u"shared")->flag, MessageElementFlag::BttvEmote);
+
+    // The original index is unchanged
+    ASSERT_EQ(index.find(u"shared")->emote->author.string, "ffz");
+
+    // Added and removed emotes
+    bttv.erase(EmoteName{"b"});
+    bttv[EmoteName{"c"}] = std::make_shared<const Emote>(Emote{
+        .name = EmoteName{"c"},
+        .author = EmoteAuthor{"bttv"},
+    });
+    auto changed = removed.withChanges(sources, {"b", "c"});
+    ASSERT_EQ(changed.size(), 3U);
+    ASSERT_EQ(changed.find(u"b"), nullptr);
+    ASSERT_NE(changed.find(u"c"), nullptr);
+    ASSERT_EQ(changed.find(u"c")->name, "c");
+    ASSERT_NE(changed.find(u"a"), nullptr);
+    ASSERT_NE(removed.find(u"b"), nullptr);
+    ASSERT_EQ(removed.find(u"c"), nullptr);
+
+    // Names that aren't in any source are ignored
+    auto unknown = changed.withChanges(sources, {"d"});
+    ASSERT_EQ(unknown.size(), 3U);
+    ASSERT_EQ(unknown.find(u"d"), nullptr);
+}
@@ -1,6 +1,7 @@
 #include "controllers/accounts/AccountController.hpp"
 #include "controllers/filters/lang/expressions/UnaryOperation.hpp"
 #include "controllers/filters/lang/Filter.hpp"
+#include "controllers/filters/lang/MessageContext.hpp"
 #include "controllers/filters/lang/Types.hpp"
 #include "controllers/highlights/HighlightController.hpp"
 #include "messages/MessageBuilder.hpp"
@@ -15,6 +16,7 @@
 #include "providers/ffz/FfzBadges.hpp"
 #include "providers/seventv/SeventvBadges.hpp"
 #include "providers/twitch/TwitchBadge.hpp"
+#include "providers/twitch/TwitchBadges.hpp"
 #include "Test.hpp"
 
 #include <QColor>
@@ -74,6 +76,11 @@ public:
         return &this->highlights;
     }
 
+    TwitchBadges *getTwitchBadges() override
+    {
+        return &this->twitchBadges;
+    }
+
     ILogging *getChatLogger() override
     {
         return &this->logging;
@@ -88,6 +95,7 @@ public:
     FfzBadges ffzBadges;
     SeventvBadges seventvBadges;
     HighlightController highlights;
+    TwitchBadges twitchBadges;
 };
 
 class FiltersF : public ::testing::Test
@@ -297,6 +305,69 @@ TEST_F(FiltersF, TypingContextChecks)
     delete privmsg;
 }
 
+TEST_F(FiltersF, CompiledEvaluation)
+{
+    MockChannel channel("pajlada");
+
+    QByteArray message =
+        R"(@badge-info=subscriber/80;badges=broadcaster/1,subscriber/3072,partner/1;color=#CC44FF;display-name=pajlada;emote-only=1;emotes=25:0-4;first-msg=0;flags=;id=90ef1e46-8baa-4bf2-9c54-272f39d6fa11;mod=0;returning-chatter=0;room-id=11148817;subscriber=1;tmi-sent-ts=1662206235860;turbo=0;user-id=11148817;user-type= :pajlada!pajlada@pajlada.tmi.twitch.tv PRIVMSG #pajlada :ACTION Kappa)";
+
+    auto *privmsg = dynamic_cast<Communi::IrcPrivateMessage *>(
+        Communi::IrcPrivateMessage::fromData(message, nullptr));
+    EXPECT_NE(privmsg, nullptr);
+
+    QString originalMessage = privmsg->content();
+
+    auto [msg, alert] = MessageBuilder::makeIrcMessage(
+        &channel, privmsg, MessageParseArgs{}, originalMessage, 0);
+
+    EXPECT_NE(msg.get(), nullptr);
+
+    auto contextMap = buildContextMap(msg, &channel);
+
+    // clang-format off
+    std::vector<QString> tests{
+        R".(1 + 1).",
+        R".(author.name).",
+        R".(author.name == "PAJLADA").",
+        R".(author.badges contains "broadcaster").",
+        R".(author.subbed && author.sub_length > 40).",
+        R".(!author.subbed || flags.action).",
+        R".(author.no_color || author.color == "#cc44ff").",
+        R".(channel.name + "/" + author.user_id).",
+        R".({author.name, channel.name} contains "pajlada").",
+        R".({author.name, message.length} contains "pajlada").",
+        R".(message.content match r"kappa").",
+        R".(message.content match ri"kappa").",
+        R".(message.content match {r"(\w)appa", 1}).",
+        R".(message.length * 2 - 1).",
+        R".(reward.cost < 0 && reward.title == "").",
+        R".(channel.live || channel.watching).",
+    };
+    // clang-format on
+
+    for (const auto &input : tests)
+    {
+        auto filterResult = Filter::fromString(input);
+        bool isValid = std::holds_alternative<Filter>(filterResult);
+        ASSERT_TRUE(isValid)
+            << "Filter::fromString( " << input << " ) is invalid";
+
+        auto filter = std::move(std::get<Filter>(filterResult));
+        MessageContext context(*msg, &channel);
+
+        auto expected = filter.execute(contextMap);
+        auto result = filter.execute(context);
+
+        EXPECT_EQ(result, expected)
+            << "Compiled filter{ " << input << " } evaluated to "
+            << result.toString() << " instead of " << expected.toString()
+            << ".\nDebug: " << filter.debugString(MESSAGE_TYPING_CONTEXT);
+    }
+
+    delete privmsg;
+}
+
 TEST_F(FiltersF, ExpressionDebug)
 {
     struct TestCase {
@@ -0,0 +1,50 @@
+#include "messages/Image.hpp"
+
+#include "Test.hpp"
+#include "util/Metrics.hpp"
+
+#include <QBuffer>
+#include <QImageReader>
+
+using namespace chatterino;
+
+namespace {
+
+/// A 1x1 animated WebP with three frames lasting 100, 200 and 300 ms
+const QByteArray ANIMATED_WEBP = QByteArray::fromBase64(
+    "UklGRq4AAABXRUJQVlA4WAoAAAASAAAAAAAAAAAAQU5JTQYAAAD/////AABBTk1GJgAAAAAAAA"
+    "AAAAAAAAAAAGQAAABWUDhMDQAAAC8AAAAQBxAREYiI/gcAQU5NRiYAAAAAAAAAAAAAAAAAAADI"
+    "AAAAVlA4TA0AAAAvAAAAEAcQERGIiP4HAEFOTUYmAAAAAAAAAAAAAAAAAAAALAEAAFZQOEwNAA"
+    "AALwAAABAHEBERiIj+BwA=");
+
+}  // namespace
+
+TEST(Image, readFramesDecodesLazily)
+{
+    if (!QImageReader::supportedImageFormats().contains("webp"))
+    {
+        GTEST_SKIP() << "WebP isn't supported";
+    }
+
+    QBuffer buffer;
+    buffer.setData(ANIMATED_WEBP);
+    QImageReader reader(&buffer);
+    ASSERT_EQ(reader.imageCount(), 3);
+
+    const metrics::Counter decoded("decoded image frames");
+    auto decodedBefore = decoded.value();
+
+    auto frames = detail::readFrames(reader, {"animated.webp"}, 1);
+
+    // Only the first frame is decoded, the others are skipped
+    ASSERT_EQ(decoded.value() - decodedBefore, 1);
+    ASSERT_EQ(frames.size(), 3);
+    ASSERT_FALSE(frames[0].image.isNull());
+    ASSERT_TRUE(frames[1].image.isNull());
+    ASSERT_TRUE(frames[2].image.isNull());
+
+    // Skipped frames still know how long they're shown
+    ASSERT_EQ(frames[0].duration, 100);
+    ASSERT_EQ(frames[1].duration, 200);
+    ASSERT_EQ(frames[2].duration, 300);
+}
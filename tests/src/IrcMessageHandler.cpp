@@ -5,6 +5,7 @@
 #include "controllers/highlights/HighlightController.hpp"
 #include "controllers/ignores/IgnorePhrase.hpp"
 #include "controllers/sound/NullBackend.hpp"
+#include "debug/AssertInGuiThread.hpp"
 #include "lib/Snapshot.hpp"
 #include "messages/Emote.hpp"
 #include "messages/Message.hpp"
@@ -27,9 +28,11 @@
 #include "singletons/Emotes.hpp"
 #include "Test.hpp"
 #include "util/IrcHelpers.hpp"
+#include "util/OrderedTaskQueue.hpp"
 #include "util/VectorMessageSink.hpp"
 
 #include <IrcConnection>
+#include <QCoreApplication>
 #include <QDebug>
 #include <QDir>
 #include <QFile>
@@ -39,6 +42,7 @@
 #include <QJsonValue>
 #include <QString>
 
+#include <chrono>
 #include <unordered_map>
 #include <vector>
 
@@ -58,6 +62,15 @@ constexpr bool UPDATE_SNAPSHOTS = false;
 
 const QString IRC_CATEGORY = u"IrcMessageHandler"_s;
 
+/// The application's getters may only be used from the GUI thread
+template <typename T>
+T *fromGuiThread(T *service)
+{
+    EXPECT_TRUE(isGuiThread()) << "An application getter was used off the GUI "
+                                  "thread";
+    return service;
+}
+
 class MockApplication : public mock::BaseApplication
 {
 public:
@@ -74,77 +87,77 @@ public:
 
     IEmotes *getEmotes() override
     {
-        return &this->emotes;
+        return fromGuiThread(&this->emotes);
     }
 
     IUserDataController *getUserData() override
     {
-        return &this->userData;
+        return fromGuiThread(&this->userData);
     }
 
     AccountController *getAccounts() override
     {
-        return &this->accounts;
+        return fromGuiThread(&this->accounts);
     }
 
     ITwitchIrcServer *getTwitch() override
     {
-        return &this->twitch;
+        return fromGuiThread(&this->twitch);
     }
 
     IChatterinoBadges *getChatterinoBadges() override
     {
-        return &this->chatterinoBadges;
+        return fromGuiThread(&this->chatterinoBadges);
     }
 
     FfzBadges *getFfzBadges() override
     {
-        return &this->ffzBadges;
+        return fromGuiThread(&this->ffzBadges);
     }
 
     SeventvBadges *getSeventvBadges() override
     {
-        return &this->seventvBadges;
+        return fromGuiThread(&this->seventvBadges);
     }
 
     HighlightController *getHighlights() override
     {
-        return &this->highlights;
+        return fromGuiThread(&this->highlights);
     }
 
     BttvEmotes *getBttvEmotes() override
     {
-        return &this->bttvEmotes;
+        return fromGuiThread(&this->bttvEmotes);
     }
 
     FfzEmotes *getFfzEmotes() override
     {
-        return &this->ffzEmotes;
+        return fromGuiThread(&this->ffzEmotes);
     }
 
     SeventvEmotes *getSeventvEmotes() override
     {
-        return &this->seventvEmotes;
+        return fromGuiThread(&this->seventvEmotes);
     }
 
     ILogging *getChatLogger() override
     {
-        return &this->logging;
+        return fromGuiThread(&this->logging);
     }
 
     TwitchBadges *getTwitchBadges() override
     {
-        return &this->twitchBadges;
+        return fromGuiThread(&this->twitchBadges);
     }
 
     ILinkResolver *getLinkResolver() override
     {
-        return &this->linkResolver;
+        return fromGuiThread(&this->linkResolver);
     }
 
     ISoundController *getSound() override
     {
-        return &this->sound;
+        return fromGuiThread(&this->sound);
     }
 
     mock::EmptyLogging logging;
@@ -620,6 +633,86 @@ TEST_P(TestIrcMessageHandlerP, Run)
         << QJsonDocument(got).toJson() << "\ninstead.";
 }
 
+/// Builds the PRIVMSGs of the snapshots on a worker thread like
+/// TwitchIrcServer does and checks that the same messages are added to the
+/// channel. Inputs that are handled on the GUI thread are skipped.
+TEST_P(TestIrcMessageHandlerP, RunAsync)
+{
+    auto channel = makeMockTwitchChannel(u"pajlada"_s, *snapshot);
+    this->mockApplication->twitch.mockChannels.emplace("pajlada", channel);
+
+    const auto &userData = snapshot->param("userData").toObject();
+    for (auto it = userData.begin(); it != userData.end(); ++it)
+    {
+        const auto &data = it.value().toObject();
+        if (auto color = data.value("color").toString(); !color.isEmpty())
+        {
+            this->mockApplication->getUserData()->setUserColor(it.key(),
+                                                               color);
+        }
+    }
+
+    std::unique_ptr<Communi::IrcMessage> ircMessage(
+        Communi::IrcMessage::fromData(snapshot->inputUtf8(), nullptr));
+    ASSERT_NE(ircMessage, nullptr);
+    auto *privmsg =
+        dynamic_cast<Communi::IrcPrivateMessage *>(ircMessage.get());
+    if (privmsg == nullptr || privmsg->target() != u"#pajlada")
+    {
+        GTEST_SKIP() << "Only PRIVMSGs to #pajlada are built asynchronously";
+    }
+    auto roomID = privmsg->tag(u"room-id"_s).toString();
+    if (roomID.isEmpty())
+    {
+        GTEST_SKIP() << "Messages without a room-id are built on the GUI "
+                        "thread";
+    }
+    channel->setRoomId(roomID);
+
+    for (auto prevInput : snapshot->param("prevMessages").toArray())
+    {
+        std::unique_ptr<Communi::IrcMessage> prevMessage(
+            Communi::IrcMessage::fromData(prevInput.toString().toUtf8(),
+                                          nullptr));
+        ASSERT_NE(prevMessage, nullptr);
+        IrcMessageHandler::parseMessageInto(prevMessage.get(), *channel,
+                                            channel.get());
+    }
+
+    auto nAdditionalMessages = snapshot->param("nAdditional").toInt(0);
+    ASSERT_GE(channel->getMessageSnapshot().size(), nAdditionalMessages);
+    auto firstAddedMsg =
+        channel->getMessageSnapshot().size() - nAdditionalMessages;
+
+    auto build = IrcMessageHandler::instance().prepareAsyncPrivMessage(
+        privmsg, this->mockApplication->twitch);
+    if (!build)
+    {
+        GTEST_SKIP() << "The message is built on the GUI thread";
+    }
+
+    OrderedTaskQueue queue(2);
+    queue.push(std::move(build));
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+    while (!queue.idle() && std::chrono::steady_clock::now() < deadline)
+    {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    ASSERT_TRUE(queue.idle());
+
+    auto messages = channel->getMessageSnapshot();
+    QJsonArray got;
+    for (auto i = firstAddedMsg; i < messages.size(); i++)
+    {
+        got.append(messages[i]->toJson());
+    }
+
+    ASSERT_TRUE(snapshot->run(got, false))
+        << "Snapshot " << snapshot->name() << " failed. Expected JSON to be\n"
+        << QJsonDocument(snapshot->output().toArray()).toJson() << "\nbut got\n"
+        << QJsonDocument(got).toJson() << "\ninstead.";
+}
+
 INSTANTIATE_TEST_SUITE_P(
     IrcMessage, TestIrcMessageHandlerP,
     testing::ValuesIn(testlib::Snapshot::discover(IRC_CATEGORY)));
@@ -1,7 +1,12 @@
 #include "messages/LimitedQueue.hpp"
 
 #include "Test.hpp"
+#include "util/QStringHash.hpp"
 
+#include <QString>
+#include <QStringView>
+
+#include <array>
 #include <vector>
 
 using namespace chatterino;
@@ -264,3 +269,211 @@ TEST(LimitedQueue, Find)
                            })
                      .has_value());
 }
+
+namespace {
+
+using KeyedItem = std::pair<int, int>;
+
+struct KeyOfItem {
+    int operator()(const KeyedItem &item) const
+    {
+        return item.first;
+    }
+};
+
+using NamedItem = std::pair<QString, int>;
+
+struct NameOfItem {
+    using Hash = TransparentQStringHash;
+
+    const QString &operator()(const NamedItem &item) const
+    {
+        return item.first;
+    }
+};
+
+}  // namespace
+
+TEST(LimitedQueue, FindByKey)
+{
+    LimitedQueue<KeyedItem, KeyOfItem> queue(4);
+    auto valueOf = [&](int key) {
+        return queue.findByKey(key).value_or(KeyedItem{-1, -1}).second;
+    };
+    auto keysAre = [&](const std::vector<int> &keys) {
+        auto snapshot = queue.getSnapshot();
+        if (snapshot.size() != keys.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            if (snapshot[i].first != keys[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    queue.pushBack({1, 10});
+    queue.pushBack({2, 20});
+    queue.pushBack({3, 30});
+    EXPECT_EQ(valueOf(1), 10);
+    EXPECT_EQ(valueOf(2), 20);
+    EXPECT_EQ(valueOf(3), 30);
+    EXPECT_FALSE(queue.findByKey(4).has_value());
+
+    // the newest item with a key wins
+    queue.pushBack({1, 11});
+    EXPECT_EQ(valueOf(1), 11);
+
+    // evicting the older item with the same key keeps the newer one
+    KeyedItem deleted;
+    EXPECT_TRUE(queue.pushBack({4, 40}, deleted));
+    EXPECT_TRUE(deleted == KeyedItem(1, 10));
+    EXPECT_EQ(valueOf(1), 11);
+    EXPECT_EQ(valueOf(4), 40);
+
+    EXPECT_TRUE(queue.pushBack({5, 50}));
+    EXPECT_FALSE(queue.findByKey(2).has_value());
+    EXPECT_TRUE(keysAre({3, 1, 4, 5}));
+
+    // replacing
+    EXPECT_EQ(queue.replaceItem(KeyedItem{4, 40}, KeyedItem{6, 60}), 2);
+    EXPECT_FALSE(queue.findByKey(4).has_value());
+    EXPECT_EQ(valueOf(6), 60);
+    EXPECT_TRUE(queue.replaceItem(std::size_t(0), KeyedItem{3, 31}));
+    EXPECT_EQ(valueOf(3), 31);
+    EXPECT_EQ(queue.replaceItem(1, KeyedItem{1, 11}, KeyedItem{7, 70}), 1);
+    EXPECT_FALSE(queue.findByKey(1).has_value());
+    EXPECT_EQ(valueOf(7), 70);
+
+    // inserting into a full queue removes the first item
+    EXPECT_TRUE(queue.insertAfter(KeyedItem{7, 70}, KeyedItem{8, 80}));
+    EXPECT_FALSE(queue.findByKey(3).has_value());
+    EXPECT_EQ(valueOf(8), 80);
+    EXPECT_TRUE(keysAre({7, 8, 6, 5}));
+
+    // an inserted item doesn't shadow a newer item with the same key
+    EXPECT_TRUE(queue.insertBefore(KeyedItem{6, 60}, KeyedItem{5, 51}));
+    EXPECT_EQ(valueOf(5), 50);
+    EXPECT_FALSE(queue.findByKey(7).has_value());
+
+    queue.clear();
+    EXPECT_FALSE(queue.findByKey(5).has_value());
+    EXPECT_FALSE(queue.findByKey(8).has_value());
+
+    // items pushed to the front are older than existing ones
+    queue.pushBack({1, 12});
+    auto pushed = queue.pushFront({{1, 13}, {2, 21}});
+    EXPECT_EQ(pushed.size(), 2U);
+    EXPECT_EQ(valueOf(1), 12);
+    EXPECT_EQ(valueOf(2), 21);
+}
+
+TEST(LimitedQueue, FindByKeyView)
+{
+    LimitedQueue<NamedItem, NameOfItem> queue(4);
+    queue.pushBack({"abc", 1});
+    queue.pushBack({"def", 2});
+
+    QString ids = "xabcdefx";
+    EXPECT_EQ(queue.findByKey(QStringView{ids}.mid(1, 3))->second, 1);
+    EXPECT_EQ(queue.findByKey(QStringView{ids}.mid(4, 3))->second, 2);
+    EXPECT_FALSE(queue.findByKey(QStringView{ids}.mid(2, 3)).has_value());
+    EXPECT_EQ(queue.findByKey(QString("def"))->second, 2);
+}
+
+TEST(LimitedQueue, SnapshotsKeepTheirItems)
+{
+    LimitedQueue<int> queue(3);
+    queue.pushBack(1);
+    queue.pushBack(2);
+    queue.pushBack(3);
+
+    auto snapshot = queue.getSnapshot();
+    auto copy = snapshot;
+
+    // wrap around the storage several times
+    for (int i = 4; i < 12; ++i)
+    {
+        queue.pushBack(i);
+    }
+    SNAPSHOT_EQUALS(snapshot, {1, 2, 3}, "after push back");
+    SNAPSHOT_EQUALS(queue.getSnapshot(), {9, 10, 11}, "pushed");
+
+    auto snapshot2 = queue.getSnapshot();
+    EXPECT_TRUE(queue.replaceItem(10, 20) == 1);
+    EXPECT_TRUE(queue.insertBefore(11, 15));
+    SNAPSHOT_EQUALS(snapshot2, {9, 10, 11}, "after replace and insert");
+    SNAPSHOT_EQUALS(queue.getSnapshot(), {20, 15, 11}, "replaced and inserted");
+
+    auto snapshot3 = queue.getSnapshot();
+    queue.clear();
+    queue.pushFront({1, 2});
+    queue.pushBack(3);
+    SNAPSHOT_EQUALS(snapshot3, {20, 15, 11}, "after clear");
+    SNAPSHOT_EQUALS(copy, {1, 2, 3}, "copy");
+    SNAPSHOT_EQUALS(queue.getSnapshot(), {1, 2, 3}, "refilled");
+
+    std::vector<int> reversed(snapshot3.rbegin(), snapshot3.rend());
+    EXPECT_EQ(reversed, (std::vector<int>{11, 15, 20}));
+}
+
+namespace {
+
+/// Items are grouped by their first and second value
+struct GroupsOfItem {
+    std::array<int, 2> operator()(const KeyedItem &item) const
+    {
+        if (item.first == item.second)
+        {
+            return {item.first, 0};
+        }
+        return {item.first, item.second};
+    }
+};
+
+}  // namespace
+
+TEST(LimitedQueue, FindAllInGroup)
+{
+    LimitedQueue<KeyedItem, void, GroupsOfItem> queue(4);
+    auto groupIs = [&](int key, const std::vector<KeyedItem> &items) {
+        return queue.findAllInGroup(key) == items;
+    };
+
+    queue.pushBack({1, 2});
+    queue.pushBack({2, 2});
+    queue.pushBack({3, 1});
+    EXPECT_TRUE(groupIs(1, {{1, 2}, {3, 1}}));
+    EXPECT_TRUE(groupIs(2, {{1, 2}, {2, 2}}));
+    EXPECT_TRUE(groupIs(3, {{3, 1}}));
+    EXPECT_TRUE(groupIs(4, {}));
+    // default constructed keys aren't grouped
+    EXPECT_TRUE(groupIs(0, {}));
+
+    // eviction
+    queue.pushBack({4, 4});
+    queue.pushBack({1, 5});
+    EXPECT_TRUE(groupIs(1, {{3, 1}, {1, 5}}));
+    EXPECT_TRUE(groupIs(2, {{2, 2}}));
+
+    // replacing
+    EXPECT_EQ(queue.replaceItem(KeyedItem{2, 2}, KeyedItem{3, 3}), 0);
+    EXPECT_TRUE(groupIs(2, {}));
+    EXPECT_TRUE(groupIs(3, {{3, 3}, {3, 1}}));
+
+    // inserting moves the following items
+    EXPECT_TRUE(queue.insertBefore(KeyedItem{1, 5}, KeyedItem{5, 3}));
+    EXPECT_TRUE(groupIs(3, {{3, 1}, {5, 3}}));
+    EXPECT_TRUE(groupIs(5, {{5, 3}, {1, 5}}));
+
+    queue.clear();
+    EXPECT_TRUE(groupIs(3, {}));
+
+    queue.pushBack({1, 2});
+    queue.pushFront({{2, 1}});
+    EXPECT_TRUE(groupIs(1, {{2, 1}, {1, 2}}));
+}
@@ -0,0 +1,71 @@
+#include "providers/links/LinkInfoCache.hpp"
+
+#include "common/Literals.hpp"
+#include "providers/links/LinkInfo.hpp"
+#include "Test.hpp"
+
+using namespace chatterino;
+using namespace literals;
+
+using State = LinkInfo::State;
+
+TEST(LinkInfoCache, sharesInfos)
+{
+    LinkInfoCache cache;
+
+    auto a = cache.get(u"https://chatterino.com"_s);
+    auto b = cache.get(u"https://chatterino.com"_s);
+    auto c = cache.get(u"https://www.chatterino.com"_s);
+
+    ASSERT_EQ(a, b);
+    ASSERT_NE(a, c);
+    ASSERT_EQ(a->originalUrl(), u"https://chatterino.com"_s);
+    ASSERT_EQ(c->originalUrl(), u"https://www.chatterino.com"_s);
+    ASSERT_EQ(a->state(), State::Created);
+    ASSERT_EQ(cache.size(), 2);
+}
+
+TEST(LinkInfoCache, limit)
+{
+    LinkInfoCache cache(2);
+
+    auto a = cache.get(u"https://a.com"_s);
+    auto b = cache.get(u"https://b.com"_s);
+    // a was used more recently than b
+    ASSERT_EQ(cache.get(u"https://a.com"_s), a);
+
+    auto c = cache.get(u"https://c.com"_s);
+    ASSERT_EQ(cache.size(), 2);
+    ASSERT_EQ(cache.get(u"https://a.com"_s), a);
+    ASSERT_EQ(cache.get(u"https://c.com"_s), c);
+
+    // b was evicted, but the old info is still usable
+    auto b2 = cache.get(u"https://b.com"_s);
+    ASSERT_NE(b, b2);
+    ASSERT_EQ(b->originalUrl(), u"https://b.com"_s);
+    ASSERT_EQ(cache.size(), 2);
+}
+
+TEST(LinkInfoCache, expiry)
+{
+    LinkInfoCache cache;
+    auto now = LinkInfoCache::Clock::now();
+
+    auto resolved = cache.get(u"https://a.com"_s, now);
+    resolved->setState(State::Loading);
+    resolved->setState(State::Resolved);
+    auto errored = cache.get(u"https://b.com"_s, now);
+    errored->setState(State::Errored);
+
+    auto later = now + LinkInfoCache::ERRORED_TTL;
+    ASSERT_EQ(cache.get(u"https://a.com"_s, later), resolved);
+    auto errored2 = cache.get(u"https://b.com"_s, later);
+    ASSERT_NE(errored2, errored);
+    ASSERT_EQ(errored2->state(), State::Created);
+
+    later = now + LinkInfoCache::RESOLVED_TTL;
+    auto resolved2 = cache.get(u"https://a.com"_s, later);
+    ASSERT_NE(resolved2, resolved);
+    ASSERT_EQ(resolved2->state(), State::Created);
+    ASSERT_EQ(cache.get(u"https://a.com"_s, later), resolved2);
+}
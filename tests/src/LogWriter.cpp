@@ -0,0 +1,165 @@
+#include "singletons/helper/LogWriter.hpp"
+
+#include "messages/Message.hpp"
+#include "Test.hpp"
+#include "util/Metrics.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QStringList>
+#include <QTemporaryDir>
+
+#include <chrono>
+#include <memory>
+
+using namespace chatterino;
+using namespace std::chrono_literals;
+
+namespace {
+
+LogWriterOptions makeOptions(const QTemporaryDir &dir)
+{
+    return {
+        .baseDirectory = dir.path(),
+        .timestampFormat = "Disable",
+        // only the byte threshold or the destructor should write anything
+        .flushInterval = 1h,
+        .flushThreshold = 64 * 1024,
+    };
+}
+
+MessagePtr makeMessage(const QString &text)
+{
+    auto message = std::make_shared<Message>();
+    message->messageText = text;
+    return message;
+}
+
+/// All lines logged for the Twitch channel @a channel without the opening and
+/// closing lines
+QStringList readLines(const QTemporaryDir &dir, const QString &channel)
+{
+    QDir channelDir(dir.filePath("Twitch/Channels/" + channel));
+    QStringList lines;
+    // there's more than one file if the date changed while logging
+    for (const auto &name :
+         channelDir.entryList({"*.log"}, QDir::Files, QDir::Name))
+    {
+        QFile file(channelDir.filePath(name));
+        EXPECT_TRUE(file.open(QIODevice::ReadOnly));
+        for (const auto &line :
+             QString::fromUtf8(file.readAll()).split('\n', Qt::SkipEmptyParts))
+        {
+            if (!line.startsWith("# "))
+            {
+                lines.append(line);
+            }
+        }
+    }
+    return lines;
+}
+
+}  // namespace
+
+TEST(LogWriter, keepsOrder)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    {
+        LogWriter writer(makeOptions(dir));
+        // stays below the queue capacity, so nothing can be dropped
+        for (int i = 0; i < 3000; i++)
+        {
+            writer.addMessage("forsen", "twitch",
+                              makeMessage(QString::number(i)), {});
+            writer.addMessage("pajlada", "twitch",
+                              makeMessage(QString::number(-i)), {});
+        }
+    }
+
+    auto forsen = readLines(dir, "forsen");
+    auto pajlada = readLines(dir, "pajlada");
+    ASSERT_EQ(forsen.size(), 3000);
+    ASSERT_EQ(pajlada.size(), 3000);
+    for (int i = 0; i < 3000; i++)
+    {
+        ASSERT_EQ(forsen[i], QString::number(i));
+        ASSERT_EQ(pajlada[i], QString::number(-i));
+    }
+}
+
+TEST(LogWriter, flushesOnShutdown)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    {
+        LogWriter writer(makeOptions(dir));
+        writer.addMessage("forsen", "twitch", makeMessage("first"), {});
+        writer.addMessage("forsen", "twitch", makeMessage("second"), {});
+        // closing the channel writes its lines without waiting for a flush
+        writer.closeChannel("forsen", "twitch");
+        writer.addMessage("pajlada", "twitch", makeMessage("third"), {});
+    }
+
+    ASSERT_EQ(readLines(dir, "forsen"), QStringList({"first", "second"}));
+    ASSERT_EQ(readLines(dir, "pajlada"), QStringList({"third"}));
+
+    QDir channelDir(dir.filePath("Twitch/Channels/pajlada"));
+    auto files = channelDir.entryList({"*.log"}, QDir::Files);
+    ASSERT_EQ(files.size(), 1);
+    QFile file(channelDir.filePath(files.front()));
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+    ASSERT_TRUE(file.readAll().contains("# Stop logging at "));
+}
+
+TEST(LogWriter, spillsLinesWhenFull)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const metrics::Counter spilled("log lines spilled");
+    auto spilledBefore = spilled.value();
+
+    {
+        LogWriter writer(makeOptions(dir), 16);
+        writer.pauseForTesting();
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < 100; i++)
+        {
+            writer.addMessage("forsen", "twitch",
+                              makeMessage(QString::number(i)), {});
+        }
+        // A full queue never makes us wait for the writer
+        ASSERT_LT(std::chrono::steady_clock::now() - start, 1s);
+        ASSERT_EQ(spilled.value() - spilledBefore, 100 - 16);
+
+        // Closing a channel while spilling isn't lost either
+        writer.closeChannel("forsen", "twitch");
+        writer.addMessage("pajlada", "twitch", makeMessage("other"), {});
+
+        writer.resumeForTesting();
+        writer.addMessage("forsen", "twitch", makeMessage("after"), {});
+    }
+
+    auto lines = readLines(dir, "forsen");
+    ASSERT_EQ(lines.size(), 101);
+    for (int i = 0; i < 100; i++)
+    {
+        ASSERT_EQ(lines[i], QString::number(i));
+    }
+    ASSERT_EQ(lines.back(), "after");
+    ASSERT_EQ(readLines(dir, "pajlada"), QStringList({"other"}));
+
+    // The channel was closed in between, so its first file is terminated
+    QDir channelDir(dir.filePath("Twitch/Channels/forsen"));
+    QByteArray contents;
+    for (const auto &name : channelDir.entryList({"*.log"}, QDir::Files))
+    {
+        QFile file(channelDir.filePath(name));
+        ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+        contents += file.readAll();
+    }
+    ASSERT_EQ(contents.count("# Stop logging at "), 2);
+}
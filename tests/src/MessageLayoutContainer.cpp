@@ -11,8 +11,10 @@
 #include "singletons/Resources.hpp"
 #include "singletons/Theme.hpp"
 #include "Test.hpp"
+#include "util/Metrics.hpp"
 
 #include <memory>
+#include <utility>
 #include <vector>
 
 using namespace chatterino;
@@ -241,4 +243,54 @@ INSTANTIATE_TEST_SUITE_P(
             TextDirection::LTR,
         }));
 
+TEST(MessageLayoutContainer, RelayoutWithMeasuredWidths)
+{
+    MockApplication mockApplication;
+    auto &fonts = mockApplication.fonts;
+
+    TextElement element(u"aaaa bbbb cccc dddd"_s, MessageElementFlag::Text);
+    auto layout = [&](int width, float scale) {
+        MessageLayoutContainer container;
+        MessageLayoutContext ctx{
+            .messageColors = {},
+            .flags = MessageElementFlag::Text,
+            .width = width,
+            .scale = scale,
+            .imageScale = scale,
+        };
+        container.beginLayout(ctx.width, ctx.scale, ctx.imageScale, {});
+        element.addToContainer(container, ctx);
+        container.endLayout();
+
+        return std::pair{container.getWidth(), container.getHeight()};
+    };
+
+    const metrics::Counter measuredWords("measured text element words");
+    auto measured = [&, before = measuredWords.value()] {
+        return measuredWords.value() - before;
+    };
+
+    auto wordWidth = fonts.getWordWidth(FontStyle::ChatMedium, 1, u"aaaa"_s);
+    ASSERT_EQ(wordWidth, fonts.getFontMetrics(FontStyle::ChatMedium, 1)
+                             .horizontalAdvance(u"aaaa"_s));
+    auto narrowWidth = static_cast<int>(wordWidth * 2);
+
+    auto wide = layout(10000, 1);
+    ASSERT_EQ(measured(), 4);
+    auto narrow = layout(narrowWidth, 1);
+    ASSERT_GT(narrow.second, wide.second) << "expected a linebreak";
+
+    // Widths measured for the previous layout are reused
+    ASSERT_EQ(layout(10000, 1), wide);
+    ASSERT_EQ(layout(narrowWidth, 1), narrow);
+    ASSERT_EQ(measured(), 4);
+
+    // ...unless the scale changed
+    auto zoomed = layout(10000, 2);
+    ASSERT_GT(zoomed.first, wide.first);
+    ASSERT_EQ(measured(), 8);
+    ASSERT_EQ(layout(10000, 1), wide);
+    ASSERT_EQ(measured(), 12);
+}
+
 }  // namespace chatterino
@@ -0,0 +1,136 @@
+#include "messages/MessageSimilarity.hpp"
+
+#include "Test.hpp"
+
+#include <QStringList>
+
+#include <algorithm>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+/// The full table implementation this used to be
+float referenceSimilarity(QStringView str1, QStringView str2)
+{
+    std::vector<std::vector<int>> tree(str1.size(),
+                                       std::vector<int>(str2.size(), 0));
+    int z = 0;
+    for (qsizetype i = 0; i < str1.size(); ++i)
+    {
+        for (qsizetype j = 0; j < str2.size(); ++j)
+        {
+            if (str1[i] == str2[j])
+            {
+                tree[i][j] = (i == 0 || j == 0) ? 1 : tree[i - 1][j - 1] + 1;
+                z = std::max(tree[i][j], z);
+            }
+        }
+    }
+    if (z == 0)
+    {
+        return 0.F;
+    }
+    auto div = std::max({qsizetype{1}, str1.size(), str2.size()});
+    return float(z) / float(div);
+}
+
+const QStringList TEXTS{
+    "",
+    "a",
+    "forsen",
+    "forsenE",
+    "forsenE forsenE forsenE",
+    "forsenE forsenE forsenE forsenE",
+    "LULW he really just walked into that",
+    "he really just walked into that LULW",
+    "KEKW KEKW KEKW KEKW KEKW KEKW",
+    "is this the same game as yesterday",
+    "the quick brown fox jumps over the lazy dog",
+    "the quick brown fox jumps over the lazy cat",
+    "ÄÖÜ äöü ẞ 🙂🙂",
+};
+
+}  // namespace
+
+TEST(MessageSimilarity, RelativeSimilarity)
+{
+    for (const auto &a : TEXTS)
+    {
+        for (const auto &b : TEXTS)
+        {
+            EXPECT_FLOAT_EQ(relativeSimilarity(a, b), referenceSimilarity(a, b))
+                << a << " - " << b;
+        }
+    }
+}
+
+TEST(MessageSimilarity, ExceedsSimilarity)
+{
+    for (float threshold : {0.F, 0.1F, 0.5F, 0.9F, 0.99F, 1.F})
+    {
+        for (const auto &a : TEXTS)
+        {
+            for (const auto &b : TEXTS)
+            {
+                EXPECT_EQ(exceedsSimilarity(a, b, threshold),
+                          referenceSimilarity(a, b) > threshold)
+                    << a << " - " << b << " @ " << threshold;
+            }
+        }
+    }
+}
+
+TEST(MessageSimilarity, SketchAgreesWithExact)
+{
+    for (float threshold : {0.F, 0.1F, 0.5F, 0.9F, 0.99F, 1.F})
+    {
+        for (const auto &a : TEXTS)
+        {
+            for (const auto &b : TEXTS)
+            {
+                EXPECT_EQ(exceedsSimilarity(a, makeSimilaritySketch(a), b,
+                                            makeSimilaritySketch(b), threshold),
+                          exceedsSimilarity(a, b, threshold))
+                    << a << " - " << b << " @ " << threshold;
+            }
+        }
+    }
+}
+
+TEST(MessageSimilarity, SketchAroundThreshold)
+{
+    // The longest common substring is "the quick brown fox jumps over the
+    // lazy " (40 of 43 characters)
+    const QString a = "the quick brown fox jumps over the lazy dog";
+    const QString b = "the quick brown fox jumps over the lazy cat";
+    // Same characters, but hardly any common bigrams: only the prefilter
+    // rules these out without comparing them
+    const QString c = "god yzal eht revo spmuj xof nworb kciuq eht";
+
+    auto sketchA = makeSimilaritySketch(a);
+    auto sketchB = makeSimilaritySketch(b);
+    auto sketchC = makeSimilaritySketch(c);
+    auto similarity = relativeSimilarity(a, b);
+    ASSERT_FLOAT_EQ(similarity, 40.F / 43.F);
+
+    for (float threshold : {similarity - 0.01F, similarity, similarity + 0.01F})
+    {
+        EXPECT_EQ(exceedsSimilarity(a, sketchA, b, sketchB, threshold),
+                  similarity > threshold)
+            << threshold;
+    }
+
+    auto lowSimilarity = relativeSimilarity(a, c);
+    for (float threshold :
+         {lowSimilarity - 0.01F, lowSimilarity, lowSimilarity + 0.01F})
+    {
+        EXPECT_EQ(exceedsSimilarity(a, sketchA, c, sketchC, threshold),
+                  exceedsSimilarity(a, c, threshold))
+            << threshold;
+        EXPECT_EQ(exceedsSimilarity(a, c, threshold),
+                  lowSimilarity > threshold)
+            << threshold;
+    }
+}
@@ -0,0 +1,160 @@
+#include "util/Metrics.hpp"
+
+#include "Test.hpp"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <thread>
+#include <vector>
+
+using namespace chatterino;
+using namespace std::chrono_literals;
+
+TEST(Metrics, counterSumsThreads)
+{
+    const metrics::Counter counter("test counter threads");
+    ASSERT_EQ(counter.value(), 0);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; i++)
+    {
+        threads.emplace_back([&] {
+            for (int j = 0; j < 1000; j++)
+            {
+                counter.increase();
+            }
+            counter.decrease(10);
+        });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    ASSERT_EQ(counter.value(), 8 * 990);
+}
+
+TEST(Metrics, sameNameSharesValue)
+{
+    const metrics::Counter a("test counter shared");
+    const metrics::Counter b("test counter shared");
+    a.increase(3);
+    b.increase(4);
+    ASSERT_EQ(a.value(), 7);
+    ASSERT_EQ(b.value(), 7);
+
+    const metrics::Gauge gauge("test gauge");
+    gauge.set(42);
+    gauge.set(12);
+    ASSERT_EQ(metrics::Gauge("test gauge").value(), 12);
+}
+
+TEST(Metrics, kindMismatchIsNotRegistered)
+{
+    const metrics::Counter counter("test kind mismatch");
+    counter.increase(5);
+
+    // Reusing the name for a gauge gets a separate, unexported gauge
+    const metrics::Gauge gauge("test kind mismatch");
+    gauge.set(3);
+    ASSERT_EQ(gauge.value(), 3);
+    ASSERT_EQ(counter.value(), 5);
+
+    auto values = QJsonDocument::fromJson(metrics::toJson())
+                      .object()
+                      .value("values")
+                      .toObject();
+    ASSERT_EQ(values.value("test kind mismatch").toInteger(), 5);
+}
+
+TEST(Metrics, histogramQuantiles)
+{
+    const metrics::Histogram histogram("test histogram");
+    for (int i = 0; i < 98; i++)
+    {
+        histogram.record(3us);
+    }
+    histogram.record(100us);
+    histogram.record(5ms);
+
+    auto snapshot = histogram.snapshot();
+    ASSERT_EQ(snapshot.count, 100U);
+    ASSERT_EQ(snapshot.sum, 98 * 3us + 100us + 5ms);
+    // 3us is in [2us, 4us)
+    ASSERT_EQ(snapshot.quantile(0.5), 4us);
+    ASSERT_EQ(snapshot.quantile(0.99), 128us);
+    ASSERT_EQ(snapshot.quantile(1), 8192us);
+
+    {
+        auto timer = histogram.time();
+    }
+    ASSERT_EQ(histogram.snapshot().count, 101U);
+
+    const metrics::Histogram empty("test histogram empty");
+    ASSERT_EQ(empty.snapshot().quantile(0.5), 0us);
+}
+
+TEST(Metrics, openMetricsCollision)
+{
+    metrics::Counter("test collision").increase(1);
+    // Sanitized, this is the same name
+    const metrics::Counter other("Test-Collision");
+    other.increase(5);
+    ASSERT_EQ(other.value(), 5);
+
+    ASSERT_TRUE(metrics::toOpenMetrics().contains(
+        u"# TYPE chatterino_test_collision gauge\nchatterino_test_collision "
+        u"1\n"));
+    auto values = QJsonDocument::fromJson(metrics::toJson())
+                      .object()
+                      .value("values")
+                      .toObject();
+    ASSERT_FALSE(values.contains("Test-Collision"));
+}
+
+TEST(Metrics, openMetricsBucketBounds)
+{
+    const metrics::Histogram histogram("test open metrics bounds");
+    // Each duration is counted in the bucket whose bound it's equal to
+    histogram.record(1us);
+    histogram.record(2us);
+    histogram.record(2500ns);
+    histogram.record(4us);
+
+    auto text = metrics::toOpenMetrics();
+    ASSERT_TRUE(text.contains(
+        u"chatterino_test_open_metrics_bounds_seconds_bucket{le=\"1e-06\"} "
+        u"1\n"));
+    ASSERT_TRUE(text.contains(
+        u"chatterino_test_open_metrics_bounds_seconds_bucket{le=\"2e-06\"} "
+        u"2\n"));
+    ASSERT_TRUE(text.contains(
+        u"chatterino_test_open_metrics_bounds_seconds_bucket{le=\"4e-06\"} "
+        u"4\n"));
+}
+
+TEST(Metrics, openMetrics)
+{
+    metrics::Counter("test open metrics", metrics::Unit::Bytes).increase(2048);
+    metrics::Histogram("test open metrics time").record(3us);
+
+    auto text = metrics::toOpenMetrics();
+    ASSERT_TRUE(text.contains(u"# TYPE chatterino_test_open_metrics_bytes "
+                              u"gauge\nchatterino_test_open_metrics_bytes "
+                              u"2048\n"));
+    ASSERT_TRUE(text.contains(u"# TYPE chatterino_test_open_metrics_time_"
+                              u"seconds histogram\n"));
+    ASSERT_TRUE(text.contains(
+        u"chatterino_test_open_metrics_time_seconds_bucket{le=\"2e-06\"} 0\n"));
+    ASSERT_TRUE(text.contains(
+        u"chatterino_test_open_metrics_time_seconds_bucket{le=\"4e-06\"} 1\n"));
+    ASSERT_TRUE(text.contains(
+        u"chatterino_test_open_metrics_time_seconds_bucket{le=\"+Inf\"} 1\n"));
+    ASSERT_TRUE(
+        text.contains(u"chatterino_test_open_metrics_time_seconds_count 1\n"));
+    ASSERT_TRUE(text.endsWith(u"# EOF\n"));
+
+    ASSERT_TRUE(
+        metrics::debugText().contains(u"test open metrics: 2.00 KiB\n"));
+}
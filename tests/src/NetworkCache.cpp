@@ -0,0 +1,205 @@
+#include "common/network/NetworkCache.hpp"
+
+#include "Test.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+using namespace chatterino;
+using namespace chatterino::network::detail;
+
+namespace {
+
+const QString HASH_A(64, u'a');
+const QString HASH_B(64, u'b');
+const QString HASH_C(64, u'c');
+
+constexpr int64_t NOW = 1'700'000'000'000;
+constexpr int64_t HOUR = 60 * 60 * 1000;
+
+NetworkCache::Metadata fresh(int64_t now)
+{
+    return {
+        .etag = "\"etag\"",
+        .lastModified = "Tue, 14 Nov 2023 22:13:20 GMT",
+        .expires = now + HOUR,
+    };
+}
+
+}  // namespace
+
+class NetworkCacheTest : public ::testing::Test
+{
+protected:
+    QTemporaryDir dir;
+};
+
+TEST_F(NetworkCacheTest, readWrite)
+{
+    NetworkCache cache(this->dir.path(), 1024);
+    ASSERT_FALSE(cache.read(HASH_A, NOW).has_value());
+
+    cache.write(HASH_A, "body", fresh(NOW), NOW);
+    ASSERT_EQ(cache.totalSize(), 4);
+    ASSERT_TRUE(QFile::exists(this->dir.filePath(HASH_A)));
+
+    auto hit = cache.read(HASH_A, NOW + 1);
+    ASSERT_TRUE(hit.has_value());
+    ASSERT_EQ(hit->body, "body");
+    ASSERT_TRUE(hit->fresh);
+    ASSERT_EQ(hit->metadata.etag, "\"etag\"");
+
+    hit = cache.read(HASH_A, NOW + HOUR);
+    ASSERT_TRUE(hit.has_value());
+    ASSERT_FALSE(hit->fresh);
+
+    cache.refresh(HASH_A, {.expires = NOW + 2 * HOUR}, NOW + HOUR);
+    hit = cache.read(HASH_A, NOW + HOUR);
+    ASSERT_TRUE(hit.has_value());
+    ASSERT_TRUE(hit->fresh);
+    // validators are kept if the response doesn't repeat them
+    ASSERT_EQ(hit->metadata.etag, "\"etag\"");
+
+    // replacing a body updates the size
+    cache.write(HASH_A, "longer body", fresh(NOW), NOW);
+    ASSERT_EQ(cache.totalSize(), 11);
+    ASSERT_EQ(cache.size(), 1);
+}
+
+TEST_F(NetworkCacheTest, missingBody)
+{
+    NetworkCache cache(this->dir.path(), 1024);
+    cache.write(HASH_A, "body", fresh(NOW), NOW);
+    ASSERT_TRUE(QFile::remove(this->dir.filePath(HASH_A)));
+
+    ASSERT_FALSE(cache.read(HASH_A, NOW).has_value());
+    ASSERT_EQ(cache.size(), 0);
+    ASSERT_EQ(cache.totalSize(), 0);
+}
+
+TEST_F(NetworkCacheTest, eviction)
+{
+    NetworkCache cache(this->dir.path(), 10);
+    cache.write(HASH_A, "aaaa", fresh(NOW), NOW);
+    cache.write(HASH_B, "bbbb", fresh(NOW), NOW + 1);
+    // a is now used more recently than b
+    ASSERT_TRUE(cache.read(HASH_A, NOW + 2).has_value());
+
+    cache.write(HASH_C, "cccc", fresh(NOW), NOW + 3);
+    ASSERT_EQ(cache.size(), 2);
+    ASSERT_EQ(cache.totalSize(), 8);
+    ASSERT_TRUE(cache.read(HASH_A, NOW + 4).has_value());
+    ASSERT_FALSE(cache.read(HASH_B, NOW + 4).has_value());
+    ASSERT_FALSE(QFile::exists(this->dir.filePath(HASH_B)));
+    ASSERT_TRUE(cache.read(HASH_C, NOW + 4).has_value());
+
+    cache.setBudget(4);
+    ASSERT_EQ(cache.size(), 0);
+    ASSERT_EQ(cache.totalSize(), 0);
+}
+
+TEST_F(NetworkCacheTest, persistence)
+{
+    {
+        NetworkCache cache(this->dir.path(), 1024);
+        cache.write(HASH_A, "aaaa", fresh(NOW), NOW);
+        cache.write(HASH_B, "bb", {}, NOW);
+    }
+    ASSERT_TRUE(QFile::exists(
+        this->dir.filePath(QString(NetworkCache::INDEX_FILE_NAME))));
+
+    NetworkCache cache(this->dir.path(), 1024);
+    ASSERT_EQ(cache.size(), 2);
+    ASSERT_EQ(cache.totalSize(), 6);
+
+    auto hit = cache.read(HASH_A, NOW);
+    ASSERT_TRUE(hit.has_value());
+    ASSERT_TRUE(hit->fresh);
+    ASSERT_EQ(hit->metadata.etag, "\"etag\"");
+    ASSERT_EQ(hit->metadata.lastModified, "Tue, 14 Nov 2023 22:13:20 GMT");
+
+    hit = cache.read(HASH_B, NOW);
+    ASSERT_TRUE(hit.has_value());
+    ASSERT_FALSE(hit->fresh);
+    ASSERT_EQ(hit->body, "bb");
+}
+
+TEST_F(NetworkCacheTest, legacyFiles)
+{
+    for (const auto &name : {HASH_A, HASH_B, QString("other-file")})
+    {
+        QFile file(this->dir.filePath(name));
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        file.write("body");
+    }
+
+    NetworkCache cache(this->dir.path(), 1024);
+    ASSERT_EQ(cache.size(), 2);
+    ASSERT_EQ(cache.totalSize(), 8);
+
+    auto hit = cache.read(HASH_A, NOW);
+    ASSERT_TRUE(hit.has_value());
+    ASSERT_EQ(hit->body, "body");
+    ASSERT_TRUE(hit->metadata.etag.isEmpty());
+}
+
+TEST(NetworkCache, expiry)
+{
+    // max-age takes precedence over Expires
+    ASSERT_EQ(NetworkCache::expiryOf("public, max-age=60",
+                                     "Tue, 14 Nov 2023 22:13:20 GMT", {}, NOW),
+              NOW + 60'000);
+    ASSERT_EQ(NetworkCache::expiryOf("Max-Age=0", {}, {}, NOW), NOW);
+    ASSERT_EQ(NetworkCache::expiryOf("max-age=60, no-cache", {}, {}, NOW), NOW);
+    ASSERT_EQ(NetworkCache::expiryOf("no-store", {}, {}, NOW), NOW);
+
+    // 1700000000 is Tue, 14 Nov 2023 22:13:20 GMT
+    ASSERT_EQ(NetworkCache::expiryOf({}, "Tue, 14 Nov 2023 23:13:20 GMT", {},
+                                     NOW),
+              NOW + HOUR);
+    ASSERT_EQ(NetworkCache::expiryOf({}, "0", {}, NOW), NOW);
+
+    // a tenth of the age
+    ASSERT_EQ(NetworkCache::expiryOf({}, {}, "Tue, 14 Nov 2023 12:13:20 GMT",
+                                     NOW),
+              NOW + HOUR);
+    ASSERT_EQ(NetworkCache::expiryOf({}, {}, "Thu, 01 Jan 1970 00:00:00 GMT",
+                                     NOW),
+              NOW + NetworkCache::MAX_HEURISTIC_FRESHNESS_MS);
+
+    ASSERT_EQ(NetworkCache::expiryOf({}, {}, {}, NOW),
+              NOW + NetworkCache::DEFAULT_FRESHNESS_MS);
+}
+
+TEST_F(NetworkCacheTest, reconcile)
+{
+    {
+        NetworkCache cache(this->dir.path(), 1024);
+        cache.write(HASH_A, "aaaa", fresh(NOW), NOW);
+        cache.write(HASH_B, "bbbb", fresh(NOW), NOW);
+    }
+
+    // b was deleted and c was written after the index was last saved
+    ASSERT_TRUE(QFile::remove(this->dir.filePath(HASH_B)));
+    {
+        QFile file(this->dir.filePath(HASH_C));
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        file.write("cc");
+    }
+
+    NetworkCache cache(this->dir.path(), 1024);
+    ASSERT_EQ(cache.size(), 2);
+    ASSERT_EQ(cache.totalSize(), 6);
+
+    auto hit = cache.read(HASH_A, NOW);
+    ASSERT_TRUE(hit.has_value());
+    ASSERT_EQ(hit->metadata.etag, "\"etag\"");
+
+    hit = cache.read(HASH_C, NOW);
+    ASSERT_TRUE(hit.has_value());
+    ASSERT_EQ(hit->body, "cc");
+    ASSERT_TRUE(hit->metadata.etag.isEmpty());
+
+    ASSERT_FALSE(cache.read(HASH_B, NOW).has_value());
+}
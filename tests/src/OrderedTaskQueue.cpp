@@ -0,0 +1,102 @@
+#include "util/OrderedTaskQueue.hpp"
+
+#include "Test.hpp"
+
+#include <QCoreApplication>
+
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+void processEventsUntil(const std::function<bool()> &done)
+{
+    auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds{5};
+    while (!done() && std::chrono::steady_clock::now() < deadline)
+    {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+}
+
+}  // namespace
+
+TEST(OrderedTaskQueue, commitsInOrder)
+{
+    OrderedTaskQueue queue(4);
+    std::vector<int> committed;
+
+    for (int i = 0; i < 32; i++)
+    {
+        queue.push([i, &committed]() -> OrderedTaskQueue::Commit {
+            // make earlier tasks finish later
+            std::this_thread::sleep_for(std::chrono::milliseconds{32 - i});
+            return [i, &committed] {
+                committed.push_back(i);
+            };
+        });
+    }
+    ASSERT_FALSE(queue.idle());
+
+    processEventsUntil([&] {
+        return queue.idle();
+    });
+
+    ASSERT_EQ(committed.size(), 32);
+    for (int i = 0; i < 32; i++)
+    {
+        ASSERT_EQ(committed[i], i);
+    }
+}
+
+TEST(OrderedTaskQueue, commitOnlyWaitsForPending)
+{
+    OrderedTaskQueue queue(2);
+    std::vector<int> committed;
+
+    // nothing pending - runs immediately
+    queue.pushCommit([&] {
+        committed.push_back(0);
+    });
+    ASSERT_EQ(committed.size(), 1);
+
+    queue.push([&]() -> OrderedTaskQueue::Commit {
+        std::this_thread::sleep_for(std::chrono::milliseconds{20});
+        return [&] {
+            committed.push_back(1);
+        };
+    });
+    queue.pushCommit([&] {
+        committed.push_back(2);
+    });
+    ASSERT_EQ(committed.size(), 1);
+
+    processEventsUntil([&] {
+        return queue.idle();
+    });
+
+    ASSERT_EQ(committed, (std::vector<int>{0, 1, 2}));
+}
+
+TEST(OrderedTaskQueue, emptyCommit)
+{
+    OrderedTaskQueue queue(2);
+    bool committed = false;
+
+    queue.push([] {
+        return OrderedTaskQueue::Commit{};
+    });
+    queue.pushCommit([&] {
+        committed = true;
+    });
+
+    processEventsUntil([&] {
+        return queue.idle();
+    });
+
+    ASSERT_TRUE(committed);
+}
@@ -0,0 +1,116 @@
+#include "util/PersistentHashMap.hpp"
+
+#include "Test.hpp"
+
+#include <QString>
+
+#include <unordered_map>
+
+using namespace chatterino;
+
+namespace {
+
+/// Puts all keys with the same length into the same bucket
+struct LengthHash {
+    size_t operator()(const QString &s) const
+    {
+        return static_cast<size_t>(s.length());
+    }
+};
+
+template <typename Map>
+std::unordered_map<QString, int> toStd(const Map &map)
+{
+    std::unordered_map<QString, int> out;
+    for (const auto &[key, value] : map)
+    {
+        EXPECT_TRUE(out.emplace(key, value).second);
+    }
+    return out;
+}
+
+}  // namespace
+
+TEST(PersistentHashMap, Basic)
+{
+    PersistentHashMap<QString, int> map;
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(map.begin(), map.end());
+
+    map[QStringLiteral("a")] = 1;
+    ASSERT_TRUE(map.try_emplace(QStringLiteral("b"), 2).second);
+    ASSERT_FALSE(map.try_emplace(QStringLiteral("b"), 3).second);
+    ASSERT_TRUE(map.insert({QStringLiteral("c"), 3}).second);
+    ASSERT_FALSE(map.insert_or_assign(QStringLiteral("c"), 4).second);
+
+    ASSERT_EQ(map.size(), 3U);
+    ASSERT_EQ(map.at(QStringLiteral("a")), 1);
+    ASSERT_EQ(map.find(QStringLiteral("b"))->second, 2);
+    ASSERT_EQ(map.at(QStringLiteral("c")), 4);
+    ASSERT_FALSE(map.contains(QStringLiteral("d")));
+
+    ASSERT_EQ(map.erase(QStringLiteral("d")), 0U);
+    ASSERT_EQ(map.erase(QStringLiteral("a")), 1U);
+    map.erase(map.find(QStringLiteral("b")));
+    ASSERT_EQ(map.size(), 1U);
+    ASSERT_EQ(toStd(map), (std::unordered_map<QString, int>{
+                              {QStringLiteral("c"), 4},
+                          }));
+}
+
+TEST(PersistentHashMap, CopiesAreIndependent)
+{
+    PersistentHashMap<QString, int> map;
+    std::unordered_map<QString, int> expected;
+    for (int i = 0; i < 2000; i++)
+    {
+        map[QString::number(i)] = i;
+        expected[QString::number(i)] = i;
+    }
+
+    auto copy = map;
+    ASSERT_TRUE(copy.sharesStorageWith(map));
+
+    copy.erase(QStringLiteral("42"));
+    copy[QStringLiteral("43")] = -1;
+    copy[QStringLiteral("new")] = 1;
+    ASSERT_FALSE(copy.sharesStorageWith(map));
+
+    ASSERT_EQ(toStd(map), expected);
+
+    expected.erase(QStringLiteral("42"));
+    expected[QStringLiteral("43")] = -1;
+    expected[QStringLiteral("new")] = 1;
+    ASSERT_EQ(toStd(copy), expected);
+    ASSERT_EQ(copy.size(), expected.size());
+}
+
+TEST(PersistentHashMap, Collisions)
+{
+    PersistentHashMap<QString, int, LengthHash> map;
+    std::unordered_map<QString, int> expected;
+    for (int i = 0; i < 500; i++)
+    {
+        map[QString::number(i)] = i;
+        expected[QString::number(i)] = i;
+    }
+    ASSERT_EQ(toStd(map), expected);
+
+    auto copy = map;
+    for (int i = 0; i < 500; i += 2)
+    {
+        ASSERT_EQ(copy.erase(QString::number(i)), 1U);
+        expected.erase(QString::number(i));
+    }
+    ASSERT_EQ(toStd(copy), expected);
+    ASSERT_EQ(map.size(), 500U);
+
+    // Iterating from any element visits the remaining ones
+    size_t visited = 0;
+    for (auto it = copy.find(QStringLiteral("1")); it != copy.end(); ++it)
+    {
+        visited++;
+    }
+    ASSERT_GE(visited, 1U);
+    ASSERT_LE(visited, copy.size());
+}
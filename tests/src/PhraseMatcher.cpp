@@ -0,0 +1,150 @@
+#include "util/PhraseMatcher.hpp"
+
+#include "controllers/highlights/HighlightPhrase.hpp"
+#include "controllers/ignores/IgnorePhrase.hpp"
+#include "Test.hpp"
+
+#include <QStringList>
+
+using namespace chatterino;
+
+namespace {
+
+const QStringList SUBJECTS{
+    "",
+    "test",
+    "TEst",
+    "foo tEst",
+    "foo teSt bar",
+    "testbar",
+    "footest",
+    "foo!test",
+    "!test bar",
+    "test! bar",
+    "test!bar",
+    "ab ab ab",
+    "abab",
+    "xyz abc xyz",
+    "forsen: forsenE Kappa",
+    "Straße STRASSE",
+    "ÄÖÜ äöü",
+    "she sells sea shells",
+    "hers his he",
+    "\ttabbed\tline\t",
+    "2024-01-01 12:00",
+};
+
+const QStringList PATTERNS{
+    "test", "!test", "test!", "ab",    "abab", "b a", "Kappa", "forsen",
+    "äöü",  "STRASSE", "he", "she",   "hers", "his", "sea she", "tabbed",
+    "",     " ",
+};
+
+const QStringList REGEXES{
+    R"(\btest\b)", R"(^foo)",       R"(bar$)",  R"(\d{4}-\d\d)",
+    R"((ab)\1)",   R"((?<x>a)b)",   R"((?<x>e)s)", R"(Kappa|forsen)",
+    R"(s[ea]{2})", R"(ÄÖÜ)",        R"(()",     R"((?i)TEST)",
+    R"((?x) t e s t # comment)", R"(\Qa.b)",
+};
+
+}  // namespace
+
+TEST(PhraseMatcher, MatchesHighlightPhrases)
+{
+    for (bool isCaseSensitive : {false, true})
+    {
+        std::vector<HighlightPhrase> highlights;
+        std::vector<PhraseMatcher::Phrase> phrases;
+        auto add = [&](const QString &pattern, bool isRegex) {
+            highlights.emplace_back(pattern, false, false, false, isRegex,
+                                    isCaseSensitive, "", QColor());
+            phrases.push_back({
+                .pattern = pattern,
+                .isRegex = isRegex,
+                .isCaseSensitive = isCaseSensitive,
+                .wholeWord = !isRegex,
+            });
+        };
+        for (const auto &pattern : PATTERNS)
+        {
+            add(pattern, false);
+        }
+        for (const auto &regex : REGEXES)
+        {
+            add(regex, true);
+        }
+
+        PhraseMatcher matcher(phrases);
+        ASSERT_EQ(matcher.size(), highlights.size());
+
+        for (const auto &subject : SUBJECTS)
+        {
+            auto matches = matcher.match(subject);
+            ASSERT_EQ(matches.size(), highlights.size());
+
+            bool any = false;
+            for (size_t i = 0; i < highlights.size(); i++)
+            {
+                bool expected = highlights[i].isMatch(subject);
+                any = any || expected;
+                EXPECT_EQ(matches[i], expected)
+                    << "pattern: " << highlights[i].getPattern()
+                    << " subject: " << subject
+                    << " case sensitive: " << isCaseSensitive;
+            }
+            EXPECT_EQ(matcher.matchesAny(subject), any)
+                << "subject: " << subject;
+        }
+    }
+}
+
+TEST(PhraseMatcher, MatchesIgnorePhrases)
+{
+    for (bool isCaseSensitive : {false, true})
+    {
+        std::vector<IgnorePhrase> ignores;
+        std::vector<PhraseMatcher::Phrase> phrases;
+        auto add = [&](const QString &pattern, bool isRegex) {
+            ignores.emplace_back(pattern, isRegex, true, "", isCaseSensitive);
+            phrases.push_back({
+                .pattern = pattern,
+                .isRegex = isRegex,
+                .isCaseSensitive = isCaseSensitive,
+            });
+        };
+        for (const auto &pattern : PATTERNS)
+        {
+            add(pattern, false);
+        }
+        for (const auto &regex : REGEXES)
+        {
+            add(regex, true);
+        }
+
+        PhraseMatcher matcher(phrases);
+
+        for (const auto &subject : SUBJECTS)
+        {
+            auto matches = matcher.match(subject);
+            for (size_t i = 0; i < ignores.size(); i++)
+            {
+                EXPECT_EQ(matches[i], ignores[i].isMatch(subject))
+                    << "pattern: " << ignores[i].getPattern()
+                    << " subject: " << subject
+                    << " case sensitive: " << isCaseSensitive;
+            }
+        }
+    }
+}
+
+TEST(PhraseMatcher, Empty)
+{
+    PhraseMatcher matcher;
+    EXPECT_EQ(matcher.size(), 0U);
+    EXPECT_TRUE(matcher.match("test").empty());
+    EXPECT_FALSE(matcher.matchesAny("test"));
+
+    PhraseMatcher onlyEmpty({{.pattern = ""}, {.pattern = "", .isRegex = true}});
+    EXPECT_EQ(onlyEmpty.match("test"), std::vector<bool>({false, false}));
+    EXPECT_FALSE(onlyEmpty.matchesAny("test"));
+}
@@ -0,0 +1,46 @@
+#include "util/StringPool.hpp"
+
+#include "common/Literals.hpp"
+#include "Test.hpp"
+
+using namespace chatterino;
+using namespace literals;
+
+TEST(StringPool, sharesEqualStrings)
+{
+    StringPool pool;
+
+    // Built at runtime, so they don't share their data
+    auto a = QString::fromUtf8("forsen");
+    auto b = QString::fromUtf8("forsen");
+    ASSERT_NE(a.constData(), b.constData());
+
+    auto internedA = pool.intern(a);
+    auto internedB = pool.intern(b);
+    ASSERT_EQ(internedA, u"forsen"_s);
+    ASSERT_EQ(internedA.constData(), internedB.constData());
+    ASSERT_EQ(internedA.constData(), a.constData());
+
+    pool.internInPlace(b);
+    ASSERT_EQ(b.constData(), a.constData());
+
+    ASSERT_EQ(pool.intern(QString()), QString());
+    ASSERT_EQ(pool.size(), 1);
+}
+
+TEST(StringPool, dropsUnusedStrings)
+{
+    StringPool pool(4);
+
+    auto kept = pool.intern(QString::fromUtf8("kept"));
+    for (int i = 0; i < 3; i++)
+    {
+        pool.intern(QString::number(i));
+    }
+
+    // The pool reached 4 strings. Only `kept` and the string that was being
+    // interned were still used.
+    ASSERT_EQ(pool.size(), 2);
+    ASSERT_EQ(pool.intern(QString::fromUtf8("kept")).constData(),
+              kept.constData());
+}
@@ -3,6 +3,7 @@
 #include "mocks/BaseApplication.hpp"
 #include "mocks/Emotes.hpp"
 #include "providers/twitch/TwitchBadge.hpp"
+#include "providers/twitch/TwitchIrcLine.hpp"
 #include "Test.hpp"
 #include "util/IrcHelpers.hpp"
 
@@ -152,6 +153,13 @@ TEST(TwitchIrc, BadgeInfoParsing)
         EXPECT_EQ(outputBadges, test.expectedBadges)
             << "Input for badges " << test.input << " failed";
 
+        auto line = TwitchIrcLine::parse(test.input);
+        ASSERT_TRUE(line.has_value());
+        EXPECT_EQ(parseBadgeInfoTag(*line), test.expectedBadgeInfo)
+            << "Input for line badgeInfo " << test.input << " failed";
+        EXPECT_EQ(parseBadgeTag(*line), test.expectedBadges)
+            << "Input for line badges " << test.input << " failed";
+
         delete privmsg;
     }
 }
@@ -331,6 +339,12 @@ TEST_F(TestTwitchIrc, ParseTwitchEmotes)
         EXPECT_EQ(actualTwitchEmotes, test.expectedTwitchEmotes)
             << "Input for twitch emotes " << test.input << " failed";
 
+        auto line = TwitchIrcLine::parse(test.input);
+        ASSERT_TRUE(line.has_value());
+        EXPECT_EQ(parseTwitchEmotes(*line, originalMessage, 0),
+                  test.expectedTwitchEmotes)
+            << "Input for line twitch emotes " << test.input << " failed";
+
         delete privmsg;
     }
 }
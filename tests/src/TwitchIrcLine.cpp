@@ -0,0 +1,148 @@
+#include "providers/twitch/TwitchIrcLine.hpp"
+
+#include "Test.hpp"
+
+#include <IrcMessage>
+
+#include <memory>
+
+using namespace chatterino;
+
+namespace {
+
+const QByteArray PRIVMSG =
+    R"(@badge-info=subscriber/22;badges=broadcaster/1,subscriber/18;client-nonce=abc;color=#F97304;display-name=zneix;emotes=;first-msg=0;flags=;id=1d99f67f-a566-4416-a4e2-e85d7fce9223;mod=0;reply-parent-msg-body=hello\sworld;room-id=99631238;tmi-sent-ts=1653612232758;user-id=99631238;user-type= :zneix!zneix@zneix.tmi.twitch.tv PRIVMSG #zneix :-tags :) foo)";
+
+}  // namespace
+
+TEST(TwitchIrcLine, Tags)
+{
+    auto line = TwitchIrcLine::parse(PRIVMSG);
+    ASSERT_TRUE(line.has_value());
+
+    EXPECT_TRUE(line->hasTag(TwitchTag::BadgeInfo));
+    EXPECT_EQ(line->rawTag(TwitchTag::BadgeInfo), "subscriber/22");
+    EXPECT_EQ(line->tag(TwitchTag::Badges), "broadcaster/1,subscriber/18");
+    EXPECT_EQ(line->tag(TwitchTag::DisplayName), "zneix");
+    EXPECT_EQ(line->tag(TwitchTag::TmiSentTs), "1653612232758");
+
+    // present, but empty
+    EXPECT_TRUE(line->hasTag(TwitchTag::Emotes));
+    EXPECT_TRUE(line->tag(TwitchTag::Emotes).isEmpty());
+    EXPECT_TRUE(line->hasTag(TwitchTag::UserType));
+
+    // values aren't unescaped
+    EXPECT_EQ(line->tag(TwitchTag::ReplyParentMsgBody), R"(hello\sworld)");
+
+    EXPECT_FALSE(line->hasTag(TwitchTag::Bits));
+    EXPECT_TRUE(line->tag(TwitchTag::Bits).isNull());
+    EXPECT_TRUE(line->rawTag(TwitchTag::Bits).isEmpty());
+
+    // tags that aren't a TwitchTag
+    EXPECT_TRUE(line->hasTag("client-nonce"));
+    EXPECT_EQ(line->tag("client-nonce"), "abc");
+    EXPECT_TRUE(line->hasTag("flags"));
+    EXPECT_FALSE(line->hasTag("turbo"));
+
+    // known tags by their key
+    EXPECT_EQ(line->tag("room-id"), "99631238");
+    EXPECT_FALSE(line->hasTag("bits"));
+}
+
+TEST(TwitchIrcLine, PrefixCommandParameters)
+{
+    auto line = TwitchIrcLine::parse(PRIVMSG + "\r\n");
+    ASSERT_TRUE(line.has_value());
+
+    EXPECT_EQ(line->rawPrefix(), "zneix!zneix@zneix.tmi.twitch.tv");
+    EXPECT_EQ(line->nick(), "zneix");
+    EXPECT_EQ(line->command(), "PRIVMSG");
+    ASSERT_EQ(line->parameterCount(), 2);
+    EXPECT_EQ(line->parameter(0), "#zneix");
+    EXPECT_EQ(line->parameter(1), "-tags :) foo");
+    EXPECT_TRUE(line->parameter(2).isNull());
+
+    auto ping = TwitchIrcLine::parse("PING :tmi.twitch.tv");
+    ASSERT_TRUE(ping.has_value());
+    EXPECT_TRUE(ping->rawPrefix().isEmpty());
+    EXPECT_TRUE(ping->nick().isEmpty());
+    EXPECT_EQ(ping->command(), "PING");
+    ASSERT_EQ(ping->parameterCount(), 1);
+    EXPECT_EQ(ping->parameter(0), "tmi.twitch.tv");
+
+    auto clearChat = TwitchIrcLine::parse(
+        "@room-id=11148817;tmi-sent-ts=1642715756806 :tmi.twitch.tv "
+        "CLEARCHAT #pajlada");
+    ASSERT_TRUE(clearChat.has_value());
+    EXPECT_EQ(clearChat->nick(), "tmi.twitch.tv");
+    EXPECT_EQ(clearChat->command(), "CLEARCHAT");
+    ASSERT_EQ(clearChat->parameterCount(), 1);
+    EXPECT_EQ(clearChat->parameter(0), "#pajlada");
+}
+
+TEST(TwitchIrcLine, Invalid)
+{
+    EXPECT_FALSE(TwitchIrcLine::parse("").has_value());
+    EXPECT_FALSE(TwitchIrcLine::parse("\r\n").has_value());
+    EXPECT_FALSE(TwitchIrcLine::parse("@id=1 ").has_value());
+    EXPECT_FALSE(TwitchIrcLine::parse("@id=1 :tmi.twitch.tv").has_value());
+}
+
+TEST(TwitchIrcLine, TagKeys)
+{
+    for (size_t i = 0; i < static_cast<size_t>(TwitchTag::Count); i++)
+    {
+        auto tag = static_cast<TwitchTag>(i);
+        EXPECT_EQ(TwitchIrcLine::tagFromKey(TwitchIrcLine::keyOf(tag)), tag)
+            << TwitchIrcLine::keyOf(tag).toByteArray();
+    }
+
+    EXPECT_EQ(TwitchIrcLine::tagFromKey("client-nonce"), std::nullopt);
+    EXPECT_EQ(TwitchIrcLine::tagFromKey(""), std::nullopt);
+    EXPECT_EQ(TwitchIrcLine::tagFromKey("badge"), std::nullopt);
+}
+
+TEST(TwitchIrcLine, MatchesCommuni)
+{
+    std::unique_ptr<Communi::IrcMessage> message(
+        Communi::IrcMessage::fromData(PRIVMSG, nullptr));
+    auto line = TwitchIrcLine::fromMessage(*message);
+
+    auto expected = message->tags();
+    auto actual = line.tags();
+    ASSERT_EQ(actual.keys(), expected.keys());
+    for (auto it = expected.begin(); it != expected.end(); ++it)
+    {
+        EXPECT_EQ(actual.value(it.key()).toString(), it.value().toString())
+            << it.key();
+    }
+
+    EXPECT_EQ(line.nick(), message->nick());
+    EXPECT_EQ(QString::fromUtf8(line.command()), message->command());
+    ASSERT_EQ(line.parameterCount(), message->parameters().size());
+    for (qsizetype i = 0; i < line.parameterCount(); i++)
+    {
+        EXPECT_EQ(line.parameter(i), message->parameters().at(i));
+    }
+}
+
+TEST(TwitchIrcLine, FromConstructedMessage)
+{
+    Communi::IrcMessage message(nullptr);
+    message.setPrefix("pajlada!pajlada@pajlada.tmi.twitch.tv");
+    message.setCommand("PRIVMSG");
+    message.setParameters({"#pajlada", "hello world"});
+    message.setTags({
+        {"id", "foo"},
+        {"client-nonce", "bar"},
+    });
+
+    auto line = TwitchIrcLine::fromMessage(message);
+    EXPECT_EQ(line.tag(TwitchTag::Id), "foo");
+    EXPECT_EQ(line.tag("client-nonce"), "bar");
+    EXPECT_EQ(line.nick(), "pajlada");
+    EXPECT_EQ(line.command(), "PRIVMSG");
+    ASSERT_EQ(line.parameterCount(), 2);
+    EXPECT_EQ(line.parameter(0), "#pajlada");
+    EXPECT_EQ(line.parameter(1), "hello world");
+}
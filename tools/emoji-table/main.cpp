@@ -0,0 +1,562 @@
+/// Compiles resources/emoji.json into a C++ source with a static
+/// chatterino::emoji::EmojiTable, so the emojis don't have to be parsed at
+/// startup.
+///
+/// Usage: emoji-table-generator <emoji.json> <output.cpp>
+
+#include "providers/emoji/EmojiStyle.hpp"
+#include "providers/emoji/EmojiTable.hpp"
+
+#include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace chatterino;
+using namespace chatterino::emoji;
+
+const std::map<std::string, std::string> TONE_NAMES{
+    {"1F3FB", "tone1"}, {"1F3FC", "tone2"}, {"1F3FD", "tone3"},
+    {"1F3FE", "tone4"}, {"1F3FF", "tone5"},
+};
+
+[[noreturn]] void fail(const std::string &message)
+{
+    std::cerr << "emoji-table-generator: " << message << '\n';
+    std::exit(1);
+}
+
+std::vector<std::string> split(const std::string &s, char separator)
+{
+    std::vector<std::string> parts;
+    std::stringstream stream(s);
+    std::string part;
+    while (std::getline(stream, part, separator))
+    {
+        parts.push_back(part);
+    }
+    return parts;
+}
+
+/// Converts a code like "1F468-200D-2695-FE0F" to UTF-16
+std::u16string codeToUtf16(const std::string &code)
+{
+    std::u16string out;
+    for (const auto &part : split(code, '-'))
+    {
+        size_t end = 0;
+        auto cp = static_cast<char32_t>(std::stoul(part, &end, 16));
+        if (end != part.size() || cp > 0x10FFFF)
+        {
+            fail("Invalid code " + code);
+        }
+
+        if (cp >= 0x10000)
+        {
+            cp -= 0x10000;
+            out.push_back(static_cast<char16_t>(0xD800 + (cp >> 10)));
+            out.push_back(static_cast<char16_t>(0xDC00 + (cp & 0x3FF)));
+        }
+        else
+        {
+            out.push_back(static_cast<char16_t>(cp));
+        }
+    }
+    return out;
+}
+
+std::u16string asciiToUtf16(const std::string &s)
+{
+    return {s.begin(), s.end()};
+}
+
+/// "1F3FB-1F3FC" -> "tone1-tone2"
+std::string toneNames(const std::string &tones)
+{
+    std::string names;
+    for (const auto &tone : split(tones, '-'))
+    {
+        auto it = TONE_NAMES.find(tone);
+        if (it == TONE_NAMES.end())
+        {
+            fail("Unknown tone " + tone);
+        }
+        if (!names.empty())
+        {
+            names += '-';
+        }
+        names += it->second;
+    }
+    return names;
+}
+
+struct Emoji {
+    std::string unifiedCode;
+    std::string nonQualifiedCode;
+    std::u16string value;
+    std::u16string nonQualified;
+    std::vector<std::string> shortCodes;
+    uint8_t capabilities = 0;
+};
+
+std::string getString(const rapidjson::Value &obj, const char *key)
+{
+    auto it = obj.FindMember(key);
+    if (it == obj.MemberEnd() || !it->value.IsString())
+    {
+        return {};
+    }
+    return it->value.GetString();
+}
+
+Emoji parseEmoji(const rapidjson::Value &obj,
+                 std::vector<std::string> shortCodes)
+{
+    Emoji emoji{
+        .unifiedCode = getString(obj, "unified"),
+        .nonQualifiedCode = getString(obj, "non_qualified"),
+        .shortCodes = std::move(shortCodes),
+    };
+    if (emoji.unifiedCode.empty())
+    {
+        fail("Emoji without a unified code");
+    }
+
+    emoji.value = codeToUtf16(emoji.unifiedCode);
+    if (!emoji.nonQualifiedCode.empty())
+    {
+        emoji.nonQualified = codeToUtf16(emoji.nonQualifiedCode);
+    }
+
+    auto hasImage = [&](const char *key) {
+        auto it = obj.FindMember(key);
+        return it != obj.MemberEnd() && it->value.IsBool() &&
+               it->value.GetBool();
+    };
+    if (hasImage("has_img_apple"))
+    {
+        emoji.capabilities |= static_cast<uint8_t>(EmojiStyle::Apple);
+    }
+    if (hasImage("has_img_google"))
+    {
+        emoji.capabilities |= static_cast<uint8_t>(EmojiStyle::Google);
+    }
+    if (hasImage("has_img_twitter"))
+    {
+        emoji.capabilities |= static_cast<uint8_t>(EmojiStyle::Twitter);
+    }
+    if (hasImage("has_img_facebook"))
+    {
+        emoji.capabilities |= static_cast<uint8_t>(EmojiStyle::Facebook);
+    }
+
+    return emoji;
+}
+
+std::vector<Emoji> readEmojis(const char *path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        fail(std::string("Can't open ") + path);
+    }
+    std::string json((std::istreambuf_iterator<char>(file)),
+                     std::istreambuf_iterator<char>());
+
+    rapidjson::Document root;
+    rapidjson::ParseResult result = root.Parse(json.c_str(), json.size());
+    if (!result || !root.IsArray())
+    {
+        fail(std::string("JSON parse error: ") +
+             rapidjson::GetParseError_En(result.Code()));
+    }
+
+    std::vector<Emoji> emojis;
+    for (const auto &obj : root.GetArray())
+    {
+        std::vector<std::string> shortCodes;
+        for (const auto &name : obj["short_names"].GetArray())
+        {
+            shortCodes.emplace_back(name.GetString());
+        }
+        if (shortCodes.empty())
+        {
+            fail("Emoji without short codes");
+        }
+        auto baseName = shortCodes[0];
+        emojis.push_back(parseEmoji(obj, std::move(shortCodes)));
+
+        auto variations = obj.FindMember("skin_variations");
+        if (variations == obj.MemberEnd())
+        {
+            continue;
+        }
+        for (const auto &variation : variations->value.GetObject())
+        {
+            emojis.push_back(parseEmoji(
+                variation.value,
+                {baseName + "_" + toneNames(variation.name.GetString())}));
+        }
+    }
+    return emojis;
+}
+
+struct TrieBuilder {
+    struct Node {
+        std::map<char16_t, std::unique_ptr<Node>> children;
+        uint32_t emoji = EmojiTrieNode::NO_EMOJI;
+    };
+
+    Node root;
+
+    /// Adds @a sequence unless another emoji already ends there
+    void insert(const std::u16string &sequence, uint32_t emoji)
+    {
+        auto *node = &this->root;
+        for (auto unit : sequence)
+        {
+            auto &child = node->children[unit];
+            if (!child)
+            {
+                child = std::make_unique<Node>();
+            }
+            node = child.get();
+        }
+        if (node->emoji == EmojiTrieNode::NO_EMOJI)
+        {
+            node->emoji = emoji;
+        }
+    }
+
+    /// Lays out the nodes breadth first, so siblings are next to each other
+    std::vector<EmojiTrieNode> flatten() const
+    {
+        std::vector<EmojiTrieNode> nodes{{.emoji = this->root.emoji}};
+        std::vector<const Node *> queue{&this->root};
+        for (size_t i = 0; i < queue.size(); i++)
+        {
+            const auto *node = queue[i];
+            nodes[i].firstChild = static_cast<uint32_t>(nodes.size());
+            nodes[i].childCount = static_cast<uint16_t>(node->children.size());
+            for (const auto &[unit, child] : node->children)
+            {
+                nodes.push_back({
+                    .unit = unit,
+                    .emoji = child->emoji,
+                });
+                queue.push_back(child.get());
+            }
+        }
+        return nodes;
+    }
+};
+
+struct PerfectHash {
+    std::vector<uint16_t> seeds;
+    std::vector<uint16_t> slots;
+};
+
+/// Builds a perfect hash (hash and displace) of @a names
+PerfectHash buildPerfectHash(const std::vector<std::u16string> &names,
+                             const std::vector<uint16_t> &values)
+{
+    auto bucketCount = std::max<size_t>(1, names.size() / 4);
+    for (auto slotCount = names.size() + names.size() / 4 + 1;;
+         slotCount += names.size() / 8 + 1)
+    {
+        std::vector<std::vector<size_t>> buckets(bucketCount);
+        for (size_t i = 0; i < names.size(); i++)
+        {
+            buckets[shortCodeHash(names[i], 0) % bucketCount].push_back(i);
+        }
+        std::vector<size_t> order(bucketCount);
+        std::iota(order.begin(), order.end(), 0);
+        std::ranges::stable_sort(order, [&](size_t a, size_t b) {
+            return buckets[a].size() > buckets[b].size();
+        });
+
+        PerfectHash hash{
+            .seeds = std::vector<uint16_t>(bucketCount, 0),
+            .slots = std::vector<uint16_t>(slotCount, EmojiTable::NO_SHORT_CODE),
+        };
+        bool ok = true;
+        for (auto bucketIdx : order)
+        {
+            const auto &bucket = buckets[bucketIdx];
+            if (bucket.empty())
+            {
+                break;
+            }
+
+            bool placed = false;
+            for (uint32_t seed = 1; seed < UINT16_MAX && !placed; seed++)
+            {
+                std::vector<size_t> taken;
+                for (auto i : bucket)
+                {
+                    auto slot = shortCodeHash(names[i], seed) % slotCount;
+                    if (hash.slots[slot] != EmojiTable::NO_SHORT_CODE ||
+                        std::ranges::find(taken, slot) != taken.end())
+                    {
+                        break;
+                    }
+                    taken.push_back(slot);
+                }
+                if (taken.size() != bucket.size())
+                {
+                    continue;
+                }
+
+                for (size_t j = 0; j < bucket.size(); j++)
+                {
+                    hash.slots[taken[j]] = values[bucket[j]];
+                }
+                hash.seeds[bucketIdx] = static_cast<uint16_t>(seed);
+                placed = true;
+            }
+
+            if (!placed)
+            {
+                ok = false;
+                break;
+            }
+        }
+
+        if (ok)
+        {
+            return hash;
+        }
+    }
+}
+
+class Writer
+{
+public:
+    explicit Writer(std::ostream &out)
+        : out_(out)
+    {
+    }
+
+    /// Writes the elements of @a values with @a format, wrapping lines
+    template <typename T, typename Format>
+    void array(const char *declaration, const std::vector<T> &values,
+               Format format)
+    {
+        this->out_ << declaration << "{\n   ";
+        size_t column = 3;
+        for (const auto &value : values)
+        {
+            auto text = format(value);
+            if (column + text.size() + 2 > 80)
+            {
+                this->out_ << "\n   ";
+                column = 3;
+            }
+            this->out_ << ' ' << text << ',';
+            column += text.size() + 2;
+        }
+        this->out_ << "\n};\n\n";
+    }
+
+private:
+    std::ostream &out_;
+};
+
+std::string range(EmojiTableRange r)
+{
+    return "{" + std::to_string(r.offset) + ", " + std::to_string(r.length) +
+           "}";
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    if (argc != 3)
+    {
+        fail("Usage: emoji-table-generator <emoji.json> <output.cpp>");
+    }
+
+    auto emojis = readEmojis(argv[1]);
+
+    std::u16string text;
+    auto addText = [&](const std::u16string &s) {
+        EmojiTableRange r{
+            .offset = static_cast<uint32_t>(text.size()),
+            .length = static_cast<uint32_t>(s.size()),
+        };
+        text += s;
+        return r;
+    };
+
+    std::vector<EmojiTableEntry> entries;
+    std::vector<EmojiShortCode> shortCodes;
+    std::vector<std::u16string> shortCodeNames;
+    for (uint32_t i = 0; i < emojis.size(); i++)
+    {
+        const auto &emoji = emojis[i];
+        EmojiTableEntry entry{
+            .value = addText(emoji.value),
+            .nonQualified = addText(emoji.nonQualified),
+            .unifiedCode = addText(asciiToUtf16(emoji.unifiedCode)),
+            .nonQualifiedCode = addText(asciiToUtf16(emoji.nonQualifiedCode)),
+            .shortCodes =
+                {
+                    .offset = static_cast<uint32_t>(shortCodes.size()),
+                    .length = static_cast<uint32_t>(emoji.shortCodes.size()),
+                },
+            .capabilities = emoji.capabilities,
+        };
+        for (const auto &name : emoji.shortCodes)
+        {
+            shortCodeNames.push_back(asciiToUtf16(name));
+            shortCodes.push_back({
+                .name = addText(shortCodeNames.back()),
+                .emoji = i,
+            });
+        }
+        entries.push_back(entry);
+    }
+    if (shortCodes.size() >= EmojiTable::NO_SHORT_CODE)
+    {
+        fail("Too many short codes");
+    }
+
+    std::vector<uint16_t> sortedShortCodes(shortCodes.size());
+    std::iota(sortedShortCodes.begin(), sortedShortCodes.end(), 0);
+    std::ranges::stable_sort(sortedShortCodes, [&](uint16_t a, uint16_t b) {
+        return shortCodeNames[a] < shortCodeNames[b];
+    });
+
+    // If multiple emojis share a short code, the last one wins
+    std::map<std::u16string, uint16_t> uniqueShortCodes;
+    for (uint16_t i = 0; i < shortCodes.size(); i++)
+    {
+        uniqueShortCodes[shortCodeNames[i]] = i;
+    }
+    std::vector<std::u16string> hashNames;
+    std::vector<uint16_t> hashValues;
+    for (const auto &[name, index] : uniqueShortCodes)
+    {
+        hashNames.push_back(name);
+        hashValues.push_back(index);
+    }
+    auto hash = buildPerfectHash(hashNames, hashValues);
+
+    // Fully qualified emojis take precedence over non qualified ones
+    TrieBuilder trieBuilder;
+    for (uint32_t i = 0; i < emojis.size(); i++)
+    {
+        trieBuilder.insert(emojis[i].value, i);
+    }
+    for (uint32_t i = 0; i < emojis.size(); i++)
+    {
+        if (!emojis[i].nonQualified.empty())
+        {
+            trieBuilder.insert(emojis[i].nonQualified, i);
+        }
+    }
+    auto trie = trieBuilder.flatten();
+
+    uint64_t asciiStarts[2]{};
+    for (const auto &[unit, child] : trieBuilder.root.children)
+    {
+        if (unit < 128)
+        {
+            asciiStarts[unit / 64] |= uint64_t{1} << (unit % 64);
+        }
+    }
+
+    std::ostringstream out;
+    Writer writer(out);
+    out << "// This file is generated from resources/emoji.json by "
+           "tools/emoji-table.\n"
+           "// Don't edit it.\n\n"
+           "#include \"providers/emoji/EmojiTable.hpp\"\n\n"
+           "#include <iterator>\n\n"
+           "namespace {\n\n"
+           "using namespace chatterino::emoji;\n\n";
+
+    writer.array("constexpr char16_t TEXT[] = ",
+                 std::vector<char16_t>(text.begin(), text.end()),
+                 [](char16_t c) {
+                     return std::to_string(c);
+                 });
+    writer.array("constexpr EmojiTableEntry EMOJIS[] = ", entries,
+                 [](const EmojiTableEntry &e) {
+                     return "{" + range(e.value) + ", " +
+                            range(e.nonQualified) + ", " +
+                            range(e.unifiedCode) + ", " +
+                            range(e.nonQualifiedCode) + ", " +
+                            range(e.shortCodes) + ", " +
+                            std::to_string(e.capabilities) + "}";
+                 });
+    writer.array("constexpr EmojiShortCode SHORT_CODES[] = ", shortCodes,
+                 [](const EmojiShortCode &s) {
+                     return "{" + range(s.name) + ", " +
+                            std::to_string(s.emoji) + "}";
+                 });
+    auto number = [](uint16_t n) {
+        return std::to_string(n);
+    };
+    writer.array("constexpr uint16_t SORTED_SHORT_CODES[] = ",
+                 sortedShortCodes, number);
+    writer.array("constexpr EmojiTrieNode TRIE[] = ", trie,
+                 [](const EmojiTrieNode &n) {
+                     return "{" + std::to_string(n.unit) + ", " +
+                            std::to_string(n.childCount) + ", " +
+                            std::to_string(n.firstChild) + ", " +
+                            std::to_string(n.emoji) + "U}";
+                 });
+    writer.array("constexpr uint16_t SHORT_CODE_SEEDS[] = ", hash.seeds,
+                 number);
+    writer.array("constexpr uint16_t SHORT_CODE_SLOTS[] = ", hash.slots,
+                 number);
+
+    out << "}  // namespace\n\n"
+           "namespace chatterino::emoji {\n\n"
+           "constinit const EmojiTable EMOJI_TABLE{\n"
+           "    .emojis = EMOJIS,\n"
+           "    .shortCodes = SHORT_CODES,\n"
+           "    .sortedShortCodes = SORTED_SHORT_CODES,\n"
+           "    .text = {TEXT, std::size(TEXT)},\n"
+           "    .trie = TRIE,\n"
+           "    .asciiStarts = {"
+        << asciiStarts[0] << "ULL, " << asciiStarts[1]
+        << "ULL},\n"
+           "    .shortCodeSeeds = SHORT_CODE_SEEDS,\n"
+           "    .shortCodeSlots = SHORT_CODE_SLOTS,\n"
+           "};\n\n"
+           "}  // namespace chatterino::emoji\n";
+
+    // Only touch the output if it changed, so dependents aren't rebuilt
+    auto generated = out.str();
+    {
+        std::ifstream existing(argv[2], std::ios::binary);
+        std::string current((std::istreambuf_iterator<char>(existing)),
+                            std::istreambuf_iterator<char>());
+        if (current == generated)
+        {
+            return 0;
+        }
+    }
+
+    std::ofstream file(argv[2], std::ios::binary | std::ios::trunc);
+    file << generated;
+    if (!file)
+    {
+        fail(std::string("Can't write ") + argv[2]);
+    }
+    return 0;
+}